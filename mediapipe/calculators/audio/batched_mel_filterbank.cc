@@ -0,0 +1,88 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/audio/batched_mel_filterbank.h"
+
+#include <cmath>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "audio/dsp/mfcc/mel_filterbank.h"
+#include "mediapipe/framework/formats/matrix.h"
+
+namespace mediapipe {
+
+absl::Status BatchedMelFilterbank::Initialize(int input_length,
+                                              double input_sample_rate,
+                                              int output_channel_count,
+                                              double lower_frequency_limit,
+                                              double upper_frequency_limit) {
+  audio_dsp::MelFilterbank mel_filterbank;
+  if (!mel_filterbank.Initialize(input_length, input_sample_rate,
+                                 output_channel_count, lower_frequency_limit,
+                                 upper_frequency_limit)) {
+    return absl::InvalidArgumentError("Failed to initialize MelFilterbank.");
+  }
+  input_length_ = input_length;
+  num_channels_ = output_channel_count;
+
+  // The response to a unit bin is the column of weights of that bin.
+  taps_.clear();
+  std::vector<double> unit_bin(input_length, 0.0);
+  std::vector<double> response;
+  for (int bin = 0; bin < input_length; ++bin) {
+    unit_bin[bin] = 1.0;
+    mel_filterbank.Compute(unit_bin, &response);
+    unit_bin[bin] = 0.0;
+    for (int channel = 0; channel < num_channels_; ++channel) {
+      if (response[channel] != 0.0) {
+        taps_.push_back({bin, channel, response[channel]});
+      }
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::Status BatchedMelFilterbank::Compute(const Matrix& input,
+                                           Matrix* output) {
+  if (input.rows() != input_length_) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected ", input_length_, " spectral bins, got ",
+                     input.rows()));
+  }
+  magnitudes_ = input.cast<double>().array().sqrt();
+  mel_spectra_.setZero(num_channels_, input.cols());
+  for (const Tap& tap : taps_) {
+    mel_spectra_.row(tap.channel) += tap.weight * magnitudes_.row(tap.bin);
+  }
+  *output = mel_spectra_.cast<float>().matrix();
+  return absl::OkStatus();
+}
+
+absl::Status BatchedMelFilterbank::Compute(const std::vector<double>& input,
+                                           std::vector<double>* output) const {
+  if (static_cast<int>(input.size()) != input_length_) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Expected ", input_length_, " spectral bins, got ",
+                     input.size()));
+  }
+  output->assign(num_channels_, 0.0);
+  for (const Tap& tap : taps_) {
+    (*output)[tap.channel] += tap.weight * std::sqrt(input[tap.bin]);
+  }
+  return absl::OkStatus();
+}
+
+}  // namespace mediapipe
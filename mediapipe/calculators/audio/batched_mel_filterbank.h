@@ -0,0 +1,74 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_AUDIO_BATCHED_MEL_FILTERBANK_H_
+#define MEDIAPIPE_CALCULATORS_AUDIO_BATCHED_MEL_FILTERBANK_H_
+
+#include <vector>
+
+#include "Eigen/Core"
+#include "absl/status/status.h"
+#include "mediapipe/framework/formats/matrix.h"
+
+namespace mediapipe {
+
+// Applies the mel filterbank of audio_dsp::MelFilterbank to many frames of
+// squared-magnitude spectra at once.
+//
+// audio_dsp::MelFilterbank sums the weighted square roots of the spectral
+// bins into each mel channel, so its weights are read once from its response
+// to each bin, and then applied to all the frames of a call together: every
+// non-zero weight adds a row of square roots, i.e. one bin of all the frames,
+// to a row of the output, which vectorizes across frames.
+class BatchedMelFilterbank {
+ public:
+  // Same arguments as audio_dsp::MelFilterbank::Initialize().
+  absl::Status Initialize(int input_length, double input_sample_rate,
+                          int output_channel_count,
+                          double lower_frequency_limit,
+                          double upper_frequency_limit);
+
+  // Converts the squared-magnitude spectra in the columns of `input` into
+  // mel-warped linear-magnitude spectra in the columns of `output`.
+  absl::Status Compute(const Matrix& input, Matrix* output);
+
+  // Converts a single squared-magnitude spectrum into a mel-warped
+  // linear-magnitude spectrum, like audio_dsp::MelFilterbank::Compute().
+  absl::Status Compute(const std::vector<double>& input,
+                       std::vector<double>* output) const;
+
+ private:
+  using RowMajorArrayXXd =
+      Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  // The weight of a spectral bin in a mel channel.
+  struct Tap {
+    int bin;
+    int channel;
+    double weight;
+  };
+
+  int input_length_ = 0;
+  int num_channels_ = 0;
+  std::vector<Tap> taps_;
+
+  // Scratch buffers with one row per bin or channel and one column per frame,
+  // reused across calls.
+  RowMajorArrayXXd magnitudes_;
+  RowMajorArrayXXd mel_spectra_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_AUDIO_BATCHED_MEL_FILTERBANK_H_
@@ -0,0 +1,107 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/audio/batched_mel_filterbank.h"
+
+#include <vector>
+
+#include "Eigen/Core"
+#include "audio/dsp/mfcc/mel_filterbank.h"
+#include "mediapipe/framework/formats/matrix.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr double kSampleRate = 16000.0;
+constexpr double kLowerFrequency = 125.0;
+constexpr double kUpperFrequency = 7500.0;
+
+TEST(BatchedMelFilterbankTest, MatchesMelFilterbank) {
+  for (int input_length : {33, 257}) {
+    for (int num_channels : {5, 40}) {
+      audio_dsp::MelFilterbank expected_filterbank;
+      ASSERT_TRUE(expected_filterbank.Initialize(input_length, kSampleRate,
+                                                 num_channels, kLowerFrequency,
+                                                 kUpperFrequency));
+      BatchedMelFilterbank filterbank;
+      MP_ASSERT_OK(filterbank.Initialize(input_length, kSampleRate,
+                                         num_channels, kLowerFrequency,
+                                         kUpperFrequency));
+      const Matrix input = Matrix::Random(input_length, 100).array().square();
+
+      Matrix output;
+      MP_ASSERT_OK(filterbank.Compute(input, &output));
+
+      ASSERT_EQ(output.rows(), num_channels);
+      ASSERT_EQ(output.cols(), input.cols());
+      for (int frame = 0; frame < input.cols(); ++frame) {
+        const std::vector<double> spectrum(input.col(frame).data(),
+                                           input.col(frame).data() +
+                                               input_length);
+        std::vector<double> expected_mel_spectrum;
+        expected_filterbank.Compute(spectrum, &expected_mel_spectrum);
+        for (int channel = 0; channel < num_channels; ++channel) {
+          EXPECT_FLOAT_EQ(output(channel, frame),
+                          expected_mel_spectrum[channel])
+              << "channel " << channel << ", frame " << frame;
+        }
+      }
+    }
+  }
+}
+
+TEST(BatchedMelFilterbankTest, MatchesMelFilterbankOnSingleFrame) {
+  constexpr int kInputLength = 257;
+  constexpr int kNumChannels = 40;
+  audio_dsp::MelFilterbank expected_filterbank;
+  ASSERT_TRUE(expected_filterbank.Initialize(kInputLength, kSampleRate,
+                                             kNumChannels, kLowerFrequency,
+                                             kUpperFrequency));
+  BatchedMelFilterbank filterbank;
+  MP_ASSERT_OK(filterbank.Initialize(kInputLength, kSampleRate, kNumChannels,
+                                     kLowerFrequency, kUpperFrequency));
+  const Eigen::VectorXd input =
+      Eigen::VectorXd::Random(kInputLength).array().square();
+  const std::vector<double> spectrum(input.data(),
+                                     input.data() + kInputLength);
+
+  std::vector<double> mel_spectrum;
+  MP_ASSERT_OK(filterbank.Compute(spectrum, &mel_spectrum));
+
+  std::vector<double> expected_mel_spectrum;
+  expected_filterbank.Compute(spectrum, &expected_mel_spectrum);
+  ASSERT_EQ(static_cast<int>(mel_spectrum.size()), kNumChannels);
+  for (int channel = 0; channel < kNumChannels; ++channel) {
+    EXPECT_NEAR(mel_spectrum[channel], expected_mel_spectrum[channel], 1e-9)
+        << "channel " << channel;
+  }
+}
+
+TEST(BatchedMelFilterbankTest, FailsWithWrongInputLength) {
+  BatchedMelFilterbank filterbank;
+  MP_ASSERT_OK(filterbank.Initialize(/*input_length=*/33, kSampleRate,
+                                     /*output_channel_count=*/5,
+                                     kLowerFrequency, kUpperFrequency));
+  Matrix output;
+  EXPECT_FALSE(filterbank.Compute(Matrix::Zero(32, 1), &output).ok());
+  std::vector<double> mel_spectrum;
+  EXPECT_FALSE(
+      filterbank.Compute(std::vector<double>(32, 0.0), &mel_spectrum).ok());
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,261 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/audio/batched_spectrogram.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Eigen/Core"
+#include "absl/base/const_init.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/formats/matrix.h"
+
+namespace mediapipe {
+
+namespace {
+
+// The maximum number of frames transformed together, which bounds the size of
+// the scratch buffers to keep them in cache.
+constexpr int kMaxBatchFrames = 64;
+
+ABSL_CONST_INIT absl::Mutex plans_mutex(absl::kConstInit);
+
+int NextPowerOfTwo(int value) {
+  int power_of_two = 1;
+  while (power_of_two < value) {
+    power_of_two *= 2;
+  }
+  return power_of_two;
+}
+
+}  // namespace
+
+// A real FFT of length N is computed as a complex FFT of length M = N / 2 on
+// the even and odd samples, followed by a split step combining its bins.
+struct BatchedSpectrogram::FftPlan {
+  explicit FftPlan(int fft_length) : half_length(fft_length / 2) {
+    bit_reversed.resize(half_length);
+    int num_bits = 0;
+    while ((1 << num_bits) < half_length) {
+      ++num_bits;
+    }
+    for (int i = 0; i < half_length; ++i) {
+      int reversed = 0;
+      for (int bit = 0; bit < num_bits; ++bit) {
+        reversed |= ((i >> bit) & 1) << (num_bits - 1 - bit);
+      }
+      bit_reversed[i] = reversed;
+    }
+    for (int k = 0; k < half_length / 2; ++k) {
+      const double angle = -2.0 * M_PI * k / half_length;
+      twiddle_real.push_back(cos(angle));
+      twiddle_imag.push_back(sin(angle));
+    }
+    for (int k = 0; k <= half_length; ++k) {
+      const double angle = -2.0 * M_PI * k / fft_length;
+      split_real.push_back(cos(angle));
+      split_imag.push_back(sin(angle));
+    }
+  }
+
+  // M, the length of the complex FFT.
+  const int half_length;
+  // The index in bit-reversed order of each of the M complex samples.
+  std::vector<int> bit_reversed;
+  // exp(-2 * pi * i * k / M) for k in [0, M / 2).
+  std::vector<double> twiddle_real;
+  std::vector<double> twiddle_imag;
+  // exp(-2 * pi * i * k / N) for k in [0, M].
+  std::vector<double> split_real;
+  std::vector<double> split_imag;
+};
+
+const BatchedSpectrogram::FftPlan* BatchedSpectrogram::GetFftPlan(
+    int fft_length) {
+  static auto* plans =
+      new absl::flat_hash_map<int, std::unique_ptr<const FftPlan>>();
+  absl::MutexLock lock(&plans_mutex);
+  auto& plan = (*plans)[fft_length];
+  if (plan == nullptr) {
+    plan = std::make_unique<const FftPlan>(fft_length);
+  }
+  return plan.get();
+}
+
+absl::Status BatchedSpectrogram::Initialize(const std::vector<double>& window,
+                                            int step_length) {
+  if (window.size() < 2) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Window length must be at least 2, got ", window.size()));
+  }
+  if (step_length < 1) {
+    return absl::InvalidArgumentError(
+        absl::StrCat("Step length must be positive, got ", step_length));
+  }
+  window_ = window;
+  step_length_ = step_length;
+  fft_length_ = NextPowerOfTwo(window.size());
+  plan_ = GetFftPlan(fft_length_);
+  samples_.clear();
+  samples_to_skip_ = 0;
+  return absl::OkStatus();
+}
+
+int BatchedSpectrogram::AppendSamples(const Samples& input) {
+  const int64_t num_skipped =
+      std::min<int64_t>(samples_to_skip_, input.size());
+  samples_to_skip_ -= num_skipped;
+  const int old_size = samples_.size();
+  samples_.resize(old_size + input.size() - num_skipped);
+  for (int i = num_skipped; i < input.size(); ++i) {
+    samples_[old_size + i - num_skipped] = input[i];
+  }
+  const int window_length = window_.size();
+  if (static_cast<int>(samples_.size()) < window_length) {
+    return 0;
+  }
+  return (samples_.size() - window_length) / step_length_ + 1;
+}
+
+void BatchedSpectrogram::ConsumeFrames(int num_frames) {
+  const int64_t num_consumed =
+      static_cast<int64_t>(num_frames) * step_length_;
+  if (num_consumed >= static_cast<int64_t>(samples_.size())) {
+    samples_to_skip_ += num_consumed - samples_.size();
+    samples_.clear();
+  } else {
+    samples_.erase(samples_.begin(), samples_.begin() + num_consumed);
+  }
+}
+
+void BatchedSpectrogram::ComputeSpectra(int first_frame, int num_frames) {
+  const FftPlan& plan = *plan_;
+  const int half_length = plan.half_length;
+  const int window_length = window_.size();
+  fft_real_.resize(half_length, num_frames);
+  fft_imag_.resize(half_length, num_frames);
+  butterfly_real_.resize(num_frames);
+  butterfly_imag_.resize(num_frames);
+
+  // Packs the even and odd windowed samples of the frames into the real and
+  // imaginary parts of the complex FFT input, in bit-reversed order.
+  const double* frames = samples_.data() + first_frame * step_length_;
+  for (int n = 0; n < half_length; ++n) {
+    double* real = &fft_real_(plan.bit_reversed[n], 0);
+    double* imag = &fft_imag_(plan.bit_reversed[n], 0);
+    const int even = 2 * n;
+    const int odd = even + 1;
+    for (int frame = 0; frame < num_frames; ++frame) {
+      const double* samples = frames + frame * step_length_;
+      real[frame] = even < window_length ? samples[even] * window_[even] : 0.0;
+      imag[frame] = odd < window_length ? samples[odd] * window_[odd] : 0.0;
+    }
+  }
+
+  // Radix-2 decimation in time, where each butterfly combines two rows, i.e.
+  // the same bin of all the frames.
+  for (int half_span = 1; half_span < half_length; half_span *= 2) {
+    const int twiddle_step = half_length / (2 * half_span);
+    for (int start = 0; start < half_length; start += 2 * half_span) {
+      for (int j = 0; j < half_span; ++j) {
+        const double w_real = plan.twiddle_real[j * twiddle_step];
+        const double w_imag = plan.twiddle_imag[j * twiddle_step];
+        const int a = start + j;
+        const int b = a + half_span;
+        butterfly_real_ =
+            w_real * fft_real_.row(b) - w_imag * fft_imag_.row(b);
+        butterfly_imag_ =
+            w_real * fft_imag_.row(b) + w_imag * fft_real_.row(b);
+        fft_real_.row(b) = fft_real_.row(a) - butterfly_real_;
+        fft_imag_.row(b) = fft_imag_.row(a) - butterfly_imag_;
+        fft_real_.row(a) += butterfly_real_;
+        fft_imag_.row(a) += butterfly_imag_;
+      }
+    }
+  }
+
+  // Splits the complex bins Z[k] into the real FFT bins X[k] = E[k] +
+  // exp(-2 * pi * i * k / N) * O[k], where E[k] = (Z[k] + conj(Z[M - k])) / 2
+  // and O[k] = -i * (Z[k] - conj(Z[M - k])) / 2 are the bins of the even and
+  // odd samples.
+  spectrum_real_.resize(half_length + 1, num_frames);
+  spectrum_imag_.resize(half_length + 1, num_frames);
+  spectrum_real_.row(0) = fft_real_.row(0) + fft_imag_.row(0);
+  spectrum_imag_.row(0).setZero();
+  spectrum_real_.row(half_length) = fft_real_.row(0) - fft_imag_.row(0);
+  spectrum_imag_.row(half_length).setZero();
+  for (int k = 1; k < half_length; ++k) {
+    const auto z_real = fft_real_.row(k);
+    const auto z_imag = fft_imag_.row(k);
+    const auto mirror_real = fft_real_.row(half_length - k);
+    const auto mirror_imag = fft_imag_.row(half_length - k);
+    const double w_real = plan.split_real[k];
+    const double w_imag = plan.split_imag[k];
+    // O[k] = ((z_imag + mirror_imag) - i * (z_real - mirror_real)) / 2.
+    butterfly_real_ = 0.5 * (z_imag + mirror_imag);
+    butterfly_imag_ = 0.5 * (mirror_real - z_real);
+    spectrum_real_.row(k) = 0.5 * (z_real + mirror_real) +
+                            w_real * butterfly_real_ - w_imag * butterfly_imag_;
+    spectrum_imag_.row(k) = 0.5 * (z_imag - mirror_imag) +
+                            w_real * butterfly_imag_ + w_imag * butterfly_real_;
+  }
+}
+
+template <typename OutputMatrix, typename WriteBatchFn>
+absl::Status BatchedSpectrogram::ComputeAndWriteSpectra(
+    const Samples& input, OutputMatrix* output, WriteBatchFn write_batch) {
+  if (plan_ == nullptr) {
+    return absl::FailedPreconditionError(
+        "BatchedSpectrogram is not initialized.");
+  }
+  const int num_frames = AppendSamples(input);
+  output->resize(output_frequency_channels(), num_frames);
+  for (int first_frame = 0; first_frame < num_frames;
+       first_frame += kMaxBatchFrames) {
+    const int num_batch_frames =
+        std::min(kMaxBatchFrames, num_frames - first_frame);
+    ComputeSpectra(first_frame, num_batch_frames);
+    write_batch(output->middleCols(first_frame, num_batch_frames));
+  }
+  ConsumeFrames(num_frames);
+  return absl::OkStatus();
+}
+
+absl::Status BatchedSpectrogram::ComputeSpectrogram(const Samples& input,
+                                                    Matrix* output) {
+  return ComputeAndWriteSpectra(input, output, [this](auto output_frames) {
+    output_frames = (spectrum_real_.square() + spectrum_imag_.square())
+                        .cast<float>()
+                        .matrix();
+  });
+}
+
+absl::Status BatchedSpectrogram::ComputeSpectrogram(const Samples& input,
+                                                    Eigen::MatrixXcf* output) {
+  return ComputeAndWriteSpectra(input, output, [this](auto output_frames) {
+    output_frames.real() = spectrum_real_.cast<float>().matrix();
+    // audio_dsp::Spectrogram returns the conjugated DFT.
+    output_frames.imag() = (-spectrum_imag_).cast<float>().matrix();
+  });
+}
+
+}  // namespace mediapipe
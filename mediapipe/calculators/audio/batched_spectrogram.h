@@ -0,0 +1,118 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_AUDIO_BATCHED_SPECTROGRAM_H_
+#define MEDIAPIPE_CALCULATORS_AUDIO_BATCHED_SPECTROGRAM_H_
+
+#include <cstdint>
+#include <vector>
+
+#include "Eigen/Core"
+#include "absl/status/status.h"
+#include "mediapipe/framework/formats/matrix.h"
+
+namespace mediapipe {
+
+// Computes the spectrogram of a stream of samples like audio_dsp::Spectrogram,
+// but transforms all the frames completed by a call at once and writes them
+// directly into the columns of an output matrix.
+//
+// Frames start every `step_length` samples of the stream. Each frame is
+// multiplied by the window and zero-padded to the FFT length, which is the
+// smallest power of two not less than the window length, and has
+// fft_length / 2 + 1 frequency bins. The samples of incomplete frames are kept
+// for the next call.
+//
+// The FFTs of a batch of frames are computed together, with the frames laid
+// out so that every butterfly is a vector operation across frames, and their
+// twiddle factors are computed once per FFT length and shared by all the
+// instances. Values are computed in double precision, and complex values
+// follow the sign convention of audio_dsp::Spectrogram, whose imaginary parts
+// are negated compared to the usual DFT definition.
+class BatchedSpectrogram {
+ public:
+  // A row of samples of a possibly multichannel Matrix.
+  using Samples =
+      Eigen::Ref<const Eigen::RowVectorXf, 0, Eigen::InnerStride<>>;
+
+  BatchedSpectrogram() = default;
+  BatchedSpectrogram(const BatchedSpectrogram&) = delete;
+  BatchedSpectrogram& operator=(const BatchedSpectrogram&) = delete;
+
+  // Sets the window applied to each frame, whose size is the frame length,
+  // and the number of samples between the starts of consecutive frames.
+  // Discards the samples of previous calls.
+  absl::Status Initialize(const std::vector<double>& window, int step_length);
+
+  // Returns the number of frequency bins of each frame.
+  int output_frequency_channels() const { return fft_length_ / 2 + 1; }
+
+  // Appends `input` to the stream, and returns the squared magnitudes of the
+  // frames completed by it in the columns of `output`, which is resized to
+  // have output_frequency_channels() rows and one column per frame.
+  absl::Status ComputeSpectrogram(const Samples& input, Matrix* output);
+
+  // Same as above, but returns the complex values of the frames.
+  absl::Status ComputeSpectrogram(const Samples& input,
+                                  Eigen::MatrixXcf* output);
+
+ private:
+  // The bit-reversal permutation and twiddle factors of an FFT length.
+  struct FftPlan;
+
+  // Returns the plan of `fft_length`, computing it on first use.
+  static const FftPlan* GetFftPlan(int fft_length);
+
+  using RowMajorArrayXXd =
+      Eigen::Array<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>;
+
+  // Appends `input` to `samples_` and returns the number of frames it can
+  // produce.
+  int AppendSamples(const Samples& input);
+  // Removes the samples of the first `num_frames` frames from `samples_`.
+  void ConsumeFrames(int num_frames);
+  // Computes the spectra of `num_frames` frames, starting at the frame
+  // `first_frame` of `samples_`, into `spectrum_real_` and `spectrum_imag_`.
+  void ComputeSpectra(int first_frame, int num_frames);
+  // Computes the spectra of the frames completed by `input`, and writes each
+  // batch of them into `output` with `write_batch`.
+  template <typename OutputMatrix, typename WriteBatchFn>
+  absl::Status ComputeAndWriteSpectra(const Samples& input,
+                                      OutputMatrix* output,
+                                      WriteBatchFn write_batch);
+
+  const FftPlan* plan_ = nullptr;
+  std::vector<double> window_;
+  int step_length_ = 0;
+  int fft_length_ = 0;
+
+  // The samples of the stream starting at the next frame.
+  std::vector<double> samples_;
+  // How many samples of the stream to drop before the next frame, when the
+  // step is longer than the window.
+  int64_t samples_to_skip_ = 0;
+
+  // Scratch buffers for a batch of frames, with one row per FFT bin and one
+  // column per frame, reused across calls.
+  RowMajorArrayXXd fft_real_;
+  RowMajorArrayXXd fft_imag_;
+  RowMajorArrayXXd spectrum_real_;
+  RowMajorArrayXXd spectrum_imag_;
+  Eigen::Array<double, 1, Eigen::Dynamic> butterfly_real_;
+  Eigen::Array<double, 1, Eigen::Dynamic> butterfly_imag_;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_AUDIO_BATCHED_SPECTROGRAM_H_
@@ -0,0 +1,152 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/audio/batched_spectrogram.h"
+
+#include <complex>
+#include <vector>
+
+#include "Eigen/Core"
+#include "audio/dsp/spectrogram/spectrogram.h"
+#include "mediapipe/framework/formats/matrix.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr float kTolerance = 1e-5;
+
+struct SpectrogramTestParams {
+  int window_length;
+  int step_length;
+};
+
+class BatchedSpectrogramComparisonTest
+    : public ::testing::TestWithParam<SpectrogramTestParams> {
+ protected:
+  std::vector<double> MakeWindow() const {
+    std::vector<double> window(GetParam().window_length);
+    for (int i = 0; i < GetParam().window_length; ++i) {
+      window[i] = 0.5 + 0.5 * i / window.size();
+    }
+    return window;
+  }
+
+  // Returns packets of random samples of various sizes, including packets
+  // that don't complete any frame.
+  std::vector<Matrix> MakePackets() const {
+    std::vector<Matrix> packets;
+    for (int num_samples : {1, GetParam().window_length - 1, 3, 1000, 0, 257,
+                            2 * GetParam().step_length}) {
+      packets.push_back(Matrix::Random(1, num_samples));
+    }
+    return packets;
+  }
+};
+
+TEST_P(BatchedSpectrogramComparisonTest, MatchesSquaredMagnitudeSpectrogram) {
+  const std::vector<double> window = MakeWindow();
+  audio_dsp::Spectrogram expected_spectrogram;
+  ASSERT_TRUE(expected_spectrogram.Initialize(window, GetParam().step_length));
+  BatchedSpectrogram spectrogram;
+  MP_ASSERT_OK(spectrogram.Initialize(window, GetParam().step_length));
+  EXPECT_EQ(spectrogram.output_frequency_channels(),
+            expected_spectrogram.output_frequency_channels());
+
+  for (const Matrix& packet : MakePackets()) {
+    const std::vector<float> samples(packet.data(),
+                                     packet.data() + packet.size());
+    std::vector<std::vector<float>> expected_frames;
+    ASSERT_TRUE(
+        expected_spectrogram.ComputeSpectrogram(samples, &expected_frames));
+
+    Matrix frames;
+    MP_ASSERT_OK(spectrogram.ComputeSpectrogram(packet.row(0), &frames));
+
+    ASSERT_EQ(frames.cols(), static_cast<int>(expected_frames.size()));
+    for (int frame = 0; frame < frames.cols(); ++frame) {
+      const Eigen::Map<const Eigen::VectorXf> expected_frame(
+          expected_frames[frame].data(), expected_frames[frame].size());
+      EXPECT_TRUE(frames.col(frame).isApprox(expected_frame, kTolerance))
+          << "frame " << frame;
+    }
+  }
+}
+
+TEST_P(BatchedSpectrogramComparisonTest, MatchesComplexSpectrogram) {
+  const std::vector<double> window = MakeWindow();
+  audio_dsp::Spectrogram expected_spectrogram;
+  ASSERT_TRUE(expected_spectrogram.Initialize(window, GetParam().step_length));
+  BatchedSpectrogram spectrogram;
+  MP_ASSERT_OK(spectrogram.Initialize(window, GetParam().step_length));
+
+  for (const Matrix& packet : MakePackets()) {
+    const std::vector<float> samples(packet.data(),
+                                     packet.data() + packet.size());
+    std::vector<std::vector<std::complex<float>>> expected_frames;
+    ASSERT_TRUE(
+        expected_spectrogram.ComputeSpectrogram(samples, &expected_frames));
+
+    Eigen::MatrixXcf frames;
+    MP_ASSERT_OK(spectrogram.ComputeSpectrogram(packet.row(0), &frames));
+
+    ASSERT_EQ(frames.cols(), static_cast<int>(expected_frames.size()));
+    for (int frame = 0; frame < frames.cols(); ++frame) {
+      const Eigen::Map<const Eigen::VectorXcf> expected_frame(
+          expected_frames[frame].data(), expected_frames[frame].size());
+      EXPECT_TRUE(frames.col(frame).isApprox(expected_frame, kTolerance))
+          << "frame " << frame;
+    }
+  }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    BatchedSpectrogramComparisonTests, BatchedSpectrogramComparisonTest,
+    ::testing::ValuesIn<SpectrogramTestParams>({
+        {/*window_length=*/2, /*step_length=*/1},
+        {/*window_length=*/100, /*step_length=*/40},
+        {/*window_length=*/100, /*step_length=*/100},
+        {/*window_length=*/64, /*step_length=*/90},
+        {/*window_length=*/400, /*step_length=*/160},
+    }));
+
+TEST(BatchedSpectrogramTest, ReadsChannelOfMultichannelInput) {
+  const std::vector<double> window(100, 1.0);
+  BatchedSpectrogram spectrogram;
+  MP_ASSERT_OK(spectrogram.Initialize(window, /*step_length=*/50));
+  BatchedSpectrogram expected_spectrogram;
+  MP_ASSERT_OK(expected_spectrogram.Initialize(window, /*step_length=*/50));
+  const Matrix input = Matrix::Random(3, 300);
+  const Matrix channel = input.row(1);
+
+  Matrix frames;
+  MP_ASSERT_OK(spectrogram.ComputeSpectrogram(input.row(1), &frames));
+  Matrix expected_frames;
+  MP_ASSERT_OK(expected_spectrogram.ComputeSpectrogram(channel.row(0),
+                                                      &expected_frames));
+
+  EXPECT_EQ(frames.cols(), 5);
+  EXPECT_EQ(frames, expected_frames);
+}
+
+TEST(BatchedSpectrogramTest, FailsWithInvalidWindow) {
+  BatchedSpectrogram spectrogram;
+  EXPECT_FALSE(spectrogram.Initialize({1.0}, /*step_length=*/1).ok());
+  EXPECT_FALSE(spectrogram.Initialize({1.0, 1.0}, /*step_length=*/0).ok());
+}
+
+}  // namespace
+}  // namespace mediapipe
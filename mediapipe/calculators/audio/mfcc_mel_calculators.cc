@@ -27,8 +27,8 @@
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
-#include "audio/dsp/mfcc/mel_filterbank.h"
 #include "audio/dsp/mfcc/mfcc.h"
+#include "mediapipe/calculators/audio/batched_mel_filterbank.h"
 #include "mediapipe/calculators/audio/mfcc_mel_calculators.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
@@ -94,6 +94,11 @@ class FramewiseTransformCalculatorBase : public CalculatorBase {
   virtual absl::Status ConfigureTransform(const TimeSeriesHeader& header,
                                           CalculatorContext* cc) = 0;
 
+  // Takes a Matrix with one input frame per column, and performs the specific
+  // transformation to produce the output frames. By default, transforms each
+  // frame with TransformFrame().
+  virtual absl::Status TransformFrames(const Matrix& input, Matrix* output);
+
   // Takes a vector<double> corresponding to an input frame, and
   // perform the specific transformation to produce an output frame.
   virtual void TransformFrame(const std::vector<double>& input,
@@ -121,8 +126,17 @@ absl::Status FramewiseTransformCalculatorBase::Open(CalculatorContext* cc) {
 
 absl::Status FramewiseTransformCalculatorBase::Process(CalculatorContext* cc) {
   const Matrix& input = cc->Inputs().Index(0).Get<Matrix>();
+  auto output = std::make_unique<Matrix>();
+  MP_RETURN_IF_ERROR(TransformFrames(input, output.get()));
+  cc->Outputs().Index(0).Add(output.release(), cc->InputTimestamp());
+
+  return absl::OkStatus();
+}
+
+absl::Status FramewiseTransformCalculatorBase::TransformFrames(
+    const Matrix& input, Matrix* output) {
   const int num_frames = input.cols();
-  std::unique_ptr<Matrix> output(new Matrix(num_output_channels_, num_frames));
+  output->resize(num_output_channels_, num_frames);
   // The main work here is converting each column of the float Matrix
   // into a vector of doubles, which is what our target functions from
   // dsp_core consume, and doing the reverse with their output.
@@ -144,8 +158,6 @@ absl::Status FramewiseTransformCalculatorBase::Process(CalculatorContext* cc) {
                                                        output_frame.size(), 1);
     output->col(frame) = output_frame_map.cast<float>();
   }
-  cc->Outputs().Index(0).Add(output.release(), cc->InputTimestamp());
-
   return absl::OkStatus();
 }
 
@@ -223,7 +235,9 @@ REGISTER_CALCULATOR(MfccCalculator);
 
 // Calculator wrapper around the dsp/mfcc/mel_filterbank.cc routine.
 // Take frames of squared-magnitude spectra from the SpectrogramCalculator
-// and convert them into Mel-warped (linear-magnitude) spectra.
+// and convert them into Mel-warped (linear-magnitude) spectra. All the frames
+// of a packet are converted at once by BatchedMelFilterbank, which also
+// implements TransformFrame() for single frames.
 // Note: This code computes a mel-frequency filterbank, using a simple
 // algorithm that gives bad results (some mel channels that are always zero)
 // if you ask for too many channels.
@@ -238,7 +252,7 @@ class MelSpectrumCalculator : public FramewiseTransformCalculatorBase {
                                   CalculatorContext* cc) override {
     MelSpectrumCalculatorOptions mel_spectrum_options =
         cc->Options<MelSpectrumCalculatorOptions>();
-    mel_filterbank_.reset(new audio_dsp::MelFilterbank());
+    mel_filterbank_ = std::make_unique<BatchedMelFilterbank>();
     int input_length = header.num_channels();
     set_num_output_channels(mel_spectrum_options.channel_count());
     // An upstream calculator (such as SpectrogramCalculator) must store
@@ -250,12 +264,12 @@ class MelSpectrumCalculator : public FramewiseTransformCalculatorBase {
           absl::StrCat("No audio_sample_rate in input TimeSeriesHeader ",
                        PortableDebugString(header)));
     }
-    bool initialized = mel_filterbank_->Initialize(
+    absl::Status status = mel_filterbank_->Initialize(
         input_length, header.audio_sample_rate(), num_output_channels(),
         mel_spectrum_options.min_frequency_hertz(),
         mel_spectrum_options.max_frequency_hertz());
 
-    if (initialized) {
+    if (status.ok()) {
       return absl::OkStatus();
     } else {
       return absl::Status(absl::StatusCode::kInternal,
@@ -263,13 +277,17 @@ class MelSpectrumCalculator : public FramewiseTransformCalculatorBase {
     }
   }
 
+  absl::Status TransformFrames(const Matrix& input, Matrix* output) override {
+    return mel_filterbank_->Compute(input, output);
+  }
+
   void TransformFrame(const std::vector<double>& input,
                       std::vector<double>* output) const override {
-    mel_filterbank_->Compute(input, output);
+    ABSL_CHECK_OK(mel_filterbank_->Compute(input, output));
   }
 
  private:
-  std::unique_ptr<audio_dsp::MelFilterbank> mel_filterbank_;
+  std::unique_ptr<BatchedMelFilterbank> mel_filterbank_;
 };
 REGISTER_CALCULATOR(MelSpectrumCalculator);
 
@@ -19,10 +19,11 @@
 #include <deque>
 #include <memory>
 #include <string>
+#include <utility>
 
 #include "absl/strings/string_view.h"
-#include "audio/dsp/spectrogram/spectrogram.h"
 #include "audio/dsp/window_functions.h"
+#include "mediapipe/calculators/audio/batched_spectrogram.h"
 #include "mediapipe/calculators/audio/spectrogram_calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/matrix.h"
@@ -158,11 +159,10 @@ class SpectrogramCalculator : public CalculatorBase {
     return frame_duration_samples_ - frame_overlap_samples_;
   }
 
-  // Take the next set of input samples, already translated into a
-  // vector<float> and pass them to the spectrogram object.
-  // Convert the output of the spectrogram object into a Matrix (or an
-  // Eigen::MatrixXcf if complex-valued output is requested) and pass to
-  // MediaPipe output.
+  // Take the next set of input samples and pass each channel to its
+  // spectrogram object, which writes all the completed frames into a Matrix
+  // (or an Eigen::MatrixXcf if complex-valued output is requested), and pass
+  // them to MediaPipe output.
   absl::Status ProcessVector(const Matrix& input_stream, CalculatorContext* cc);
 
   // Templated function to process either real- or complex-output spectrogram.
@@ -196,8 +196,8 @@ class SpectrogramCalculator : public CalculatorBase {
   int output_type_;
   // Output type: mono or multichannel.
   bool allow_multichannel_input_;
-  // Vector of Spectrogram objects, one for each channel.
-  std::vector<std::unique_ptr<audio_dsp::Spectrogram>> spectrogram_generators_;
+  // Vector of BatchedSpectrogram objects, one for each channel.
+  std::vector<std::unique_ptr<BatchedSpectrogram>> spectrogram_generators_;
   // Fixed scale factor applied to output values (regardless of type).
   double output_scale_;
 
@@ -295,9 +295,9 @@ absl::Status SpectrogramCalculator::Open(CalculatorContext* cc) {
   // Propagate settings down to the actual Spectrogram object.
   spectrogram_generators_.clear();
   for (int i = 0; i < num_input_channels_; i++) {
-    spectrogram_generators_.push_back(
-        std::unique_ptr<audio_dsp::Spectrogram>(new audio_dsp::Spectrogram()));
-    spectrogram_generators_[i]->Initialize(window, frame_step_samples());
+    spectrogram_generators_.push_back(std::make_unique<BatchedSpectrogram>());
+    MP_RETURN_IF_ERROR(
+        spectrogram_generators_[i]->Initialize(window, frame_step_samples()));
   }
 
   num_output_channels_ =
@@ -363,66 +363,45 @@ absl::Status SpectrogramCalculator::ProcessVectorToOutput(
     const Matrix& input_stream,
     const OutputMatrixType postprocess_output_fn(const OutputMatrixType&),
     CalculatorContext* cc) {
-  std::unique_ptr<std::vector<OutputMatrixType>> spectrogram_matrices(
-      new std::vector<OutputMatrixType>());
-  std::vector<std::vector<typename OutputMatrixType::Scalar>> output_vectors;
+  auto spectrogram_matrices =
+      std::make_unique<std::vector<OutputMatrixType>>(input_stream.rows());
 
   // Compute a spectrogram for each channel.
-  int num_output_time_frames;
+  int num_output_time_frames = 0;
   for (int channel = 0; channel < input_stream.rows(); ++channel) {
-    output_vectors.clear();
-
-    // Copy one row (channel) of the input matrix into the std::vector.
-    std::vector<float> input_vector(input_stream.cols());
-    Eigen::Map<Matrix>(&input_vector[0], 1, input_vector.size()) =
-        input_stream.row(channel);
-
-    if (!spectrogram_generators_[channel]->ComputeSpectrogram(
-            input_vector, &output_vectors)) {
-      return absl::Status(absl::StatusCode::kInternal,
-                          "Spectrogram returned failure");
-    }
+    OutputMatrixType& output_frames = (*spectrogram_matrices)[channel];
+    MP_RETURN_IF_ERROR(spectrogram_generators_[channel]->ComputeSpectrogram(
+        input_stream.row(channel), &output_frames));
     if (channel == 0) {
       // Record the number of time frames we expect from each channel.
-      num_output_time_frames = output_vectors.size();
+      num_output_time_frames = output_frames.cols();
     } else {
-      RET_CHECK_EQ(output_vectors.size(), num_output_time_frames)
+      RET_CHECK_EQ(output_frames.cols(), num_output_time_frames)
           << "Inconsistent spectrogram time frames for channel " << channel;
     }
     // Skip remaining processing if there are too few input samples to trigger
     // any output frames.
-    if (!output_vectors.empty()) {
-      // Translate the returned values into a matrix of output frames.
-      OutputMatrixType output_frames(num_output_channels_,
-                                     output_vectors.size());
-      for (int frame = 0; frame < output_vectors.size(); ++frame) {
-        Eigen::Map<const OutputMatrixType> frame_map(
-            &output_vectors[frame][0], output_vectors[frame].size(), 1);
-        // The underlying dsp object returns squared magnitudes; here
-        // we optionally translate to linear magnitude or dB.
-        output_frames.col(frame) =
-            output_scale_ * postprocess_output_fn(frame_map);
-      }
-      spectrogram_matrices->push_back(output_frames);
+    if (num_output_time_frames > 0) {
+      // The underlying dsp object returns squared magnitudes; here
+      // we optionally translate to linear magnitude or dB.
+      output_frames = output_scale_ * postprocess_output_fn(output_frames);
     }
   }
   // If the input is very short, there may not be enough accumulated,
   // unprocessed samples to cause any new frames to be generated by
   // the spectrogram object.  If so, we don't want to emit
   // a packet at all.
-  if (!spectrogram_matrices->empty()) {
-    RET_CHECK_EQ(spectrogram_matrices->size(), input_stream.rows())
-        << "Inconsistent number of spectrogram channels.";
+  if (num_output_time_frames > 0) {
     if (allow_multichannel_input_) {
       cc->Outputs().Index(0).Add(spectrogram_matrices.release(),
                                  CurrentOutputTimestamp(cc));
     } else {
       cc->Outputs().Index(0).Add(
-          new OutputMatrixType(spectrogram_matrices->at(0)),
+          new OutputMatrixType(std::move(spectrogram_matrices->at(0))),
           CurrentOutputTimestamp(cc));
     }
-    cumulative_completed_frames_ += output_vectors.size();
-    last_completed_frames_ = output_vectors.size();
+    cumulative_completed_frames_ += num_output_time_frames;
+    last_completed_frames_ = num_output_time_frames;
     if (!use_local_timestamp_) {
       // In non-local timestamp mode the timestamp of the next packet will be
       // equal to CumulativeOutputTimestamp(). Inform the framework about this
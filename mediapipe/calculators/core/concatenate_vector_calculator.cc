@@ -19,6 +19,7 @@
 #include "mediapipe/framework/formats/classification.pb.h"
 #include "mediapipe/framework/formats/image.h"
 #include "mediapipe/framework/formats/landmark.pb.h"
+#include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/integral_types.h"
 #include "mediapipe/util/render_data.pb.h"
@@ -101,6 +102,10 @@ typedef ConcatenateVectorCalculator<::tflite::gpu::gl::GlBuffer>
 MEDIAPIPE_REGISTER_NODE(ConcatenateGlBufferVectorCalculator);
 #endif
 
+typedef ConcatenateVectorCalculator<mediapipe::NormalizedRect>
+    ConcatenateNormalizedRectVectorCalculator;
+MEDIAPIPE_REGISTER_NODE(ConcatenateNormalizedRectVectorCalculator);
+
 typedef ConcatenateVectorCalculator<mediapipe::RenderData>
     ConcatenateRenderDataVectorCalculator;
 MEDIAPIPE_REGISTER_NODE(ConcatenateRenderDataVectorCalculator);
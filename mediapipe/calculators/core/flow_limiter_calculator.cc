@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <deque>
+#include <map>
 #include <utility>
 #include <vector>
 
@@ -64,6 +66,14 @@ constexpr char kOptionsTag[] = "OPTIONS";
 // including the current timestamp, and "ALLOW = false" indicates the start of
 // dropping frames including the current timestamp.
 //
+// By default, the oldest queued frame is dropped when a frame arrives while the
+// queue is full. With `drop_policy: DROP_NEWEST`, the arriving frame is dropped
+// instead. Frames waiting in the queue longer than `max_queue_delay` are
+// dropped as well. If `target_latency` is set, `max_in_flight` is only an upper
+// bound: fewer frames are released at one time while frames finish processing
+// later than the target. Both durations are measured against the latest input
+// timestamp, so input timestamps are expected to follow capture time.
+//
 // FlowLimiterCalculator provides limited support for multiple input streams.
 // The first input stream is treated as the main input stream and successive
 // input streams are treated as auxiliary input streams.  The auxiliary input
@@ -98,6 +108,7 @@ class FlowLimiterCalculator : public CalculatorBase {
       options_.set_max_in_flight(
           cc->InputSidePackets().Tag(kMaxInFlightTag).Get<int>());
     }
+    adaptive_max_in_flight_ = options_.max_in_flight();
     input_queues_.resize(cc->Inputs().NumEntries(""));
     allowed_[Timestamp::Unset()] = true;
     RET_CHECK_OK(CopyInputHeadersToOutputs(cc->Inputs(), &(cc->Outputs())));
@@ -115,6 +126,7 @@ class FlowLimiterCalculator : public CalculatorBase {
              frames_in_flight_.front() <= finished_packet.Timestamp()) {
         frames_in_flight_.pop_front();
       }
+      UpdateAdaptiveMaxInFlight(finished_packet.Timestamp());
     }
 
     // Process the frame input streams.
@@ -122,6 +134,7 @@ class FlowLimiterCalculator : public CalculatorBase {
       Packet packet = cc->Inputs().Get("", i).Value();
       if (!packet.IsEmpty()) {
         input_queues_[i].push_back(packet);
+        if (i == 0) latest_input_ts_ = packet.Timestamp();
       }
     }
 
@@ -137,11 +150,28 @@ class FlowLimiterCalculator : public CalculatorBase {
       }
     }
 
-    // Release allowed frames from the main input queue.
+    // Drop the frames that waited too long in the queue.
     auto& input_queue = input_queues_[0];
-    while (ProcessingAllowed() && !input_queue.empty()) {
+    const TimestampDiff max_queue_delay = options_.max_queue_delay();
+    if (max_queue_delay > 0 && latest_input_ts_ != Timestamp::Unset()) {
+      while (!input_queue.empty() &&
+             (latest_input_ts_ - input_queue.front().Timestamp()) >
+                 max_queue_delay) {
+        SendAllow(false, input_queue.front().Timestamp(), cc);
+        input_queue.pop_front();
+      }
+    }
+
+    // Release allowed frames from the main input queue.
+    while (!input_queue.empty() &&
+           (input_queue.front().IsEmpty() || ProcessingAllowed())) {
       Packet packet = input_queue.front();
       input_queue.pop_front();
+      if (packet.IsEmpty()) {
+        // A frame dropped while older frames were still queued.
+        SendAllow(false, packet.Timestamp(), cc);
+        continue;
+      }
       cc->Outputs().Get("", 0).AddPacket(packet);
       SendAllow(true, packet.Timestamp(), cc);
       frames_in_flight_.push_back(packet.Timestamp());
@@ -150,10 +180,20 @@ class FlowLimiterCalculator : public CalculatorBase {
     // Limit the number of queued frames.
     // Note that frames can be dropped after frames are released because
     // frame-packets and FINISH-packets never arrive in the same Process call.
-    while (input_queue.size() > options_.max_in_queue()) {
-      Packet packet = input_queue.front();
-      input_queue.pop_front();
-      SendAllow(false, packet.Timestamp(), cc);
+    if (options_.drop_policy() == FlowLimiterCalculatorOptions::DROP_NEWEST) {
+      DropNewestQueuedFrames();
+      // Dropped frames are only reported in timestamp order, once no older
+      // frame is queued.
+      while (!input_queue.empty() && input_queue.front().IsEmpty()) {
+        SendAllow(false, input_queue.front().Timestamp(), cc);
+        input_queue.pop_front();
+      }
+    } else {
+      while (input_queue.size() > options_.max_in_queue()) {
+        Packet packet = input_queue.front();
+        input_queue.pop_front();
+        SendAllow(false, packet.Timestamp(), cc);
+      }
     }
 
     // Propagate the input timestamp bound.
@@ -190,7 +230,55 @@ class FlowLimiterCalculator : public CalculatorBase {
   // Returns true if an additional frame can be released for processing.
   // The "ALLOW" output stream indicates this condition at each input frame.
   bool ProcessingAllowed() {
-    return frames_in_flight_.size() < options_.max_in_flight();
+    return frames_in_flight_.size() < MaxInFlight();
+  }
+
+  // Returns the maximum number of frames released at one time.
+  int MaxInFlight() const {
+    if (options_.target_latency() <= 0) return options_.max_in_flight();
+    return std::min(adaptive_max_in_flight_, options_.max_in_flight());
+  }
+
+  // Adapts the number of frames released at one time to the latency of the
+  // frame finished at `finished`, if a target latency is set.
+  void UpdateAdaptiveMaxInFlight(Timestamp finished) {
+    const TimestampDiff target_latency = options_.target_latency();
+    if (target_latency <= 0 || latest_input_ts_ == Timestamp::Unset() ||
+        finished > latest_input_ts_) {
+      return;
+    }
+    const TimestampDiff latency = latest_input_ts_ - finished;
+    if (latency > target_latency) {
+      adaptive_max_in_flight_ = std::max(MaxInFlight() - 1, 1);
+    } else if (latency.Value() * 2 <= target_latency.Value()) {
+      adaptive_max_in_flight_ =
+          std::min(MaxInFlight() + 1, options_.max_in_flight());
+    }
+  }
+
+  // Replaces the newest queued frames beyond max_in_queue with empty packets,
+  // which keep their timestamps until they can be reported as dropped.
+  // Consecutive dropped frames are reported by a single "ALLOW = false" at the
+  // earliest of them, so only that placeholder is kept.  This bounds the queue
+  // even if queued frames are never released.
+  void DropNewestQueuedFrames() {
+    auto& input_queue = input_queues_[0];
+    int num_queued =
+        std::count_if(input_queue.begin(), input_queue.end(),
+                      [](const Packet& packet) { return !packet.IsEmpty(); });
+    for (auto it = input_queue.rbegin();
+         num_queued > options_.max_in_queue() && it != input_queue.rend();
+         ++it) {
+      if (it->IsEmpty()) continue;
+      *it = Packet().At(it->Timestamp());
+      --num_queued;
+    }
+    input_queue.erase(
+        std::unique(input_queue.begin(), input_queue.end(),
+                    [](const Packet& earlier, const Packet& later) {
+                      return earlier.IsEmpty() && later.IsEmpty();
+                    }),
+        input_queue.end());
   }
 
   // Outputs a packet indicating whether a frame was sent or dropped.
@@ -261,6 +349,10 @@ class FlowLimiterCalculator : public CalculatorBase {
   std::vector<std::deque<Packet>> input_queues_;
   std::deque<Timestamp> frames_in_flight_;
   std::map<Timestamp, bool> allowed_;
+  // The latest timestamp received on the main input stream.
+  Timestamp latest_input_ts_ = Timestamp::Unset();
+  // The number of frames released at one time when target_latency is set.
+  int adaptive_max_in_flight_ = 1;
 };
 REGISTER_CALCULATOR(FlowLimiterCalculator);
 
@@ -980,5 +980,167 @@ TEST_F(FlowLimiterCalculatorTest, AuxiliaryInputs) {
               ElementsAreArray(PacketMatchers<bool>(expected_allow)));
 }
 
+// Runs a FlowLimiterCalculator whose FINISHED stream is fed by the test, so
+// that frames finish exactly when the test decides.
+class FlowLimiterCalculatorPolicyTest : public testing::Test {
+ protected:
+  void StartGraph(const FlowLimiterCalculatorOptions& options) {
+    CalculatorGraphConfig graph_config =
+        ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+          input_stream: 'in'
+          input_stream: 'finished'
+          node {
+            calculator: 'FlowLimiterCalculator'
+            input_side_packet: 'OPTIONS:limiter_options'
+            input_stream: 'in'
+            input_stream: 'FINISHED:finished'
+            output_stream: 'in_sampled'
+            output_stream: 'ALLOW:allow'
+          }
+        )pb");
+    tool::AddVectorSink("in_sampled", &graph_config, &sampled_packets_);
+    tool::AddVectorSink("allow", &graph_config, &allow_packets_);
+    MP_ASSERT_OK(graph_.Initialize(
+        graph_config,
+        {{"limiter_options",
+          MakePacket<FlowLimiterCalculatorOptions>(options)}}));
+    MP_ASSERT_OK(graph_.StartRun({}));
+  }
+
+  void AddFrame(int64_t timestamp) {
+    MP_EXPECT_OK(graph_.AddPacketToInputStream(
+        "in", MakePacket<int64_t>(timestamp).At(Timestamp(timestamp))));
+    MP_EXPECT_OK(graph_.WaitUntilIdle());
+  }
+
+  void FinishFrame(int64_t timestamp) {
+    MP_EXPECT_OK(graph_.AddPacketToInputStream(
+        "finished", MakePacket<int64_t>(timestamp).At(Timestamp(timestamp))));
+    MP_EXPECT_OK(graph_.WaitUntilIdle());
+  }
+
+  void CloseGraph() {
+    MP_EXPECT_OK(graph_.CloseAllPacketSources());
+    MP_EXPECT_OK(graph_.WaitUntilDone());
+  }
+
+  CalculatorGraph graph_;
+  std::vector<Packet> sampled_packets_;
+  std::vector<Packet> allow_packets_;
+};
+
+TEST_F(FlowLimiterCalculatorPolicyTest, DropOldest) {
+  FlowLimiterCalculatorOptions options;
+  options.set_max_in_flight(1);
+  options.set_max_in_queue(1);
+  StartGraph(options);
+  AddFrame(0);
+  AddFrame(10);
+  AddFrame(20);
+  AddFrame(30);
+  FinishFrame(0);
+  CloseGraph();
+
+  EXPECT_EQ(TimestampValues(sampled_packets_), (std::vector<int64_t>{0, 30}));
+  EXPECT_EQ(TimestampValues(allow_packets_),
+            (std::vector<int64_t>{0, 10, 20, 30}));
+  EXPECT_EQ(PacketValues<bool>(allow_packets_),
+            (std::vector<bool>{true, false, false, true}));
+}
+
+TEST_F(FlowLimiterCalculatorPolicyTest, DropNewest) {
+  FlowLimiterCalculatorOptions options;
+  options.set_max_in_flight(1);
+  options.set_max_in_queue(1);
+  options.set_drop_policy(FlowLimiterCalculatorOptions::DROP_NEWEST);
+  StartGraph(options);
+  AddFrame(0);
+  AddFrame(10);
+  AddFrame(20);
+  AddFrame(30);
+  FinishFrame(0);
+  AddFrame(40);
+  CloseGraph();
+
+  EXPECT_EQ(TimestampValues(sampled_packets_), (std::vector<int64_t>{0, 10}));
+  // Frames 20 and 30 are reported as dropped from frame 20 on, once frame 10
+  // is released.
+  EXPECT_EQ(TimestampValues(allow_packets_),
+            (std::vector<int64_t>{0, 10, 20}));
+  EXPECT_EQ(PacketValues<bool>(allow_packets_),
+            (std::vector<bool>{true, true, false}));
+}
+
+TEST_F(FlowLimiterCalculatorPolicyTest, DropNewestWithoutFinishedFrames) {
+  FlowLimiterCalculatorOptions options;
+  options.set_max_in_flight(1);
+  options.set_max_in_queue(2);
+  options.set_drop_policy(FlowLimiterCalculatorOptions::DROP_NEWEST);
+  StartGraph(options);
+  // Frame 0 doesn't finish for a long time, so every frame after frames 10
+  // and 20 is dropped while they wait in the queue.
+  for (int64_t timestamp = 0; timestamp < 10000; timestamp += 10) {
+    AddFrame(timestamp);
+  }
+  FinishFrame(0);
+  FinishFrame(10);
+  CloseGraph();
+
+  // All the frames dropped from frame 30 on are reported at once.
+  EXPECT_EQ(TimestampValues(sampled_packets_),
+            (std::vector<int64_t>{0, 10, 20}));
+  EXPECT_EQ(TimestampValues(allow_packets_),
+            (std::vector<int64_t>{0, 10, 20, 30}));
+  EXPECT_EQ(PacketValues<bool>(allow_packets_),
+            (std::vector<bool>{true, true, true, false}));
+}
+
+TEST_F(FlowLimiterCalculatorPolicyTest, MaxQueueDelay) {
+  FlowLimiterCalculatorOptions options;
+  options.set_max_in_flight(1);
+  options.set_max_in_queue(5);
+  options.set_max_queue_delay(25);
+  StartGraph(options);
+  AddFrame(0);
+  AddFrame(10);
+  AddFrame(20);
+  AddFrame(30);
+  // Frame 10 waited too long.
+  AddFrame(40);
+  FinishFrame(0);
+  CloseGraph();
+
+  EXPECT_EQ(TimestampValues(sampled_packets_), (std::vector<int64_t>{0, 20}));
+  EXPECT_EQ(TimestampValues(allow_packets_),
+            (std::vector<int64_t>{0, 10, 20}));
+  EXPECT_EQ(PacketValues<bool>(allow_packets_),
+            (std::vector<bool>{true, false, true}));
+}
+
+TEST_F(FlowLimiterCalculatorPolicyTest, TargetLatency) {
+  FlowLimiterCalculatorOptions options;
+  options.set_max_in_flight(2);
+  options.set_max_in_queue(0);
+  options.set_target_latency(15);
+  StartGraph(options);
+  AddFrame(0);
+  AddFrame(10);
+  AddFrame(20);
+  // Frame 0 finishes 20us behind the latest frame, so only one frame is
+  // released at one time from now on.
+  FinishFrame(0);
+  AddFrame(30);
+  FinishFrame(10);
+  AddFrame(40);
+  // Frame 40 finishes without delay, so two frames are released again.
+  FinishFrame(40);
+  AddFrame(50);
+  AddFrame(60);
+  CloseGraph();
+
+  EXPECT_EQ(TimestampValues(sampled_packets_),
+            (std::vector<int64_t>{0, 10, 40, 50, 60}));
+}
+
 }  // anonymous namespace
 }  // namespace mediapipe
@@ -25,6 +25,7 @@
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
+#include "absl/types/span.h"
 #include "audio/dsp/resampler_q.h"
 #include "audio/dsp/window_functions.h"
 #include "mediapipe/calculators/tensor/audio_to_tensor_calculator.pb.h"
@@ -75,6 +76,61 @@ bool IsValidFftSize(int size) {
   return factorization[0] >= 5 && n == 1;
 }
 
+// Writes `samples` into a new float tensor of shape `tensor_dims`, padded with
+// zeros if there are fewer samples than tensor elements.
+std::vector<Tensor> ConvertToTensor(absl::Span<const float> samples,
+                                    const std::vector<int>& tensor_dims) {
+  Tensor tensor(Tensor::ElementType::kFloat32, Tensor::Shape(tensor_dims));
+  {
+    auto buffer_view = tensor.GetCpuWriteView();
+    float* buffer = buffer_view.buffer<float>();
+    const int num_samples = samples.size();
+    const int num_elements = tensor.shape().num_elements();
+    std::memcpy(buffer, samples.data(), num_samples * sizeof(float));
+    if (num_samples < num_elements) {
+      std::fill(buffer + num_samples, buffer + num_elements, 0.0f);
+    }
+  }
+  std::vector<Tensor> tensor_vector;
+  tensor_vector.push_back(std::move(tensor));
+  return tensor_vector;
+}
+
+// Writes the ordered real FFT output of PFFFT, whose first two values are the
+// real DC and Nyquist components, into a new 2D tensor holding the real parts
+// in its first row and the imaginary parts in its second row.
+absl::StatusOr<std::vector<Tensor>> ConvertFftOutputToTensor(
+    absl::Span<const float> fft_output, DftTensorFormat dft_tensor_format) {
+  const int fft_size = fft_output.size();
+  switch (dft_tensor_format) {
+    case Options::WITH_NYQUIST: {
+      std::vector<Tensor> tensors =
+          ConvertToTensor(fft_output.subspan(2), {2, fft_size / 2});
+      auto buffer_view = tensors[0].GetCpuWriteView();
+      float* buffer = buffer_view.buffer<float>();
+      // The last two elements are Nyquist component.
+      buffer[fft_size - 2] = fft_output[1];  // Nyquist real part
+      buffer[fft_size - 1] = 0.0f;           // Nyquist imagery part
+      return tensors;
+    }
+    case Options::WITH_DC_AND_NYQUIST: {
+      std::vector<Tensor> tensors =
+          ConvertToTensor(fft_output, {2, (fft_size + 2) / 2});
+      auto buffer_view = tensors[0].GetCpuWriteView();
+      float* buffer = buffer_view.buffer<float>();
+      buffer[1] = 0.0f;  // DC imagery part.
+      // The last two elements are  Nyquist component.
+      buffer[fft_size] = fft_output[1];  // Nyquist real part
+      buffer[fft_size + 1] = 0.0f;       // Nyquist imagery part
+      return tensors;
+    }
+    case Options::WITHOUT_DC_AND_NYQUIST:
+      return ConvertToTensor(fft_output.subspan(2), {2, (fft_size - 2) / 2});
+    default:
+      return absl::InvalidArgumentError("Unsupported dft tensor format.");
+  }
+}
+
 }  // namespace
 
 // Converts audio buffers into tensors, possibly with resampling, buffering
@@ -202,7 +258,13 @@ class AudioToTensorCalculator : public Node {
   audio_dsp::QResamplerParams params_;
   // A QResampler instance to resample an audio stream.
   std::unique_ptr<audio_dsp::QResampler<float>> resampler_;
-  Matrix sample_buffer_;
+  // The output of `resampler_` for the current input, reused across inputs.
+  Matrix resampled_buffer_;
+  // The samples of the streaming mode that are not consumed yet, stored in
+  // column-major order like a Matrix with `num_channels_` rows. Frames are
+  // written straight from this buffer into the output tensors, and its
+  // memory is reused across inputs as the consumed samples are removed.
+  std::vector<float> sample_buffer_;
   int processed_buffer_cols_ = 0;
   double gain_ = 1.0;
 
@@ -220,14 +282,16 @@ class AudioToTensorCalculator : public Node {
                                        const Matrix& input);
 
   absl::Status SetupStreamingResampler(double input_sample_rate_);
-  void AppendToSampleBuffer(Matrix buffer_to_append);
+  void AppendToSampleBuffer(const Matrix& buffer_to_append);
   void AppendZerosToSampleBuffer(int num_samples);
 
-  absl::StatusOr<std::vector<Tensor>> ConvertToTensor(
-      const Matrix& block, std::vector<int> tensor_dims);
-  absl::Status OutputTensor(const Matrix& block, Timestamp timestamp,
+  // Outputs the tensor of a frame, whose samples are stored in column-major
+  // order like a Matrix with `num_channels_` rows.
+  absl::Status OutputTensor(absl::Span<const float> frame, Timestamp timestamp,
                             CalculatorContext* cc);
-  absl::Status ProcessBuffer(const Matrix& buffer, bool should_flush,
+  // Outputs the tensors of the frames of `buffer`, whose samples are stored
+  // in column-major order like a Matrix with `num_channels_` rows.
+  absl::Status ProcessBuffer(absl::Span<const float> buffer, bool should_flush,
                              CalculatorContext* cc);
 };
 
@@ -274,7 +338,6 @@ absl::Status AudioToTensorCalculator::Open(CalculatorContext* cc) {
   stream_mode_ = options.stream_mode();
   if (stream_mode_) {
     check_inconsistent_timestamps_ = options.check_inconsistent_timestamps();
-    sample_buffer_.resize(num_channels_, Eigen::NoChange);
   }
   padding_samples_before_ = options.padding_samples_before();
   padding_samples_after_ = options.padding_samples_after();
@@ -366,9 +429,8 @@ absl::Status AudioToTensorCalculator::Close(CalculatorContext* cc) {
     return absl::OkStatus();
   }
   if (resampler_) {
-    Matrix resampled_buffer(num_channels_, 0);
-    resampler_->Flush(&resampled_buffer);
-    AppendToSampleBuffer(std::move(resampled_buffer));
+    resampler_->Flush(&resampled_buffer_);
+    AppendToSampleBuffer(resampled_buffer_);
   }
   AppendZerosToSampleBuffer(padding_samples_after_);
   MP_RETURN_IF_ERROR(ProcessBuffer(sample_buffer_, /*should_flush=*/true, cc));
@@ -401,25 +463,19 @@ absl::Status AudioToTensorCalculator::ProcessStreamingData(
   }
 
   if (resampler_) {
-    Matrix resampled_buffer(num_channels_, 0);
-    resampler_->ProcessSamples(input_buffer, &resampled_buffer);
-    AppendToSampleBuffer(std::move(resampled_buffer));
+    resampler_->ProcessSamples(input_buffer, &resampled_buffer_);
+    AppendToSampleBuffer(resampled_buffer_);
   } else {
-    // Tries to consume the input matrix first to avoid extra data copy.
-    auto status_or_matrix = kAudioIn(cc).packet().Consume<Matrix>();
-    if (status_or_matrix.ok()) {
-      Matrix local_matrix(num_channels_, 0);
-      local_matrix.swap(*status_or_matrix.value());
-      AppendToSampleBuffer(std::move(local_matrix));
-    } else {
-      AppendToSampleBuffer(input_buffer);
-    }
+    AppendToSampleBuffer(input_buffer);
   }
 
   MP_RETURN_IF_ERROR(ProcessBuffer(sample_buffer_, /*should_flush=*/false, cc));
-  // Removes the processed samples from the global sample buffer.
-  sample_buffer_ = Matrix(sample_buffer_.rightCols(sample_buffer_.cols() -
-                                                   processed_buffer_cols_ - 1));
+  // Removes the processed samples from the global sample buffer. Only the
+  // samples of the next frames are moved, and the memory is kept for the
+  // next inputs.
+  sample_buffer_.erase(
+      sample_buffer_.begin(),
+      sample_buffer_.begin() + (processed_buffer_cols_ + 1) * num_channels_);
   return absl::OkStatus();
 }
 
@@ -434,11 +490,11 @@ absl::Status AudioToTensorCalculator::ProcessNonStreamingData(
     std::vector<float> resampled = audio_dsp::QResampleSignal<float>(
         source_sample_rate, target_sample_rate_, num_channels_, params_,
         input_frame);
-    Eigen::Map<const Matrix> matrix_mapping(resampled.data(), num_channels_,
-                                            resampled.size() / num_channels_);
-    return ProcessBuffer(matrix_mapping, /*should_flush=*/true, cc);
+    return ProcessBuffer(resampled, /*should_flush=*/true, cc);
   }
-  return ProcessBuffer(input_frame, /*should_flush=*/true, cc);
+  return ProcessBuffer(
+      absl::MakeConstSpan(input_frame.data(), input_frame.size()),
+      /*should_flush=*/true, cc);
 }
 
 absl::Status AudioToTensorCalculator::SetupStreamingResampler(
@@ -459,49 +515,24 @@ absl::Status AudioToTensorCalculator::SetupStreamingResampler(
 
 void AudioToTensorCalculator::AppendZerosToSampleBuffer(int num_samples) {
   ABSL_CHECK_GE(num_samples, 0);  // Ensured by `UpdateContract`.
-  if (num_samples == 0) {
-    return;
-  }
-  sample_buffer_.conservativeResize(Eigen::NoChange,
-                                    sample_buffer_.cols() + num_samples);
-  sample_buffer_.rightCols(num_samples).setZero();
+  sample_buffer_.resize(sample_buffer_.size() + num_samples * num_channels_,
+                        0.0f);
 }
 
-void AudioToTensorCalculator::AppendToSampleBuffer(Matrix buffer_to_append) {
-  sample_buffer_.conservativeResize(
-      Eigen::NoChange, sample_buffer_.cols() + buffer_to_append.cols());
-  sample_buffer_.rightCols(buffer_to_append.cols()).swap(buffer_to_append);
+void AudioToTensorCalculator::AppendToSampleBuffer(
+    const Matrix& buffer_to_append) {
+  sample_buffer_.insert(sample_buffer_.end(), buffer_to_append.data(),
+                        buffer_to_append.data() + buffer_to_append.size());
 }
 
-absl::StatusOr<std::vector<Tensor>> AudioToTensorCalculator::ConvertToTensor(
-    const Matrix& block, std::vector<int> tensor_dims) {
-  Tensor tensor(Tensor::ElementType::kFloat32, Tensor::Shape(tensor_dims));
-  auto buffer_view = tensor.GetCpuWriteView();
-  int total_size = 1;
-  for (int dim : tensor_dims) {
-    total_size *= dim;
-  }
-  if (block.size() < total_size) {
-    std::memset(buffer_view.buffer<float>(), 0, tensor.bytes());
-  }
-  std::memcpy(buffer_view.buffer<float>(), block.data(),
-              block.size() * sizeof(float));
-  std::vector<Tensor> tensor_vector;
-  tensor_vector.push_back(std::move(tensor));
-  return tensor_vector;
-}
-
-absl::Status AudioToTensorCalculator::OutputTensor(const Matrix& block,
-                                                   Timestamp timestamp,
-                                                   CalculatorContext* cc) {
+absl::Status AudioToTensorCalculator::OutputTensor(
+    absl::Span<const float> frame, Timestamp timestamp,
+    CalculatorContext* cc) {
   std::vector<Tensor> output_tensor;
   if (fft_state_) {
-    Eigen::VectorXf time_series_data =
-        Eigen::VectorXf::Map(block.data(), block.size());
     //  Window on input audio prior to FFT.
-    std::transform(time_series_data.begin(), time_series_data.end(),
-                   fft_window_.begin(), fft_input_buffer_.begin(),
-                   std::multiplies<float>());
+    std::transform(frame.begin(), frame.end(), fft_window_.begin(),
+                   fft_input_buffer_.begin(), std::multiplies<float>());
     pffft_transform_ordered(fft_state_, fft_input_buffer_.data(),
                             fft_output_.data(), fft_workplace_.data(),
                             PFFFT_FORWARD);
@@ -509,71 +540,36 @@ absl::Status AudioToTensorCalculator::OutputTensor(const Matrix& block,
       kDcAndNyquistOut(cc).Send(std::make_pair(fft_output_[0], fft_output_[1]),
                                 timestamp);
     }
-    switch (dft_tensor_format_) {
-      case Options::WITH_NYQUIST: {
-        Matrix fft_output_matrix =
-            Eigen::Map<const Matrix>(fft_output_.data() + 2, 1, fft_size_ - 2);
-        fft_output_matrix.conservativeResize(Eigen::NoChange, fft_size_);
-        // The last two elements are Nyquist component.
-        fft_output_matrix(fft_size_ - 2) = fft_output_[1];  // Nyquist real part
-        fft_output_matrix(fft_size_ - 1) = 0.0f;  // Nyquist imagery part
-        ASSIGN_OR_RETURN(output_tensor, ConvertToTensor(fft_output_matrix,
-                                                        {2, fft_size_ / 2}));
-        break;
-      }
-      case Options::WITH_DC_AND_NYQUIST: {
-        Matrix fft_output_matrix =
-            Eigen::Map<const Matrix>(fft_output_.data(), 1, fft_size_);
-        fft_output_matrix.conservativeResize(Eigen::NoChange, fft_size_ + 2);
-        fft_output_matrix(1) = 0.0f;  // DC imagery part.
-        // The last two elements are  Nyquist component.
-        fft_output_matrix(fft_size_) = fft_output_[1];  // Nyquist real part
-        fft_output_matrix(fft_size_ + 1) = 0.0f;        // Nyquist imagery part
-        ASSIGN_OR_RETURN(
-            output_tensor,
-            ConvertToTensor(fft_output_matrix, {2, (fft_size_ + 2) / 2}));
-        break;
-      }
-      case Options::WITHOUT_DC_AND_NYQUIST: {
-        Matrix fft_output_matrix =
-            Eigen::Map<const Matrix>(fft_output_.data() + 2, 1, fft_size_ - 2);
-        ASSIGN_OR_RETURN(
-            output_tensor,
-            ConvertToTensor(fft_output_matrix, {2, (fft_size_ - 2) / 2}));
-        break;
-      }
-      default:
-        return absl::InvalidArgumentError("Unsupported dft tensor format.");
-    }
-
-  } else {
     ASSIGN_OR_RETURN(output_tensor,
-                     ConvertToTensor(block, {num_channels_, num_samples_}));
+                     ConvertFftOutputToTensor(fft_output_, dft_tensor_format_));
+  } else {
+    output_tensor = ConvertToTensor(frame, {num_channels_, num_samples_});
   }
   kTensorsOut(cc).Send(std::move(output_tensor), timestamp);
   return absl::OkStatus();
 }
 
-absl::Status AudioToTensorCalculator::ProcessBuffer(const Matrix& buffer,
-                                                    bool should_flush,
-                                                    CalculatorContext* cc) {
+absl::Status AudioToTensorCalculator::ProcessBuffer(
+    absl::Span<const float> buffer, bool should_flush, CalculatorContext* cc) {
   const bool should_flush_at_timestamp_max =
       stream_mode_ && should_flush &&
       flush_mode_ == Options::ENTIRE_TAIL_AT_TIMESTAMP_MAX;
+  const int buffer_cols = buffer.size() / num_channels_;
   int next_frame_first_col = 0;
   std::vector<Timestamp> timestamps;
   if (!should_flush_at_timestamp_max) {
-    while (next_frame_first_col + num_samples_ <= buffer.cols()) {
-      MP_RETURN_IF_ERROR(OutputTensor(
-          buffer.block(0, next_frame_first_col, num_channels_, num_samples_),
-          next_output_timestamp_, cc));
+    while (next_frame_first_col + num_samples_ <= buffer_cols) {
+      MP_RETURN_IF_ERROR(
+          OutputTensor(buffer.subspan(next_frame_first_col * num_channels_,
+                                      num_samples_ * num_channels_),
+                       next_output_timestamp_, cc));
       timestamps.push_back(next_output_timestamp_);
       next_output_timestamp_ += round(frame_step_ / target_sample_rate_ *
                                       Timestamp::kTimestampUnitsPerSecond);
       next_frame_first_col += frame_step_;
     }
   }
-  if (should_flush && next_frame_first_col < buffer.cols()) {
+  if (should_flush && next_frame_first_col < buffer_cols) {
     // In the streaming mode, the flush happens in Close() and a packet at
     // Timestamp::Max() will be emitted. In the non-streaming mode, each
     // Process() invocation will process the entire buffer completely.
@@ -581,9 +577,10 @@ absl::Status AudioToTensorCalculator::ProcessBuffer(const Matrix& buffer,
                               ? Timestamp::Max()
                               : next_output_timestamp_;
     MP_RETURN_IF_ERROR(OutputTensor(
-        buffer.block(
-            0, next_frame_first_col, num_channels_,
-            std::min(num_samples_, (int)buffer.cols() - next_frame_first_col)),
+        buffer.subspan(
+            next_frame_first_col * num_channels_,
+            std::min(num_samples_, buffer_cols - next_frame_first_col) *
+                num_channels_),
         timestamp, cc));
     timestamps.push_back(timestamp);
   }
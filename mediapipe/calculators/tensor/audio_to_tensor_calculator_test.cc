@@ -465,6 +465,20 @@ TEST_F(AudioToTensorCalculatorStreamingModeTest, OutputOverlappingFp32Tensors) {
   CloseGraph();
 }
 
+TEST_F(AudioToTensorCalculatorStreamingModeTest,
+       OutputMostlyOverlappingTensorsFromSmallInputs) {
+  SetInputBufferNumSamplesPerChannel(3);
+  Run(/*num_samples=*/10, /*num_overlapping_samples=*/9,
+      /*resampling_factor=*/1.0f);
+  // 21 full frames advancing by one sample, plus the tail flushed in Close().
+  CheckTensorsOutputPackets(
+      /*sample_offset=*/2,
+      /*num_packets=*/GetExpectedNumOfSamples() - 10 + 2,
+      /*timestamp_interval=*/100,
+      /*output_last_at_close=*/true);
+  CloseGraph();
+}
+
 TEST_F(AudioToTensorCalculatorStreamingModeTest, Downsampling) {
   SetInputBufferNumSamplesPerChannel(1000);
   Run(/*num_samples=*/256, /*num_overlapping_samples=*/0,
@@ -14,7 +14,6 @@
 
 #include <algorithm>
 #include <cstdint>
-#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
@@ -25,6 +24,7 @@
 #include "absl/strings/ascii.h"
 #include "absl/strings/string_view.h"
 #include "absl/strings/substitute.h"
+#include "absl/types/span.h"
 #include "mediapipe/calculators/tensor/bert_preprocessor_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/api2/port.h"
@@ -51,6 +51,20 @@ constexpr absl::string_view kSegmentIdsTensorName = "segment_ids";
 constexpr absl::string_view kClassifierToken = "[CLS]";
 constexpr absl::string_view kSeparatorToken = "[SEP]";
 
+namespace {
+
+// Returns the smallest power of two that is greater than or equal to
+// `seq_len`.
+int BucketSeqLen(int seq_len) {
+  int bucket = 1;
+  while (bucket < seq_len) {
+    bucket <<= 1;
+  }
+  return bucket;
+}
+
+}  // namespace
+
 // Preprocesses input text into three int32 input tensors for a BERT model using
 // a tokenizer.
 // The associated BERT model is expected to contain input tensors with names:
@@ -91,7 +105,9 @@ constexpr absl::string_view kSeparatorToken = "[SEP]";
 //       (3): the input mask ids, which are 1 at each of the input token indices
 //            and 0 elsewhere.
 //     The Tensors will have size equal to the max sequence length for the BERT
-//     model.
+//     model if its input tensors have static shape. Otherwise, they have the
+//     size of the input tokens, rounded up to the next power of two if
+//     `bucket_dynamic_seq_len` is set.
 //
 // Example:
 // node {
@@ -130,16 +146,29 @@ class BertPreprocessorCalculator : public Node {
   int input_masks_tensor_index_ = 2;
   // Whether the model's input tensor shapes are dynamic.
   bool has_dynamic_input_tensors_ = false;
+  // Whether to round the size of dynamic input tensors up to a power of two.
+  bool bucket_dynamic_seq_len_ = false;
+
+  // The ids of the classifier and separator tokens.
+  int32_t classifier_token_id_ = 0;
+  int32_t separator_token_id_ = 0;
+  // Buffer holding the token ids if the input tensors are dynamic, as their
+  // size is then only known after tokenization. Reused across calls.
+  std::vector<int32_t> token_ids_;
 
-  // Applies `tokenizer_` to the `input_text` to generate a vector of tokens.
-  // This util prepends "[CLS]" and appends "[SEP]" to the input tokens and
-  // clips the vector of tokens to have length at most `bert_max_seq_len_` if
-  // the input tensors are static.
-  std::vector<std::string> TokenizeInputText(absl::string_view input_text);
-  // Processes the `input_tokens` to generate the three input tensors of size
-  // `tensor_size` for the BERT model.
-  std::vector<Tensor> GenerateInputTensors(
-      const std::vector<std::string>& input_tokens, int tensor_size);
+  // Applies `tokenizer_` to the `input_text` and writes the token ids to the
+  // input ids tensor of the returned input tensors, which are otherwise
+  // uninitialized. Sets `num_tokens` to the number of written tokens, which is
+  // at most `bert_max_seq_len_ - 2` if the input tensors are static.
+  std::vector<Tensor> TokenizeInputText(absl::string_view input_text,
+                                        int* num_tokens);
+  // Allocates the three input tensors of size `tensor_size` for the BERT
+  // model.
+  std::vector<Tensor> CreateInputTensors(int tensor_size) const;
+  // Fills the `input_tensors` around the `num_tokens` token ids already
+  // written to the input ids tensor, starting at index 1.
+  void FillInputTensors(int num_tokens,
+                        std::vector<Tensor>& input_tensors) const;
 };
 
 absl::Status BertPreprocessorCalculator::UpdateContract(
@@ -186,59 +215,73 @@ absl::Status BertPreprocessorCalculator::Open(CalculatorContext* cc) {
       cc->Options<mediapipe::BertPreprocessorCalculatorOptions>();
   bert_max_seq_len_ = options.bert_max_seq_len();
   has_dynamic_input_tensors_ = options.has_dynamic_input_tensors();
+  bucket_dynamic_seq_len_ = options.bucket_dynamic_seq_len();
+
+  int token_id = 0;
+  if (tokenizer_->LookupId(kClassifierToken, &token_id)) {
+    classifier_token_id_ = token_id;
+  }
+  if (tokenizer_->LookupId(kSeparatorToken, &token_id)) {
+    separator_token_id_ = token_id;
+  }
   return absl::OkStatus();
 }
 
 absl::Status BertPreprocessorCalculator::Process(CalculatorContext* cc) {
-  int tensor_size = bert_max_seq_len_;
-  std::vector<std::string> input_tokens = TokenizeInputText(kTextIn(cc).Get());
-  if (has_dynamic_input_tensors_) {
-    tensor_size = input_tokens.size();
-  }
-  kTensorsOut(cc).Send(GenerateInputTensors(input_tokens, tensor_size));
+  int num_tokens = 0;
+  std::vector<Tensor> input_tensors =
+      TokenizeInputText(kTextIn(cc).Get(), &num_tokens);
+  FillInputTensors(num_tokens, input_tensors);
+  kTensorsOut(cc).Send(std::move(input_tensors));
   return absl::OkStatus();
 }
 
-std::vector<std::string> BertPreprocessorCalculator::TokenizeInputText(
-    absl::string_view input_text) {
+std::vector<Tensor> BertPreprocessorCalculator::TokenizeInputText(
+    absl::string_view input_text, int* num_tokens) {
   std::string processed_input = std::string(input_text);
   absl::AsciiStrToLower(&processed_input);
 
-  tasks::text::tokenizers::TokenizerResult tokenizer_result =
-      tokenizer_->Tokenize(processed_input);
-
-  // Offset by 2 to account for [CLS] and [SEP]
-  int input_tokens_size =
-      static_cast<int>(tokenizer_result.subwords.size()) + 2;
-  // For static shapes, truncate the input tokens to `bert_max_seq_len_`.
-  if (!has_dynamic_input_tensors_) {
-    input_tokens_size = std::min(bert_max_seq_len_, input_tokens_size);
-  }
-  std::vector<std::string> input_tokens;
-  input_tokens.reserve(input_tokens_size);
-  input_tokens.push_back(std::string(kClassifierToken));
-  for (int i = 0; i < input_tokens_size - 2; ++i) {
-    input_tokens.push_back(std::move(tokenizer_result.subwords[i]));
+  if (has_dynamic_input_tensors_) {
+    *num_tokens =
+        tokenizer_->TokenizeIds(processed_input, absl::MakeSpan(token_ids_));
+    if (*num_tokens > token_ids_.size()) {
+      token_ids_.resize(*num_tokens);
+      tokenizer_->TokenizeIds(processed_input, absl::MakeSpan(token_ids_));
+    }
+    // Offset by 2 to account for [CLS] and [SEP]
+    int tensor_size = *num_tokens + 2;
+    if (bucket_dynamic_seq_len_) {
+      // The padding stops at the model's maximum sequence length, which
+      // longer inputs still exceed as dynamic inputs aren't truncated.
+      tensor_size = std::max(
+          tensor_size, std::min(BucketSeqLen(tensor_size), bert_max_seq_len_));
+    }
+    std::vector<Tensor> input_tensors = CreateInputTensors(tensor_size);
+    {
+      auto view = input_tensors[input_ids_tensor_index_].GetCpuWriteView();
+      std::copy(token_ids_.begin(), token_ids_.begin() + *num_tokens,
+                view.buffer<int32_t>() + 1);
+    }
+    return input_tensors;
   }
-  input_tokens.push_back(std::string(kSeparatorToken));
-  return input_tokens;
-}
 
-std::vector<Tensor> BertPreprocessorCalculator::GenerateInputTensors(
-    const std::vector<std::string>& input_tokens, int tensor_size) {
-  std::vector<int32_t> input_ids(tensor_size, 0);
-  std::vector<int32_t> segment_ids(tensor_size, 0);
-  std::vector<int32_t> input_masks(tensor_size, 0);
-  // Convert tokens back into ids and set mask
-  for (int i = 0; i < input_tokens.size(); ++i) {
-    tokenizer_->LookupId(input_tokens[i], &input_ids[i]);
-    input_masks[i] = 1;
+  // For static shapes, truncate the input tokens to `bert_max_seq_len_`, by
+  // tokenizing straight into the input ids tensor.
+  std::vector<Tensor> input_tensors = CreateInputTensors(bert_max_seq_len_);
+  {
+    auto view = input_tensors[input_ids_tensor_index_].GetCpuWriteView();
+    const int max_num_tokens = bert_max_seq_len_ - 2;
+    *num_tokens = std::min(
+        tokenizer_->TokenizeIds(
+            processed_input,
+            absl::MakeSpan(view.buffer<int32_t>() + 1, max_num_tokens)),
+        max_num_tokens);
   }
-  //                           |<-----------tensor_size------------>|
-  // input_ids                 [CLS] s1  s2...  sn [SEP]  0  0...  0
-  // segment_ids                 0    0   0...  0    0    0  0...  0
-  // input_masks                 1    1   1...  1    1    0  0...  0
+  return input_tensors;
+}
 
+std::vector<Tensor> BertPreprocessorCalculator::CreateInputTensors(
+    int tensor_size) const {
   std::vector<Tensor> input_tensors;
   input_tensors.reserve(kNumInputTensorsForBert);
   for (int i = 0; i < kNumInputTensorsForBert; ++i) {
@@ -246,21 +289,38 @@ std::vector<Tensor> BertPreprocessorCalculator::GenerateInputTensors(
         {Tensor::ElementType::kInt32,
          Tensor::Shape({1, tensor_size}, has_dynamic_input_tensors_)});
   }
-  std::memcpy(input_tensors[input_ids_tensor_index_]
-                  .GetCpuWriteView()
-                  .buffer<int32_t>(),
-              input_ids.data(), input_ids.size() * sizeof(int32_t));
-  std::memcpy(input_tensors[segment_ids_tensor_index_]
-                  .GetCpuWriteView()
-                  .buffer<int32_t>(),
-              segment_ids.data(), segment_ids.size() * sizeof(int32_t));
-  std::memcpy(input_tensors[input_masks_tensor_index_]
-                  .GetCpuWriteView()
-                  .buffer<int32_t>(),
-              input_masks.data(), input_masks.size() * sizeof(int32_t));
   return input_tensors;
 }
 
+void BertPreprocessorCalculator::FillInputTensors(
+    int num_tokens, std::vector<Tensor>& input_tensors) const {
+  //                           |<-----------tensor_size------------>|
+  // input_ids                 [CLS] s1  s2...  sn [SEP]  0  0...  0
+  // segment_ids                 0    0   0...  0    0    0  0...  0
+  // input_masks                 1    1   1...  1    1    0  0...  0
+  const int tensor_size = input_tensors[input_ids_tensor_index_]
+                              .shape()
+                              .num_elements();
+  const int input_tokens_size = num_tokens + 2;
+  {
+    auto view = input_tensors[input_ids_tensor_index_].GetCpuWriteView();
+    int32_t* input_ids = view.buffer<int32_t>();
+    input_ids[0] = classifier_token_id_;
+    input_ids[input_tokens_size - 1] = separator_token_id_;
+    std::fill(input_ids + input_tokens_size, input_ids + tensor_size, 0);
+  }
+  {
+    auto view = input_tensors[segment_ids_tensor_index_].GetCpuWriteView();
+    std::fill_n(view.buffer<int32_t>(), tensor_size, 0);
+  }
+  {
+    auto view = input_tensors[input_masks_tensor_index_].GetCpuWriteView();
+    int32_t* input_masks = view.buffer<int32_t>();
+    std::fill(input_masks, input_masks + input_tokens_size, 1);
+    std::fill(input_masks + input_tokens_size, input_masks + tensor_size, 0);
+  }
+}
+
 MEDIAPIPE_REGISTER_NODE(BertPreprocessorCalculator);
 
 }  // namespace api2
@@ -44,7 +44,8 @@ constexpr absl::string_view kTestModelPath =
 
 absl::StatusOr<std::vector<std::vector<int>>> RunBertPreprocessorCalculator(
     absl::string_view text, absl::string_view model_path,
-    bool has_dynamic_input_tensors = false, int tensor_size = kBertMaxSeqLen) {
+    bool has_dynamic_input_tensors = false, int tensor_size = kBertMaxSeqLen,
+    bool bucket_dynamic_seq_len = false) {
   auto graph_config = ParseTextProtoOrDie<CalculatorGraphConfig>(
       absl::Substitute(R"(
         input_stream: "text"
@@ -58,11 +59,13 @@ absl::StatusOr<std::vector<std::vector<int>>> RunBertPreprocessorCalculator(
             [mediapipe.BertPreprocessorCalculatorOptions.ext] {
               bert_max_seq_len: $0
               has_dynamic_input_tensors: $1
+              bucket_dynamic_seq_len: $2
             }
           }
         }
       )",
-                       tensor_size, has_dynamic_input_tensors));
+                       tensor_size, has_dynamic_input_tensors,
+                       bucket_dynamic_seq_len));
   std::vector<Packet> output_packets;
   tool::AddVectorSink("tensors", &graph_config, &output_packets);
 
@@ -99,6 +102,11 @@ absl::StatusOr<std::vector<std::vector<int>>> RunBertPreprocessorCalculator(
     if (tensor.element_type() != Tensor::ElementType::kInt32) {
       return absl::InvalidArgumentError("Expected tensor element type kInt32");
     }
+    if (tensor.shape().num_elements() != tensor_size) {
+      return absl::InvalidArgumentError(
+          absl::Substitute("Tensor has size $0, expected $1",
+                           tensor.shape().num_elements(), tensor_size));
+    }
     auto* buffer = tensor.GetCpuReadView().buffer<int>();
     std::vector<int> buffer_view(buffer, buffer + tensor_size);
     results.push_back(buffer_view);
@@ -152,5 +160,66 @@ TEST(BertPreprocessorCalculatorTest, LongInput) {
   EXPECT_THAT(processed_tensor_values, ElementsAreArray(expected_result));
 }
 
+TEST(BertPreprocessorCalculatorTest, DynamicInput) {
+  std::vector<std::vector<int>> expected_result = {
+      {101, 2009, 1005, 1055, 1037, 11951, 1998, 2411, 12473, 4990, 102}};
+  const int tensor_size = expected_result[0].size();
+  // segment_ids
+  expected_result.push_back(std::vector(tensor_size, 0));
+  // input_masks
+  expected_result.push_back(std::vector(tensor_size, 1));
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<int>> processed_tensor_values,
+      RunBertPreprocessorCalculator(
+          "it's a charming and often affecting journey", kTestModelPath,
+          /*has_dynamic_input_tensors=*/true, tensor_size));
+  EXPECT_THAT(processed_tensor_values, ElementsAreArray(expected_result));
+}
+
+TEST(BertPreprocessorCalculatorTest, DynamicInputWithBucketedSeqLen) {
+  // The 11 tokens are padded to the next power of two.
+  constexpr int kBucketedSeqLen = 16;
+  std::vector<std::vector<int>> expected_result = {
+      {101, 2009, 1005, 1055, 1037, 11951, 1998, 2411, 12473, 4990, 102}};
+  // segment_ids
+  expected_result.push_back(std::vector(kBucketedSeqLen, 0));
+  // input_masks
+  expected_result.push_back(std::vector(expected_result[0].size(), 1));
+  expected_result[2].resize(kBucketedSeqLen);
+  // padding input_ids
+  expected_result[0].resize(kBucketedSeqLen);
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<int>> processed_tensor_values,
+      RunBertPreprocessorCalculator(
+          "it's a charming and often affecting journey", kTestModelPath,
+          /*has_dynamic_input_tensors=*/true, kBucketedSeqLen,
+          /*bucket_dynamic_seq_len=*/true));
+  EXPECT_THAT(processed_tensor_values, ElementsAreArray(expected_result));
+}
+
+TEST(BertPreprocessorCalculatorTest, DynamicInputWithBucketCappedAtMaxSeqLen) {
+  // The 11 tokens would be padded to 16, but the model takes at most 12.
+  constexpr int kBertMaxSeqLen = 12;
+  std::vector<std::vector<int>> expected_result = {
+      {101, 2009, 1005, 1055, 1037, 11951, 1998, 2411, 12473, 4990, 102}};
+  // segment_ids
+  expected_result.push_back(std::vector(kBertMaxSeqLen, 0));
+  // input_masks
+  expected_result.push_back(std::vector(expected_result[0].size(), 1));
+  expected_result[2].resize(kBertMaxSeqLen);
+  // padding input_ids
+  expected_result[0].resize(kBertMaxSeqLen);
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      std::vector<std::vector<int>> processed_tensor_values,
+      RunBertPreprocessorCalculator(
+          "it's a charming and often affecting journey", kTestModelPath,
+          /*has_dynamic_input_tensors=*/true, kBertMaxSeqLen,
+          /*bucket_dynamic_seq_len=*/true));
+  EXPECT_THAT(processed_tensor_values, ElementsAreArray(expected_result));
+}
+
 }  // namespace
 }  // namespace mediapipe
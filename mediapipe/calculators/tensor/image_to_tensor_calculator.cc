@@ -26,6 +26,8 @@
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/formats/tensor_pool.h"
+#include "mediapipe/framework/formats/tensor_pool_service.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/canonical_errors.h"
 #include "mediapipe/framework/port/ret_check.h"
@@ -155,6 +157,7 @@ class ImageToTensorCalculator : public Node {
     cc->UseService(kGpuService).Optional();
 #endif  // MEDIAPIPE_METAL_ENABLED
 #endif  // MEDIAPIPE_DISABLE_GPU
+    cc->UseService(kTensorPoolService).Optional();
 
     return absl::OkStatus();
   }
@@ -162,6 +165,10 @@ class ImageToTensorCalculator : public Node {
   absl::Status Open(CalculatorContext* cc) {
     options_ = cc->Options<mediapipe::ImageToTensorCalculatorOptions>();
     params_ = GetOutputTensorParams(options_);
+    auto tensor_pool_service = cc->Service(kTensorPoolService);
+    if (tensor_pool_service.IsAvailable()) {
+      tensor_pool_ = tensor_pool_service.GetObject().shared_from_this();
+    }
     return absl::OkStatus();
   }
 
@@ -220,8 +227,14 @@ class ImageToTensorCalculator : public Node {
 
     Tensor::ElementType output_tensor_type =
         GetOutputTensorType(image->UsesGpu(), params_);
-    Tensor tensor(output_tensor_type, {1, tensor_height, tensor_width,
-                                       GetNumOutputChannels(*image)});
+    const Tensor::Shape tensor_shape{1, tensor_height, tensor_width,
+                                     GetNumOutputChannels(*image)};
+    // CPU tensors have the same shape on every frame, so their buffers are
+    // recycled through the graph's tensor pool when it is available.
+    Tensor tensor = tensor_pool_ && !image->UsesGpu()
+                        ? tensor_pool_->GetTensor(output_tensor_type,
+                                                  tensor_shape)
+                        : Tensor(output_tensor_type, tensor_shape);
     MP_RETURN_IF_ERROR((image->UsesGpu() ? gpu_converter_ : cpu_converter_)
                            ->Convert(*image, roi, params_.range_min,
                                      params_.range_max,
@@ -296,6 +309,7 @@ class ImageToTensorCalculator : public Node {
 
   std::unique_ptr<ImageToTensorConverter> gpu_converter_;
   std::unique_ptr<ImageToTensorConverter> cpu_converter_;
+  std::shared_ptr<TensorPool> tensor_pool_;
   mediapipe::ImageToTensorCalculatorOptions options_;
   OutputTensorParams params_;
 };
@@ -24,6 +24,8 @@
 #include "mediapipe/calculators/tensor/inference_calculator_utils.h"
 #include "mediapipe/calculators/tensor/inference_interpreter_delegate_runner.h"
 #include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/calculators/tensor/xnnpack_weights_cache.h"
+#include "mediapipe/framework/formats/tensor_pool_service.h"
 #include "tensorflow/lite/interpreter.h"
 #if defined(MEDIAPIPE_ANDROID)
 #include "tensorflow/lite/delegates/nnapi/nnapi_delegate.h"
@@ -45,7 +47,9 @@ class InferenceCalculatorCpuImpl
  private:
   absl::StatusOr<std::unique_ptr<InferenceRunner>> CreateInferenceRunner(
       CalculatorContext* cc);
-  absl::StatusOr<TfLiteDelegatePtr> MaybeCreateDelegate(CalculatorContext* cc);
+  absl::StatusOr<TfLiteDelegatePtr> MaybeCreateDelegate(
+      CalculatorContext* cc, const TfLiteModelPtr& model,
+      std::shared_ptr<XnnpackWeightsCache>* weights_cache);
 
   std::unique_ptr<InferenceRunner> inference_runner_;
 };
@@ -55,6 +59,7 @@ absl::Status InferenceCalculatorCpuImpl::UpdateContract(
   const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
   RET_CHECK(!options.model_path().empty() ^ kSideInModel(cc).IsConnected())
       << "Either model as side packet or model path in options is required.";
+  cc->UseService(kTensorPoolService).Optional();
 
   return absl::OkStatus();
 }
@@ -86,16 +91,33 @@ absl::StatusOr<std::unique_ptr<InferenceRunner>>
 InferenceCalculatorCpuImpl::CreateInferenceRunner(CalculatorContext* cc) {
   ASSIGN_OR_RETURN(auto model_packet, GetModelAsPacket(cc));
   ASSIGN_OR_RETURN(auto op_resolver_packet, GetOpResolverAsPacket(cc));
-  const int interpreter_num_threads =
-      cc->Options<mediapipe::InferenceCalculatorOptions>().cpu_num_thread();
-  ASSIGN_OR_RETURN(TfLiteDelegatePtr delegate, MaybeCreateDelegate(cc));
+  const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
+  const int interpreter_num_threads = options.cpu_num_thread();
+  std::shared_ptr<XnnpackWeightsCache> weights_cache;
+  ASSIGN_OR_RETURN(
+      TfLiteDelegatePtr delegate,
+      MaybeCreateDelegate(cc, *model_packet.Get(), &weights_cache));
+  std::shared_ptr<TensorPool> tensor_pool;
+  auto tensor_pool_service = cc->Service(kTensorPoolService);
+  if (tensor_pool_service.IsAvailable()) {
+    tensor_pool = tensor_pool_service.GetObject().shared_from_this();
+  }
+  if (weights_cache != nullptr) {
+    return weights_cache->CreateRunner(
+        std::move(model_packet), std::move(op_resolver_packet),
+        std::move(delegate), interpreter_num_threads, std::move(tensor_pool),
+        options.enable_zero_copy_tensor_io());
+  }
   return CreateInferenceInterpreterDelegateRunner(
       std::move(model_packet), std::move(op_resolver_packet),
-      std::move(delegate), interpreter_num_threads);
+      std::move(delegate), interpreter_num_threads, std::move(tensor_pool),
+      options.enable_zero_copy_tensor_io());
 }
 
 absl::StatusOr<TfLiteDelegatePtr>
-InferenceCalculatorCpuImpl::MaybeCreateDelegate(CalculatorContext* cc) {
+InferenceCalculatorCpuImpl::MaybeCreateDelegate(
+    CalculatorContext* cc, const TfLiteModelPtr& model,
+    std::shared_ptr<XnnpackWeightsCache>* weights_cache) {
   const auto& calculator_opts =
       cc->Options<mediapipe::InferenceCalculatorOptions>();
   auto opts_delegate = calculator_opts.delegate();
@@ -151,6 +173,11 @@ InferenceCalculatorCpuImpl::MaybeCreateDelegate(CalculatorContext* cc) {
     auto xnnpack_opts = TfLiteXNNPackDelegateOptionsDefault();
     xnnpack_opts.num_threads =
         GetXnnpackNumThreads(opts_has_delegate, opts_delegate);
+    if (opts_has_delegate && opts_delegate.xnnpack().enable_weights_cache()) {
+      *weights_cache =
+          XnnpackWeightsCache::GetOrCreate(model, xnnpack_opts.flags);
+      return (*weights_cache)->CreateDelegate(xnnpack_opts);
+    }
     return TfLiteDelegatePtr(TfLiteXNNPackDelegateCreate(&xnnpack_opts),
                              &TfLiteXNNPackDelegateDelete);
   }
@@ -12,14 +12,19 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
+#include <cstdint>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_set.h"
 #include "absl/log/absl_check.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_replace.h"
 #include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
 #include "mediapipe/calculators/tensor/inference_calculator.pb.h"
 #include "mediapipe/calculators/tensor/inference_calculator_test_base.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -100,7 +105,7 @@ constexpr char kGraphWithModelAsInputSidePacket[] = R"(
     }
   )";
 
-std::vector<Tensor> CreateInputs() {
+std::vector<Tensor> CreateInputs(float value = 1.0f) {
   std::vector<Tensor> input_vec;
   // Prepare input tensor.
   input_vec.emplace_back(
@@ -111,7 +116,7 @@ std::vector<Tensor> CreateInputs() {
     auto num_elements = input_vec.back().shape().num_elements();
     auto tensor_buffer = view.buffer<float>();
     for (int i = 0; i < num_elements; i++) {
-      tensor_buffer[i] = 1;
+      tensor_buffer[i] = value;
     }
   }
 
@@ -176,10 +181,164 @@ TEST(InferenceCalculatorTest, SmokeTest) {
       {{"$delegate", "delegate { xnnpack { num_threads: 10 } }"}}));
 }
 
+TEST(InferenceCalculatorTest, ZeroCopyTensorIoSmokeTest) {
+  DoSmokeTest(absl::StrReplaceAll(
+      kGraphWithModelPathInOption,
+      {{"$delegate",
+        "delegate { tflite {} } enable_zero_copy_tensor_io: true"}}));
+  DoSmokeTest(absl::StrReplaceAll(
+      kGraphWithModelPathInOption,
+      {{"$delegate",
+        "delegate { xnnpack {} } enable_zero_copy_tensor_io: true"}}));
+}
+
+// Runs `num_runs` inferences of the add model and returns the buffers of the
+// output tensors, which are released before the next inference.
+absl::flat_hash_set<const void*> RunAndGetOutputBuffers(
+    const std::string& graph_proto, int num_runs) {
+  CalculatorGraph graph(
+      ParseTextProtoOrDie<CalculatorGraphConfig>(graph_proto));
+  absl::flat_hash_set<const void*> output_buffers;
+  int num_outputs = 0;
+  MP_EXPECT_OK(graph.ObserveOutputStream(
+      "tensor_out", [&](const Packet& packet) {
+        const std::vector<Tensor>& result_vec =
+            packet.Get<std::vector<Tensor>>();
+        EXPECT_EQ(result_vec.size(), 1);
+        const Tensor& result = result_vec[0];
+        auto view = result.GetCpuReadView();
+        auto result_buffer = view.buffer<float>();
+        // The input of the i-th inference is filled with i + 1.
+        const float expected_value = 2.0f * (packet.Timestamp().Value() + 1);
+        for (int i = 0; i < result.shape().num_elements(); i++) {
+          EXPECT_EQ(result_buffer[i], expected_value);
+        }
+        output_buffers.insert(result_buffer);
+        ++num_outputs;
+        return absl::OkStatus();
+      }));
+  MP_EXPECT_OK(graph.StartRun({}));
+  for (int i = 0; i < num_runs; ++i) {
+    MP_EXPECT_OK(graph.AddPacketToInputStream(
+        "tensor_in", MakePacket<std::vector<Tensor>>(CreateInputs(i + 1))
+                         .At(Timestamp(i))));
+    MP_EXPECT_OK(graph.WaitUntilIdle());
+  }
+  MP_EXPECT_OK(graph.CloseInputStream("tensor_in"));
+  MP_EXPECT_OK(graph.WaitUntilDone());
+  EXPECT_EQ(num_outputs, num_runs);
+  return output_buffers;
+}
+
+TEST(InferenceCalculatorTest, ZeroCopyTensorIoReusesOutputBuffers) {
+  for (absl::string_view delegate :
+       {"delegate { tflite {} }", "delegate { xnnpack {} }"}) {
+    const std::string graph_proto = absl::StrReplaceAll(
+        kGraphWithModelPathInOption,
+        {{"$delegate",
+          absl::StrCat(delegate, " enable_zero_copy_tensor_io: true")}});
+    // The interpreter writes into one buffer while the other is sent
+    // downstream, and released buffers are bound again.
+    EXPECT_LE(RunAndGetOutputBuffers(graph_proto, /*num_runs=*/5).size(), 2)
+        << delegate;
+  }
+}
+
+// Returns the outputs of the BERT classifier, whose inputs have dynamic
+// sequence length, for inputs of each of `sequence_lengths`.
+std::vector<std::vector<float>> RunBertClassifier(
+    bool enable_zero_copy_tensor_io, const std::vector<int>& sequence_lengths) {
+  CalculatorGraphConfig graph_config =
+      ParseTextProtoOrDie<CalculatorGraphConfig>(absl::Substitute(
+          R"(
+            input_stream: "tensor_in"
+            node {
+              calculator: "InferenceCalculator"
+              input_stream: "TENSORS:tensor_in"
+              output_stream: "TENSORS:tensor_out"
+              options {
+                [mediapipe.InferenceCalculatorOptions.ext] {
+                  model_path: "mediapipe/tasks/testdata/text/bert_text_classifier.tflite"
+                  delegate { tflite {} }
+                  enable_zero_copy_tensor_io: $0
+                }
+              }
+            }
+          )",
+          enable_zero_copy_tensor_io ? "true" : "false"));
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("tensor_out", &graph_config, &output_packets);
+  CalculatorGraph graph(graph_config);
+  MP_EXPECT_OK(graph.StartRun({}));
+  for (int i = 0; i < sequence_lengths.size(); ++i) {
+    std::vector<Tensor> input_vec;
+    // Token ids, segment ids and input mask of ones are all valid.
+    for (int j = 0; j < 3; ++j) {
+      input_vec.emplace_back(
+          Tensor::ElementType::kInt32,
+          Tensor::Shape({1, sequence_lengths[i]}, /*is_dynamic=*/true));
+      auto view = input_vec.back().GetCpuWriteView();
+      std::fill_n(view.buffer<int32_t>(), sequence_lengths[i], 1);
+    }
+    MP_EXPECT_OK(graph.AddPacketToInputStream(
+        "tensor_in", MakePacket<std::vector<Tensor>>(std::move(input_vec))
+                         .At(Timestamp(i))));
+    MP_EXPECT_OK(graph.WaitUntilIdle());
+  }
+  MP_EXPECT_OK(graph.CloseInputStream("tensor_in"));
+  MP_EXPECT_OK(graph.WaitUntilDone());
+
+  std::vector<std::vector<float>> outputs;
+  for (const Packet& packet : output_packets) {
+    const Tensor& result = packet.Get<std::vector<Tensor>>()[0];
+    auto view = result.GetCpuReadView();
+    outputs.emplace_back(view.buffer<float>(),
+                         view.buffer<float>() + result.shape().num_elements());
+  }
+  return outputs;
+}
+
+TEST(InferenceCalculatorTest, ZeroCopyTensorIoSupportsInputResizing) {
+  const std::vector<int> sequence_lengths = {16, 32, 16, 8};
+  const std::vector<std::vector<float>> outputs =
+      RunBertClassifier(/*enable_zero_copy_tensor_io=*/true, sequence_lengths);
+  const std::vector<std::vector<float>> expected_outputs =
+      RunBertClassifier(/*enable_zero_copy_tensor_io=*/false, sequence_lengths);
+  ASSERT_EQ(outputs.size(), sequence_lengths.size());
+  EXPECT_EQ(outputs, expected_outputs);
+}
+
 TEST(InferenceCalculatorTest, ModelAsInputSidePacketSmokeTest) {
   DoSmokeTest(kGraphWithModelAsInputSidePacket);
 }
 
+TEST(InferenceCalculatorTest, XnnpackWeightsCacheSmokeTest) {
+  const std::string graph_proto = absl::StrReplaceAll(
+      kGraphWithModelPathInOption,
+      {{"$delegate", "delegate { xnnpack { enable_weights_cache: true } }"}});
+  DoSmokeTest(graph_proto);
+
+  // Two calculators running the same model instance share the cache.
+  DoSmokeTest(absl::StrCat(
+      absl::StrReplaceAll(
+          kGraphWithModelAsInputSidePacket,
+          {{"delegate { tflite {} }",
+            "delegate { xnnpack { enable_weights_cache: true } }"}}),
+      R"(
+        node {
+          calculator: "InferenceCalculator"
+          input_stream: "TENSORS:tensor_in"
+          output_stream: "TENSORS:other_tensor_out"
+          input_side_packet: "MODEL:model"
+          options {
+            [mediapipe.InferenceCalculatorOptions.ext] {
+              delegate { xnnpack { enable_weights_cache: true } }
+            }
+          }
+        }
+      )"));
+}
+
 void BM_InitializeCalculator(benchmark::State& state) {
   mediapipe::InferenceCalculatorOptions::Delegate delegate;
   delegate.mutable_tflite();
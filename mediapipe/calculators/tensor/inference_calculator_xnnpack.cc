@@ -24,6 +24,8 @@
 #include "mediapipe/calculators/tensor/inference_calculator_utils.h"
 #include "mediapipe/calculators/tensor/inference_interpreter_delegate_runner.h"
 #include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/calculators/tensor/xnnpack_weights_cache.h"
+#include "mediapipe/framework/formats/tensor_pool_service.h"
 #include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
 #include "tensorflow/lite/interpreter.h"
 
@@ -43,7 +45,9 @@ class InferenceCalculatorXnnpackImpl
  private:
   absl::StatusOr<std::unique_ptr<InferenceRunner>> CreateInferenceRunner(
       CalculatorContext* cc);
-  absl::StatusOr<TfLiteDelegatePtr> CreateDelegate(CalculatorContext* cc);
+  absl::StatusOr<TfLiteDelegatePtr> CreateDelegate(
+      CalculatorContext* cc, const TfLiteModelPtr& model,
+      std::shared_ptr<XnnpackWeightsCache>* weights_cache);
 
   std::unique_ptr<InferenceRunner> inference_runner_;
 };
@@ -53,6 +57,7 @@ absl::Status InferenceCalculatorXnnpackImpl::UpdateContract(
   const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
   RET_CHECK(!options.model_path().empty() ^ kSideInModel(cc).IsConnected())
       << "Either model as side packet or model path in options is required.";
+  cc->UseService(kTensorPoolService).Optional();
 
   return absl::OkStatus();
 }
@@ -84,16 +89,32 @@ absl::StatusOr<std::unique_ptr<InferenceRunner>>
 InferenceCalculatorXnnpackImpl::CreateInferenceRunner(CalculatorContext* cc) {
   ASSIGN_OR_RETURN(auto model_packet, GetModelAsPacket(cc));
   ASSIGN_OR_RETURN(auto op_resolver_packet, GetOpResolverAsPacket(cc));
-  const int interpreter_num_threads =
-      cc->Options<mediapipe::InferenceCalculatorOptions>().cpu_num_thread();
-  ASSIGN_OR_RETURN(TfLiteDelegatePtr delegate, CreateDelegate(cc));
+  const auto& options = cc->Options<mediapipe::InferenceCalculatorOptions>();
+  const int interpreter_num_threads = options.cpu_num_thread();
+  std::shared_ptr<XnnpackWeightsCache> weights_cache;
+  ASSIGN_OR_RETURN(TfLiteDelegatePtr delegate,
+                   CreateDelegate(cc, *model_packet.Get(), &weights_cache));
+  std::shared_ptr<TensorPool> tensor_pool;
+  auto tensor_pool_service = cc->Service(kTensorPoolService);
+  if (tensor_pool_service.IsAvailable()) {
+    tensor_pool = tensor_pool_service.GetObject().shared_from_this();
+  }
+  if (weights_cache != nullptr) {
+    return weights_cache->CreateRunner(
+        std::move(model_packet), std::move(op_resolver_packet),
+        std::move(delegate), interpreter_num_threads, std::move(tensor_pool),
+        options.enable_zero_copy_tensor_io());
+  }
   return CreateInferenceInterpreterDelegateRunner(
       std::move(model_packet), std::move(op_resolver_packet),
-      std::move(delegate), interpreter_num_threads);
+      std::move(delegate), interpreter_num_threads, std::move(tensor_pool),
+      options.enable_zero_copy_tensor_io());
 }
 
 absl::StatusOr<TfLiteDelegatePtr>
-InferenceCalculatorXnnpackImpl::CreateDelegate(CalculatorContext* cc) {
+InferenceCalculatorXnnpackImpl::CreateDelegate(
+    CalculatorContext* cc, const TfLiteModelPtr& model,
+    std::shared_ptr<XnnpackWeightsCache>* weights_cache) {
   const auto& calculator_opts =
       cc->Options<mediapipe::InferenceCalculatorOptions>();
   auto opts_delegate = calculator_opts.delegate();
@@ -114,6 +135,11 @@ InferenceCalculatorXnnpackImpl::CreateDelegate(CalculatorContext* cc) {
   auto xnnpack_opts = TfLiteXNNPackDelegateOptionsDefault();
   xnnpack_opts.num_threads =
       GetXnnpackNumThreads(opts_has_delegate, opts_delegate);
+  if (opts_has_delegate && opts_delegate.xnnpack().enable_weights_cache()) {
+    *weights_cache =
+        XnnpackWeightsCache::GetOrCreate(model, xnnpack_opts.flags);
+    return (*weights_cache)->CreateDelegate(xnnpack_opts);
+  }
   return TfLiteDelegatePtr(TfLiteXNNPackDelegateCreate(&xnnpack_opts),
                            &TfLiteXNNPackDelegateDelete);
 }
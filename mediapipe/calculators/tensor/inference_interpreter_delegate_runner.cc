@@ -14,15 +14,26 @@
 
 #include "mediapipe/calculators/tensor/inference_interpreter_delegate_runner.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/formats/tensor_pool.h"
 #include "mediapipe/framework/mediapipe_profiling.h"
 #include "mediapipe/framework/port/ret_check.h"
+#include "mediapipe/framework/port/status_macros.h"
 #include "tensorflow/lite/c/c_api_types.h"
+#include "tensorflow/lite/c/common.h"
 #include "tensorflow/lite/interpreter.h"
 #include "tensorflow/lite/interpreter_builder.h"
 #include "tensorflow/lite/string_util.h"
@@ -47,17 +58,43 @@ void CopyTensorBufferToInterpreter(const Tensor& input_tensor,
   std::memcpy(local_tensor_buffer, input_tensor_buffer, input_tensor.bytes());
 }
 
-template <>
-void CopyTensorBufferToInterpreter<char>(const Tensor& input_tensor,
-                                         Interpreter* interpreter,
-                                         int input_tensor_index) {
-  const char* input_tensor_buffer =
-      input_tensor.GetCpuReadView().buffer<char>();
-  tflite::DynamicBuffer dynamic_buffer;
-  dynamic_buffer.AddString(input_tensor_buffer,
-                           input_tensor.shape().num_elements());
-  dynamic_buffer.WriteToTensorAsVector(
-      interpreter->tensor(interpreter->inputs()[input_tensor_index]));
+// Writes the characters of `input_tensor` as the single string of a
+// kTfLiteString input tensor. tflite::DynamicBuffer would copy them into an
+// intermediate buffer, then into a newly allocated tensor buffer. Instead,
+// they are copied once into the dynamic tensor buffer, which TFLite reuses
+// across inferences as long as it is large enough.
+absl::Status CopyStringTensorToInterpreter(const Tensor& input_tensor,
+                                           Interpreter* interpreter,
+                                           int input_tensor_index) {
+  auto input_tensor_view = input_tensor.GetCpuReadView();
+  const char* input_tensor_buffer = input_tensor_view.buffer<char>();
+  const int num_chars = input_tensor.shape().num_elements();
+  TfLiteTensor* tensor =
+      interpreter->tensor(interpreter->inputs()[input_tensor_index]);
+  if (tensor->allocation_type != kTfLiteDynamic) {
+    tflite::DynamicBuffer dynamic_buffer;
+    dynamic_buffer.AddString(input_tensor_buffer, num_chars);
+    dynamic_buffer.WriteToTensorAsVector(tensor);
+    return absl::OkStatus();
+  }
+  // A string tensor holding a single string starts with the number of
+  // strings and the offsets of the start and end of the string, in bytes
+  // from the start of the tensor, followed by the characters.
+  constexpr int32_t kHeaderSize = 3 * sizeof(int32_t);
+  const int32_t header[3] = {1, kHeaderSize, kHeaderSize + num_chars};
+  if (tensor->dims->size != 1 || tensor->dims->data[0] != 1) {
+    TfLiteIntArrayFree(tensor->dims);
+    tensor->dims = TfLiteIntArrayCreate(1);
+    tensor->dims->data[0] = 1;
+  }
+  if (TfLiteTensorRealloc(kHeaderSize + num_chars, tensor) != kTfLiteOk) {
+    return absl::InternalError(absl::StrCat(
+        "Failed to reallocate string input tensor ", input_tensor_index,
+        " to ", kHeaderSize + num_chars, " bytes."));
+  }
+  std::memcpy(tensor->data.raw, header, kHeaderSize);
+  std::memcpy(tensor->data.raw + kHeaderSize, input_tensor_buffer, num_chars);
+  return absl::OkStatus();
 }
 
 template <typename T>
@@ -72,46 +109,198 @@ void CopyTensorBufferFromInterpreter(Interpreter* interpreter,
               output_tensor->bytes());
 }
 
+// Returns an error if the values of the quantized `input_tensor` would be
+// interpreted differently by the interpreter input `tensor`. Tensors with the
+// default parameters (e.g. from ImageToTensorCalculator) hold values in the
+// model's input domain already.
+absl::Status CheckQuantizationParameters(const Tensor& input_tensor,
+                                         const TfLiteTensor& tensor) {
+  const Tensor::QuantizationParameters& params =
+      input_tensor.quantization_parameters();
+  const Tensor::QuantizationParameters default_params;
+  if (params.scale == default_params.scale &&
+      params.zero_point == default_params.zero_point) {
+    return absl::OkStatus();
+  }
+  if (params.zero_point != tensor.params.zero_point ||
+      std::abs(params.scale - tensor.params.scale) >
+          1e-6f * std::abs(tensor.params.scale)) {
+    return absl::InvalidArgumentError(absl::StrCat(
+        "Quantization parameters of the input tensor (scale ", params.scale,
+        ", zero point ", params.zero_point,
+        ") don't match those of the model input (scale ", tensor.params.scale,
+        ", zero point ", tensor.params.zero_point, ")."));
+  }
+  return absl::OkStatus();
+}
+
+// Returns the MediaPipe Tensor element type sharing the memory layout of
+// `type`, or kNone if there is none.
+Tensor::ElementType GetBindableElementType(TfLiteType type) {
+  switch (type) {
+    case TfLiteType::kTfLiteFloat32:
+      return Tensor::ElementType::kFloat32;
+    case TfLiteType::kTfLiteUInt8:
+      return Tensor::ElementType::kUInt8;
+    case TfLiteType::kTfLiteInt8:
+      return Tensor::ElementType::kInt8;
+    case TfLiteType::kTfLiteInt32:
+      return Tensor::ElementType::kInt32;
+    case TfLiteType::kTfLiteBool:
+      return Tensor::ElementType::kBool;
+    default:
+      return Tensor::ElementType::kNone;
+  }
+}
+
+// Returns true if the interpreter output `tensor` can write into the buffer of
+// a MediaPipe Tensor through a custom allocation.
+bool CanBindOutputTensor(const TfLiteTensor& tensor) {
+  return (tensor.allocation_type == kTfLiteArenaRw ||
+          tensor.allocation_type == kTfLiteCustom) &&
+         !tensor.is_variable &&
+         GetBindableElementType(tensor.type) != Tensor::ElementType::kNone;
+}
+
+// Returns true if an input of `interpreter` has a dimension of unknown size,
+// which ResizeInputTensorStrict() may change.
+bool HasResizableInputs(const Interpreter& interpreter) {
+  for (int tensor_index : interpreter.inputs()) {
+    const TfLiteIntArray* dims_signature =
+        interpreter.tensor(tensor_index)->dims_signature;
+    if (dims_signature != nullptr &&
+        std::find(dims_signature->data,
+                  dims_signature->data + dims_signature->size,
+                  -1) != dims_signature->data + dims_signature->size) {
+      return true;
+    }
+  }
+  return false;
+}
+
 }  // namespace
 
 class InferenceInterpreterDelegateRunner : public InferenceRunner {
  public:
   InferenceInterpreterDelegateRunner(api2::Packet<TfLiteModelPtr> model,
                                      std::unique_ptr<Interpreter> interpreter,
-                                     TfLiteDelegatePtr delegate)
+                                     TfLiteDelegatePtr delegate,
+                                     std::shared_ptr<TensorPool> tensor_pool,
+                                     bool enable_zero_copy_tensor_io)
       : model_(std::move(model)),
         interpreter_(std::move(interpreter)),
-        delegate_(std::move(delegate)) {}
+        delegate_(std::move(delegate)),
+        tensor_pool_(std::move(tensor_pool)),
+        // Custom allocations can't be dropped once input resizing changes
+        // the output sizes, so such models keep copying their outputs.
+        zero_copy_tensor_io_(enable_zero_copy_tensor_io &&
+                             !HasResizableInputs(*interpreter_)),
+        bound_output_tensors_(interpreter_->outputs().size()) {
+    // Zero-copy outputs need aligned buffers which only pooled tensors have.
+    if (zero_copy_tensor_io_ && !tensor_pool_) {
+      tensor_pool_ = TensorPool::Create();
+    }
+  }
 
   absl::StatusOr<std::vector<Tensor>> Run(
       CalculatorContext* cc, const std::vector<Tensor>& input_tensors) override;
 
  private:
+  Tensor CreateOutputTensor(
+      Tensor::ElementType element_type, const Tensor::Shape& shape,
+      const Tensor::QuantizationParameters& quantization_parameters = {}) {
+    if (tensor_pool_) {
+      return tensor_pool_->GetTensor(element_type, shape,
+                                     quantization_parameters);
+    }
+    return Tensor(element_type, shape, quantization_parameters);
+  }
+
+  // Binds the interpreter outputs to new pooled tensors, which the next
+  // Invoke() writes into.
+  absl::Status BindOutputTensors();
+
   api2::Packet<TfLiteModelPtr> model_;
   std::unique_ptr<Interpreter> interpreter_;
   TfLiteDelegatePtr delegate_;
+  std::shared_ptr<TensorPool> tensor_pool_;
+  // Whether interpreter outputs are written directly into the memory of
+  // MediaPipe Tensors through TFLite custom allocations.
+  const bool zero_copy_tensor_io_;
+  // The tensors whose buffers are bound to the interpreter outputs, if any.
+  // They are owned here until they are replaced by the next bound tensors, so
+  // that the interpreter never refers to released memory.
+  std::vector<std::optional<Tensor>> bound_output_tensors_;
+  bool has_bound_output_tensors_ = false;
 };
 
+absl::Status InferenceInterpreterDelegateRunner::BindOutputTensors() {
+  const auto& input_indexes = interpreter_->inputs();
+  const auto& output_indexes = interpreter_->outputs();
+  bool has_bound_outputs = false;
+  for (int i = 0; i < output_indexes.size(); ++i) {
+    const TfLiteTensor* tensor = interpreter_->tensor(output_indexes[i]);
+    if (!CanBindOutputTensor(*tensor) ||
+        std::find(input_indexes.begin(), input_indexes.end(),
+                  output_indexes[i]) != input_indexes.end()) {
+      continue;
+    }
+    const Tensor::ElementType element_type =
+        GetBindableElementType(tensor->type);
+    Tensor::Shape shape{std::vector<int>{
+        tensor->dims->data, tensor->dims->data + tensor->dims->size}};
+    Tensor::QuantizationParameters quantization_parameters;
+    if (element_type == Tensor::ElementType::kUInt8 ||
+        element_type == Tensor::ElementType::kInt8) {
+      quantization_parameters = {tensor->params.scale,
+                                 tensor->params.zero_point};
+    }
+    Tensor output_tensor =
+        tensor_pool_->GetTensor(element_type, shape, quantization_parameters);
+    RET_CHECK_EQ(output_tensor.bytes(), tensor->bytes);
+    void* buffer = output_tensor.GetCpuWriteView().buffer<void>();
+    RET_CHECK_EQ(interpreter_->SetCustomAllocationForTensor(
+                     output_indexes[i], {buffer, tensor->bytes}),
+                 kTfLiteOk);
+    bound_output_tensors_[i] = std::move(output_tensor);
+    has_bound_outputs = true;
+  }
+  // Verifies the new custom allocations.
+  if (has_bound_outputs) {
+    RET_CHECK_EQ(interpreter_->AllocateTensors(), kTfLiteOk);
+  }
+  return absl::OkStatus();
+}
+
 absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
     CalculatorContext* cc, const std::vector<Tensor>& input_tensors) {
   // Read CPU input into tensors.
   RET_CHECK_EQ(interpreter_->inputs().size(), input_tensors.size());
 
   // If the input tensors have dynamic shape, then the tensors need to be
-  // resized and reallocated before we can copy the tensor values.
+  // resized and reallocated before we can copy the tensor values. This is
+  // skipped when the shapes didn't change since the previous inference, e.g.
+  // when consecutive inputs are padded to the same length.
   bool resized_tensor_shapes = false;
   for (int i = 0; i < input_tensors.size(); ++i) {
-    if (input_tensors[i].shape().is_dynamic) {
-      interpreter_->ResizeInputTensorStrict(i, input_tensors[i].shape().dims);
-      resized_tensor_shapes = true;
+    if (!input_tensors[i].shape().is_dynamic) continue;
+    const std::vector<int>& dims = input_tensors[i].shape().dims;
+    const TfLiteIntArray* interpreter_dims =
+        interpreter_->tensor(interpreter_->inputs()[i])->dims;
+    if (std::equal(dims.begin(), dims.end(), interpreter_dims->data,
+                   interpreter_dims->data + interpreter_dims->size)) {
+      continue;
     }
+    interpreter_->ResizeInputTensorStrict(i, dims);
+    resized_tensor_shapes = true;
   }
   // Reallocation is needed for memory sanity.
   if (resized_tensor_shapes) interpreter_->AllocateTensors();
 
   for (int i = 0; i < input_tensors.size(); ++i) {
-    const TfLiteType input_tensor_type =
-        interpreter_->tensor(interpreter_->inputs()[i])->type;
+    const TfLiteTensor* tensor =
+        interpreter_->tensor(interpreter_->inputs()[i]);
+    const TfLiteType input_tensor_type = tensor->type;
     switch (input_tensor_type) {
       case TfLiteType::kTfLiteFloat16:
       case TfLiteType::kTfLiteFloat32: {
@@ -120,11 +309,15 @@ absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
         break;
       }
       case TfLiteType::kTfLiteUInt8: {
+        MP_RETURN_IF_ERROR(
+            CheckQuantizationParameters(input_tensors[i], *tensor));
         CopyTensorBufferToInterpreter<uint8_t>(input_tensors[i],
                                                interpreter_.get(), i);
         break;
       }
       case TfLiteType::kTfLiteInt8: {
+        MP_RETURN_IF_ERROR(
+            CheckQuantizationParameters(input_tensors[i], *tensor));
         CopyTensorBufferToInterpreter<int8_t>(input_tensors[i],
                                               interpreter_.get(), i);
         break;
@@ -135,8 +328,8 @@ absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
         break;
       }
       case TfLiteType::kTfLiteString: {
-        CopyTensorBufferToInterpreter<char>(input_tensors[i],
-                                            interpreter_.get(), i);
+        MP_RETURN_IF_ERROR(CopyStringTensorToInterpreter(
+            input_tensors[i], interpreter_.get(), i));
         break;
       }
       case TfLiteType::kTfLiteBool:
@@ -148,50 +341,74 @@ absl::StatusOr<std::vector<Tensor>> InferenceInterpreterDelegateRunner::Run(
     }
   }
 
+  // Binds the outputs before the first inference. Each inference then writes
+  // into the tensors bound after the previous one.
+  if (zero_copy_tensor_io_ && !has_bound_output_tensors_) {
+    MP_RETURN_IF_ERROR(BindOutputTensors());
+    has_bound_output_tensors_ = true;
+  }
+
   // Run inference.
   {
     MEDIAPIPE_PROFILING(CPU_TASK_INVOKE, cc);
     RET_CHECK_EQ(interpreter_->Invoke(), kTfLiteOk);
   }
-  // Output result tensors (CPU).
+
+  // Takes the written tensors and binds new ones for the next inference, so
+  // that the interpreter no longer refers to the tensors sent downstream.
   const auto& tensor_indexes = interpreter_->outputs();
+  std::vector<std::optional<Tensor>> written_output_tensors(
+      tensor_indexes.size());
+  if (zero_copy_tensor_io_) {
+    written_output_tensors.swap(bound_output_tensors_);
+    MP_RETURN_IF_ERROR(BindOutputTensors());
+  }
+
+  // Output result tensors (CPU).
   std::vector<Tensor> output_tensors;
   output_tensors.reserve(tensor_indexes.size());
   for (int i = 0; i < tensor_indexes.size(); ++i) {
+    if (written_output_tensors[i].has_value()) {
+      output_tensors.push_back(*std::move(written_output_tensors[i]));
+      continue;
+    }
     TfLiteTensor* tensor = interpreter_->tensor(tensor_indexes[i]);
     Tensor::Shape shape{std::vector<int>{
         tensor->dims->data, tensor->dims->data + tensor->dims->size}};
     switch (tensor->type) {
       case TfLiteType::kTfLiteFloat16:
       case TfLiteType::kTfLiteFloat32:
-        output_tensors.emplace_back(Tensor::ElementType::kFloat32, shape);
+        output_tensors.push_back(
+            CreateOutputTensor(Tensor::ElementType::kFloat32, shape));
         CopyTensorBufferFromInterpreter<float>(interpreter_.get(), i,
                                                &output_tensors.back());
         break;
       case TfLiteType::kTfLiteUInt8:
-        output_tensors.emplace_back(
+        output_tensors.push_back(CreateOutputTensor(
             Tensor::ElementType::kUInt8, shape,
             Tensor::QuantizationParameters{tensor->params.scale,
-                                           tensor->params.zero_point});
+                                           tensor->params.zero_point}));
         CopyTensorBufferFromInterpreter<uint8_t>(interpreter_.get(), i,
                                                  &output_tensors.back());
         break;
       case TfLiteType::kTfLiteInt8:
-        output_tensors.emplace_back(
+        output_tensors.push_back(CreateOutputTensor(
             Tensor::ElementType::kInt8, shape,
             Tensor::QuantizationParameters{tensor->params.scale,
-                                           tensor->params.zero_point});
+                                           tensor->params.zero_point}));
         CopyTensorBufferFromInterpreter<int8_t>(interpreter_.get(), i,
                                                 &output_tensors.back());
         break;
       case TfLiteType::kTfLiteInt32:
-        output_tensors.emplace_back(Tensor::ElementType::kInt32, shape);
+        output_tensors.push_back(
+            CreateOutputTensor(Tensor::ElementType::kInt32, shape));
         CopyTensorBufferFromInterpreter<int32_t>(interpreter_.get(), i,
                                                  &output_tensors.back());
         break;
       case TfLiteType::kTfLiteBool:
-        output_tensors.emplace_back(Tensor::ElementType::kBool, shape,
-                                    Tensor::QuantizationParameters{1.0f, 0});
+        output_tensors.push_back(
+            CreateOutputTensor(Tensor::ElementType::kBool, shape,
+                               Tensor::QuantizationParameters{1.0f, 0}));
         CopyTensorBufferFromInterpreter<bool>(interpreter_.get(), i,
                                               &output_tensors.back());
         break;
@@ -211,7 +428,9 @@ absl::StatusOr<std::unique_ptr<InferenceRunner>>
 CreateInferenceInterpreterDelegateRunner(
     api2::Packet<TfLiteModelPtr> model,
     api2::Packet<tflite::OpResolver> op_resolver, TfLiteDelegatePtr delegate,
-    int interpreter_num_threads) {
+    int interpreter_num_threads, std::shared_ptr<TensorPool> tensor_pool,
+    bool enable_zero_copy_tensor_io,
+    std::function<absl::Status()> on_delegate_applied) {
   InterpreterBuilder interpreter_builder(*model.Get(), op_resolver.Get());
   if (delegate) {
     interpreter_builder.AddDelegate(delegate.get());
@@ -224,9 +443,13 @@ CreateInferenceInterpreterDelegateRunner(
   std::unique_ptr<Interpreter> interpreter;
   RET_CHECK_EQ(interpreter_builder(&interpreter), kTfLiteOk);
   RET_CHECK(interpreter);
+  if (on_delegate_applied) {
+    MP_RETURN_IF_ERROR(on_delegate_applied());
+  }
   RET_CHECK_EQ(interpreter->AllocateTensors(), kTfLiteOk);
   return std::make_unique<InferenceInterpreterDelegateRunner>(
-      std::move(model), std::move(interpreter), std::move(delegate));
+      std::move(model), std::move(interpreter), std::move(delegate),
+      std::move(tensor_pool), enable_zero_copy_tensor_io);
 }
 
 }  // namespace mediapipe
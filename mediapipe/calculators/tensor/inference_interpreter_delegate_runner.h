@@ -15,13 +15,16 @@
 #ifndef MEDIAPIPE_CALCULATORS_TENSOR_INFERENCE_INTERPRETER_DELEGATE_RUNNER_H_
 #define MEDIAPIPE_CALCULATORS_TENSOR_INFERENCE_INTERPRETER_DELEGATE_RUNNER_H_
 
+#include <functional>
 #include <memory>
 #include <vector>
 
+#include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "mediapipe/calculators/tensor/inference_runner.h"
 #include "mediapipe/calculators/tensor/tflite_delegate_ptr.h"
 #include "mediapipe/framework/api2/packet.h"
+#include "mediapipe/framework/formats/tensor_pool.h"
 #include "mediapipe/util/tflite/tflite_model_loader.h"
 #include "tensorflow/lite/c/c_api_types.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
@@ -33,11 +36,26 @@ namespace mediapipe {
 //
 // `delegate` can be nullptr, in that case newly initialized interpreter will
 // use what is available by default.
+//
+// `tensor_pool` can be nullptr, otherwise output tensors are obtained from it
+// so that their buffers are reused across invocations.
+//
+// If `enable_zero_copy_tensor_io` is true, the interpreter writes its outputs
+// directly into pooled MediaPipe Tensors bound through TFLite custom
+// allocations instead of having them copied. Inputs are still copied, as they
+// are only borrowed for the duration of Run(). Models with resizable inputs
+// always copy their outputs.
+//
+// `on_delegate_applied`, if set, is called once `delegate` has been applied to
+// the interpreter and before the interpreter allocates its tensors.
 absl::StatusOr<std::unique_ptr<InferenceRunner>>
 CreateInferenceInterpreterDelegateRunner(
     api2::Packet<TfLiteModelPtr> model,
     api2::Packet<tflite::OpResolver> op_resolver, TfLiteDelegatePtr delegate,
-    int interpreter_num_threads);
+    int interpreter_num_threads,
+    std::shared_ptr<TensorPool> tensor_pool = nullptr,
+    bool enable_zero_copy_tensor_io = false,
+    std::function<absl::Status()> on_delegate_applied = nullptr);
 
 }  // namespace mediapipe
 
@@ -0,0 +1,107 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_QUANTIZED_TENSOR_READER_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_QUANTIZED_TENSOR_READER_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/formats/tensor.h"
+
+namespace mediapipe {
+
+// Reads the elements of a float32, uint8 or int8 CPU buffer as float values.
+// Quantized values are dequantized on access as
+//   scale * (value - zero_point),
+// so postprocessors can consume quantized model outputs directly instead of
+// requiring a dequantized float copy of the whole tensor.
+template <typename T>
+class QuantizedTensorReader {
+ public:
+  static_assert(std::is_same_v<T, float> || std::is_same_v<T, uint8_t> ||
+                    std::is_same_v<T, int8_t>,
+                "Unsupported element type.");
+  using ValueType = T;
+
+  QuantizedTensorReader(const T* data,
+                        const Tensor::QuantizationParameters& params)
+      : data_(data), scale_(params.scale), zero_point_(params.zero_point) {}
+
+  // Returns the dequantized value at `index`.
+  float operator[](int index) const { return Dequantize(data_[index]); }
+
+  // Returns the value at `index` as stored. As long as scale is positive,
+  // comparisons between raw values give the same order as the dequantized
+  // ones, so e.g. an argmax can be computed without dequantizing.
+  T raw(int index) const { return data_[index]; }
+
+  float Dequantize(T value) const {
+    if constexpr (std::is_same_v<T, float>) {
+      return value;
+    } else {
+      return scale_ * (static_cast<int>(value) - zero_point_);
+    }
+  }
+
+ private:
+  const T* data_;
+  float scale_;
+  int zero_point_;
+};
+
+// Returns true if `element_type` can be read with a QuantizedTensorReader.
+inline bool IsFloatOrQuantized(Tensor::ElementType element_type) {
+  return element_type == Tensor::ElementType::kFloat32 ||
+         element_type == Tensor::ElementType::kUInt8 ||
+         element_type == Tensor::ElementType::kInt8;
+}
+
+// Calls `fn` with a QuantizedTensorReader of the matching type over the CPU
+// buffer of `tensor` and returns the status returned by `fn`. The CPU read
+// view is held while `fn` runs.
+//
+//   MP_RETURN_IF_ERROR(VisitQuantizedTensorReader(
+//       tensor, [&](const auto& reader) -> absl::Status {
+//         for (int i = 0; i < n; ++i) sum += reader[i];
+//         return absl::OkStatus();
+//       }));
+template <typename Fn>
+absl::Status VisitQuantizedTensorReader(const Tensor& tensor, Fn&& fn) {
+  auto view = tensor.GetCpuReadView();
+  const auto& params = tensor.quantization_parameters();
+  switch (tensor.element_type()) {
+    case Tensor::ElementType::kFloat32:
+      return std::forward<Fn>(fn)(
+          QuantizedTensorReader<float>(view.buffer<float>(), params));
+    case Tensor::ElementType::kUInt8:
+      return std::forward<Fn>(fn)(
+          QuantizedTensorReader<uint8_t>(view.buffer<uint8_t>(), params));
+    case Tensor::ElementType::kInt8:
+      return std::forward<Fn>(fn)(
+          QuantizedTensorReader<int8_t>(view.buffer<int8_t>(), params));
+    default:
+      return absl::InvalidArgumentError(
+          absl::StrCat("Unsupported input tensor type: ",
+                       static_cast<int>(tensor.element_type()),
+                       ". Expected kFloat32, kUInt8 or kInt8."));
+  }
+}
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_QUANTIZED_TENSOR_READER_H_
@@ -0,0 +1,106 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/quantized_tensor_reader.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatEq;
+
+template <typename T>
+Tensor MakeTensor(Tensor::ElementType element_type,
+                  const std::vector<T>& values,
+                  const Tensor::QuantizationParameters& params = {}) {
+  Tensor tensor(element_type, Tensor::Shape{static_cast<int>(values.size())},
+                params);
+  auto view = tensor.GetCpuWriteView();
+  for (int i = 0; i < values.size(); ++i) {
+    view.buffer<T>()[i] = values[i];
+  }
+  return tensor;
+}
+
+std::vector<float> ReadAll(const Tensor& tensor) {
+  std::vector<float> values;
+  MP_EXPECT_OK(VisitQuantizedTensorReader(
+      tensor, [&](const auto& reader) -> absl::Status {
+        for (int i = 0; i < tensor.shape().num_elements(); ++i) {
+          values.push_back(reader[i]);
+        }
+        return absl::OkStatus();
+      }));
+  return values;
+}
+
+TEST(QuantizedTensorReaderTest, ReadsFloat) {
+  Tensor tensor = MakeTensor<float>(Tensor::ElementType::kFloat32,
+                                    {-1.5f, 0.0f, 2.0f});
+  EXPECT_THAT(ReadAll(tensor),
+              ElementsAre(FloatEq(-1.5f), FloatEq(0.0f), FloatEq(2.0f)));
+}
+
+TEST(QuantizedTensorReaderTest, DequantizesUInt8) {
+  Tensor tensor = MakeTensor<uint8_t>(
+      Tensor::ElementType::kUInt8, {0, 128, 255},
+      Tensor::QuantizationParameters(0.5f, 128));
+  EXPECT_THAT(ReadAll(tensor),
+              ElementsAre(FloatEq(-64.0f), FloatEq(0.0f), FloatEq(63.5f)));
+}
+
+TEST(QuantizedTensorReaderTest, DequantizesInt8) {
+  Tensor tensor =
+      MakeTensor<int8_t>(Tensor::ElementType::kInt8, {-128, -1, 127},
+                         Tensor::QuantizationParameters(0.25f, -1));
+  EXPECT_THAT(ReadAll(tensor),
+              ElementsAre(FloatEq(-31.75f), FloatEq(0.0f), FloatEq(32.0f)));
+}
+
+TEST(QuantizedTensorReaderTest, RawValuesKeepOrder) {
+  Tensor tensor =
+      MakeTensor<int8_t>(Tensor::ElementType::kInt8, {-5, 3, 1},
+                         Tensor::QuantizationParameters(0.1f, 2));
+  MP_EXPECT_OK(VisitQuantizedTensorReader(
+      tensor, [](const auto& reader) -> absl::Status {
+        EXPECT_LT(reader.raw(0), reader.raw(2));
+        EXPECT_LT(reader[0], reader[2]);
+        EXPECT_GT(reader.raw(1), reader.raw(2));
+        EXPECT_GT(reader[1], reader[2]);
+        return absl::OkStatus();
+      }));
+}
+
+TEST(QuantizedTensorReaderTest, RejectsUnsupportedType) {
+  Tensor tensor = MakeTensor<int32_t>(Tensor::ElementType::kInt32, {1});
+  EXPECT_EQ(VisitQuantizedTensorReader(
+                tensor,
+                [](const auto& reader) -> absl::Status {
+                  return absl::OkStatus();
+                })
+                .code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -12,14 +12,15 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <algorithm>
 #include <cstdint>
-#include <cstring>
 #include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "absl/status/status.h"
+#include "absl/types/span.h"
 #include "mediapipe/calculators/tensor/regex_preprocessor_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/api2/port.h"
@@ -86,6 +87,10 @@ class RegexPreprocessorCalculator : public Node {
   std::unique_ptr<tasks::text::tokenizers::RegexTokenizer> tokenizer_;
   // The max sequence length accepted by the text model.
   int max_seq_len_ = 0;
+  // The ids of the special tokens of the tokenizer vocabulary.
+  bool has_start_token_ = false;
+  int start_token_id_ = 0;
+  int pad_token_id_ = 0;
 };
 
 absl::Status RegexPreprocessorCalculator::UpdateContract(
@@ -122,38 +127,12 @@ absl::Status RegexPreprocessorCalculator::Open(CalculatorContext* cc) {
   const auto& options =
       cc->Options<mediapipe::RegexPreprocessorCalculatorOptions>();
   max_seq_len_ = options.max_seq_len();
+  has_start_token_ = tokenizer_->GetStartToken(&start_token_id_);
+  tokenizer_->GetPadToken(&pad_token_id_);
   return absl::OkStatus();
 }
 
 absl::Status RegexPreprocessorCalculator::Process(CalculatorContext* cc) {
-  tasks::text::tokenizers::TokenizerResult tokenizer_result =
-      tokenizer_->Tokenize(kTextIn(cc).Get());
-
-  int unknown_token_id = 0;
-  tokenizer_->GetUnknownToken(&unknown_token_id);
-  int pad_token_id = 0;
-  tokenizer_->GetPadToken(&pad_token_id);
-
-  std::vector<int> input_tokens(max_seq_len_, pad_token_id);
-  int start_token_id = 0;
-  int input_token_index = 0;
-  if (tokenizer_->GetStartToken(&start_token_id)) {
-    input_tokens[0] = start_token_id;
-    input_token_index = 1;
-  }
-
-  for (int i = 0; (i < tokenizer_result.subwords.size()) &&
-                  (input_token_index < max_seq_len_);
-       ++i, ++input_token_index) {
-    const std::string& token = tokenizer_result.subwords[i];
-    int token_id = 0;
-    if (tokenizer_->LookupId(token, &token_id)) {
-      input_tokens[input_token_index] = token_id;
-    } else {
-      input_tokens[input_token_index] = unknown_token_id;
-    }
-  }
-
   //                              |<-------sentence_length-------->|
   // input_tensor                 <START>, t1, t2... <PAD>, <PAD>...
   // <START> is optional, t1, t2... will be replaced by <UNKNOWN> if it's
@@ -161,8 +140,24 @@ absl::Status RegexPreprocessorCalculator::Process(CalculatorContext* cc) {
   std::vector<Tensor> result;
   result.push_back(
       {Tensor::ElementType::kInt32, Tensor::Shape({1, max_seq_len_})});
-  std::memcpy(result[0].GetCpuWriteView().buffer<int32_t>(),
-              input_tokens.data(), input_tokens.size() * sizeof(int32_t));
+  {
+    auto view = result[0].GetCpuWriteView();
+    int32_t* input_tokens = view.buffer<int32_t>();
+    int input_token_index = 0;
+    if (has_start_token_) {
+      input_tokens[input_token_index++] = start_token_id_;
+    }
+    // The token ids are written straight to the tensor, truncated to
+    // `max_seq_len_`.
+    const int max_num_tokens = max_seq_len_ - input_token_index;
+    input_token_index += std::min(
+        tokenizer_->TokenizeIds(
+            kTextIn(cc).Get(),
+            absl::MakeSpan(input_tokens + input_token_index, max_num_tokens)),
+        max_num_tokens);
+    std::fill(input_tokens + input_token_index, input_tokens + max_seq_len_,
+              pad_token_id_);
+  }
   kTensorsOut(cc).Send(std::move(result));
   return absl::OkStatus();
 }
@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -26,6 +28,8 @@
 #include "mediapipe/framework/formats/image_frame.h"
 #include "mediapipe/framework/formats/matrix.h"
 #include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/formats/tensor_pool.h"
+#include "mediapipe/framework/formats/tensor_pool_service.h"
 #include "mediapipe/framework/port.h"
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/gpu/gpu_buffer_format.h"
@@ -129,6 +133,11 @@ namespace mediapipe {
 //          - MTLBuffer if Metal API is available
 //          - SSBO if Metal is unavailable and OpenGL ES 3.1 is available
 //          - Texture2D if Metal and GLES 3.1 are not available and GLES 3.0 is.
+//          If use_quantized_tensors is set, 8-bit IMAGE inputs are instead
+//          copied as is into a CPU tensor of type kUInt8 (or shifted by -128
+//          into a kInt8 tensor if use_signed_quantized_tensors is set), whose
+//          quantization parameters map the pixel values onto the configured
+//          output range.
 //
 // Example use:
 // node {
@@ -159,7 +168,23 @@ class TensorConverterCalculator : public CalculatorBase {
   template <class T>
   absl::Status NormalizeImage(const ImageFrame& image_frame,
                               bool flip_vertically, float* tensor_ptr);
+  // Copies the pixel values, XOR-ed with `sign_flip` to shift them by -128
+  // into int8 values if it is 0x80.
+  absl::Status CopyImageToQuantizedTensor(const ImageFrame& image_frame,
+                                          bool flip_vertically,
+                                          uint8_t sign_flip,
+                                          uint8_t* tensor_ptr);
   absl::Status CopyMatrixToTensor(const Matrix& matrix, float* tensor_ptr);
+  // Returns the parameters such that dequantizing a pixel value yields the
+  // same value as NormalizeImage, or an error if the output range can't be
+  // expressed with an integer zero point.
+  absl::StatusOr<Tensor::QuantizationParameters> GetQuantizationParameters()
+      const;
+  // Returns a CPU tensor, recycled through the tensor pool if any.
+  Tensor CreateCpuTensor(Tensor::ElementType element_type,
+                         const Tensor::Shape& shape,
+                         const Tensor::QuantizationParameters&
+                             quantization_parameters = {});
   absl::Status ProcessCPU(CalculatorContext* cc);
   absl::Status ProcessGPU(CalculatorContext* cc);
 
@@ -179,9 +204,13 @@ class TensorConverterCalculator : public CalculatorBase {
 
   bool initialized_ = false;
   bool use_gpu_ = false;
+  std::shared_ptr<TensorPool> tensor_pool_;
   absl::optional<std::pair<float, float>> output_range_;
   bool flip_vertically_ = false;
   bool row_major_matrix_ = false;
+  bool use_quantized_tensors_ = false;
+  bool use_signed_quantized_tensors_ = false;
+  Tensor::QuantizationParameters quantization_parameters_;
   int max_num_channels_ = 3;
 };
 REGISTER_CALCULATOR(TensorConverterCalculator);
@@ -214,6 +243,7 @@ absl::Status TensorConverterCalculator::GetContract(CalculatorContract* cc) {
 
   RET_CHECK(cc->Outputs().HasTag(kTensorsTag));
   cc->Outputs().Tag(kTensorsTag).Set<std::vector<Tensor>>();
+  cc->UseService(kTensorPoolService).Optional();
   return absl::OkStatus();
 }
 
@@ -232,6 +262,11 @@ absl::Status TensorConverterCalculator::Open(CalculatorContext* cc) {
   }
 #endif  // !MEDIAPIPE_DISABLE_GPU
 
+  auto tensor_pool_service = cc->Service(kTensorPoolService);
+  if (!use_gpu_ && tensor_pool_service.IsAvailable()) {
+    tensor_pool_ = tensor_pool_service.GetObject().shared_from_this();
+  }
+
   MP_RETURN_IF_ERROR(LoadOptions(cc, use_gpu_));
 
   return absl::OkStatus();
@@ -271,6 +306,43 @@ absl::Status TensorConverterCalculator::Close(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+Tensor TensorConverterCalculator::CreateCpuTensor(
+    Tensor::ElementType element_type, const Tensor::Shape& shape,
+    const Tensor::QuantizationParameters& quantization_parameters) {
+  if (tensor_pool_) {
+    return tensor_pool_->GetTensor(element_type, shape,
+                                   quantization_parameters);
+  }
+  return Tensor(element_type, shape, quantization_parameters);
+}
+
+absl::StatusOr<Tensor::QuantizationParameters>
+TensorConverterCalculator::GetQuantizationParameters() const {
+  // NormalizeImage maps [0, 255] linearly onto the output range, [0, 1] by
+  // default.
+  const float range_min = output_range_.has_value() ? output_range_->first : 0;
+  const float range_max =
+      output_range_.has_value() ? output_range_->second : 1;
+  RET_CHECK_LT(range_min, range_max)
+      << "The output range [" << range_min << ", " << range_max
+      << "] is empty, it can't be represented by quantized tensors.";
+  const float scale = (range_max - range_min) / 255.0f;
+  // The pixel value that maps onto 0 must be an integer, otherwise any zero
+  // point would shift all the dequantized values.
+  const float zero_point = -range_min / scale;
+  const float rounded_zero_point = std::round(zero_point);
+  RET_CHECK(std::abs(zero_point - rounded_zero_point) <= 1e-3f &&
+            rounded_zero_point >= 0.0f && rounded_zero_point <= 255.0f)
+      << "The output range [" << range_min << ", " << range_max
+      << "] can't be represented by quantized tensors: 0 corresponds to pixel "
+         "value "
+      << zero_point << ", which isn't an integer in [0, 255].";
+  // Signed tensors hold the pixel values shifted by -128.
+  const int zero_point_offset = use_signed_quantized_tensors_ ? -128 : 0;
+  return Tensor::QuantizationParameters(
+      scale, static_cast<int>(rounded_zero_point) + zero_point_offset);
+}
+
 absl::Status TensorConverterCalculator::ProcessCPU(CalculatorContext* cc) {
   auto output_tensors = absl::make_unique<std::vector<Tensor>>();
   if (cc->Inputs().HasTag(kImageFrameTag)) {
@@ -291,21 +363,41 @@ absl::Status TensorConverterCalculator::ProcessCPU(CalculatorContext* cc) {
           format == mediapipe::ImageFormat::VEC32F1))
       RET_CHECK_FAIL() << "Unsupported CPU input format.";
 
-    output_tensors->emplace_back(
-        Tensor::ElementType::kFloat32,
-        Tensor::Shape{1, height, width, channels_preserved});
-    auto cpu_view = output_tensors->back().GetCpuWriteView();
-
-    // Copy image data into tensor.
-    if (image_frame.ByteDepth() == 1) {
-      MP_RETURN_IF_ERROR(NormalizeImage<uint8_t>(image_frame, flip_vertically_,
-                                                 cpu_view.buffer<float>()));
-    } else if (image_frame.ByteDepth() == 4) {
-      MP_RETURN_IF_ERROR(NormalizeImage<float>(image_frame, flip_vertically_,
-                                               cpu_view.buffer<float>()));
+    const Tensor::Shape shape{1, height, width, channels_preserved};
+    if (use_quantized_tensors_) {
+      // Pixels are copied without conversion, the normalization is carried by
+      // the quantization parameters instead.
+      RET_CHECK_EQ(image_frame.ByteDepth(), 1)
+          << "Quantized tensors require 8-bit images.";
+      output_tensors->push_back(
+          CreateCpuTensor(use_signed_quantized_tensors_
+                              ? Tensor::ElementType::kInt8
+                              : Tensor::ElementType::kUInt8,
+                          shape, quantization_parameters_));
+      auto cpu_view = output_tensors->back().GetCpuWriteView();
+      uint8_t* tensor_ptr =
+          use_signed_quantized_tensors_
+              ? reinterpret_cast<uint8_t*>(cpu_view.buffer<int8_t>())
+              : cpu_view.buffer<uint8_t>();
+      MP_RETURN_IF_ERROR(CopyImageToQuantizedTensor(
+          image_frame, flip_vertically_,
+          /*sign_flip=*/use_signed_quantized_tensors_ ? 0x80 : 0, tensor_ptr));
     } else {
-      return absl::InternalError(
-          "Only byte-based (8 bit) and float (32 bit) images supported.");
+      output_tensors->push_back(
+          CreateCpuTensor(Tensor::ElementType::kFloat32, shape));
+      auto cpu_view = output_tensors->back().GetCpuWriteView();
+
+      // Copy image data into tensor.
+      if (image_frame.ByteDepth() == 1) {
+        MP_RETURN_IF_ERROR(NormalizeImage<uint8_t>(
+            image_frame, flip_vertically_, cpu_view.buffer<float>()));
+      } else if (image_frame.ByteDepth() == 4) {
+        MP_RETURN_IF_ERROR(NormalizeImage<float>(
+            image_frame, flip_vertically_, cpu_view.buffer<float>()));
+      } else {
+        return absl::InternalError(
+            "Only byte-based (8 bit) and float (32 bit) images supported.");
+      }
     }
   } else if (cc->Inputs().HasTag(kMatrixTag)) {
     if (cc->Inputs().Tag(kMatrixTag).IsEmpty()) {
@@ -315,8 +407,9 @@ absl::Status TensorConverterCalculator::ProcessCPU(CalculatorContext* cc) {
     const int height = matrix.rows();
     const int width = matrix.cols();
     const int channels = 1;
-    output_tensors->emplace_back(Tensor::ElementType::kFloat32,
-                                 Tensor::Shape{1, height, width, channels});
+    output_tensors->push_back(
+        CreateCpuTensor(Tensor::ElementType::kFloat32,
+                        Tensor::Shape{1, height, width, channels}));
     MP_RETURN_IF_ERROR(CopyMatrixToTensor(
         matrix, output_tensors->back().GetCpuWriteView().buffer<float>()));
   } else {
@@ -634,8 +727,9 @@ absl::Status TensorConverterCalculator::LoadOptions(CalculatorContext* cc,
       cc->Options<::mediapipe::TensorConverterCalculatorOptions>();
 
   // if zero_center, set output float range to match [-1, 1] as specified in
-  // calculator proto.
-  if (options.zero_center()) {
+  // calculator proto. It is ignored by quantized tensors, for which [-1, 1]
+  // has no integer zero point.
+  if (options.zero_center() && !options.use_quantized_tensors()) {
     output_range_.emplace(std::pair<float, float>(-1.0, 1.0));
   }
 
@@ -645,7 +739,8 @@ absl::Status TensorConverterCalculator::LoadOptions(CalculatorContext* cc,
   if (options.has_output_tensor_float_range()) {
     output_range_.emplace(options.output_tensor_float_range().min(),
                           options.output_tensor_float_range().max());
-    ABSL_CHECK_GT(output_range_->second, output_range_->first);
+    RET_CHECK_GT(output_range_->second, output_range_->first)
+        << "output_tensor_float_range must not be empty.";
   }
 
   // Custom div and sub values.
@@ -661,6 +756,17 @@ absl::Status TensorConverterCalculator::LoadOptions(CalculatorContext* cc,
   // Get row_major_matrix mode.
   row_major_matrix_ = options.row_major_matrix();
 
+  // Get quantized output mode.
+  use_quantized_tensors_ = options.use_quantized_tensors();
+  RET_CHECK(!use_quantized_tensors_ || !use_gpu)
+      << "use_quantized_tensors is only supported for CPU inputs.";
+  use_signed_quantized_tensors_ = options.use_signed_quantized_tensors();
+  RET_CHECK(!use_signed_quantized_tensors_ || use_quantized_tensors_)
+      << "use_signed_quantized_tensors requires use_quantized_tensors.";
+  if (use_quantized_tensors_) {
+    ASSIGN_OR_RETURN(quantization_parameters_, GetQuantizationParameters());
+  }
+
   // Get desired way to handle input channels.
   max_num_channels_ = options.max_num_channels();
   ABSL_CHECK_GE(max_num_channels_, 1);
@@ -717,6 +823,33 @@ absl::Status TensorConverterCalculator::NormalizeImage(
   return absl::OkStatus();
 }
 
+absl::Status TensorConverterCalculator::CopyImageToQuantizedTensor(
+    const ImageFrame& image_frame, bool flip_vertically, uint8_t sign_flip,
+    uint8_t* tensor_ptr) {
+  const int height = image_frame.Height();
+  const int width = image_frame.Width();
+  const int channels = image_frame.NumberOfChannels();
+  const int channels_preserved = std::min(channels, max_num_channels_);
+
+  for (int i = 0; i < height; ++i) {
+    const uint8_t* image_ptr =
+        image_frame.PixelData() +
+        (flip_vertically ? height - 1 - i : i) * image_frame.WidthStep();
+    if (channels_preserved == channels && sign_flip == 0) {
+      std::memcpy(tensor_ptr, image_ptr, width * channels);
+      tensor_ptr += width * channels;
+      continue;
+    }
+    for (int j = 0; j < width; ++j) {
+      for (int c = 0; c < channels_preserved; ++c) {
+        *tensor_ptr++ = image_ptr[c] ^ sign_flip;
+      }
+      image_ptr += channels;
+    }
+  }
+  return absl::OkStatus();
+}
+
 absl::Status TensorConverterCalculator::CopyMatrixToTensor(const Matrix& matrix,
                                                            float* tensor_ptr) {
   if (row_major_matrix_) {
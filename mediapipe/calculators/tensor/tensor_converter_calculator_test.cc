@@ -321,6 +321,206 @@ TEST_F(TensorConverterCalculatorTest, SetOutputRange) {
   }
 }
 
+TEST_F(TensorConverterCalculatorTest, QuantizedOutput) {
+  std::vector<std::pair<float, float>> range_values = {
+      std::make_pair(0.0, 1.0), std::make_pair(-128.0, 127.0)};
+  for (std::pair<float, float> range : range_values) {
+    CalculatorGraph graph;
+    CalculatorGraphConfig graph_config =
+        mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(absl::Substitute(
+            R"pb(
+              input_stream: "input_image"
+              node {
+                calculator: "TensorConverterCalculator"
+                input_stream: "IMAGE:input_image"
+                output_stream: "TENSORS:tensor"
+                options {
+                  [mediapipe.TensorConverterCalculatorOptions.ext] {
+                    use_quantized_tensors: true
+                    output_tensor_float_range { min: $0 max: $1 }
+                  }
+                }
+              }
+            )pb",
+            /*$0=*/range.first,
+            /*$1=*/range.second));
+    std::vector<Packet> output_packets;
+    tool::AddVectorSink("tensor", &graph_config, &output_packets);
+
+    // Run the graph.
+    MP_ASSERT_OK(graph.Initialize(graph_config));
+    MP_ASSERT_OK(graph.StartRun({}));
+    auto input_image = std::make_unique<ImageFrame>(ImageFormat::GRAY8, 1, 1);
+    cv::Mat mat = mediapipe::formats::MatView(input_image.get());
+    mat.at<uint8_t>(0, 0) = 200;
+    MP_ASSERT_OK(graph.AddPacketToInputStream(
+        "input_image", Adopt(input_image.release()).At(Timestamp(0))));
+
+    // Wait until the calculator finishes processing.
+    MP_ASSERT_OK(graph.WaitUntilIdle());
+    ASSERT_EQ(output_packets.size(), 1);
+
+    // Get and process results.
+    const std::vector<Tensor>& tensor_vec =
+        output_packets[0].Get<std::vector<Tensor>>();
+    ASSERT_EQ(tensor_vec.size(), 1);
+    const Tensor& tensor = tensor_vec[0];
+    EXPECT_EQ(tensor.element_type(), Tensor::ElementType::kUInt8);
+    auto view = tensor.GetCpuReadView();
+    EXPECT_EQ(*view.buffer<uint8_t>(), 200);
+
+    // Dequantizing yields the value of the float path.
+    const auto& params = tensor.quantization_parameters();
+    const float scale = (range.second - range.first) / 255.0;
+    EXPECT_FLOAT_EQ(params.scale, scale);
+    EXPECT_EQ(params.zero_point, static_cast<int>(-range.first / scale));
+    EXPECT_FLOAT_EQ(params.scale * (200 - params.zero_point),
+                    range.first + 200 * scale);
+
+    // Fully close graph at end, otherwise calculator+tensors are destroyed
+    // after calling WaitUntilDone().
+    MP_ASSERT_OK(graph.CloseInputStream("input_image"));
+    MP_ASSERT_OK(graph.WaitUntilDone());
+  }
+}
+
+TEST_F(TensorConverterCalculatorTest, SignedQuantizedOutput) {
+  CalculatorGraph graph;
+  CalculatorGraphConfig graph_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input_image"
+        node {
+          calculator: "TensorConverterCalculator"
+          input_stream: "IMAGE:input_image"
+          output_stream: "TENSORS:tensor"
+          options {
+            [mediapipe.TensorConverterCalculatorOptions.ext] {
+              use_quantized_tensors: true
+              use_signed_quantized_tensors: true
+              output_tensor_float_range { min: 0 max: 1 }
+            }
+          }
+        }
+      )pb");
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("tensor", &graph_config, &output_packets);
+
+  MP_ASSERT_OK(graph.Initialize(graph_config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  auto input_image = std::make_unique<ImageFrame>(ImageFormat::GRAY8, 1, 1);
+  cv::Mat mat = mediapipe::formats::MatView(input_image.get());
+  mat.at<uint8_t>(0, 0) = 200;
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "input_image", Adopt(input_image.release()).At(Timestamp(0))));
+  MP_ASSERT_OK(graph.WaitUntilIdle());
+  ASSERT_EQ(output_packets.size(), 1);
+
+  const Tensor& tensor = output_packets[0].Get<std::vector<Tensor>>()[0];
+  EXPECT_EQ(tensor.element_type(), Tensor::ElementType::kInt8);
+  auto view = tensor.GetCpuReadView();
+  EXPECT_EQ(*view.buffer<int8_t>(), 200 - 128);
+  const auto& params = tensor.quantization_parameters();
+  EXPECT_EQ(params.zero_point, -128);
+  EXPECT_FLOAT_EQ(params.scale * (*view.buffer<int8_t>() - params.zero_point),
+                  200 / 255.0f);
+
+  MP_ASSERT_OK(graph.CloseInputStream("input_image"));
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
+TEST_F(TensorConverterCalculatorTest, QuantizedOutputIgnoresZeroCenter) {
+  CalculatorGraph graph;
+  CalculatorGraphConfig graph_config =
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input_image"
+        node {
+          calculator: "TensorConverterCalculator"
+          input_stream: "IMAGE:input_image"
+          output_stream: "TENSORS:tensor"
+          options {
+            [mediapipe.TensorConverterCalculatorOptions.ext] {
+              use_quantized_tensors: true
+              zero_center: true
+            }
+          }
+        }
+      )pb");
+  std::vector<Packet> output_packets;
+  tool::AddVectorSink("tensor", &graph_config, &output_packets);
+
+  MP_ASSERT_OK(graph.Initialize(graph_config));
+  MP_ASSERT_OK(graph.StartRun({}));
+  auto input_image = std::make_unique<ImageFrame>(ImageFormat::GRAY8, 1, 1);
+  MP_ASSERT_OK(graph.AddPacketToInputStream(
+      "input_image", Adopt(input_image.release()).At(Timestamp(0))));
+  MP_ASSERT_OK(graph.WaitUntilIdle());
+  ASSERT_EQ(output_packets.size(), 1);
+
+  // The output range is [0, 1].
+  const auto& params = output_packets[0]
+                           .Get<std::vector<Tensor>>()[0]
+                           .quantization_parameters();
+  EXPECT_FLOAT_EQ(params.scale, 1.0f / 255.0f);
+  EXPECT_EQ(params.zero_point, 0);
+
+  MP_ASSERT_OK(graph.CloseInputStream("input_image"));
+  MP_ASSERT_OK(graph.WaitUntilDone());
+}
+
+TEST_F(TensorConverterCalculatorTest,
+       QuantizedOutputFailsWithoutIntegerZeroPoint) {
+  // 0 lies between pixel values 127 and 128 in [-1, 1].
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input_image"
+        node {
+          calculator: "TensorConverterCalculator"
+          input_stream: "IMAGE:input_image"
+          output_stream: "TENSORS:tensor"
+          options {
+            [mediapipe.TensorConverterCalculatorOptions.ext] {
+              use_quantized_tensors: true
+              output_tensor_float_range { min: -1 max: 1 }
+            }
+          }
+        }
+      )pb")));
+  MP_ASSERT_OK(graph.StartRun({}));
+
+  absl::Status status = graph.WaitUntilIdle();
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.message(),
+              HasSubstr("can't be represented by quantized tensors"));
+}
+
+TEST_F(TensorConverterCalculatorTest, QuantizedOutputFailsWithEmptyRange) {
+  // custom_div is large enough for the range to collapse to a single value.
+  CalculatorGraph graph;
+  MP_ASSERT_OK(graph.Initialize(
+      mediapipe::ParseTextProtoOrDie<CalculatorGraphConfig>(R"pb(
+        input_stream: "input_image"
+        node {
+          calculator: "TensorConverterCalculator"
+          input_stream: "IMAGE:input_image"
+          output_stream: "TENSORS:tensor"
+          options {
+            [mediapipe.TensorConverterCalculatorOptions.ext] {
+              use_quantized_tensors: true
+              use_custom_normalization: true
+              custom_div: 1e38
+              custom_sub: 1
+            }
+          }
+        }
+      )pb")));
+  MP_ASSERT_OK(graph.StartRun({}));
+
+  absl::Status status = graph.WaitUntilIdle();
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.message(), HasSubstr("is empty"));
+}
+
 TEST_F(TensorConverterCalculatorTest, FlipVertically) {
   CalculatorGraph graph;
   CalculatorGraphConfig graph_config =
@@ -18,6 +18,7 @@
 
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "mediapipe/calculators/tensor/quantized_tensor_reader.h"
 #include "mediapipe/calculators/tensor/tensors_to_classification_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -51,8 +52,9 @@ void SetClassificationLabel(const LabelMapItem label_map_item,
 // classifications.
 //
 // Input:
-//  TENSORS - Vector of Tensors of type kFloat32 containing one
-//            tensor, the size of which must be (1, * num_classes).
+//  TENSORS - Vector of Tensors of type kFloat32, kUInt8 or kInt8 containing
+//            one tensor, the size of which must be (1, * num_classes).
+//            Quantized scores are dequantized on the fly.
 // Output:
 //  CLASSIFICATIONS - Result MediaPipe ClassificationList. The score and index
 //                    fields of each classification are set, while the label
@@ -166,7 +168,7 @@ absl::Status TensorsToClassificationCalculator::Open(CalculatorContext* cc) {
 absl::Status TensorsToClassificationCalculator::Process(CalculatorContext* cc) {
   const auto& input_tensors = *kInTensors(cc);
   RET_CHECK_EQ(input_tensors.size(), 1);
-  RET_CHECK(input_tensors[0].element_type() == Tensor::ElementType::kFloat32);
+  RET_CHECK(IsFloatOrQuantized(input_tensors[0].element_type()));
 
   int num_classes = input_tensors[0].shape().num_elements();
 
@@ -178,39 +180,43 @@ absl::Status TensorsToClassificationCalculator::Process(CalculatorContext* cc) {
   if (label_map_loaded_) {
     RET_CHECK_EQ(num_classes, GetLabelMap(cc).size());
   }
-  auto view = input_tensors[0].GetCpuReadView();
-  auto raw_scores = view.buffer<float>();
-
   auto classification_list = absl::make_unique<ClassificationList>();
-  if (is_binary_classification_) {
-    Classification* class_first = classification_list->add_classification();
-    Classification* class_second = classification_list->add_classification();
-    class_first->set_index(0);
-    class_second->set_index(1);
-    class_first->set_score(raw_scores[0]);
-    class_second->set_score(1. - raw_scores[0]);
+  MP_RETURN_IF_ERROR(VisitQuantizedTensorReader(
+      input_tensors[0], [&](const auto& raw_scores) {
+        if (is_binary_classification_) {
+          Classification* class_first =
+              classification_list->add_classification();
+          Classification* class_second =
+              classification_list->add_classification();
+          class_first->set_index(0);
+          class_second->set_index(1);
+          class_first->set_score(raw_scores[0]);
+          class_second->set_score(1. - raw_scores[0]);
 
-    if (label_map_loaded_) {
-      SetClassificationLabel(GetLabelMap(cc).at(0), class_first);
-      SetClassificationLabel(GetLabelMap(cc).at(1), class_second);
-    }
-  } else {
-    for (int i = 0; i < num_classes; ++i) {
-      if (!IsClassIndexAllowed(i)) {
-        continue;
-      }
-      if (raw_scores[i] < min_score_threshold_) {
-        continue;
-      }
-      Classification* classification =
-          classification_list->add_classification();
-      classification->set_index(i);
-      classification->set_score(raw_scores[i]);
-      if (label_map_loaded_) {
-        SetClassificationLabel(GetLabelMap(cc).at(i), classification);
-      }
-    }
-  }
+          if (label_map_loaded_) {
+            SetClassificationLabel(GetLabelMap(cc).at(0), class_first);
+            SetClassificationLabel(GetLabelMap(cc).at(1), class_second);
+          }
+        } else {
+          for (int i = 0; i < num_classes; ++i) {
+            if (!IsClassIndexAllowed(i)) {
+              continue;
+            }
+            const float score = raw_scores[i];
+            if (score < min_score_threshold_) {
+              continue;
+            }
+            Classification* classification =
+                classification_list->add_classification();
+            classification->set_index(i);
+            classification->set_score(score);
+            if (label_map_loaded_) {
+              SetClassificationLabel(GetLabelMap(cc).at(i), classification);
+            }
+          }
+        }
+        return absl::OkStatus();
+      }));
 
   auto raw_classification_list = classification_list->mutable_classification();
   if (top_k_ > 0) {
@@ -13,6 +13,7 @@
 // limitations under the License.
 
 #include <algorithm>
+#include <cstdint>
 #include <limits>
 #include <vector>
 
@@ -323,4 +324,44 @@ TEST_F(TensorsToClassificationCalculatorTest,
   ASSERT_TRUE(classification_list.classification(1).has_label());
 }
 
+TEST_F(TensorsToClassificationCalculatorTest, CorrectOutputWithUInt8Tensor) {
+  mediapipe::CalculatorRunner runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToClassificationCalculator"
+    input_stream: "TENSORS:tensors"
+    output_stream: "CLASSIFICATIONS:classifications"
+    options {
+      [mediapipe.TensorsToClassificationCalculatorOptions.ext] {
+        min_score_thresh: 0.25
+      }
+    }
+  )pb"));
+
+  // Quantized scores {0, 0.5, 1}.
+  auto tensors = absl::make_unique<std::vector<Tensor>>();
+  tensors->emplace_back(Tensor::ElementType::kUInt8, Tensor::Shape{1, 3},
+                        Tensor::QuantizationParameters(0.25f, 10));
+  {
+    auto view = tensors->back().GetCpuWriteView();
+    uint8_t* tensor_buffer = view.buffer<uint8_t>();
+    tensor_buffer[0] = 10;
+    tensor_buffer[1] = 12;
+    tensor_buffer[2] = 14;
+  }
+  runner.MutableInputs()->Tag("TENSORS").packets.push_back(
+      mediapipe::Adopt(tensors.release()).At(mediapipe::Timestamp(0)));
+  MP_ASSERT_OK(runner.Run());
+
+  const auto& output_packets_ = runner.Outputs().Tag("CLASSIFICATIONS").packets;
+
+  EXPECT_EQ(1, output_packets_.size());
+
+  const auto& classification_list =
+      output_packets_[0].Get<ClassificationList>();
+  ASSERT_EQ(2, classification_list.classification_size());
+  EXPECT_EQ(1, classification_list.classification(0).index());
+  EXPECT_EQ(0.5, classification_list.classification(0).score());
+  EXPECT_EQ(2, classification_list.classification(1).index());
+  EXPECT_EQ(1, classification_list.classification(1).score());
+}
+
 }  // namespace mediapipe
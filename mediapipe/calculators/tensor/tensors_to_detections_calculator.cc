@@ -12,12 +12,16 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <limits>
+#include <type_traits>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "absl/log/absl_log.h"
 #include "absl/strings/str_format.h"
 #include "absl/types/span.h"
+#include "mediapipe/calculators/tensor/quantized_tensor_reader.h"
 #include "mediapipe/calculators/tensor/tensors_to_detections_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -152,6 +156,9 @@ BoxFormat GetBoxFormat(const TensorsToDetectionsCalculatorOptions& options) {
 //            for anchors (e.g. for SSD models) depend on the outputs of the
 //            detection model. The size of anchor tensor must be (num_boxes *
 //            4).
+//            The box and score tensors may also be quantized (kUInt8 or
+//            kInt8) CPU tensors, which are then dequantized on the fly using
+//            their quantization parameters.
 //
 // Input side packet:
 //  ANCHORS (optional) - The anchors used for decoding the bounding boxes, as a
@@ -207,9 +214,19 @@ class TensorsToDetectionsCalculator : public Node {
 
   absl::Status LoadOptions(CalculatorContext* cc);
   absl::Status GpuInit(CalculatorContext* cc);
-  absl::Status DecodeBoxes(const float* raw_boxes,
-                           const std::vector<Anchor>& anchors,
+  // Copies anchors_ into anchor_arrays_.
+  void SetAnchorArrays();
+  // Decodes the boxes at `box_indices` into `boxes`, leaving the others
+  // untouched. `Reader` is a QuantizedTensorReader over the raw box or score
+  // tensor.
+  template <typename Reader>
+  absl::Status DecodeBoxes(const Reader& raw_boxes,
+                           absl::Span<const int> box_indices,
                            std::vector<float>* boxes);
+  template <typename Reader>
+  void ScoreBoxes(const Reader& raw_scores,
+                  std::vector<float>* detection_scores,
+                  std::vector<int>* detection_classes);
   absl::Status ConvertToDetections(const float* detection_boxes,
                                    const float* detection_scores,
                                    const int* detection_classes,
@@ -241,6 +258,27 @@ class TensorsToDetectionsCalculator : public Node {
   std::vector<int> box_indices_ = {0, 1, 2, 3};
   bool has_custom_box_indices_ = false;
   std::vector<Anchor> anchors_;
+  // Boxes in center-size, structure-of-arrays layout for decoding on CPU.
+  struct CenterSizeArrays {
+    void Resize(int size) {
+      y_center.resize(size);
+      x_center.resize(size);
+      h.resize(size);
+      w.resize(size);
+    }
+
+    std::vector<float> y_center;
+    std::vector<float> x_center;
+    std::vector<float> h;
+    std::vector<float> w;
+  };
+  CenterSizeArrays anchor_arrays_;
+  // Scratch arrays for DecodeBoxes, holding the raw boxes to decode and, if
+  // not all the boxes are decoded, their anchors.
+  CenterSizeArrays candidate_boxes_;
+  CenterSizeArrays candidate_anchors_;
+  // Class indices in [0, num_classes) that pass IsClassIndexAllowed.
+  std::vector<int> allowed_class_indices_;
 
 #ifndef MEDIAPIPE_DISABLE_GL_COMPUTE
   mediapipe::GlCalculatorHelper gpu_helper_;
@@ -305,7 +343,7 @@ absl::Status TensorsToDetectionsCalculator::Process(CalculatorContext* cc) {
   }
   const auto& input_tensors = *kInTensors(cc);
   for (const auto& tensor : input_tensors) {
-    RET_CHECK(tensor.element_type() == Tensor::ElementType::kFloat32);
+    RET_CHECK(IsFloatOrQuantized(tensor.element_type()));
   }
   const int num_input_tensors = input_tensors.size();
   if (!scores_tensor_index_is_set_) {
@@ -323,6 +361,13 @@ absl::Status TensorsToDetectionsCalculator::Process(CalculatorContext* cc) {
     RET_CHECK(!has_custom_box_indices_);
   }
 
+  if (gpu_processing) {
+    for (const auto& tensor : input_tensors) {
+      RET_CHECK(tensor.element_type() == Tensor::ElementType::kFloat32)
+          << "Quantized tensors are only supported on CPU.";
+    }
+  }
+
   if (gpu_processing && !gpu_inited_) {
     auto status = GpuInit(cc);
     if (status.ok()) {
@@ -392,11 +437,6 @@ absl::Status TensorsToDetectionsCalculator::ProcessCPU(
       return absl::InvalidArgumentError(
           "The dimensions of score Tensor must be 3 or 4.");
     }
-    auto raw_box_view = raw_box_tensor->GetCpuReadView();
-    auto raw_boxes = raw_box_view.buffer<float>();
-    auto raw_scores_view = raw_score_tensor->GetCpuReadView();
-    auto raw_scores = raw_scores_view.buffer<float>();
-
     // TODO: Support other options to load anchors.
     if (!anchors_init_) {
       if (input_tensors.size() == kNumInputTensorsWithAnchors) {
@@ -405,6 +445,8 @@ absl::Status TensorsToDetectionsCalculator::ProcessCPU(
         RET_CHECK_EQ(anchor_tensor->shape().dims.size(), 2);
         RET_CHECK_EQ(anchor_tensor->shape().dims[0], num_boxes_);
         RET_CHECK_EQ(anchor_tensor->shape().dims[1], kNumCoordsPerBox);
+        RET_CHECK(anchor_tensor->element_type() ==
+                  Tensor::ElementType::kFloat32);
         auto anchor_view = anchor_tensor->GetCpuReadView();
         auto raw_anchors = anchor_view.buffer<float>();
         ConvertRawValuesToAnchors(raw_anchors, num_boxes_, &anchors_);
@@ -413,43 +455,36 @@ absl::Status TensorsToDetectionsCalculator::ProcessCPU(
       } else {
         return absl::UnavailableError("No anchor data available.");
       }
+      SetAnchorArrays();
       anchors_init_ = true;
     }
-    std::vector<float> boxes(num_boxes_ * num_coords_);
-    MP_RETURN_IF_ERROR(DecodeBoxes(raw_boxes, anchors_, &boxes));
 
+    // Scores are computed first so that only the boxes which can become
+    // detections need to be decoded.
     std::vector<float> detection_scores(num_boxes_);
     std::vector<int> detection_classes(num_boxes_);
-
-    // Filter classes by scores.
+    MP_RETURN_IF_ERROR(VisitQuantizedTensorReader(
+        *raw_score_tensor, [&](const auto& raw_scores) {
+          ScoreBoxes(raw_scores, &detection_scores, &detection_classes);
+          return absl::OkStatus();
+        }));
+
+    std::vector<int> candidates;
+    candidates.reserve(num_boxes_);
     for (int i = 0; i < num_boxes_; ++i) {
-      int class_id = -1;
-      float max_score = -std::numeric_limits<float>::max();
-      // Find the top score for box i.
-      for (int score_idx = 0; score_idx < num_classes_; ++score_idx) {
-        if (IsClassIndexAllowed(score_idx)) {
-          auto score = raw_scores[i * num_classes_ + score_idx];
-          if (options_.sigmoid_score()) {
-            if (options_.has_score_clipping_thresh()) {
-              score = score < -options_.score_clipping_thresh()
-                          ? -options_.score_clipping_thresh()
-                          : score;
-              score = score > options_.score_clipping_thresh()
-                          ? options_.score_clipping_thresh()
-                          : score;
-            }
-            score = 1.0f / (1.0f + std::exp(-score));
-          }
-          if (max_score < score) {
-            max_score = score;
-            class_id = score_idx;
-          }
-        }
+      if (options_.has_min_score_thresh() &&
+          detection_scores[i] < options_.min_score_thresh()) {
+        continue;
       }
-      detection_scores[i] = max_score;
-      detection_classes[i] = class_id;
+      candidates.push_back(i);
     }
 
+    std::vector<float> boxes(num_boxes_ * num_coords_);
+    MP_RETURN_IF_ERROR(VisitQuantizedTensorReader(
+        *raw_box_tensor, [&](const auto& raw_boxes) {
+          return DecodeBoxes(raw_boxes, candidates, &boxes);
+        }));
+
     MP_RETURN_IF_ERROR(
         ConvertToDetections(boxes.data(), detection_scores.data(),
                             detection_classes.data(), output_detections));
@@ -457,6 +492,10 @@ absl::Status TensorsToDetectionsCalculator::ProcessCPU(
     // Postprocessing on CPU with postprocessing op (e.g. anchor decoding and
     // non-maximum suppression) within the model.
     RET_CHECK_EQ(input_tensors.size(), 4);
+    for (const auto& tensor : input_tensors) {
+      RET_CHECK(tensor.element_type() == Tensor::ElementType::kFloat32)
+          << "Models with built-in postprocessing must output float tensors.";
+    }
     auto num_boxes_tensor =
         &input_tensors[tensor_mapping_.num_detections_tensor_index()];
     RET_CHECK_EQ(num_boxes_tensor->shape().dims.size(), 1);
@@ -737,6 +776,11 @@ absl::Status TensorsToDetectionsCalculator::LoadOptions(CalculatorContext* cc) {
     }
   }
 
+  allowed_class_indices_.clear();
+  for (int i = 0; i < num_classes_; ++i) {
+    if (IsClassIndexAllowed(i)) allowed_class_indices_.push_back(i);
+  }
+
   if (options_.has_tensor_mapping()) {
     RET_CHECK_OK(CheckCustomTensorMapping(options_.tensor_mapping()));
     tensor_mapping_ = options_.tensor_mapping();
@@ -771,93 +815,196 @@ absl::Status TensorsToDetectionsCalculator::LoadOptions(CalculatorContext* cc) {
   return absl::OkStatus();
 }
 
+void TensorsToDetectionsCalculator::SetAnchorArrays() {
+  const int num_anchors = anchors_.size();
+  anchor_arrays_.Resize(num_anchors);
+  for (int i = 0; i < num_anchors; ++i) {
+    anchor_arrays_.y_center[i] = anchors_[i].y_center();
+    anchor_arrays_.x_center[i] = anchors_[i].x_center();
+    anchor_arrays_.h[i] = anchors_[i].h();
+    anchor_arrays_.w[i] = anchors_[i].w();
+  }
+}
+
+template <typename Reader>
 absl::Status TensorsToDetectionsCalculator::DecodeBoxes(
-    const float* raw_boxes, const std::vector<Anchor>& anchors,
+    const Reader& raw_boxes, absl::Span<const int> box_indices,
     std::vector<float>* boxes) {
-  for (int i = 0; i < num_boxes_; ++i) {
-    const int box_offset = i * num_coords_ + options_.box_coord_offset();
-
-    float y_center = 0.0;
-    float x_center = 0.0;
-    float h = 0.0;
-    float w = 0.0;
-    // TODO
-    switch (box_output_format_) {
-      case mediapipe::TensorsToDetectionsCalculatorOptions::UNSPECIFIED:
-      case mediapipe::TensorsToDetectionsCalculatorOptions::YXHW:
-        y_center = raw_boxes[box_offset];
-        x_center = raw_boxes[box_offset + 1];
-        h = raw_boxes[box_offset + 2];
-        w = raw_boxes[box_offset + 3];
-        break;
-      case mediapipe::TensorsToDetectionsCalculatorOptions::XYWH:
-        x_center = raw_boxes[box_offset];
-        y_center = raw_boxes[box_offset + 1];
-        w = raw_boxes[box_offset + 2];
-        h = raw_boxes[box_offset + 3];
-        break;
-      case mediapipe::TensorsToDetectionsCalculatorOptions::XYXY:
-        x_center = (-raw_boxes[box_offset] + raw_boxes[box_offset + 2]) / 2;
-        y_center = (-raw_boxes[box_offset + 1] + raw_boxes[box_offset + 3]) / 2;
-        w = raw_boxes[box_offset + 2] + raw_boxes[box_offset];
-        h = raw_boxes[box_offset + 3] + raw_boxes[box_offset + 1];
-        break;
+  RET_CHECK_GE(anchor_arrays_.w.size(), num_boxes_)
+      << "Anchors are not initialized for CPU decoding.";
+  const int num_decoded = box_indices.size();
+  const float x_scale = options_.x_scale();
+  const float y_scale = options_.y_scale();
+  const float h_scale = options_.h_scale();
+  const float w_scale = options_.w_scale();
+  const int box_coord_offset = options_.box_coord_offset();
+  const int num_keypoints = options_.num_keypoints();
+  const int keypoint_coord_offset = options_.keypoint_coord_offset();
+  const int num_values_per_keypoint = options_.num_values_per_keypoint();
+
+  // Offsets of the values gathered into y_center, x_center, h and w within a
+  // raw box. XYXY boxes are gathered as ymin, xmin, ymax and xmax, and are
+  // converted below.
+  int y_offset = 0, x_offset = 1, h_offset = 2, w_offset = 3;
+  // Keypoints are stored as (y, x) for YXHW and as (x, y) otherwise.
+  int keypoint_x_index = 1, keypoint_y_index = 0;
+  switch (box_output_format_) {
+    case mediapipe::TensorsToDetectionsCalculatorOptions::UNSPECIFIED:
+    case mediapipe::TensorsToDetectionsCalculatorOptions::YXHW:
+      break;
+    case mediapipe::TensorsToDetectionsCalculatorOptions::XYWH:
+    case mediapipe::TensorsToDetectionsCalculatorOptions::XYXY:
+      y_offset = 1;
+      x_offset = 0;
+      h_offset = 3;
+      w_offset = 2;
+      keypoint_x_index = 0;
+      keypoint_y_index = 1;
+      break;
+  }
+
+  // Gathers the boxes to decode, and their anchors unless all the boxes are
+  // decoded, into contiguous arrays. The decoding loops below then only use
+  // unit-stride loads and no per-box branches.
+  const bool decode_all = num_decoded == num_boxes_;
+  CenterSizeArrays& box_arrays = candidate_boxes_;
+  box_arrays.Resize(num_decoded);
+  if (!decode_all) candidate_anchors_.Resize(num_decoded);
+  for (int j = 0; j < num_decoded; ++j) {
+    const int i = box_indices[j];
+    const int box_offset = i * num_coords_ + box_coord_offset;
+    box_arrays.y_center[j] = raw_boxes[box_offset + y_offset];
+    box_arrays.x_center[j] = raw_boxes[box_offset + x_offset];
+    box_arrays.h[j] = raw_boxes[box_offset + h_offset];
+    box_arrays.w[j] = raw_boxes[box_offset + w_offset];
+    if (!decode_all) {
+      candidate_anchors_.y_center[j] = anchor_arrays_.y_center[i];
+      candidate_anchors_.x_center[j] = anchor_arrays_.x_center[i];
+      candidate_anchors_.h[j] = anchor_arrays_.h[i];
+      candidate_anchors_.w[j] = anchor_arrays_.w[i];
     }
-    x_center =
-        x_center / options_.x_scale() * anchors[i].w() + anchors[i].x_center();
-    y_center =
-        y_center / options_.y_scale() * anchors[i].h() + anchors[i].y_center();
-
-    if (options_.apply_exponential_on_box_size()) {
-      h = std::exp(h / options_.h_scale()) * anchors[i].h();
-      w = std::exp(w / options_.w_scale()) * anchors[i].w();
-    } else {
-      h = h / options_.h_scale() * anchors[i].h();
-      w = w / options_.w_scale() * anchors[i].w();
+  }
+  // With all the boxes decoded, box_indices[j] == j.
+  const CenterSizeArrays& anchors =
+      decode_all ? anchor_arrays_ : candidate_anchors_;
+
+  float* y_center = box_arrays.y_center.data();
+  float* x_center = box_arrays.x_center.data();
+  float* h = box_arrays.h.data();
+  float* w = box_arrays.w.data();
+  const float* anchor_y_center = anchors.y_center.data();
+  const float* anchor_x_center = anchors.x_center.data();
+  const float* anchor_h = anchors.h.data();
+  const float* anchor_w = anchors.w.data();
+
+  if (box_output_format_ ==
+      mediapipe::TensorsToDetectionsCalculatorOptions::XYXY) {
+    for (int j = 0; j < num_decoded; ++j) {
+      const float ymin = y_center[j];
+      const float xmin = x_center[j];
+      const float ymax = h[j];
+      const float xmax = w[j];
+      x_center[j] = (-xmin + xmax) / 2;
+      y_center[j] = (-ymin + ymax) / 2;
+      w[j] = xmax + xmin;
+      h[j] = ymax + ymin;
     }
+  }
 
-    const float ymin = y_center - h / 2.f;
-    const float xmin = x_center - w / 2.f;
-    const float ymax = y_center + h / 2.f;
-    const float xmax = x_center + w / 2.f;
-
-    (*boxes)[i * num_coords_ + 0] = ymin;
-    (*boxes)[i * num_coords_ + 1] = xmin;
-    (*boxes)[i * num_coords_ + 2] = ymax;
-    (*boxes)[i * num_coords_ + 3] = xmax;
-
-    if (options_.num_keypoints()) {
-      for (int k = 0; k < options_.num_keypoints(); ++k) {
-        const int offset = i * num_coords_ + options_.keypoint_coord_offset() +
-                           k * options_.num_values_per_keypoint();
-
-        float keypoint_y = 0.0;
-        float keypoint_x = 0.0;
-        switch (box_output_format_) {
-          case mediapipe::TensorsToDetectionsCalculatorOptions::UNSPECIFIED:
-          case mediapipe::TensorsToDetectionsCalculatorOptions::YXHW:
-            keypoint_y = raw_boxes[offset];
-            keypoint_x = raw_boxes[offset + 1];
-            break;
-          case mediapipe::TensorsToDetectionsCalculatorOptions::XYWH:
-          case mediapipe::TensorsToDetectionsCalculatorOptions::XYXY:
-            keypoint_x = raw_boxes[offset];
-            keypoint_y = raw_boxes[offset + 1];
-            break;
-        }
+  for (int j = 0; j < num_decoded; ++j) {
+    x_center[j] = x_center[j] / x_scale * anchor_w[j] + anchor_x_center[j];
+    y_center[j] = y_center[j] / y_scale * anchor_h[j] + anchor_y_center[j];
+  }
+  if (options_.apply_exponential_on_box_size()) {
+    for (int j = 0; j < num_decoded; ++j) {
+      h[j] = std::exp(h[j] / h_scale) * anchor_h[j];
+      w[j] = std::exp(w[j] / w_scale) * anchor_w[j];
+    }
+  } else {
+    for (int j = 0; j < num_decoded; ++j) {
+      h[j] = h[j] / h_scale * anchor_h[j];
+      w[j] = w[j] / w_scale * anchor_w[j];
+    }
+  }
 
-        (*boxes)[offset] = keypoint_x / options_.x_scale() * anchors[i].w() +
-                           anchors[i].x_center();
-        (*boxes)[offset + 1] =
-            keypoint_y / options_.y_scale() * anchors[i].h() +
-            anchors[i].y_center();
-      }
+  float* decoded = boxes->data();
+  for (int j = 0; j < num_decoded; ++j) {
+    const int i = box_indices[j];
+    float* decoded_box = decoded + i * num_coords_;
+    decoded_box[0] = y_center[j] - h[j] / 2.f;  // ymin
+    decoded_box[1] = x_center[j] - w[j] / 2.f;  // xmin
+    decoded_box[2] = y_center[j] + h[j] / 2.f;  // ymax
+    decoded_box[3] = x_center[j] + w[j] / 2.f;  // xmax
+
+    for (int k = 0; k < num_keypoints; ++k) {
+      const int offset = keypoint_coord_offset + k * num_values_per_keypoint;
+      const float keypoint_x =
+          raw_boxes[i * num_coords_ + offset + keypoint_x_index];
+      const float keypoint_y =
+          raw_boxes[i * num_coords_ + offset + keypoint_y_index];
+      decoded_box[offset] =
+          keypoint_x / x_scale * anchor_w[j] + anchor_x_center[j];
+      decoded_box[offset + 1] =
+          keypoint_y / y_scale * anchor_h[j] + anchor_y_center[j];
     }
   }
 
   return absl::OkStatus();
 }
 
+template <typename Reader>
+void TensorsToDetectionsCalculator::ScoreBoxes(
+    const Reader& raw_scores, std::vector<float>* detection_scores,
+    std::vector<int>* detection_classes) {
+  using ValueType = typename Reader::ValueType;
+  const float clipping_thresh = options_.score_clipping_thresh();
+  auto transform_score = [&](float score) {
+    if (options_.sigmoid_score()) {
+      if (options_.has_score_clipping_thresh()) {
+        score = score < -clipping_thresh ? -clipping_thresh : score;
+        score = score > clipping_thresh ? clipping_thresh : score;
+      }
+      score = 1.0f / (1.0f + std::exp(-score));
+    }
+    return score;
+  };
+
+  // Filter classes by scores.
+  for (int i = 0; i < num_boxes_; ++i) {
+    int class_id = -1;
+    float max_score = -std::numeric_limits<float>::max();
+    if constexpr (std::is_same_v<ValueType, float>) {
+      // Find the top score for box i.
+      for (const int score_idx : allowed_class_indices_) {
+        const float score =
+            transform_score(raw_scores[i * num_classes_ + score_idx]);
+        if (max_score < score) {
+          max_score = score;
+          class_id = score_idx;
+        }
+      }
+    } else {
+      // Dequantization, clipping and sigmoid are all monotonic, so the top
+      // score is found on the quantized values and only the winner is
+      // transformed.
+      int max_value = std::numeric_limits<int>::min();
+      for (const int score_idx : allowed_class_indices_) {
+        const int value = raw_scores.raw(i * num_classes_ + score_idx);
+        if (max_value < value) {
+          max_value = value;
+          class_id = score_idx;
+        }
+      }
+      if (class_id >= 0) {
+        max_score = transform_score(
+            raw_scores.Dequantize(static_cast<ValueType>(max_value)));
+      }
+    }
+    (*detection_scores)[i] = max_score;
+    (*detection_classes)[i] = class_id;
+  }
+}
+
 absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
     const float* detection_boxes, const float* detection_scores,
     const int* detection_classes, std::vector<Detection>* output_detections) {
@@ -873,20 +1020,24 @@ absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
       continue;
     }
     const int box_offset = i * num_coords_;
-    Detection detection = ConvertToDetection(
-        /*box_ymin=*/detection_boxes[box_offset + box_indices_[0]],
-        /*box_xmin=*/detection_boxes[box_offset + box_indices_[1]],
-        /*box_ymax=*/detection_boxes[box_offset + box_indices_[2]],
-        /*box_xmax=*/detection_boxes[box_offset + box_indices_[3]],
-        detection_scores[i], detection_classes[i], options_.flip_vertically());
-    const auto& bbox = detection.location_data().relative_bounding_box();
-    if (bbox.width() < 0 || bbox.height() < 0 || std::isnan(bbox.width()) ||
-        std::isnan(bbox.height())) {
+    const float box_ymin = detection_boxes[box_offset + box_indices_[0]];
+    const float box_xmin = detection_boxes[box_offset + box_indices_[1]];
+    const float box_ymax = detection_boxes[box_offset + box_indices_[2]];
+    const float box_xmax = detection_boxes[box_offset + box_indices_[3]];
+    const float box_width = box_xmax - box_xmin;
+    const float box_height = box_ymax - box_ymin;
+    if (box_width < 0 || box_height < 0 || std::isnan(box_width) ||
+        std::isnan(box_height)) {
       // Decoded detection boxes could have negative values for width/height due
       // to model prediction. Filter out those boxes since some downstream
       // calculators may assume non-negative values. (b/171391719)
+      // The check is done before the Detection proto is allocated.
       continue;
     }
+    Detection detection =
+        ConvertToDetection(box_ymin, box_xmin, box_ymax, box_xmax,
+                           detection_scores[i], detection_classes[i],
+                           options_.flip_vertically());
     // Add keypoints.
     if (options_.num_keypoints() > 0) {
       auto* location_data = detection.mutable_location_data();
@@ -902,7 +1053,7 @@ absl::Status TensorsToDetectionsCalculator::ConvertToDetections(
                             : detection_boxes[keypoint_index + 1]);
       }
     }
-    output_detections->emplace_back(detection);
+    output_detections->push_back(std::move(detection));
   }
   return absl::OkStatus();
 }
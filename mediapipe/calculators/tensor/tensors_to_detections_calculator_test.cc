@@ -0,0 +1,530 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/substitute.h"
+#include "mediapipe/calculators/tensor/tensors_to_detections_calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/location_data.pb.h"
+#include "mediapipe/framework/formats/object_detection/anchor.pb.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using Node = ::mediapipe::CalculatorGraphConfig::Node;
+
+constexpr int kNumBoxes = 2;
+constexpr int kNumClasses = 2;
+constexpr float kTolerance = 1e-5;
+
+// Runs the calculator with `options` on `tensors`, decoding boxes with
+// `anchors`, and returns the detections.
+std::vector<Detection> RunCalculator(absl::string_view options,
+                                     std::vector<Tensor> tensors,
+                                     const std::vector<Anchor>& anchors) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(absl::Substitute(
+      R"pb(
+        calculator: "TensorsToDetectionsCalculator"
+        input_stream: "TENSORS:tensors"
+        input_side_packet: "ANCHORS:anchors"
+        output_stream: "DETECTIONS:detections"
+        options {
+          [mediapipe.TensorsToDetectionsCalculatorOptions.ext] { $0 }
+        }
+      )pb",
+      options)));
+  runner.MutableSidePackets()->Tag("ANCHORS") =
+      MakePacket<std::vector<Anchor>>(anchors);
+  runner.MutableInputs()->Tag("TENSORS").packets.push_back(
+      MakePacket<std::vector<Tensor>>(std::move(tensors)).At(Timestamp(0)));
+  MP_EXPECT_OK(runner.Run());
+  const auto& output_packets = runner.Outputs().Tag("DETECTIONS").packets;
+  EXPECT_EQ(output_packets.size(), 1);
+  if (output_packets.empty()) return {};
+  return output_packets[0].Get<std::vector<Detection>>();
+}
+
+template <typename T>
+Tensor CreateTensor(Tensor::ElementType element_type, Tensor::Shape shape,
+                    const std::vector<T>& values,
+                    const Tensor::QuantizationParameters& params = {}) {
+  Tensor tensor(element_type, std::move(shape), params);
+  auto view = tensor.GetCpuWriteView();
+  std::copy(values.begin(), values.end(), view.buffer<T>());
+  return tensor;
+}
+
+std::vector<Tensor> CreateFloatTensors(const std::vector<float>& boxes,
+                                       const std::vector<float>& scores,
+                                       int num_boxes = kNumBoxes) {
+  const int num_coords = boxes.size() / num_boxes;
+  const int num_classes = scores.size() / num_boxes;
+  std::vector<Tensor> tensors;
+  tensors.push_back(CreateTensor(Tensor::ElementType::kFloat32,
+                                 Tensor::Shape{1, num_boxes, num_coords},
+                                 boxes));
+  tensors.push_back(CreateTensor(Tensor::ElementType::kFloat32,
+                                 Tensor::Shape{1, num_boxes, num_classes},
+                                 scores));
+  return tensors;
+}
+
+Anchor CreateAnchor(float y_center, float x_center, float h, float w) {
+  Anchor anchor;
+  anchor.set_y_center(y_center);
+  anchor.set_x_center(x_center);
+  anchor.set_h(h);
+  anchor.set_w(w);
+  return anchor;
+}
+
+std::vector<Anchor> CreateAnchors() {
+  return {CreateAnchor(0.5f, 0.5f, 0.5f, 0.5f),
+          CreateAnchor(0.25f, 0.75f, 0.5f, 1.0f)};
+}
+
+void ExpectDetectionsEq(const std::vector<Detection>& detections,
+                        const std::vector<Detection>& expected_detections) {
+  ASSERT_EQ(detections.size(), expected_detections.size());
+  for (int i = 0; i < detections.size(); ++i) {
+    const Detection& detection = detections[i];
+    const Detection& expected = expected_detections[i];
+    EXPECT_THAT(detection.label_id(),
+                testing::ElementsAreArray(expected.label_id()));
+    ASSERT_EQ(detection.score_size(), 1);
+    EXPECT_NEAR(detection.score(0), expected.score(0), kTolerance);
+    const auto& box = detection.location_data().relative_bounding_box();
+    const auto& expected_box =
+        expected.location_data().relative_bounding_box();
+    EXPECT_NEAR(box.xmin(), expected_box.xmin(), kTolerance);
+    EXPECT_NEAR(box.ymin(), expected_box.ymin(), kTolerance);
+    EXPECT_NEAR(box.width(), expected_box.width(), kTolerance);
+    EXPECT_NEAR(box.height(), expected_box.height(), kTolerance);
+    const auto& keypoints = detection.location_data().relative_keypoints();
+    const auto& expected_keypoints =
+        expected.location_data().relative_keypoints();
+    ASSERT_EQ(keypoints.size(), expected_keypoints.size());
+    for (int k = 0; k < keypoints.size(); ++k) {
+      EXPECT_NEAR(keypoints[k].x(), expected_keypoints[k].x(), kTolerance);
+      EXPECT_NEAR(keypoints[k].y(), expected_keypoints[k].y(), kTolerance);
+    }
+  }
+}
+
+Detection CreateDetection(int label_id, float score, float xmin, float ymin,
+                          float width, float height, float keypoint_x,
+                          float keypoint_y) {
+  Detection detection;
+  detection.add_label_id(label_id);
+  detection.add_score(score);
+  LocationData* location_data = detection.mutable_location_data();
+  location_data->set_format(LocationData::RELATIVE_BOUNDING_BOX);
+  auto* box = location_data->mutable_relative_bounding_box();
+  box->set_xmin(xmin);
+  box->set_ymin(ymin);
+  box->set_width(width);
+  box->set_height(height);
+  auto* keypoint = location_data->add_relative_keypoints();
+  keypoint->set_x(keypoint_x);
+  keypoint->set_y(keypoint_y);
+  return detection;
+}
+
+constexpr char kDecodingOptions[] = R"pb(
+  num_classes: 2
+  num_boxes: 2
+  num_coords: 6
+  num_keypoints: 1
+  num_values_per_keypoint: 2
+  x_scale: 2.0
+  y_scale: 2.0
+  h_scale: 4.0
+  w_scale: 4.0
+)pb";
+
+// Raw boxes of (y, x, h, w, keypoint_y, keypoint_x), decoded with
+// kDecodingOptions and CreateAnchors() into DecodedDetections().
+const std::vector<float>& RawBoxes() {
+  static const auto* boxes = new std::vector<float>{
+      0.25f, -0.25f, 1.0f, 2.0f, 0.5f, 1.5f,
+      0.0f, 0.0f, 2.0f, 4.0f, -1.0f, 1.0f};
+  return *boxes;
+}
+const std::vector<float>& RawScores() {
+  static const auto* scores = new std::vector<float>{0.1f, 0.9f, 0.8f, 0.3f};
+  return *scores;
+}
+std::vector<Detection> DecodedDetections() {
+  return {CreateDetection(/*label_id=*/1, /*score=*/0.9f, /*xmin=*/0.3125f,
+                          /*ymin=*/0.5f, /*width=*/0.25f, /*height=*/0.125f,
+                          /*keypoint_x=*/0.875f, /*keypoint_y=*/0.625f),
+          CreateDetection(/*label_id=*/0, /*score=*/0.8f, /*xmin=*/0.25f,
+                          /*ymin=*/0.125f, /*width=*/1.0f, /*height=*/0.25f,
+                          /*keypoint_x=*/1.25f, /*keypoint_y=*/0.0f)};
+}
+
+TEST(TensorsToDetectionsCalculatorTest, DecodesBoxesAndKeypoints) {
+  ExpectDetectionsEq(RunCalculator(kDecodingOptions,
+                                   CreateFloatTensors(RawBoxes(), RawScores()),
+                                   CreateAnchors()),
+                     DecodedDetections());
+}
+
+TEST(TensorsToDetectionsCalculatorTest, ReverseOutputOrderReadsXBeforeY) {
+  // RawBoxes() as (x, y, w, h, keypoint_x, keypoint_y).
+  std::vector<float> boxes = RawBoxes();
+  for (int i = 0; i < boxes.size(); i += 2) std::swap(boxes[i], boxes[i + 1]);
+
+  ExpectDetectionsEq(
+      RunCalculator(
+          absl::StrCat(kDecodingOptions, "reverse_output_order: true"),
+          CreateFloatTensors(boxes, RawScores()), CreateAnchors()),
+      DecodedDetections());
+}
+
+TEST(TensorsToDetectionsCalculatorTest, FlipsVertically) {
+  std::vector<Detection> expected_detections = DecodedDetections();
+  for (Detection& detection : expected_detections) {
+    auto* location_data = detection.mutable_location_data();
+    auto* box = location_data->mutable_relative_bounding_box();
+    box->set_ymin(1.0f - box->ymin() - box->height());
+    auto* keypoint = location_data->mutable_relative_keypoints(0);
+    keypoint->set_y(1.0f - keypoint->y());
+  }
+
+  ExpectDetectionsEq(
+      RunCalculator(absl::StrCat(kDecodingOptions, "flip_vertically: true"),
+                    CreateFloatTensors(RawBoxes(), RawScores()),
+                    CreateAnchors()),
+      expected_detections);
+}
+
+TEST(TensorsToDetectionsCalculatorTest, ClipsSigmoidScoresAndThresholds) {
+  // Box 0 scores 5 for class 1, which is clipped to 2. Box 1 scores at most
+  // sigmoid(-1), which is below min_score_thresh.
+  const std::vector<float> scores = {0.0f, 5.0f, -5.0f, -1.0f};
+
+  const std::vector<Detection> detections = RunCalculator(
+      absl::StrCat(kDecodingOptions, R"pb(
+                     sigmoid_score: true
+                     score_clipping_thresh: 2.0
+                     min_score_thresh: 0.5
+                   )pb"),
+      CreateFloatTensors(RawBoxes(), scores), CreateAnchors());
+
+  ASSERT_EQ(detections.size(), 1);
+  EXPECT_THAT(detections[0].label_id(), testing::ElementsAre(1));
+  EXPECT_NEAR(detections[0].score(0), 1.0f / (1.0f + std::exp(-2.0f)),
+              kTolerance);
+}
+
+TEST(TensorsToDetectionsCalculatorTest, KeepsOnlyAllowedClasses) {
+  const std::vector<float> scores = {0.9f, 0.6f, 0.2f, 0.8f};
+
+  const std::vector<Detection> detections = RunCalculator(
+      absl::StrCat(kDecodingOptions, "allow_classes: 1"),
+      CreateFloatTensors(RawBoxes(), scores), CreateAnchors());
+
+  ASSERT_EQ(detections.size(), 2);
+  EXPECT_THAT(detections[0].label_id(), testing::ElementsAre(1));
+  EXPECT_FLOAT_EQ(detections[0].score(0), 0.6f);
+  EXPECT_THAT(detections[1].label_id(), testing::ElementsAre(1));
+  EXPECT_FLOAT_EQ(detections[1].score(0), 0.8f);
+}
+
+TEST(TensorsToDetectionsCalculatorTest, DropsIgnoredClasses) {
+  const std::vector<float> scores = {0.9f, 0.6f, 0.2f, 0.8f};
+
+  const std::vector<Detection> detections = RunCalculator(
+      absl::StrCat(kDecodingOptions, "ignore_classes: 1 min_score_thresh: 0.5"),
+      CreateFloatTensors(RawBoxes(), scores), CreateAnchors());
+
+  ASSERT_EQ(detections.size(), 1);
+  EXPECT_THAT(detections[0].label_id(), testing::ElementsAre(0));
+  EXPECT_FLOAT_EQ(detections[0].score(0), 0.9f);
+}
+
+// Decodes float tensors the way the calculator did before it scored boxes
+// ahead of decoding them: every box is decoded, then scored and filtered.
+std::vector<Detection> DecodeWithReferenceImplementation(
+    const TensorsToDetectionsCalculatorOptions& options,
+    const std::vector<float>& raw_boxes, const std::vector<float>& raw_scores,
+    const std::vector<Anchor>& anchors) {
+  const int num_boxes = options.num_boxes();
+  const int num_classes = options.num_classes();
+  const int num_coords = options.num_coords();
+  auto is_class_allowed = [&](int class_id) {
+    if (!options.allow_classes().empty()) {
+      return std::find(options.allow_classes().begin(),
+                       options.allow_classes().end(),
+                       class_id) != options.allow_classes().end();
+    }
+    return std::find(options.ignore_classes().begin(),
+                     options.ignore_classes().end(),
+                     class_id) == options.ignore_classes().end();
+  };
+
+  std::vector<float> boxes(num_boxes * num_coords);
+  for (int i = 0; i < num_boxes; ++i) {
+    const int box_offset = i * num_coords + options.box_coord_offset();
+    float y_center = raw_boxes[box_offset];
+    float x_center = raw_boxes[box_offset + 1];
+    float h = raw_boxes[box_offset + 2];
+    float w = raw_boxes[box_offset + 3];
+    if (options.reverse_output_order()) {
+      std::swap(x_center, y_center);
+      std::swap(w, h);
+    }
+    x_center = x_center / options.x_scale() * anchors[i].w() +
+               anchors[i].x_center();
+    y_center = y_center / options.y_scale() * anchors[i].h() +
+               anchors[i].y_center();
+    if (options.apply_exponential_on_box_size()) {
+      h = std::exp(h / options.h_scale()) * anchors[i].h();
+      w = std::exp(w / options.w_scale()) * anchors[i].w();
+    } else {
+      h = h / options.h_scale() * anchors[i].h();
+      w = w / options.w_scale() * anchors[i].w();
+    }
+    boxes[i * num_coords + 0] = y_center - h / 2.f;
+    boxes[i * num_coords + 1] = x_center - w / 2.f;
+    boxes[i * num_coords + 2] = y_center + h / 2.f;
+    boxes[i * num_coords + 3] = x_center + w / 2.f;
+    for (int k = 0; k < options.num_keypoints(); ++k) {
+      const int offset = i * num_coords + options.keypoint_coord_offset() +
+                         k * options.num_values_per_keypoint();
+      float keypoint_y = raw_boxes[offset];
+      float keypoint_x = raw_boxes[offset + 1];
+      if (options.reverse_output_order()) std::swap(keypoint_x, keypoint_y);
+      boxes[offset] = keypoint_x / options.x_scale() * anchors[i].w() +
+                      anchors[i].x_center();
+      boxes[offset + 1] = keypoint_y / options.y_scale() * anchors[i].h() +
+                          anchors[i].y_center();
+    }
+  }
+
+  std::vector<Detection> detections;
+  for (int i = 0; i < num_boxes; ++i) {
+    int class_id = -1;
+    float max_score = -std::numeric_limits<float>::max();
+    for (int c = 0; c < num_classes; ++c) {
+      if (!is_class_allowed(c)) continue;
+      float score = raw_scores[i * num_classes + c];
+      if (options.sigmoid_score()) {
+        if (options.has_score_clipping_thresh()) {
+          score = std::clamp(score, -options.score_clipping_thresh(),
+                             options.score_clipping_thresh());
+        }
+        score = 1.0f / (1.0f + std::exp(-score));
+      }
+      if (max_score < score) {
+        max_score = score;
+        class_id = c;
+      }
+    }
+
+    if (options.max_results() > 0 &&
+        detections.size() == options.max_results()) {
+      break;
+    }
+    if (options.has_min_score_thresh() &&
+        max_score < options.min_score_thresh()) {
+      continue;
+    }
+    if (!is_class_allowed(class_id)) continue;
+    const float* box = &boxes[i * num_coords];
+    const float width = box[3] - box[1];
+    const float height = box[2] - box[0];
+    if (width < 0 || height < 0 || std::isnan(width) || std::isnan(height)) {
+      continue;
+    }
+    Detection detection;
+    detection.add_score(max_score);
+    detection.add_label_id(class_id);
+    LocationData* location_data = detection.mutable_location_data();
+    location_data->set_format(LocationData::RELATIVE_BOUNDING_BOX);
+    auto* relative_box = location_data->mutable_relative_bounding_box();
+    relative_box->set_xmin(box[1]);
+    relative_box->set_ymin(options.flip_vertically() ? 1.f - box[2] : box[0]);
+    relative_box->set_width(width);
+    relative_box->set_height(height);
+    for (int k = 0; k < options.num_keypoints(); ++k) {
+      const float* keypoint = box + options.keypoint_coord_offset() +
+                              k * options.num_values_per_keypoint();
+      auto* relative_keypoint = location_data->add_relative_keypoints();
+      relative_keypoint->set_x(keypoint[0]);
+      relative_keypoint->set_y(options.flip_vertically() ? 1.f - keypoint[1]
+                                                         : keypoint[1]);
+    }
+    detections.push_back(std::move(detection));
+  }
+  return detections;
+}
+
+constexpr int kReferenceNumBoxes = 64;
+constexpr int kReferenceNumClasses = 3;
+
+constexpr char kReferenceOptions[] = R"pb(
+  num_classes: 3
+  num_boxes: 64
+  num_coords: 8
+  num_keypoints: 2
+  num_values_per_keypoint: 2
+  x_scale: 10.0
+  y_scale: 10.0
+  h_scale: 5.0
+  w_scale: 5.0
+)pb";
+
+class TensorsToDetectionsReferenceTest
+    : public ::testing::TestWithParam<const char*> {};
+
+TEST_P(TensorsToDetectionsReferenceTest, MatchesReferenceImplementation) {
+  const std::string options = absl::StrCat(kReferenceOptions, GetParam());
+  std::mt19937 rng(/*seed=*/42);
+  std::uniform_real_distribution<float> raw_value(-3.0f, 3.0f);
+  std::uniform_real_distribution<float> anchor_center(0.0f, 1.0f);
+  std::uniform_real_distribution<float> anchor_size(0.1f, 0.5f);
+  std::vector<float> boxes(kReferenceNumBoxes * 8);
+  for (float& value : boxes) value = raw_value(rng);
+  std::vector<float> scores(kReferenceNumBoxes * kReferenceNumClasses);
+  for (float& value : scores) value = raw_value(rng);
+  std::vector<Anchor> anchors;
+  for (int i = 0; i < kReferenceNumBoxes; ++i) {
+    anchors.push_back(CreateAnchor(anchor_center(rng), anchor_center(rng),
+                                   anchor_size(rng), anchor_size(rng)));
+  }
+
+  const std::vector<Detection> expected_detections =
+      DecodeWithReferenceImplementation(
+          ParseTextProtoOrDie<TensorsToDetectionsCalculatorOptions>(options),
+          boxes, scores, anchors);
+  ASSERT_FALSE(expected_detections.empty());
+  ExpectDetectionsEq(
+      RunCalculator(options,
+                    CreateFloatTensors(boxes, scores, kReferenceNumBoxes),
+                    anchors),
+      expected_detections);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    TensorsToDetectionsReferenceTests, TensorsToDetectionsReferenceTest,
+    ::testing::Values(
+        "",
+        "sigmoid_score: true score_clipping_thresh: 1.5 min_score_thresh: 0.6",
+        "reverse_output_order: true apply_exponential_on_box_size: true",
+        "flip_vertically: true min_score_thresh: 0.3",
+        "allow_classes: [ 0, 2 ] max_results: 5",
+        "ignore_classes: 1 sigmoid_score: true min_score_thresh: 0.5",
+        "max_results: 3"));
+
+constexpr char kQuantizedOptions[] = R"pb(
+  num_classes: 2
+  num_boxes: 2
+  num_coords: 6
+  num_keypoints: 1
+  num_values_per_keypoint: 2
+  x_scale: 1.0
+  y_scale: 1.0
+  h_scale: 1.0
+  w_scale: 1.0
+  sigmoid_score: true
+  score_clipping_thresh: 1.0
+  min_score_thresh: 0.7
+)pb";
+
+// Boxes and keypoints of (y, x, h, w, keypoint_y, keypoint_x) and raw scores,
+// as dequantized from the quantized tensors below.
+const std::vector<float>& FloatBoxes() {
+  static const auto* boxes = new std::vector<float>{
+      0.0f, 0.0f, 1.0f, 1.0f, 0.25f, -0.25f,
+      0.5f, -0.5f, 0.25f, 0.75f, 0.0f, 0.5f};
+  return *boxes;
+}
+const std::vector<float>& FloatScores() {
+  static const auto* scores =
+      new std::vector<float>{0.25f, 1.5f, 0.75f, -0.5f};
+  return *scores;
+}
+
+TEST(TensorsToDetectionsCalculatorTest, DecodesUInt8TensorsLikeFloatTensors) {
+  // scale * (value - zero_point) gives FloatBoxes() and FloatScores().
+  const std::vector<uint8_t> boxes = {4, 4, 8, 8, 5, 3, 6, 2, 5, 7, 4, 6};
+  const std::vector<uint8_t> scores = {66, 76, 70, 60};
+  std::vector<Tensor> tensors;
+  tensors.push_back(CreateTensor(Tensor::ElementType::kUInt8,
+                                 Tensor::Shape{1, kNumBoxes, 6}, boxes,
+                                 Tensor::QuantizationParameters(0.25f, 4)));
+  tensors.push_back(CreateTensor(Tensor::ElementType::kUInt8,
+                                 Tensor::Shape{1, kNumBoxes, kNumClasses},
+                                 scores,
+                                 Tensor::QuantizationParameters(0.125f, 64)));
+
+  const std::vector<Detection> detections =
+      RunCalculator(kQuantizedOptions, std::move(tensors), CreateAnchors());
+
+  const std::vector<Detection> expected_detections =
+      RunCalculator(kQuantizedOptions,
+                    CreateFloatTensors(FloatBoxes(), FloatScores()),
+                    CreateAnchors());
+  // Box 0 is detected as class 1, box 1 is below the threshold.
+  ASSERT_EQ(expected_detections.size(), 1);
+  EXPECT_THAT(expected_detections[0].label_id(), testing::ElementsAre(1));
+  ExpectDetectionsEq(detections, expected_detections);
+}
+
+TEST(TensorsToDetectionsCalculatorTest, DecodesInt8TensorsLikeFloatTensors) {
+  // scale * (value - zero_point) gives FloatBoxes() and FloatScores().
+  const std::vector<int8_t> boxes = {-4, -4, 0,  0, -3, -5,
+                                     -2, -6, -3, -1, -4, -2};
+  const std::vector<int8_t> scores = {2, 12, 6, -4};
+  std::vector<Tensor> tensors;
+  tensors.push_back(CreateTensor(Tensor::ElementType::kInt8,
+                                 Tensor::Shape{1, kNumBoxes, 6}, boxes,
+                                 Tensor::QuantizationParameters(0.25f, -4)));
+  tensors.push_back(CreateTensor(Tensor::ElementType::kInt8,
+                                 Tensor::Shape{1, kNumBoxes, kNumClasses},
+                                 scores,
+                                 Tensor::QuantizationParameters(0.125f, 0)));
+
+  const std::vector<Detection> detections =
+      RunCalculator(kQuantizedOptions, std::move(tensors), CreateAnchors());
+
+  ExpectDetectionsEq(
+      detections,
+      RunCalculator(kQuantizedOptions,
+                    CreateFloatTensors(FloatBoxes(), FloatScores()),
+                    CreateAnchors()));
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include "mediapipe/calculators/tensor/quantized_tensor_reader.h"
 #include "mediapipe/calculators/tensor/tensors_to_landmarks_calculator.pb.h"
 #include "mediapipe/framework/api2/node.h"
 #include "mediapipe/framework/calculator_framework.h"
@@ -47,8 +48,9 @@ float ApplyActivation(
 // the model.
 //
 // Input:
-//  TENSORS - Vector of Tensors of type kFloat32. Only the first tensor will be
-//  used. The size of the values must be (num_dimension x num_landmarks).
+//  TENSORS - Vector of Tensors of type kFloat32, kUInt8 or kInt8. Only the
+//  first tensor will be used. The size of the values must be (num_dimension x
+//  num_landmarks). Quantized tensors are dequantized on the fly.
 //
 //  FLIP_HORIZONTALLY (optional): Whether to flip landmarks horizontally or
 //  not. Overrides corresponding side packet and/or field in the calculator
@@ -139,45 +141,47 @@ absl::Status TensorsToLandmarksCalculator::Process(CalculatorContext* cc) {
   bool flip_vertically = kFlipVertically(cc).GetOr(options_.flip_vertically());
 
   const auto& input_tensors = *kInTensors(cc);
-  RET_CHECK(input_tensors[0].element_type() == Tensor::ElementType::kFloat32);
+  RET_CHECK(IsFloatOrQuantized(input_tensors[0].element_type()));
   int num_values = input_tensors[0].shape().num_elements();
   const int num_dimensions = num_values / num_landmarks_;
   ABSL_CHECK_GT(num_dimensions, 0);
 
-  auto view = input_tensors[0].GetCpuReadView();
-  auto raw_landmarks = view.buffer<float>();
-
   LandmarkList output_landmarks;
-
-  for (int ld = 0; ld < num_landmarks_; ++ld) {
-    const int offset = ld * num_dimensions;
-    Landmark* landmark = output_landmarks.add_landmark();
-
-    if (flip_horizontally) {
-      landmark->set_x(options_.input_image_width() - raw_landmarks[offset]);
-    } else {
-      landmark->set_x(raw_landmarks[offset]);
-    }
-    if (num_dimensions > 1) {
-      if (flip_vertically) {
-        landmark->set_y(options_.input_image_height() -
-                        raw_landmarks[offset + 1]);
-      } else {
-        landmark->set_y(raw_landmarks[offset + 1]);
-      }
-    }
-    if (num_dimensions > 2) {
-      landmark->set_z(raw_landmarks[offset + 2]);
-    }
-    if (num_dimensions > 3) {
-      landmark->set_visibility(ApplyActivation(options_.visibility_activation(),
-                                               raw_landmarks[offset + 3]));
-    }
-    if (num_dimensions > 4) {
-      landmark->set_presence(ApplyActivation(options_.presence_activation(),
-                                             raw_landmarks[offset + 4]));
-    }
-  }
+  MP_RETURN_IF_ERROR(VisitQuantizedTensorReader(
+      input_tensors[0], [&](const auto& raw_landmarks) {
+        for (int ld = 0; ld < num_landmarks_; ++ld) {
+          const int offset = ld * num_dimensions;
+          Landmark* landmark = output_landmarks.add_landmark();
+
+          if (flip_horizontally) {
+            landmark->set_x(options_.input_image_width() -
+                            raw_landmarks[offset]);
+          } else {
+            landmark->set_x(raw_landmarks[offset]);
+          }
+          if (num_dimensions > 1) {
+            if (flip_vertically) {
+              landmark->set_y(options_.input_image_height() -
+                              raw_landmarks[offset + 1]);
+            } else {
+              landmark->set_y(raw_landmarks[offset + 1]);
+            }
+          }
+          if (num_dimensions > 2) {
+            landmark->set_z(raw_landmarks[offset + 2]);
+          }
+          if (num_dimensions > 3) {
+            landmark->set_visibility(
+                ApplyActivation(options_.visibility_activation(),
+                                raw_landmarks[offset + 3]));
+          }
+          if (num_dimensions > 4) {
+            landmark->set_presence(ApplyActivation(
+                options_.presence_activation(), raw_landmarks[offset + 4]));
+          }
+        }
+        return absl::OkStatus();
+      }));
 
   // Output normalized landmarks if required.
   if (kOutNormalizedLandmarkList(cc).IsConnected()) {
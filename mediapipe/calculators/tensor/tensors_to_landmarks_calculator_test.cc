@@ -0,0 +1,137 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/landmark.pb.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using Node = ::mediapipe::CalculatorGraphConfig::Node;
+
+constexpr char kNodeConfig[] = R"pb(
+  calculator: "TensorsToLandmarksCalculator"
+  input_stream: "TENSORS:tensors"
+  output_stream: "LANDMARKS:landmarks"
+  output_stream: "NORM_LANDMARKS:norm_landmarks"
+  options {
+    [mediapipe.TensorsToLandmarksCalculatorOptions.ext] {
+      num_landmarks: 2
+      input_image_width: 10
+      input_image_height: 20
+      flip_horizontally: true
+      visibility_activation: SIGMOID
+    }
+  }
+)pb";
+
+// Runs the calculator on `tensor` and returns the normalized landmarks.
+NormalizedLandmarkList RunCalculator(Tensor tensor) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(kNodeConfig));
+  auto tensors = std::make_unique<std::vector<Tensor>>();
+  tensors->push_back(std::move(tensor));
+  runner.MutableInputs()->Tag("TENSORS").packets.push_back(
+      Adopt(tensors.release()).At(Timestamp(0)));
+  MP_EXPECT_OK(runner.Run());
+  const auto& output_packets = runner.Outputs().Tag("NORM_LANDMARKS").packets;
+  EXPECT_EQ(output_packets.size(), 1);
+  return output_packets[0].Get<NormalizedLandmarkList>();
+}
+
+template <typename T>
+Tensor CreateTensor(Tensor::ElementType element_type,
+                    const std::vector<T>& values,
+                    const Tensor::QuantizationParameters& params = {}) {
+  Tensor tensor(element_type,
+                Tensor::Shape{1, static_cast<int>(values.size())}, params);
+  auto view = tensor.GetCpuWriteView();
+  std::copy(values.begin(), values.end(), view.buffer<T>());
+  return tensor;
+}
+
+void ExpectLandmarksEq(const NormalizedLandmarkList& landmarks,
+                       const NormalizedLandmarkList& expected_landmarks) {
+  ASSERT_EQ(landmarks.landmark_size(), expected_landmarks.landmark_size());
+  for (int i = 0; i < landmarks.landmark_size(); ++i) {
+    const NormalizedLandmark& landmark = landmarks.landmark(i);
+    const NormalizedLandmark& expected = expected_landmarks.landmark(i);
+    EXPECT_FLOAT_EQ(landmark.x(), expected.x());
+    EXPECT_FLOAT_EQ(landmark.y(), expected.y());
+    EXPECT_FLOAT_EQ(landmark.z(), expected.z());
+    EXPECT_FLOAT_EQ(landmark.visibility(), expected.visibility());
+    EXPECT_FLOAT_EQ(landmark.presence(), expected.presence());
+  }
+}
+
+// Two landmarks of (x, y, z, visibility, presence), dequantized.
+const std::vector<float>& FloatValues() {
+  static const auto* values = new std::vector<float>{
+      2.5f, 5.0f, -1.0f, 0.5f, 0.0f, 7.5f, 15.0f, 2.0f, -3.0f, 1.0f};
+  return *values;
+}
+
+TEST(TensorsToLandmarksCalculatorTest, DecodesFloatTensor) {
+  const NormalizedLandmarkList landmarks = RunCalculator(
+      CreateTensor(Tensor::ElementType::kFloat32, FloatValues()));
+
+  ASSERT_EQ(landmarks.landmark_size(), 2);
+  EXPECT_FLOAT_EQ(landmarks.landmark(0).x(), (10 - 2.5f) / 10);
+  EXPECT_FLOAT_EQ(landmarks.landmark(0).y(), 5.0f / 20);
+  EXPECT_FLOAT_EQ(landmarks.landmark(0).z(), -1.0f / 10);
+  EXPECT_FLOAT_EQ(landmarks.landmark(0).visibility(),
+                  1.0f / (1.0f + std::exp(-0.5f)));
+  EXPECT_FLOAT_EQ(landmarks.landmark(0).presence(), 0.0f);
+  EXPECT_FLOAT_EQ(landmarks.landmark(1).x(), (10 - 7.5f) / 10);
+  EXPECT_FLOAT_EQ(landmarks.landmark(1).y(), 15.0f / 20);
+}
+
+TEST(TensorsToLandmarksCalculatorTest, DecodesUInt8TensorLikeFloatTensor) {
+  // scale * (value - zero_point) gives FloatValues().
+  const std::vector<uint8_t> values = {15, 20, 8, 11, 10, 25, 40, 14, 4, 12};
+  const NormalizedLandmarkList landmarks = RunCalculator(
+      CreateTensor(Tensor::ElementType::kUInt8, values,
+                   Tensor::QuantizationParameters(0.5f, 10)));
+
+  ExpectLandmarksEq(landmarks,
+                    RunCalculator(CreateTensor(Tensor::ElementType::kFloat32,
+                                               FloatValues())));
+}
+
+TEST(TensorsToLandmarksCalculatorTest, DecodesInt8TensorLikeFloatTensor) {
+  // scale * (value - zero_point) gives FloatValues().
+  const std::vector<int8_t> values = {-5, 0, -12, -9, -10,
+                                      5,  20, -6, -16, -8};
+  const NormalizedLandmarkList landmarks = RunCalculator(
+      CreateTensor(Tensor::ElementType::kInt8, values,
+                   Tensor::QuantizationParameters(0.5f, -10)));
+
+  ExpectLandmarksEq(landmarks,
+                    RunCalculator(CreateTensor(Tensor::ElementType::kFloat32,
+                                               FloatValues())));
+}
+
+}  // namespace
+}  // namespace mediapipe
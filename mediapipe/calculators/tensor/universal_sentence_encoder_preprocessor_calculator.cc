@@ -41,8 +41,9 @@ constexpr absl::string_view kResponseTextMetadataName = "res_text";
 
 constexpr int kNumInputTensorsForUniversalSentenceEncoder = 3;
 
-// Preprocesses input text into three kTfLiteString input tensors for a
-// Universal Sentence Encoder (USE) model.
+// Preprocesses input text into three kChar input tensors for a Universal
+// Sentence Encoder (USE) model. The inference runner writes each of them as the
+// single string of the corresponding kTfLiteString model input tensor.
 //
 // The associated USE model is expected to contain input tensors with metadata
 // names:
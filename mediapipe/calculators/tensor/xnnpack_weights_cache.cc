@@ -0,0 +1,136 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/xnnpack_weights_cache.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <utility>
+
+#include "absl/base/const_init.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/calculators/tensor/inference_interpreter_delegate_runner.h"
+#include "mediapipe/framework/port/ret_check.h"
+#include "tensorflow/lite/allocation.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/model_builder.h"
+
+namespace mediapipe {
+namespace {
+
+ABSL_CONST_INIT absl::Mutex caches_mutex(absl::kConstInit);
+
+// Identifies the weights packed into a cache by the address and the content
+// hash of the model buffer, and the delegate flags. XNNPACK looks up packed
+// weights by the address of the original weights, and packs them differently
+// depending on the flags. The content hash keeps a cache from being reused for
+// another model loaded at the address of a released one.
+using CacheKey = std::tuple<const void*, size_t, int32_t>;
+
+CacheKey GetCacheKey(const tflite::FlatBufferModel& model, int32_t flags) {
+  const tflite::Allocation* allocation = model.allocation();
+  if (allocation == nullptr) {
+    return {model.GetModel(), 0, flags};
+  }
+  const absl::string_view content(
+      static_cast<const char*>(allocation->base()), allocation->bytes());
+  return {content.data(), absl::Hash<absl::string_view>()(content), flags};
+}
+
+// The live caches.
+absl::flat_hash_map<CacheKey, std::weak_ptr<XnnpackWeightsCache>>& GetCaches()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(caches_mutex) {
+  static auto* caches =
+      new absl::flat_hash_map<CacheKey, std::weak_ptr<XnnpackWeightsCache>>();
+  return *caches;
+}
+
+}  // namespace
+
+/* static */
+std::shared_ptr<XnnpackWeightsCache> XnnpackWeightsCache::GetOrCreate(
+    const TfLiteModelPtr& model, int32_t flags) {
+  // Hashes the model content outside of the lock.
+  const CacheKey key = GetCacheKey(*model, flags);
+  absl::MutexLock lock(&caches_mutex);
+  auto& caches = GetCaches();
+  // Drops the expired caches, as their models may have been released.
+  for (auto it = caches.begin(); it != caches.end();) {
+    if (it->second.expired()) {
+      caches.erase(it++);
+    } else {
+      ++it;
+    }
+  }
+  std::weak_ptr<XnnpackWeightsCache>& entry = caches[key];
+  std::shared_ptr<XnnpackWeightsCache> cache = entry.lock();
+  if (cache == nullptr) {
+    cache =
+        std::shared_ptr<XnnpackWeightsCache>(new XnnpackWeightsCache(flags));
+    entry = cache;
+  }
+  return cache;
+}
+
+XnnpackWeightsCache::XnnpackWeightsCache(int32_t flags)
+    : flags_(flags), cache_(TfLiteXNNPackDelegateWeightsCacheCreate()) {}
+
+XnnpackWeightsCache::~XnnpackWeightsCache() {
+  TfLiteXNNPackDelegateWeightsCacheDelete(cache_);
+}
+
+absl::StatusOr<TfLiteDelegatePtr> XnnpackWeightsCache::CreateDelegate(
+    TfLiteXNNPackDelegateOptions options) {
+  RET_CHECK_EQ(options.flags, flags_)
+      << "The XNNPACK weights cache was created for other delegate flags.";
+  options.weights_cache = cache_;
+  return TfLiteDelegatePtr(
+      TfLiteXNNPackDelegateCreate(&options),
+      [cache = shared_from_this()](TfLiteOpaqueDelegate* delegate) {
+        TfLiteXNNPackDelegateDelete(delegate);
+      });
+}
+
+absl::StatusOr<std::unique_ptr<InferenceRunner>>
+XnnpackWeightsCache::CreateRunner(api2::Packet<TfLiteModelPtr> model,
+                                  api2::Packet<tflite::OpResolver> op_resolver,
+                                  TfLiteDelegatePtr delegate,
+                                  int interpreter_num_threads,
+                                  std::shared_ptr<TensorPool> tensor_pool,
+                                  bool enable_zero_copy_tensor_io) {
+  // The cache must be finalized before the first interpreter allocates its
+  // tensors, and no other delegate may pack weights into it concurrently.
+  absl::MutexLock lock(&mutex_);
+  return CreateInferenceInterpreterDelegateRunner(
+      std::move(model), std::move(op_resolver), std::move(delegate),
+      interpreter_num_threads, std::move(tensor_pool),
+      enable_zero_copy_tensor_io, [this]() -> absl::Status {
+        mutex_.AssertHeld();
+        if (!finalized_) {
+          RET_CHECK(TfLiteXNNPackDelegateWeightsCacheFinalizeHard(cache_))
+              << "Failed to finalize the XNNPACK weights cache.";
+          finalized_ = true;
+        }
+        return absl::OkStatus();
+      });
+}
+
+}  // namespace mediapipe
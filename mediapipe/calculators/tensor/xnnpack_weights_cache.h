@@ -0,0 +1,85 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
+#define MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
+
+#include <cstdint>
+#include <memory>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/status/statusor.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/calculators/tensor/tflite_delegate_ptr.h"
+#include "mediapipe/framework/api2/packet.h"
+#include "mediapipe/framework/formats/tensor_pool.h"
+#include "mediapipe/util/tflite/tflite_model_loader.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+
+namespace mediapipe {
+
+// Cache of the weights packed by the XNNPACK delegates running a model.
+//
+// XNNPACK repacks the weights of a model into its own layout whenever a
+// delegate is applied to an interpreter. The cache is shared by all the
+// delegates created with the same flags for the same model content in the
+// process: the first interpreter packs the weights into the cache, and later
+// ones only look them up.
+//
+// XNNPACK finds packed weights by the address of the original weights, so
+// models with the same content only share a cache if they share their
+// buffer, e.g. ModelResources created while SetModelSharingEnabled(true).
+class XnnpackWeightsCache
+    : public std::enable_shared_from_this<XnnpackWeightsCache> {
+ public:
+  // Returns the cache of `model` for delegates created with `flags`, the
+  // TfLiteXNNPackDelegateOptions::flags, creating it if needed. The cache is
+  // released once no caller or delegate references it anymore.
+  static std::shared_ptr<XnnpackWeightsCache> GetOrCreate(
+      const TfLiteModelPtr& model, int32_t flags);
+
+  ~XnnpackWeightsCache();
+  XnnpackWeightsCache(const XnnpackWeightsCache&) = delete;
+  XnnpackWeightsCache& operator=(const XnnpackWeightsCache&) = delete;
+
+  // Creates an XNNPACK delegate from `options` using this cache. The options
+  // must have the flags the cache was obtained for. The delegate keeps the
+  // cache alive.
+  absl::StatusOr<TfLiteDelegatePtr> CreateDelegate(
+      TfLiteXNNPackDelegateOptions options);
+
+  // Same as CreateInferenceInterpreterDelegateRunner for a `delegate` created
+  // by CreateDelegate. The cache is finalized once the first interpreter has
+  // packed the weights into it. Runners sharing the cache are created one at
+  // a time.
+  absl::StatusOr<std::unique_ptr<InferenceRunner>> CreateRunner(
+      api2::Packet<TfLiteModelPtr> model,
+      api2::Packet<tflite::OpResolver> op_resolver, TfLiteDelegatePtr delegate,
+      int interpreter_num_threads, std::shared_ptr<TensorPool> tensor_pool,
+      bool enable_zero_copy_tensor_io);
+
+ private:
+  explicit XnnpackWeightsCache(int32_t flags);
+
+  absl::Mutex mutex_;
+  const int32_t flags_;
+  TfLiteXNNPackDelegateWeightsCache* const cache_;
+  bool finalized_ ABSL_GUARDED_BY(mutex_) = false;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_CALCULATORS_TENSOR_XNNPACK_WEIGHTS_CACHE_H_
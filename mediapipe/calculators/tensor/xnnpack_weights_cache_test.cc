@@ -0,0 +1,120 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/calculators/tensor/xnnpack_weights_cache.h"
+
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "mediapipe/calculators/tensor/inference_runner.h"
+#include "mediapipe/calculators/tensor/tflite_delegate_ptr.h"
+#include "mediapipe/framework/api2/packet.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/util/tflite/tflite_model_loader.h"
+#include "tensorflow/lite/core/api/op_resolver.h"
+#include "tensorflow/lite/delegates/xnnpack/xnnpack_delegate.h"
+#include "tensorflow/lite/kernels/register.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr char kModelPath[] = "mediapipe/calculators/tensor/testdata/add.bin";
+
+api2::Packet<tflite::OpResolver> CreateOpResolverPacket() {
+  return api2::PacketAdopting<tflite::OpResolver>(
+      std::make_unique<
+          tflite::ops::builtin::BuiltinOpResolverWithoutDefaultDelegates>());
+}
+
+TEST(XnnpackWeightsCacheTest, SharesCacheOfModelWithSameFlags) {
+  MP_ASSERT_OK_AND_ASSIGN(auto model,
+                          TfLiteModelLoader::LoadFromPath(kModelPath));
+
+  auto cache = XnnpackWeightsCache::GetOrCreate(*model.Get(), /*flags=*/0);
+
+  EXPECT_EQ(XnnpackWeightsCache::GetOrCreate(*model.Get(), /*flags=*/0),
+            cache);
+  EXPECT_NE(XnnpackWeightsCache::GetOrCreate(
+                *model.Get(), TFLITE_XNNPACK_DELEGATE_FLAG_QS8),
+            cache);
+}
+
+TEST(XnnpackWeightsCacheTest, DoesNotShareCacheOfSeparatelyLoadedModels) {
+  MP_ASSERT_OK_AND_ASSIGN(auto model1,
+                          TfLiteModelLoader::LoadFromPath(kModelPath));
+  MP_ASSERT_OK_AND_ASSIGN(auto model2,
+                          TfLiteModelLoader::LoadFromPath(kModelPath));
+
+  // XNNPACK finds packed weights by their address in the model buffer.
+  EXPECT_NE(XnnpackWeightsCache::GetOrCreate(*model1.Get(), /*flags=*/0),
+            XnnpackWeightsCache::GetOrCreate(*model2.Get(), /*flags=*/0));
+}
+
+TEST(XnnpackWeightsCacheTest, ReleasesCacheWithLastDelegate) {
+  MP_ASSERT_OK_AND_ASSIGN(auto model,
+                          TfLiteModelLoader::LoadFromPath(kModelPath));
+  auto cache = XnnpackWeightsCache::GetOrCreate(*model.Get(), /*flags=*/0);
+  MP_ASSERT_OK_AND_ASSIGN(
+      TfLiteDelegatePtr delegate,
+      cache->CreateDelegate(TfLiteXNNPackDelegateOptionsDefault()));
+  std::weak_ptr<XnnpackWeightsCache> weak_cache = cache;
+
+  cache.reset();
+  EXPECT_FALSE(weak_cache.expired());
+  delegate.reset();
+  EXPECT_TRUE(weak_cache.expired());
+}
+
+TEST(XnnpackWeightsCacheTest, FailsToCreateDelegateWithOtherFlags) {
+  MP_ASSERT_OK_AND_ASSIGN(auto model,
+                          TfLiteModelLoader::LoadFromPath(kModelPath));
+  auto cache = XnnpackWeightsCache::GetOrCreate(*model.Get(), /*flags=*/0);
+  auto options = TfLiteXNNPackDelegateOptionsDefault();
+  options.flags = TFLITE_XNNPACK_DELEGATE_FLAG_QS8;
+
+  EXPECT_FALSE(cache->CreateDelegate(options).ok());
+}
+
+TEST(XnnpackWeightsCacheTest, RunnersReusePackedWeightsOfEachFlagSet) {
+  MP_ASSERT_OK_AND_ASSIGN(auto model,
+                          TfLiteModelLoader::LoadFromPath(kModelPath));
+  std::vector<std::unique_ptr<InferenceRunner>> runners;
+  for (int32_t flags : {0, TFLITE_XNNPACK_DELEGATE_FLAG_QS8}) {
+    auto options = TfLiteXNNPackDelegateOptionsDefault();
+    options.flags = flags;
+    // The first runner of each flag set packs the weights and finalizes its
+    // cache. The later ones can only be created if they find all the packed
+    // weights in the finalized cache.
+    for (int i = 0; i < 3; ++i) {
+      auto cache = XnnpackWeightsCache::GetOrCreate(*model.Get(), flags);
+      MP_ASSERT_OK_AND_ASSIGN(TfLiteDelegatePtr delegate,
+                              cache->CreateDelegate(options));
+      MP_ASSERT_OK_AND_ASSIGN(
+          auto runner,
+          cache->CreateRunner(model, CreateOpResolverPacket(),
+                              std::move(delegate),
+                              /*interpreter_num_threads=*/1,
+                              /*tensor_pool=*/nullptr,
+                              /*enable_zero_copy_tensor_io=*/false));
+      runners.push_back(std::move(runner));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace mediapipe
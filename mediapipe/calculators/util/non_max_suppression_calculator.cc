@@ -18,6 +18,7 @@
 #include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/log/absl_check.h"
 #include "absl/log/absl_log.h"
 #include "mediapipe/calculators/util/non_max_suppression_calculator.pb.h"
@@ -27,11 +28,11 @@
 #include "mediapipe/framework/formats/location.h"
 #include "mediapipe/framework/port/rectangle.h"
 #include "mediapipe/framework/port/status.h"
+#include "mediapipe/util/non_max_suppression.h"
 
 namespace mediapipe {
 
 typedef std::vector<Detection> Detections;
-typedef std::vector<std::pair<int, float>> IndexedScores;
 
 namespace {
 
@@ -74,51 +75,19 @@ bool RetainMaxScoringLabelOnly(Detection* detection) {
   return true;
 }
 
-// Computes an overlap similarity between two rectangles. Similarity measure is
-// defined by overlap_type parameter.
-float OverlapSimilarity(
-    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type,
-    const Rectangle_f& rect1, const Rectangle_f& rect2) {
-  if (!rect1.Intersects(rect2)) return 0.0f;
-  const float intersection_area = Rectangle_f(rect1).Intersect(rect2).Area();
-  float normalization;
+NmsOverlapType GetNmsOverlapType(
+    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type) {
   switch (overlap_type) {
     case NonMaxSuppressionCalculatorOptions::JACCARD:
-      normalization = Rectangle_f(rect1).Union(rect2).Area();
-      break;
+      return NmsOverlapType::kJaccard;
     case NonMaxSuppressionCalculatorOptions::MODIFIED_JACCARD:
-      normalization = rect2.Area();
-      break;
+      return NmsOverlapType::kModifiedJaccard;
     case NonMaxSuppressionCalculatorOptions::INTERSECTION_OVER_UNION:
-      normalization = rect1.Area() + rect2.Area() - intersection_area;
-      break;
+      return NmsOverlapType::kIntersectionOverUnion;
     default:
       ABSL_LOG(FATAL) << "Unrecognized overlap type: " << overlap_type;
   }
-  return normalization > 0.0f ? intersection_area / normalization : 0.0f;
-}
-
-// Computes an overlap similarity between two locations by first extracting the
-// relative box (dimension normalized by frame width/height) from the location.
-float OverlapSimilarity(
-    const int frame_width, const int frame_height,
-    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type,
-    const Location& location1, const Location& location2) {
-  const auto rect1 = location1.ConvertToRelativeBBox(frame_width, frame_height);
-  const auto rect2 = location2.ConvertToRelativeBBox(frame_width, frame_height);
-  return OverlapSimilarity(overlap_type, rect1, rect2);
-}
-
-// Computes an overlap similarity between two locations by first extracting the
-// relative box from the location. It assumes that a relative-box representation
-// is already available in the location, and therefore frame width and height
-// are not needed for further normalization.
-float OverlapSimilarity(
-    const NonMaxSuppressionCalculatorOptions::OverlapType overlap_type,
-    const Location& location1, const Location& location2) {
-  const auto rect1 = location1.GetRelativeBBox();
-  const auto rect2 = location2.GetRelativeBBox();
-  return OverlapSimilarity(overlap_type, rect1, rect2);
+  return NmsOverlapType::kJaccard;
 }
 
 }  // namespace
@@ -215,33 +184,58 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
       }
     }
 
-    // Copy all the scores (there is a single score in each detection after
-    // the above pruning) to an indexed vector for sorting. The first value is
-    // the index of the detection in the original vector from which the score
-    // stems, while the second is the actual score.
-    IndexedScores indexed_scores;
-    indexed_scores.reserve(pruned_detections.size());
-    for (int index = 0; index < pruned_detections.size(); ++index) {
-      indexed_scores.push_back(
-          std::make_pair(index, pruned_detections[index].score(0)));
+    // Gather the boxes and scores (there is a single score in each detection
+    // after the above pruning) into flat arrays for the suppression.
+    std::vector<Rectangle_f> boxes;
+    std::vector<float> scores;
+    std::vector<int> classes;
+    boxes.reserve(pruned_detections.size());
+    scores.reserve(pruned_detections.size());
+    const bool use_frame_size =
+        options_.algorithm() != NonMaxSuppressionCalculatorOptions::WEIGHTED &&
+        cc->Inputs().HasTag(kImageTag);
+    for (const auto& detection : pruned_detections) {
+      const Location location(detection.location_data());
+      if (use_frame_size) {
+        const auto& frame = cc->Inputs().Tag(kImageTag).Get<ImageFrame>();
+        boxes.push_back(
+            location.ConvertToRelativeBBox(frame.Width(), frame.Height()));
+      } else {
+        // Assumes that a relative-box representation is already available in
+        // the location, and therefore frame width and height are not needed.
+        boxes.push_back(location.GetRelativeBBox());
+      }
+      scores.push_back(detection.score(0));
+    }
+    if (options_.class_aware()) {
+      classes = GetClassIndices(pruned_detections);
     }
-    std::sort(indexed_scores.begin(), indexed_scores.end(), SortBySecond);
 
-    const int max_num_detections =
-        (options_.max_num_detections() > -1)
-            ? options_.max_num_detections()
-            : static_cast<int>(indexed_scores.size());
-    // A set of detections and locations, wrapping the location data from each
-    // detection, which are retained after the non-maximum suppression.
-    auto* retained_detections = new Detections();
-    retained_detections->reserve(max_num_detections);
+    NmsOptions nms_options;
+    nms_options.overlap_type = GetNmsOverlapType(options_.overlap_type());
+    nms_options.min_suppression_threshold =
+        options_.min_suppression_threshold();
+    nms_options.min_score_threshold = options_.min_score_threshold();
+    nms_options.max_num_detections = options_.max_num_detections();
+    nms_options.class_aware = options_.class_aware();
+    const NmsInput nms_input{boxes, scores, classes};
 
+    auto* retained_detections = new Detections();
     if (options_.algorithm() == NonMaxSuppressionCalculatorOptions::WEIGHTED) {
-      WeightedNonMaxSuppression(indexed_scores, pruned_detections,
-                                max_num_detections, cc, retained_detections);
+      // Weighted suppression does not limit the number of detections.
+      nms_options.max_num_detections = -1;
+      for (const auto& cluster :
+           WeightedNonMaxSuppression(nms_input, nms_options)) {
+        retained_detections->push_back(
+            WeightedDetection(cluster, pruned_detections, scores));
+      }
     } else {
-      NonMaxSuppression(indexed_scores, pruned_detections, max_num_detections,
-                        cc, retained_detections);
+      const std::vector<int> retained =
+          NonMaxSuppression(nms_input, nms_options);
+      retained_detections->reserve(retained.size());
+      for (int index : retained) {
+        retained_detections->push_back(std::move(pruned_detections[index]));
+      }
     }
 
     cc->Outputs().Index(0).Add(retained_detections, cc->InputTimestamp());
@@ -250,133 +244,83 @@ class NonMaxSuppressionCalculator : public CalculatorBase {
   }
 
  private:
-  void NonMaxSuppression(const IndexedScores& indexed_scores,
-                         const Detections& detections, int max_num_detections,
-                         CalculatorContext* cc, Detections* output_detections) {
-    std::vector<Location> retained_locations;
-    retained_locations.reserve(max_num_detections);
-    // We traverse the detections by decreasing score.
-    for (const auto& indexed_score : indexed_scores) {
-      const auto& detection = detections[indexed_score.first];
-      if (options_.min_score_threshold() > 0 &&
-          detection.score(0) < options_.min_score_threshold()) {
-        break;
-      }
-      const Location location(detection.location_data());
-      bool suppressed = false;
-      // The current detection is suppressed iff there exists a retained
-      // detection, whose location overlaps more than the specified
-      // threshold with the location of the current detection.
-      for (const auto& retained_location : retained_locations) {
-        float similarity;
-        if (cc->Inputs().HasTag(kImageTag)) {
-          const auto& frame = cc->Inputs().Tag(kImageTag).Get<ImageFrame>();
-          similarity = OverlapSimilarity(frame.Width(), frame.Height(),
-                                         options_.overlap_type(),
-                                         retained_location, location);
-        } else {
-          similarity = OverlapSimilarity(options_.overlap_type(),
-                                         retained_location, location);
-        }
-        if (similarity > options_.min_suppression_threshold()) {
-          suppressed = true;
-          break;
-        }
-      }
-      if (!suppressed) {
-        output_detections->push_back(detection);
-        retained_locations.push_back(location);
-      }
-      if (output_detections->size() >= max_num_detections) {
-        break;
+  // Returns a class index per detection, identifying its label id or, if it
+  // has none, its label. Detections with neither share a single class.
+  static std::vector<int> GetClassIndices(const Detections& detections) {
+    std::vector<int> classes;
+    classes.reserve(detections.size());
+    absl::flat_hash_map<int, int> label_id_indices;
+    absl::flat_hash_map<std::string, int> label_indices;
+    int num_classes = 0;
+    int unlabeled_class = -1;
+    for (const auto& detection : detections) {
+      int* class_index;
+      if (detection.label_id_size() > 0) {
+        class_index =
+            &label_id_indices.try_emplace(detection.label_id(0), num_classes)
+                 .first->second;
+      } else if (detection.label_size() > 0) {
+        class_index =
+            &label_indices.try_emplace(detection.label(0), num_classes)
+                 .first->second;
+      } else {
+        if (unlabeled_class < 0) unlabeled_class = num_classes;
+        class_index = &unlabeled_class;
       }
+      if (*class_index == num_classes) ++num_classes;
+      classes.push_back(*class_index);
     }
+    return classes;
   }
 
-  void WeightedNonMaxSuppression(const IndexedScores& indexed_scores,
-                                 const Detections& detections,
-                                 int max_num_detections, CalculatorContext* cc,
-                                 Detections* output_detections) {
-    IndexedScores remained_indexed_scores;
-    remained_indexed_scores.assign(indexed_scores.begin(),
-                                   indexed_scores.end());
-
-    IndexedScores remained;
-    IndexedScores candidates;
-    output_detections->clear();
-    while (!remained_indexed_scores.empty()) {
-      const int original_indexed_scores_size = remained_indexed_scores.size();
-      const auto& detection = detections[remained_indexed_scores[0].first];
-      if (options_.min_score_threshold() > 0 &&
-          detection.score(0) < options_.min_score_threshold()) {
-        break;
-      }
-      remained.clear();
-      candidates.clear();
-      const Location location(detection.location_data());
-      // This includes the first box.
-      for (const auto& indexed_score : remained_indexed_scores) {
-        Location rest_location(detections[indexed_score.first].location_data());
-        float similarity =
-            OverlapSimilarity(options_.overlap_type(), rest_location, location);
-        if (similarity > options_.min_suppression_threshold()) {
-          candidates.push_back(indexed_score);
-        } else {
-          remained.push_back(indexed_score);
-        }
-      }
-      auto weighted_detection = detection;
-      if (!candidates.empty()) {
-        const int num_keypoints =
-            detection.location_data().relative_keypoints_size();
-        std::vector<float> keypoints(num_keypoints * 2);
-        float w_xmin = 0.0f;
-        float w_ymin = 0.0f;
-        float w_xmax = 0.0f;
-        float w_ymax = 0.0f;
-        float total_score = 0.0f;
-        for (const auto& candidate : candidates) {
-          total_score += candidate.second;
-          const auto& location_data =
-              detections[candidate.first].location_data();
-          const auto& bbox = location_data.relative_bounding_box();
-          w_xmin += bbox.xmin() * candidate.second;
-          w_ymin += bbox.ymin() * candidate.second;
-          w_xmax += (bbox.xmin() + bbox.width()) * candidate.second;
-          w_ymax += (bbox.ymin() + bbox.height()) * candidate.second;
-
-          for (int i = 0; i < num_keypoints; ++i) {
-            keypoints[i * 2] +=
-                location_data.relative_keypoints(i).x() * candidate.second;
-            keypoints[i * 2 + 1] +=
-                location_data.relative_keypoints(i).y() * candidate.second;
-          }
-        }
-        auto* weighted_location = weighted_detection.mutable_location_data()
-                                      ->mutable_relative_bounding_box();
-        weighted_location->set_xmin(w_xmin / total_score);
-        weighted_location->set_ymin(w_ymin / total_score);
-        weighted_location->set_width((w_xmax / total_score) -
-                                     weighted_location->xmin());
-        weighted_location->set_height((w_ymax / total_score) -
-                                      weighted_location->ymin());
-        for (int i = 0; i < num_keypoints; ++i) {
-          auto* keypoint = weighted_detection.mutable_location_data()
-                               ->mutable_relative_keypoints(i);
-          keypoint->set_x(keypoints[i * 2] / total_score);
-          keypoint->set_y(keypoints[i * 2 + 1] / total_score);
-        }
-      }
-
-      output_detections->push_back(weighted_detection);
-      // Breaks the loop if the size of indexed scores doesn't change after an
-      // iteration.
-      if (original_indexed_scores_size == remained.size()) {
-        break;
-      } else {
-        remained_indexed_scores = std::move(remained);
+  // Returns the highest scoring detection of the cluster, with its location
+  // replaced by the score-weighted average of the cluster members.
+  static Detection WeightedDetection(const NmsCluster& cluster,
+                                     const Detections& detections,
+                                     const std::vector<float>& scores) {
+    const auto& detection = detections[cluster.index];
+    auto weighted_detection = detection;
+    if (cluster.members.empty()) {
+      return weighted_detection;
+    }
+    const int num_keypoints =
+        detection.location_data().relative_keypoints_size();
+    std::vector<float> keypoints(num_keypoints * 2);
+    float w_xmin = 0.0f;
+    float w_ymin = 0.0f;
+    float w_xmax = 0.0f;
+    float w_ymax = 0.0f;
+    float total_score = 0.0f;
+    for (int member : cluster.members) {
+      const float score = scores[member];
+      total_score += score;
+      const auto& location_data = detections[member].location_data();
+      const auto& bbox = location_data.relative_bounding_box();
+      w_xmin += bbox.xmin() * score;
+      w_ymin += bbox.ymin() * score;
+      w_xmax += (bbox.xmin() + bbox.width()) * score;
+      w_ymax += (bbox.ymin() + bbox.height()) * score;
+
+      for (int i = 0; i < num_keypoints; ++i) {
+        keypoints[i * 2] += location_data.relative_keypoints(i).x() * score;
+        keypoints[i * 2 + 1] += location_data.relative_keypoints(i).y() * score;
       }
     }
+    auto* weighted_location = weighted_detection.mutable_location_data()
+                                  ->mutable_relative_bounding_box();
+    weighted_location->set_xmin(w_xmin / total_score);
+    weighted_location->set_ymin(w_ymin / total_score);
+    weighted_location->set_width((w_xmax / total_score) -
+                                 weighted_location->xmin());
+    weighted_location->set_height((w_ymax / total_score) -
+                                  weighted_location->ymin());
+    for (int i = 0; i < num_keypoints; ++i) {
+      auto* keypoint = weighted_detection.mutable_location_data()
+                           ->mutable_relative_keypoints(i);
+      keypoint->set_x(keypoints[i * 2] / total_score);
+      keypoint->set_y(keypoints[i * 2 + 1] / total_score);
+    }
+    return weighted_detection;
   }
 
   NonMaxSuppressionCalculatorOptions options_;
@@ -406,6 +406,8 @@ void Tensor::Move(Tensor* src) {
   src->element_type_ = ElementType::kNone;  // Mark as invalidated.
   cpu_buffer_ = src->cpu_buffer_;
   src->cpu_buffer_ = nullptr;
+  cpu_buffer_release_ = std::move(src->cpu_buffer_release_);
+  src->cpu_buffer_release_ = nullptr;
   ahwb_tracking_key_ = src->ahwb_tracking_key_;
   mtl_resources_ = std::move(src->mtl_resources_);
   MoveAhwbStuff(src);
@@ -446,10 +448,13 @@ void Tensor::Invalidate() {
     absl::MutexLock lock(&view_mutex_);
     // If memory is allocated and not owned by the metal buffer.
     // TODO: Re-design cpu buffer memory management.
-    if (cpu_buffer_ && !mtl_resources_->metal_buffer) {
+    if (cpu_buffer_release_) {
+      if (cpu_buffer_) cpu_buffer_release_(cpu_buffer_);
+    } else if (cpu_buffer_ && !mtl_resources_->metal_buffer) {
       DeallocateVirtualMemory(cpu_buffer_, AlignToPageSize(bytes()));
     }
     cpu_buffer_ = nullptr;
+    cpu_buffer_release_ = nullptr;
     // This becomes NULL if the tensor is moved.
     if (mtl_resources_) {
       mtl_resources_->metal_buffer = nil;
@@ -521,9 +526,14 @@ void Tensor::Invalidate() {
 #endif  // MEDIAPIPE_OPENGL_ES_VERSION >= MEDIAPIPE_OPENGL_ES_31
 
   if (cpu_buffer_) {
-    free(cpu_buffer_);
+    if (cpu_buffer_release_) {
+      cpu_buffer_release_(cpu_buffer_);
+    } else {
+      free(cpu_buffer_);
+    }
   }
   cpu_buffer_ = nullptr;
+  cpu_buffer_release_ = nullptr;
 }
 #endif  // MEDIAPIPE_METAL_ENABLED
 
@@ -93,6 +93,7 @@ namespace mediapipe {
 // ...reading the cpu memory...
 
 struct MtlResources;
+class TensorPool;
 class Tensor {
   class View {
    public:
@@ -355,6 +356,8 @@ class Tensor {
 
  private:
   friend class MtlBufferView;
+  // Supplies cpu_buffer_ and cpu_buffer_release_ for recycled tensors.
+  friend class TensorPool;
   void Move(Tensor*);
   void Invalidate();
 
@@ -378,6 +381,9 @@ class Tensor {
   mutable absl::Mutex view_mutex_;
 
   mutable void* cpu_buffer_ = nullptr;
+  // If set, cpu_buffer_ is externally owned and is handed to this callback
+  // instead of being freed when the tensor is invalidated.
+  mutable std::function<void(void*)> cpu_buffer_release_;
   void AllocateCpuBuffer() const;
   // Forward declaration of the MtlResources provides compile-time verification
   // of ODR if this header includes any actual code that uses MtlResources.
@@ -325,9 +325,15 @@ void Tensor::MoveCpuOrSsboToAhwb() const {
   }
   if (valid_ & kValidCpu) {
     std::memcpy(dest, cpu_buffer_, bytes());
-    // Free CPU memory because next time AHWB is mapped instead.
-    free(cpu_buffer_);
+    // Free CPU memory because next time AHWB is mapped instead. Recycled
+    // buffers are returned to their pool instead of being freed.
+    if (cpu_buffer_release_) {
+      cpu_buffer_release_(cpu_buffer_);
+    } else {
+      free(cpu_buffer_);
+    }
     cpu_buffer_ = nullptr;
+    cpu_buffer_release_ = nullptr;
     valid_ &= ~kValidCpu;
   } else if (valid_ & kValidOpenGlBuffer) {
     gl_context_->Run([this, dest]() {
@@ -0,0 +1,117 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/formats/tensor_pool.h"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port.h"
+#include "mediapipe/framework/port/aligned_malloc_and_free.h"
+
+namespace mediapipe {
+
+TensorPool::~TensorPool() {
+  absl::MutexLock lock(&mutex_);
+  for (auto& [key, buffers] : buffers_) {
+    for (void* buffer : buffers.available) aligned_free(buffer);
+  }
+}
+
+Tensor TensorPool::GetTensor(
+    Tensor::ElementType element_type, const Tensor::Shape& shape,
+    const Tensor::QuantizationParameters& quantization_parameters,
+    int alignment) {
+#if MEDIAPIPE_METAL_ENABLED
+  // On Apple platforms the CPU buffer is page-aligned virtual memory that may
+  // be wrapped by an MTLBuffer without copying, so it cannot be recycled.
+  return Tensor(element_type, shape, quantization_parameters);
+#else
+  ABSL_CHECK_GT(alignment, 0);
+  ABSL_CHECK_EQ(alignment & (alignment - 1), 0)
+      << "Alignment must be a power of two: " << alignment;
+  Key key{element_type, shape.dims, alignment};
+  void* buffer = nullptr;
+  {
+    absl::MutexLock lock(&mutex_);
+    Buffers& buffers = buffers_[key];
+    if (!buffers.available.empty()) {
+      buffer = buffers.available.back();
+      buffers.available.pop_back();
+    }
+    ++buffers.in_use_count;
+    if (!buffer) ++allocations_;
+  }
+  Tensor tensor(element_type, shape, quantization_parameters);
+  if (!buffer) {
+    // Never request a zero-sized allocation: a null buffer would make the
+    // tensor fall back to its own allocation path.
+    buffer = aligned_malloc(std::max(tensor.bytes(), 1), alignment);
+    ABSL_CHECK(buffer) << "Can't allocate " << tensor.bytes()
+                       << " bytes for a pooled Tensor.";
+  }
+
+  // The buffer is returned to the pool, or freed if the pool is gone, when the
+  // tensor is destroyed.
+  std::weak_ptr<TensorPool> weak_pool(shared_from_this());
+  tensor.cpu_buffer_ = buffer;
+  tensor.cpu_buffer_release_ = [weak_pool, key = std::move(key)](void* buf) {
+    auto pool = weak_pool.lock();
+    if (pool) {
+      pool->Return(key, buf);
+    } else {
+      aligned_free(buf);
+    }
+  };
+  return tensor;
+#endif  // MEDIAPIPE_METAL_ENABLED
+}
+
+TensorPool::Stats TensorPool::GetStats() {
+  absl::MutexLock lock(&mutex_);
+  Stats stats;
+  for (const auto& [key, buffers] : buffers_) {
+    stats.in_use += buffers.in_use_count;
+    stats.available += buffers.available.size();
+  }
+  stats.allocations = allocations_;
+  return stats;
+}
+
+void TensorPool::Return(const Key& key, void* buffer) {
+  std::vector<void*> trimmed;
+  {
+    absl::MutexLock lock(&mutex_);
+    Buffers& buffers = buffers_[key];
+    --buffers.in_use_count;
+    buffers.available.push_back(buffer);
+    // If the total number of buffers is greater than keep_count, destroys any
+    // surplus buffers that are no longer in use.
+    const int keep = std::max(keep_count_ - buffers.in_use_count, 0);
+    if (static_cast<int>(buffers.available.size()) > keep) {
+      trimmed.assign(buffers.available.begin() + keep,
+                     buffers.available.end());
+      buffers.available.resize(keep);
+    }
+  }
+  // The trimmed buffers are released without holding the lock.
+  for (void* trimmed_buffer : trimmed) aligned_free(trimmed_buffer);
+}
+
+}  // namespace mediapipe
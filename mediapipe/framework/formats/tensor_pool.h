@@ -0,0 +1,115 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_H_
+#define MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_H_
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/synchronization/mutex.h"
+#include "mediapipe/framework/formats/tensor.h"
+
+namespace mediapipe {
+
+// Recycles the CPU buffers of Tensors with identical element type, shape and
+// alignment. Calculators that emit tensors of a fixed shape on every frame
+// (e.g. preprocessing or inference output) can obtain them from the pool, so
+// that in the steady state no memory is allocated per frame:
+//
+//   Tensor tensor = pool->GetTensor(Tensor::ElementType::kFloat32, shape);
+//   {
+//     auto view = tensor.GetCpuWriteView();
+//     ...
+//   }
+//   output_tensors->push_back(std::move(tensor));
+//
+// The buffer goes back to the pool when the tensor is destroyed, i.e. once the
+// last packet holding it has been released. The pool only manages CPU memory;
+// other backing storages (GPU, AHWB) are allocated lazily as usual.
+//
+// A single pool is shared by all calculators in a graph through
+// kTensorPoolService (see tensor_pool_service.h).
+class TensorPool : public std::enable_shared_from_this<TensorPool> {
+ public:
+  // Alignment matching TFLite's default tensor alignment.
+  static constexpr int kDefaultAlignment = 64;
+  // Number of unused buffers kept per key beyond those currently in use.
+  static constexpr int kDefaultKeepCount = 2;
+
+  // We enforce creation as a shared_ptr so that we can use a weak reference in
+  // the tensors' buffer release callbacks.
+  static std::shared_ptr<TensorPool> Create(
+      int keep_count = kDefaultKeepCount) {
+    return std::shared_ptr<TensorPool>(new TensorPool(keep_count));
+  }
+  ~TensorPool();
+
+  // Returns a tensor whose CPU buffer may either be reused or allocated anew.
+  // `alignment` must be a power of two.
+  Tensor GetTensor(Tensor::ElementType element_type,
+                   const Tensor::Shape& shape,
+                   const Tensor::QuantizationParameters&
+                       quantization_parameters = {},
+                   int alignment = kDefaultAlignment);
+
+  // Total number of buffers that are either in use or available, and the
+  // number of times GetTensor had to allocate. This method is meant for
+  // testing and monitoring.
+  struct Stats {
+    int in_use = 0;
+    int available = 0;
+    int allocations = 0;
+  };
+  Stats GetStats();
+
+ private:
+  struct Key {
+    Tensor::ElementType element_type;
+    std::vector<int> dims;
+    int alignment;
+
+    template <typename H>
+    friend H AbslHashValue(H h, const Key& key) {
+      return H::combine(std::move(h), key.element_type, key.dims,
+                        key.alignment);
+    }
+    bool operator==(const Key& other) const {
+      return element_type == other.element_type && dims == other.dims &&
+             alignment == other.alignment;
+    }
+  };
+
+  struct Buffers {
+    int in_use_count = 0;
+    std::vector<void*> available;
+  };
+
+  explicit TensorPool(int keep_count) : keep_count_(keep_count) {}
+
+  // Returns a buffer to the pool, trimming surplus buffers of the same key.
+  void Return(const Key& key, void* buffer);
+
+  const int keep_count_;
+
+  absl::Mutex mutex_;
+  absl::flat_hash_map<Key, Buffers> buffers_ ABSL_GUARDED_BY(mutex_);
+  int allocations_ ABSL_GUARDED_BY(mutex_) = 0;
+};
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_H_
@@ -0,0 +1,31 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_SERVICE_H_
+#define MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_SERVICE_H_
+
+#include "mediapipe/framework/formats/tensor_pool.h"
+#include "mediapipe/framework/graph_service.h"
+
+namespace mediapipe {
+
+// A graph-wide TensorPool. Calculators request it with
+// `cc->UseService(kTensorPoolService).Optional()` and fall back to plain
+// Tensor allocation when it's unavailable.
+inline constexpr GraphService<TensorPool> kTensorPoolService(
+    "TensorPoolService", GraphServiceBase::kAllowDefaultInitialization);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_FRAMEWORK_FORMATS_TENSOR_POOL_SERVICE_H_
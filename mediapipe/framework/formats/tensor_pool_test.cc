@@ -0,0 +1,113 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/framework/formats/tensor_pool.h"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+
+namespace mediapipe {
+namespace {
+
+constexpr int kKeepCount = 2;
+
+const Tensor::Shape kShape{1, 4, 4, 3};
+
+class TensorPoolTest : public ::testing::Test {
+ protected:
+  TensorPoolTest() { pool_ = TensorPool::Create(kKeepCount); }
+
+  std::shared_ptr<TensorPool> pool_;
+};
+
+TEST_F(TensorPoolTest, ReusesBufferOfReleasedTensor) {
+  const void* first_buffer;
+  {
+    Tensor tensor = pool_->GetTensor(Tensor::ElementType::kFloat32, kShape);
+    EXPECT_EQ(tensor.shape().dims, kShape.dims);
+    EXPECT_EQ(tensor.element_type(), Tensor::ElementType::kFloat32);
+    auto view = tensor.GetCpuWriteView();
+    first_buffer = view.buffer<float>();
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(first_buffer) %
+                  TensorPool::kDefaultAlignment,
+              0);
+    EXPECT_EQ(pool_->GetStats().in_use, 1);
+  }
+  EXPECT_EQ(pool_->GetStats().in_use, 0);
+  EXPECT_EQ(pool_->GetStats().available, 1);
+
+  Tensor tensor = pool_->GetTensor(Tensor::ElementType::kFloat32, kShape);
+  EXPECT_EQ(tensor.GetCpuWriteView().buffer<float>(), first_buffer);
+  EXPECT_EQ(pool_->GetStats().allocations, 1);
+}
+
+TEST_F(TensorPoolTest, KeysByElementTypeShapeAndAlignment) {
+  std::vector<Tensor> tensors;
+  tensors.push_back(pool_->GetTensor(Tensor::ElementType::kFloat32, kShape));
+  tensors.push_back(pool_->GetTensor(Tensor::ElementType::kUInt8, kShape));
+  tensors.push_back(
+      pool_->GetTensor(Tensor::ElementType::kFloat32, Tensor::Shape{1, 2}));
+  tensors.push_back(pool_->GetTensor(Tensor::ElementType::kFloat32, kShape,
+                                     /*quantization_parameters=*/{},
+                                     /*alignment=*/128));
+  tensors.clear();
+  EXPECT_EQ(pool_->GetStats().available, 4);
+
+  Tensor tensor = pool_->GetTensor(Tensor::ElementType::kUInt8, kShape);
+  EXPECT_EQ(pool_->GetStats().available, 3);
+  EXPECT_EQ(pool_->GetStats().allocations, 4);
+}
+
+TEST_F(TensorPoolTest, TrimsSurplusBuffers) {
+  std::vector<Tensor> tensors;
+  for (int i = 0; i <= kKeepCount; ++i) {
+    tensors.push_back(pool_->GetTensor(Tensor::ElementType::kFloat32, kShape));
+  }
+  EXPECT_EQ(pool_->GetStats().in_use, kKeepCount + 1);
+  tensors.clear();
+  EXPECT_EQ(pool_->GetStats().in_use, 0);
+  EXPECT_EQ(pool_->GetStats().available, kKeepCount);
+}
+
+TEST_F(TensorPoolTest, MovedTensorReturnsBufferOnce) {
+  std::optional<Tensor> moved;
+  {
+    Tensor tensor = pool_->GetTensor(Tensor::ElementType::kInt32, kShape);
+    moved.emplace(std::move(tensor));
+  }
+  EXPECT_EQ(pool_->GetStats().in_use, 1);
+  moved.reset();
+  EXPECT_EQ(pool_->GetStats().in_use, 0);
+  EXPECT_EQ(pool_->GetStats().available, 1);
+}
+
+TEST_F(TensorPoolTest, TensorOutlivesPool) {
+  Tensor tensor = pool_->GetTensor(Tensor::ElementType::kFloat32, kShape);
+  {
+    auto view = tensor.GetCpuWriteView();
+    view.buffer<float>()[0] = 42.0f;
+  }
+  pool_ = nullptr;
+  EXPECT_EQ(tensor.GetCpuReadView().buffer<float>()[0], 42.0f);
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -81,6 +81,8 @@ class AudioTaskApiFactory {
           "callback shouldn't be provided.",
           MediaPipeTasksStatus::kInvalidTaskGraphConfigError);
     }
+    tasks::core::TaskApiFactory::ApplyFlowLimiterOptions<Options>(
+        graph_config);
     ASSIGN_OR_RETURN(auto runner,
                      tasks::core::TaskRunner::Create(
                          std::move(graph_config), std::move(resolver),
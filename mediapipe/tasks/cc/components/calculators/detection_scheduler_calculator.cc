@@ -0,0 +1,131 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/calculators/detection_scheduler_calculator.pb.h"
+#include "mediapipe/util/tracking/box_tracker.pb.h"
+
+namespace mediapipe {
+namespace api2 {
+
+using ::absl::StatusCode;
+using ::mediapipe::tasks::CreateStatusWithPayload;
+using ::mediapipe::tasks::DetectionSchedulerCalculatorOptions;
+using ::mediapipe::tasks::MediaPipeTasksStatus;
+
+// Decides, for each frame of a video stream, whether an object detector needs
+// to run or whether the objects tracked from the previous frames can be used
+// instead. The detector runs on the first frame, then every
+// `detection_interval` frames, and on any frame following one where no box
+// was tracked or a tracked box has a tracking confidence below
+// `min_tracking_confidence`.
+//
+// Inputs:
+//   TICK - AnyType
+//     The stream driving the decisions, typically the input image.
+//   PREV_TRACKED_BOXES - TimedBoxProtoList @Optional
+//     The boxes tracked on the previous frame, typically the output of a
+//     BoxTrackerCalculator looped back through a PreviousLoopbackCalculator.
+//     Empty packets are ignored.
+//
+// Outputs:
+//   DETECT - bool
+//     Whether the detector should run on the frame at the same timestamp.
+//
+// Example:
+// node {
+//   calculator: "DetectionSchedulerCalculator"
+//   input_stream: "TICK:image"
+//   input_stream: "PREV_TRACKED_BOXES:prev_tracked_boxes"
+//   output_stream: "DETECT:detect"
+//   options {
+//     [mediapipe.tasks.DetectionSchedulerCalculatorOptions.ext] {
+//       detection_interval: 5
+//       min_tracking_confidence: 0.5
+//     }
+//   }
+// }
+class DetectionSchedulerCalculator : public Node {
+ public:
+  static constexpr Input<AnyType> kTickIn{"TICK"};
+  static constexpr Input<TimedBoxProtoList>::Optional kPrevTrackedBoxesIn{
+      "PREV_TRACKED_BOXES"};
+  static constexpr Output<bool> kDetectOut{"DETECT"};
+  MEDIAPIPE_NODE_CONTRACT(kTickIn, kPrevTrackedBoxesIn, kDetectOut);
+
+  absl::Status Open(CalculatorContext* cc) override;
+  absl::Status Process(CalculatorContext* cc) override;
+
+ private:
+  // Returns true if the previous frame tracked no box, e.g. because all the
+  // objects were lost, or a box with a low tracking confidence.
+  bool IsTrackingLost(CalculatorContext* cc) const;
+
+  DetectionSchedulerCalculatorOptions options_;
+  // Number of frames processed since the detector last ran, or -1 if it never
+  // ran.
+  int frames_since_detection_ = -1;
+};
+
+absl::Status DetectionSchedulerCalculator::Open(CalculatorContext* cc) {
+  options_ = cc->Options<DetectionSchedulerCalculatorOptions>();
+  if (options_.detection_interval() < 1) {
+    return CreateStatusWithPayload(
+        StatusCode::kInvalidArgument,
+        absl::StrFormat(
+            "Expected a detection_interval of at least 1, found %d.",
+            options_.detection_interval()),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  return absl::OkStatus();
+}
+
+absl::Status DetectionSchedulerCalculator::Process(CalculatorContext* cc) {
+  if (kTickIn(cc).IsEmpty()) {
+    return absl::OkStatus();
+  }
+  const bool detect =
+      frames_since_detection_ < 0 ||
+      frames_since_detection_ + 1 >= options_.detection_interval() ||
+      IsTrackingLost(cc);
+  frames_since_detection_ = detect ? 0 : frames_since_detection_ + 1;
+  kDetectOut(cc).Send(detect);
+  return absl::OkStatus();
+}
+
+bool DetectionSchedulerCalculator::IsTrackingLost(
+    CalculatorContext* cc) const {
+  if (kPrevTrackedBoxesIn(cc).IsEmpty()) {
+    return false;
+  }
+  if (kPrevTrackedBoxesIn(cc)->box_size() == 0) {
+    return true;
+  }
+  for (const auto& box : kPrevTrackedBoxesIn(cc)->box()) {
+    if (box.confidence() < options_.min_tracking_confidence()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+MEDIAPIPE_REGISTER_NODE(DetectionSchedulerCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
@@ -0,0 +1,125 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/strings/str_format.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/util/tracking/box_tracker.pb.h"
+
+namespace mediapipe {
+namespace {
+
+using ::mediapipe::ParseTextProtoOrDie;
+using ::testing::ElementsAre;
+using ::testing::HasSubstr;
+using Node = ::mediapipe::CalculatorGraphConfig::Node;
+
+Node BuildNode(int detection_interval, float min_tracking_confidence) {
+  return ParseTextProtoOrDie<Node>(absl::StrFormat(R"pb(
+    calculator: "DetectionSchedulerCalculator"
+    input_stream: "TICK:tick"
+    input_stream: "PREV_TRACKED_BOXES:prev_tracked_boxes"
+    output_stream: "DETECT:detect"
+    options {
+      [mediapipe.tasks.DetectionSchedulerCalculatorOptions.ext] {
+        detection_interval: %d
+        min_tracking_confidence: %f
+      }
+    }
+  )pb",
+                                                   detection_interval,
+                                                   min_tracking_confidence));
+}
+
+// Feeds one tick per confidence. The previous tracked boxes hold a single box
+// with the given confidence, except on the first frame where nothing has been
+// tracked yet.
+void AddFrames(CalculatorRunner* runner,
+               const std::vector<float>& confidences) {
+  for (int i = 0; i < confidences.size(); ++i) {
+    runner->MutableInputs()->Tag("TICK").packets.push_back(
+        MakePacket<int>(0).At(Timestamp(i)));
+    if (i == 0) continue;
+    TimedBoxProtoList boxes;
+    boxes.add_box()->set_confidence(confidences[i]);
+    runner->MutableInputs()->Tag("PREV_TRACKED_BOXES").packets.push_back(
+        MakePacket<TimedBoxProtoList>(boxes).At(Timestamp(i)));
+  }
+}
+
+std::vector<bool> GetDecisions(const CalculatorRunner& runner) {
+  std::vector<bool> decisions;
+  for (const auto& packet : runner.Outputs().Tag("DETECT").packets) {
+    decisions.push_back(packet.Get<bool>());
+  }
+  return decisions;
+}
+
+TEST(DetectionSchedulerCalculatorTest, DetectsOnEveryFrameByDefault) {
+  CalculatorRunner runner(BuildNode(/*detection_interval=*/1,
+                                    /*min_tracking_confidence=*/0.0f));
+  AddFrames(&runner, {1.0f, 1.0f, 1.0f});
+  MP_ASSERT_OK(runner.Run());
+  EXPECT_THAT(GetDecisions(runner), ElementsAre(true, true, true));
+}
+
+TEST(DetectionSchedulerCalculatorTest, DetectsEveryInterval) {
+  CalculatorRunner runner(BuildNode(/*detection_interval=*/3,
+                                    /*min_tracking_confidence=*/0.5f));
+  AddFrames(&runner, {1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f});
+  MP_ASSERT_OK(runner.Run());
+  EXPECT_THAT(GetDecisions(runner),
+              ElementsAre(true, false, false, true, false, false, true));
+}
+
+TEST(DetectionSchedulerCalculatorTest, DetectsOnLowTrackingConfidence) {
+  CalculatorRunner runner(BuildNode(/*detection_interval=*/3,
+                                    /*min_tracking_confidence=*/0.5f));
+  AddFrames(&runner, {1.0f, 0.9f, 0.2f, 0.9f, 0.9f, 0.9f});
+  MP_ASSERT_OK(runner.Run());
+  EXPECT_THAT(GetDecisions(runner),
+              ElementsAre(true, false, true, false, false, true));
+}
+
+TEST(DetectionSchedulerCalculatorTest, DetectsWhenNoBoxIsTracked) {
+  CalculatorRunner runner(BuildNode(/*detection_interval=*/3,
+                                    /*min_tracking_confidence=*/0.5f));
+  AddFrames(&runner, {1.0f, 0.9f, 0.9f, 0.9f, 0.9f});
+  // All the objects are lost on frame 1.
+  runner.MutableInputs()->Tag("PREV_TRACKED_BOXES").packets[1] =
+      MakePacket<TimedBoxProtoList>(TimedBoxProtoList()).At(Timestamp(2));
+  MP_ASSERT_OK(runner.Run());
+  EXPECT_THAT(GetDecisions(runner),
+              ElementsAre(true, false, true, false, false));
+}
+
+TEST(DetectionSchedulerCalculatorTest, FailsWithInvalidInterval) {
+  CalculatorRunner runner(BuildNode(/*detection_interval=*/0,
+                                    /*min_tracking_confidence=*/0.0f));
+  AddFrames(&runner, {1.0f});
+  auto status = runner.Run();
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(),
+              HasSubstr("Expected a detection_interval of at least 1"));
+}
+
+}  // namespace
+}  // namespace mediapipe
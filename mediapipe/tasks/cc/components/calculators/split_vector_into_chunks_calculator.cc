@@ -0,0 +1,89 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/ret_check.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Splits each input vector into as many contiguous chunks as there are output
+// streams, and sends the i-th chunk to the i-th output stream. Chunk sizes
+// differ by at most one element, the first chunks being the largest ones, and
+// chunks may be empty when the input vector has fewer elements than there are
+// output streams.
+//
+// This lets a graph distribute per-element work, e.g. running a landmark model
+// on each RoI of a frame, across several replicas of a subgraph that run in
+// parallel. As the chunks are contiguous, concatenating the per-chunk results
+// in output stream order, e.g. with a ConcatenateVectorCalculator, restores
+// the order of the input elements.
+//
+// Inputs:
+//   VECTOR - std::vector<T>
+//     The vector to split.
+//
+// Outputs:
+//   CHUNK - std::vector<T> @Multiple
+//     The chunks of the input vector, one per output stream.
+//
+// Example:
+// node {
+//   calculator: "SplitNormalizedRectVectorIntoChunksCalculator"
+//   input_stream: "VECTOR:rects"
+//   output_stream: "CHUNK:0:rects_chunk_0"
+//   output_stream: "CHUNK:1:rects_chunk_1"
+// }
+template <typename T>
+class SplitVectorIntoChunksCalculator : public Node {
+ public:
+  static constexpr Input<std::vector<T>> kVectorIn{"VECTOR"};
+  static constexpr Output<std::vector<T>>::Multiple kChunksOut{"CHUNK"};
+  MEDIAPIPE_NODE_CONTRACT(kVectorIn, kChunksOut);
+
+  static absl::Status UpdateContract(CalculatorContract* cc) {
+    RET_CHECK_GE(kChunksOut(cc).Count(), 1);
+    return absl::OkStatus();
+  }
+
+  absl::Status Process(CalculatorContext* cc) override {
+    if (kVectorIn(cc).IsEmpty()) {
+      return absl::OkStatus();
+    }
+    const std::vector<T>& input = *kVectorIn(cc);
+    const int num_chunks = kChunksOut(cc).Count();
+    const int min_chunk_size = input.size() / num_chunks;
+    const int num_larger_chunks = input.size() % num_chunks;
+    auto begin = input.begin();
+    for (int i = 0; i < num_chunks; ++i) {
+      auto end = begin + min_chunk_size + (i < num_larger_chunks ? 1 : 0);
+      kChunksOut(cc)[i].Send(std::vector<T>(begin, end));
+      begin = end;
+    }
+    return absl::OkStatus();
+  }
+};
+
+typedef SplitVectorIntoChunksCalculator<NormalizedRect>
+    SplitNormalizedRectVectorIntoChunksCalculator;
+MEDIAPIPE_REGISTER_NODE(SplitNormalizedRectVectorIntoChunksCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
@@ -0,0 +1,82 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using ::mediapipe::ParseTextProtoOrDie;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+using Node = ::mediapipe::CalculatorGraphConfig::Node;
+
+constexpr char kNodeConfig[] = R"pb(
+  calculator: "SplitNormalizedRectVectorIntoChunksCalculator"
+  input_stream: "VECTOR:rects"
+  output_stream: "CHUNK:0:chunk_0"
+  output_stream: "CHUNK:1:chunk_1"
+  output_stream: "CHUNK:2:chunk_2"
+)pb";
+
+std::vector<NormalizedRect> MakeRects(int num_rects) {
+  std::vector<NormalizedRect> rects(num_rects);
+  for (int i = 0; i < num_rects; ++i) {
+    rects[i].set_rect_id(i);
+  }
+  return rects;
+}
+
+std::vector<int> GetChunkRectIds(const CalculatorRunner& runner, int chunk) {
+  const auto& packets = runner.Outputs().Get("CHUNK", chunk).packets;
+  EXPECT_EQ(packets.size(), 1);
+  std::vector<int> rect_ids;
+  for (const auto& rect : packets[0].Get<std::vector<NormalizedRect>>()) {
+    rect_ids.push_back(rect.rect_id());
+  }
+  return rect_ids;
+}
+
+TEST(SplitVectorIntoChunksCalculatorTest, SplitsIntoBalancedChunks) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(kNodeConfig));
+  runner.MutableInputs()->Tag("VECTOR").packets.push_back(
+      MakePacket<std::vector<NormalizedRect>>(MakeRects(5)).At(Timestamp(0)));
+  MP_ASSERT_OK(runner.Run());
+
+  EXPECT_THAT(GetChunkRectIds(runner, 0), ElementsAre(0, 1));
+  EXPECT_THAT(GetChunkRectIds(runner, 1), ElementsAre(2, 3));
+  EXPECT_THAT(GetChunkRectIds(runner, 2), ElementsAre(4));
+}
+
+TEST(SplitVectorIntoChunksCalculatorTest, SendsEmptyChunks) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(kNodeConfig));
+  runner.MutableInputs()->Tag("VECTOR").packets.push_back(
+      MakePacket<std::vector<NormalizedRect>>(MakeRects(1)).At(Timestamp(0)));
+  MP_ASSERT_OK(runner.Run());
+
+  EXPECT_THAT(GetChunkRectIds(runner, 0), ElementsAre(0));
+  EXPECT_THAT(GetChunkRectIds(runner, 1), IsEmpty());
+  EXPECT_THAT(GetChunkRectIds(runner, 2), IsEmpty());
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -15,6 +15,8 @@
 #include <math.h>
 
 #include <algorithm>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "absl/container/flat_hash_set.h"
@@ -26,6 +28,7 @@
 #include "mediapipe/framework/formats/tensor.h"
 #include "mediapipe/framework/port/ret_check.h"
 #include "mediapipe/tasks/cc/components/calculators/tensors_to_embeddings_calculator.pb.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
 #include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedder_options.pb.h"
 
@@ -36,13 +39,30 @@ namespace {
 
 using ::mediapipe::tasks::components::containers::proto::Embedding;
 using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
+namespace containers = ::mediapipe::tasks::components::containers;
+
+// The number of independent partial sums used to compute squared L2 norms.
+// Accumulating into several partial sums breaks the dependency between loop
+// iterations, which lets the compiler vectorize the loop without relaxing
+// floating-point semantics.
+constexpr int kNumPartialSums = 8;
 
 // Computes the inverse L2 norm of the provided array of values. Returns 1.0 in
 // case all values are 0.
 float GetInverseL2Norm(const float* values, int size) {
+  float partial_sums[kNumPartialSums] = {};
+  int i = 0;
+  for (; i + kNumPartialSums <= size; i += kNumPartialSums) {
+    for (int j = 0; j < kNumPartialSums; ++j) {
+      partial_sums[j] += values[i + j] * values[i + j];
+    }
+  }
+  for (int j = 0; i < size; ++i, ++j) {
+    partial_sums[j] += values[i] * values[i];
+  }
   float squared_l2_norm = 0.0f;
-  for (int i = 0; i < size; ++i) {
-    squared_l2_norm += values[i] * values[i];
+  for (int j = 0; j < kNumPartialSums; ++j) {
+    squared_l2_norm += partial_sums[j];
   }
   float inv_l2_norm = 1.0f;
   if (squared_l2_norm > 0.0f) {
@@ -51,25 +71,71 @@ float GetInverseL2Norm(const float* values, int size) {
   return inv_l2_norm;
 }
 
+// Writes the `size` values, scaled by `scale`, to `output`.
+void ScaleValues(const float* values, int size, float scale, float* output) {
+  if (scale == 1.0f) {
+    std::copy(values, values + size, output);
+    return;
+  }
+  for (int i = 0; i < size; ++i) {
+    output[i] = values[i] * scale;
+  }
+}
+
+// Scalar-quantizes the `size` values, scaled by `scale`, into `output`: each
+// value is multiplied by 128, rounded half away from zero and clamped to
+// [-128, 127].
+//
+// Values are clamped before being rounded, which gives the same results as
+// clamping afterwards and keeps them in the range of int. Rounding is computed
+// by truncating and correcting by the fractional part, which is exact for
+// values in [-128, 127] and, unlike roundf(), vectorizes on all targets.
+void QuantizeValues(const float* values, int size, float scale, char* output) {
+  const float quantization_scale = scale * 128.0f;
+  for (int i = 0; i < size; ++i) {
+    const float value = std::min(
+        std::max(values[i] * quantization_scale, -128.0f), 127.0f);
+    const int truncated = static_cast<int>(value);
+    const float fraction = value - static_cast<float>(truncated);
+    output[i] = static_cast<char>(truncated + (fraction >= 0.5f) -
+                                  (fraction <= -0.5f));
+  }
+}
+
 }  // namespace
 
 // Converts tensors into an EmbeddingResult object, performing optional
 // L2-normalization and scalar-quantization on-the-fly if required through the
 // options.
 //
+// The embeddings are written directly into preallocated contiguous buffers,
+// either the ones of the EmbeddingResult proto or, when the EMBEDDING_RESULT
+// output is used instead, the ones of the EmbeddingResult struct, which lets
+// C++ clients skip the conversion from the proto.
+//
 // Input:
 //   TENSORS - std::vector<Tensor>
 //     A vector of one or more Tensors of type kFloat32.
-// Output:
-//   EMBEDDINGS - EmbeddingResult
+// Outputs:
+//   EMBEDDINGS - EmbeddingResult @Optional
 //     The contents of the input tensors converted into an EmbeddingResult
 //     proto.
+//   EMBEDDING_RESULT - tasks::components::containers::EmbeddingResult
+//     @Optional
+//     The contents of the input tensors converted into an EmbeddingResult
+//     struct, with `timestamp_ms` set from the input timestamp.
+//
+// At least one of the outputs must be connected.
 class TensorsToEmbeddingsCalculator : public Node {
  public:
   static constexpr Input<std::vector<Tensor>> kTensorsIn{"TENSORS"};
-  static constexpr Output<EmbeddingResult> kEmbeddingsOut{"EMBEDDINGS"};
-  MEDIAPIPE_NODE_CONTRACT(kTensorsIn, kEmbeddingsOut);
+  static constexpr Output<EmbeddingResult>::Optional kEmbeddingsOut{
+      "EMBEDDINGS"};
+  static constexpr Output<containers::EmbeddingResult>::Optional
+      kEmbeddingResultOut{"EMBEDDING_RESULT"};
+  MEDIAPIPE_NODE_CONTRACT(kTensorsIn, kEmbeddingsOut, kEmbeddingResultOut);
 
+  static absl::Status UpdateContract(CalculatorContract* cc);
   absl::Status Open(CalculatorContext* cc) override;
   absl::Status Process(CalculatorContext* cc) override;
 
@@ -79,10 +145,19 @@ class TensorsToEmbeddingsCalculator : public Node {
   std::vector<std::string> head_names_;
   absl::flat_hash_set<std::string> ignored_head_names_;
 
-  void FillFloatEmbedding(const Tensor& tensor, Embedding* embedding);
-  void FillQuantizedEmbedding(const Tensor& tensor, Embedding* embedding);
+  void FillEmbedding(const Tensor& tensor, Embedding* embedding);
+  void FillEmbedding(const Tensor& tensor, containers::Embedding* embedding);
 };
 
+absl::Status TensorsToEmbeddingsCalculator::UpdateContract(
+    CalculatorContract* cc) {
+  RET_CHECK(kEmbeddingsOut(cc).IsConnected() ||
+            kEmbeddingResultOut(cc).IsConnected())
+      << "At least one of the EMBEDDINGS and EMBEDDING_RESULT outputs must be "
+         "connected.";
+  return absl::OkStatus();
+}
+
 absl::Status TensorsToEmbeddingsCalculator::Open(CalculatorContext* cc) {
   auto options = cc->Options<mediapipe::TensorsToEmbeddingsCalculatorOptions>();
   l2_normalize_ = options.embedder_options().l2_normalize();
@@ -98,7 +173,6 @@ absl::Status TensorsToEmbeddingsCalculator::Open(CalculatorContext* cc) {
 }
 
 absl::Status TensorsToEmbeddingsCalculator::Process(CalculatorContext* cc) {
-  EmbeddingResult result;
   const auto& tensors = *kTensorsIn(cc);
   if (!head_names_.empty() && tensors.size() != head_names_.size()) {
     return absl::InvalidArgumentError(absl::StrFormat(
@@ -106,57 +180,76 @@ absl::Status TensorsToEmbeddingsCalculator::Process(CalculatorContext* cc) {
         "of input tensors (%d).",
         head_names_.size(), tensors.size()));
   }
+  const bool output_proto = kEmbeddingsOut(cc).IsConnected();
+  const bool output_struct = kEmbeddingResultOut(cc).IsConnected();
+  EmbeddingResult result;
+  containers::EmbeddingResult result_struct;
   for (int i = 0; i < tensors.size(); ++i) {
     if (!head_names_.empty() && ignored_head_names_.contains(head_names_[i])) {
       continue;
     }
     const auto& tensor = tensors[i];
     RET_CHECK(tensor.element_type() == Tensor::ElementType::kFloat32);
-    auto* embedding = result.add_embeddings();
-    embedding->set_head_index(i);
-    if (!head_names_.empty()) {
-      embedding->set_head_name(head_names_[i]);
+    if (output_proto) {
+      auto* embedding = result.add_embeddings();
+      embedding->set_head_index(i);
+      if (!head_names_.empty()) {
+        embedding->set_head_name(head_names_[i]);
+      }
+      FillEmbedding(tensor, embedding);
     }
-    if (quantize_) {
-      FillQuantizedEmbedding(tensor, embedding);
-    } else {
-      FillFloatEmbedding(tensor, embedding);
+    if (output_struct) {
+      auto& embedding = result_struct.embeddings.emplace_back();
+      embedding.head_index = i;
+      if (!head_names_.empty()) {
+        embedding.head_name = head_names_[i];
+      }
+      FillEmbedding(tensor, &embedding);
     }
   }
-  kEmbeddingsOut(cc).Send(result);
+  if (output_proto) {
+    kEmbeddingsOut(cc).Send(std::move(result));
+  }
+  if (output_struct) {
+    result_struct.timestamp_ms = cc->InputTimestamp().Value() / 1000;
+    kEmbeddingResultOut(cc).Send(std::move(result_struct));
+  }
   return absl::OkStatus();
 }
 
-void TensorsToEmbeddingsCalculator::FillFloatEmbedding(const Tensor& tensor,
-                                                       Embedding* embedding) {
+void TensorsToEmbeddingsCalculator::FillEmbedding(const Tensor& tensor,
+                                                  Embedding* embedding) {
   int size = tensor.shape().num_elements();
   auto tensor_view = tensor.GetCpuReadView();
   const float* tensor_buffer = tensor_view.buffer<float>();
   float inv_l2_norm =
       l2_normalize_ ? GetInverseL2Norm(tensor_buffer, size) : 1.0f;
-  auto* float_embedding = embedding->mutable_float_embedding();
-  for (int i = 0; i < size; ++i) {
-    float_embedding->add_values(tensor_buffer[i] * inv_l2_norm);
+  if (quantize_) {
+    auto* values = embedding->mutable_quantized_embedding()->mutable_values();
+    values->resize(size);
+    QuantizeValues(tensor_buffer, size, inv_l2_norm, values->data());
+  } else {
+    auto* values = embedding->mutable_float_embedding()->mutable_values();
+    values->Resize(size, 0.0f);
+    ScaleValues(tensor_buffer, size, inv_l2_norm, values->mutable_data());
   }
 }
 
-void TensorsToEmbeddingsCalculator::FillQuantizedEmbedding(
-    const Tensor& tensor, Embedding* embedding) {
+void TensorsToEmbeddingsCalculator::FillEmbedding(
+    const Tensor& tensor, containers::Embedding* embedding) {
   int size = tensor.shape().num_elements();
   auto tensor_view = tensor.GetCpuReadView();
   const float* tensor_buffer = tensor_view.buffer<float>();
   float inv_l2_norm =
       l2_normalize_ ? GetInverseL2Norm(tensor_buffer, size) : 1.0f;
-  auto* values = embedding->mutable_quantized_embedding()->mutable_values();
-  values->resize(size);
-  for (int i = 0; i < size; ++i) {
-    // Normalize.
-    float normalized = tensor_buffer[i] * inv_l2_norm;
-    // Quantize.
-    int unclamped_value = static_cast<int>(roundf(normalized * 128));
-    // Clamp and assign.
-    (*values)[i] =
-        static_cast<char>(std::max(-128, std::min(unclamped_value, 127)));
+  if (quantize_) {
+    embedding->quantized_embedding.resize(size);
+    QuantizeValues(tensor_buffer, size, inv_l2_norm,
+                   embedding->quantized_embedding.data());
+  } else {
+    embedding->float_embedding.resize(size);
+    ScaleValues(tensor_buffer, size, inv_l2_norm,
+                embedding->float_embedding.data());
   }
 }
 
@@ -0,0 +1,104 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmark for TensorsToEmbeddingsCalculator, with the embedding dimensions
+// of typical text and image embedders.
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/tensor.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/tasks/cc/components/calculators/tensors_to_embeddings_calculator.pb.h"
+
+namespace {
+
+constexpr int kNumHeads = 2;
+
+// Runs the calculator on `kNumHeads` tensors of `state.range(0)` elements,
+// quantizing the embeddings if `state.range(1)` is not 0, and sending them to
+// the output with tag `output_tag`.
+void RunTensorsToEmbeddingsCalculator(benchmark::State& state,
+                                      const std::string& output_tag) {
+  const int dimension = state.range(0);
+  const bool quantize = state.range(1) != 0;
+
+  mediapipe::CalculatorGraphConfig config;
+  config.add_input_stream("tensors");
+  auto* node = config.add_node();
+  node->set_calculator("TensorsToEmbeddingsCalculator");
+  node->add_input_stream("TENSORS:tensors");
+  node->add_output_stream(output_tag + ":embeddings");
+  auto* options = node->mutable_options()->MutableExtension(
+      mediapipe::TensorsToEmbeddingsCalculatorOptions::ext);
+  options->mutable_embedder_options()->set_l2_normalize(true);
+  options->mutable_embedder_options()->set_quantize(quantize);
+
+  std::mt19937 rng(0 /*seed*/);
+  std::normal_distribution<float> value_dist;
+  std::vector<std::vector<float>> values(kNumHeads);
+  for (auto& head_values : values) {
+    head_values.resize(dimension);
+    for (float& value : head_values) {
+      value = value_dist(rng);
+    }
+  }
+
+  mediapipe::CalculatorGraph graph;
+  ABSL_CHECK_OK(graph.Initialize(config));
+  ABSL_CHECK_OK(graph.StartRun({}));
+  int64_t timestamp = 0;
+  for (auto _ : state) {
+    state.PauseTiming();  // Pause benchmark timing.
+    auto tensors = std::make_unique<std::vector<mediapipe::Tensor>>();
+    for (const auto& head_values : values) {
+      tensors->emplace_back(mediapipe::Tensor::ElementType::kFloat32,
+                            mediapipe::Tensor::Shape{1, dimension});
+      auto view = tensors->back().GetCpuWriteView();
+      std::copy(head_values.begin(), head_values.end(),
+                view.buffer<float>());
+    }
+    state.ResumeTiming();  // Resume benchmark timing.
+
+    ABSL_CHECK_OK(graph.AddPacketToInputStream(
+        "tensors", mediapipe::Adopt(tensors.release())
+                       .At(mediapipe::Timestamp(timestamp++))));
+    ABSL_CHECK_OK(graph.WaitUntilIdle());
+  }
+  ABSL_CHECK_OK(graph.CloseAllInputStreams());
+  ABSL_CHECK_OK(graph.WaitUntilDone());
+  state.SetItemsProcessed(state.iterations() * kNumHeads * dimension);
+}
+
+void BM_TensorsToEmbeddingsCalculator(benchmark::State& state) {
+  RunTensorsToEmbeddingsCalculator(state, "EMBEDDINGS");
+}
+BENCHMARK(BM_TensorsToEmbeddingsCalculator)
+    ->ArgsProduct({{256, 512, 768, 1024}, {0, 1}});
+
+void BM_TensorsToEmbeddingsCalculatorEmbeddingResult(benchmark::State& state) {
+  RunTensorsToEmbeddingsCalculator(state, "EMBEDDING_RESULT");
+}
+BENCHMARK(BM_TensorsToEmbeddingsCalculatorEmbeddingResult)
+    ->ArgsProduct({{256, 512, 768, 1024}, {0, 1}});
+
+}  // namespace
+
+BENCHMARK_MAIN();
@@ -12,7 +12,12 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <math.h>
+
+#include <algorithm>
+#include <cmath>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "absl/status/status.h"
@@ -24,14 +29,20 @@
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/parse_text_proto.h"
 #include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
 #include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 
 namespace mediapipe {
 namespace {
 
 using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
+using ::testing::ElementsAre;
+using ::testing::FloatEq;
+using ::testing::FloatNear;
 using ::testing::HasSubstr;
+using ::testing::Pointwise;
 using Node = ::mediapipe::CalculatorGraphConfig::Node;
+namespace containers = ::mediapipe::tasks::components::containers;
 
 // Builds the graph and feeds inputs.
 void BuildGraph(CalculatorRunner* runner,
@@ -272,5 +283,151 @@ TEST(TensorsToEmbeddingsCalculatorTest,
                        })pb")));
 }
 
+TEST(TensorsToEmbeddingsCalculatorTest, SucceedsWithEmbeddingResultOutput) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToEmbeddingsCalculator"
+    input_stream: "TENSORS:tensors"
+    output_stream: "EMBEDDING_RESULT:embedding_result"
+    options {
+      [mediapipe.TensorsToEmbeddingsCalculatorOptions.ext] {
+        embedder_options { l2_normalize: true quantize: false }
+        head_names: "foo"
+        head_names: "bar"
+        ignored_head_names: "foo"
+      }
+    }
+  )pb"));
+
+  BuildGraph(&runner, {{0.1, 0.2}, {-0.2, -0.3}});
+  MP_ASSERT_OK(runner.Run());
+
+  const auto& result = runner.Outputs()
+                           .Get("EMBEDDING_RESULT", 0)
+                           .packets[0]
+                           .Get<containers::EmbeddingResult>();
+  ASSERT_EQ(result.embeddings.size(), 1);
+  EXPECT_THAT(result.embeddings[0].float_embedding,
+              ElementsAre(FloatEq(-0.5547002), FloatEq(-0.8320503)));
+  EXPECT_TRUE(result.embeddings[0].quantized_embedding.empty());
+  EXPECT_EQ(result.embeddings[0].head_index, 1);
+  EXPECT_EQ(result.embeddings[0].head_name, "bar");
+  EXPECT_EQ(result.timestamp_ms, 0);
+}
+
+TEST(TensorsToEmbeddingsCalculatorTest, SucceedsWithBothOutputs) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToEmbeddingsCalculator"
+    input_stream: "TENSORS:tensors"
+    output_stream: "EMBEDDINGS:embeddings"
+    output_stream: "EMBEDDING_RESULT:embedding_result"
+    options {
+      [mediapipe.TensorsToEmbeddingsCalculatorOptions.ext] {
+        embedder_options { l2_normalize: true quantize: true }
+      }
+    }
+  )pb"));
+
+  BuildGraph(&runner, {{0.1, 0.2}, {-0.2, -0.3}});
+  MP_ASSERT_OK(runner.Run());
+
+  const EmbeddingResult& result =
+      runner.Outputs().Get("EMBEDDINGS", 0).packets[0].Get<EmbeddingResult>();
+  EXPECT_EQ(containers::ConvertToEmbeddingResult(result).embeddings.size(), 2);
+  const auto& result_struct = runner.Outputs()
+                                  .Get("EMBEDDING_RESULT", 0)
+                                  .packets[0]
+                                  .Get<containers::EmbeddingResult>();
+  ASSERT_EQ(result_struct.embeddings.size(), 2);
+  EXPECT_EQ(result_struct.embeddings[0].quantized_embedding, "\x39\x72");
+  EXPECT_EQ(result_struct.embeddings[1].quantized_embedding, "\xb9\x95");
+}
+
+TEST(TensorsToEmbeddingsCalculatorTest, FailsWithoutOutput) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToEmbeddingsCalculator"
+    input_stream: "TENSORS:tensors"
+  )pb"));
+
+  BuildGraph(&runner, {{0.1, 0.2}});
+  auto status = runner.Run();
+
+  EXPECT_FALSE(status.ok());
+  EXPECT_THAT(status.message(),
+              HasSubstr("At least one of the EMBEDDINGS and EMBEDDING_RESULT "
+                        "outputs must be connected"));
+}
+
+// Checks the vectorized normalization and quantization against a scalar
+// reference on an embedding whose size is not a multiple of the vector width,
+// and whose values include rounding ties and values out of the quantization
+// range.
+TEST(TensorsToEmbeddingsCalculatorTest, SucceedsWithLargeEmbeddings) {
+  constexpr int kSize = 1027;
+  std::vector<float> values(kSize);
+  for (int i = 0; i < kSize; ++i) {
+    values[i] = std::sin(0.1f * i) * (i % 3 + 1);
+  }
+  values[0] = 0.5f / 128;
+  values[1] = -2.5f / 128;
+  values[2] = 2.0f;
+  values[3] = -2.0f;
+  std::vector<float> expected_normalized(kSize);
+  std::string expected_quantized(kSize, 0);
+  float squared_l2_norm = 0.0f;
+  for (float value : values) {
+    squared_l2_norm += value * value;
+  }
+  const float inv_l2_norm = 1.0f / std::sqrt(squared_l2_norm);
+  for (int i = 0; i < kSize; ++i) {
+    expected_normalized[i] = values[i] * inv_l2_norm;
+  }
+  for (int i = 0; i < kSize; ++i) {
+    expected_quantized[i] = static_cast<char>(
+        std::max(-128, std::min(static_cast<int>(roundf(values[i] * 128)),
+                                127)));
+  }
+
+  CalculatorRunner normalize_runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToEmbeddingsCalculator"
+    input_stream: "TENSORS:tensors"
+    output_stream: "EMBEDDING_RESULT:embedding_result"
+    options {
+      [mediapipe.TensorsToEmbeddingsCalculatorOptions.ext] {
+        embedder_options { l2_normalize: true quantize: false }
+      }
+    }
+  )pb"));
+  BuildGraph(&normalize_runner, {values});
+  MP_ASSERT_OK(normalize_runner.Run());
+  EXPECT_THAT(normalize_runner.Outputs()
+                  .Get("EMBEDDING_RESULT", 0)
+                  .packets[0]
+                  .Get<containers::EmbeddingResult>()
+                  .embeddings[0]
+                  .float_embedding,
+              Pointwise(FloatNear(1e-6), expected_normalized));
+
+  CalculatorRunner quantize_runner(ParseTextProtoOrDie<Node>(R"pb(
+    calculator: "TensorsToEmbeddingsCalculator"
+    input_stream: "TENSORS:tensors"
+    output_stream: "EMBEDDINGS:embeddings"
+    options {
+      [mediapipe.TensorsToEmbeddingsCalculatorOptions.ext] {
+        embedder_options { l2_normalize: false quantize: true }
+      }
+    }
+  )pb"));
+  BuildGraph(&quantize_runner, {values});
+  MP_ASSERT_OK(quantize_runner.Run());
+  EXPECT_EQ(quantize_runner.Outputs()
+                .Get("EMBEDDINGS", 0)
+                .packets[0]
+                .Get<EmbeddingResult>()
+                .embeddings(0)
+                .quantized_embedding()
+                .values(),
+            expected_quantized);
+}
+
 }  // namespace
 }  // namespace mediapipe
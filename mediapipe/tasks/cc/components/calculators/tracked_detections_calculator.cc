@@ -0,0 +1,129 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/status/status.h"
+#include "mediapipe/framework/api2/node.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+
+namespace mediapipe {
+namespace api2 {
+
+// Selects, for each frame, between the detections output by a detector and the
+// detections tracked from the previous detector runs.
+//
+// On frames where the detector ran, its detections are forwarded unchanged.
+// On the other frames, the tracked detections are forwarded. As trackers only
+// keep the labels and scores of the objects they track, the label ids and
+// display names of the tracked detections are restored from the last detector
+// detections with the same labels.
+//
+// Inputs:
+//   DETECTIONS - std::vector<Detection>
+//     The detector detections. Only present on the frames where the detector
+//     ran.
+//   TRACKED_DETECTIONS - std::vector<Detection>
+//     The tracked detections, e.g. from a TrackedDetectionManagerCalculator.
+//
+// Outputs:
+//   DETECTIONS - std::vector<Detection>
+//     The detections for the current frame.
+//
+// Example:
+// node {
+//   calculator: "TrackedDetectionsCalculator"
+//   input_stream: "DETECTIONS:detector_detections"
+//   input_stream: "TRACKED_DETECTIONS:tracked_detections"
+//   output_stream: "DETECTIONS:detections"
+// }
+class TrackedDetectionsCalculator : public Node {
+ public:
+  static constexpr Input<std::vector<Detection>> kDetectionsIn{"DETECTIONS"};
+  static constexpr Input<std::vector<Detection>> kTrackedDetectionsIn{
+      "TRACKED_DETECTIONS"};
+  static constexpr Output<std::vector<Detection>> kDetectionsOut{"DETECTIONS"};
+  MEDIAPIPE_NODE_CONTRACT(kDetectionsIn, kTrackedDetectionsIn, kDetectionsOut);
+
+  absl::Status Process(CalculatorContext* cc) override;
+
+ private:
+  struct LabelInfo {
+    int label_id = -1;
+    std::string display_name;
+  };
+
+  // Label ids and display names of the last detector detections, by label.
+  absl::flat_hash_map<std::string, LabelInfo> label_infos_;
+};
+
+absl::Status TrackedDetectionsCalculator::Process(CalculatorContext* cc) {
+  if (!kDetectionsIn(cc).IsEmpty()) {
+    const auto& detections = *kDetectionsIn(cc);
+    for (const auto& detection : detections) {
+      for (int i = 0; i < detection.label_size(); ++i) {
+        LabelInfo& info = label_infos_[detection.label(i)];
+        info.label_id =
+            i < detection.label_id_size() ? detection.label_id(i) : -1;
+        info.display_name =
+            i < detection.display_name_size() ? detection.display_name(i) : "";
+      }
+    }
+    kDetectionsOut(cc).Send(detections);
+    return absl::OkStatus();
+  }
+  if (kTrackedDetectionsIn(cc).IsEmpty()) {
+    return absl::OkStatus();
+  }
+  std::vector<Detection> detections = *kTrackedDetectionsIn(cc);
+  for (auto& detection : detections) {
+    if (detection.label_id_size() > 0 || detection.display_name_size() > 0) {
+      continue;
+    }
+    bool has_display_names = false;
+    std::vector<int> label_ids;
+    std::vector<std::string> display_names;
+    for (const auto& label : detection.label()) {
+      auto it = label_infos_.find(label);
+      if (it == label_infos_.end()) {
+        label_ids.push_back(-1);
+        display_names.emplace_back();
+        continue;
+      }
+      label_ids.push_back(it->second.label_id);
+      display_names.push_back(it->second.display_name);
+      has_display_names |= !it->second.display_name.empty();
+    }
+    for (int label_id : label_ids) {
+      detection.add_label_id(label_id);
+    }
+    if (has_display_names) {
+      for (auto& display_name : display_names) {
+        detection.add_display_name(std::move(display_name));
+      }
+    }
+  }
+  kDetectionsOut(cc).Send(std::move(detections));
+  return absl::OkStatus();
+}
+
+MEDIAPIPE_REGISTER_NODE(TrackedDetectionsCalculator);
+
+}  // namespace api2
+}  // namespace mediapipe
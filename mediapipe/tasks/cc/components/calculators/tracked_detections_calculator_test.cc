@@ -0,0 +1,104 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <string>
+#include <vector>
+
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/calculator_runner.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/parse_text_proto.h"
+#include "mediapipe/framework/port/status_matchers.h"
+
+namespace mediapipe {
+namespace {
+
+using ::mediapipe::ParseTextProtoOrDie;
+using ::testing::ElementsAre;
+using Node = ::mediapipe::CalculatorGraphConfig::Node;
+
+constexpr char kNodeConfig[] = R"pb(
+  calculator: "TrackedDetectionsCalculator"
+  input_stream: "DETECTIONS:detector_detections"
+  input_stream: "TRACKED_DETECTIONS:tracked_detections"
+  output_stream: "DETECTIONS:detections"
+)pb";
+
+void AddDetections(CalculatorRunner* runner, const std::string& tag,
+                   const std::vector<Detection>& detections, int timestamp) {
+  runner->MutableInputs()->Tag(tag).packets.push_back(
+      MakePacket<std::vector<Detection>>(detections).At(Timestamp(timestamp)));
+}
+
+TEST(TrackedDetectionsCalculatorTest, SelectsDetectorOrTrackedDetections) {
+  CalculatorRunner runner(ParseTextProtoOrDie<Node>(kNodeConfig));
+  const auto detector_detection = ParseTextProtoOrDie<Detection>(R"pb(
+    label: "cat"
+    label_id: 3
+    display_name: "Cat"
+    score: 0.9
+    location_data {
+      format: RELATIVE_BOUNDING_BOX
+      relative_bounding_box { xmin: 0.1 ymin: 0.1 width: 0.2 height: 0.2 }
+    }
+  )pb");
+  const auto tracked_detection = ParseTextProtoOrDie<Detection>(R"pb(
+    label: "cat"
+    score: 0.9
+    location_data {
+      format: RELATIVE_BOUNDING_BOX
+      relative_bounding_box { xmin: 0.2 ymin: 0.1 width: 0.2 height: 0.2 }
+    }
+  )pb");
+  const auto unknown_detection = ParseTextProtoOrDie<Detection>(R"pb(
+    label: "dog"
+    score: 0.8
+  )pb");
+  AddDetections(&runner, "DETECTIONS", {detector_detection}, 0);
+  AddDetections(&runner, "TRACKED_DETECTIONS", {}, 0);
+  AddDetections(&runner, "TRACKED_DETECTIONS",
+                {tracked_detection, unknown_detection}, 1);
+  MP_ASSERT_OK(runner.Run());
+
+  const auto& packets = runner.Outputs().Tag("DETECTIONS").packets;
+  ASSERT_EQ(packets.size(), 2);
+  EXPECT_THAT(packets[0].Get<std::vector<Detection>>(),
+              ElementsAre(EqualsProto(detector_detection)));
+  EXPECT_THAT(packets[1].Get<std::vector<Detection>>(),
+              ElementsAre(EqualsProto(R"pb(
+                            label: "cat"
+                            label_id: 3
+                            display_name: "Cat"
+                            score: 0.9
+                            location_data {
+                              format: RELATIVE_BOUNDING_BOX
+                              relative_bounding_box {
+                                xmin: 0.2
+                                ymin: 0.1
+                                width: 0.2
+                                height: 0.2
+                              }
+                            }
+                          )pb"),
+                          EqualsProto(R"pb(
+                            label: "dog"
+                            label_id: -1
+                            score: 0.8
+                          )pb")));
+}
+
+}  // namespace
+}  // namespace mediapipe
@@ -0,0 +1,354 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/components/processors/detection_tracking_graph.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "mediapipe/calculators/image/image_transformation_calculator.pb.h"
+#include "mediapipe/calculators/video/box_tracker_calculator.pb.h"
+#include "mediapipe/calculators/video/flow_packager_calculator.pb.h"
+#include "mediapipe/calculators/video/motion_analysis_calculator.pb.h"
+#include "mediapipe/framework/api2/builder.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/framework/stream_handler/sync_set_input_stream_handler.pb.h"
+#include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/calculators/detection_scheduler_calculator.pb.h"
+#include "mediapipe/tasks/cc/components/processors/proto/detection_tracking_graph_options.pb.h"
+#include "mediapipe/tasks/cc/components/utils/gate.h"
+#include "mediapipe/util/graph_builder_utils.h"
+#include "mediapipe/util/tracking/box_tracker.pb.h"
+#include "mediapipe/util/tracking/motion_analysis.pb.h"
+#include "mediapipe/util/tracking/region_flow_computation.pb.h"
+#include "mediapipe/util/tracking/tracking.pb.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace processors {
+
+namespace {
+
+using ::mediapipe::api2::Input;
+using ::mediapipe::api2::Output;
+using ::mediapipe::api2::builder::Graph;
+using ::mediapipe::api2::builder::Source;
+using ::mediapipe::tasks::components::utils::AllowGate;
+
+constexpr char kImageTag[] = "IMAGE";
+constexpr char kImageCpuTag[] = "IMAGE_CPU";
+constexpr char kNormRectTag[] = "NORM_RECT";
+constexpr char kDetectionsTag[] = "DETECTIONS";
+constexpr char kDetectorImageTag[] = "DETECTOR_IMAGE";
+constexpr char kDetectorNormRectTag[] = "DETECTOR_NORM_RECT";
+constexpr char kTrackedDetectionsTag[] = "TRACKED_DETECTIONS";
+constexpr char kTrackingBoxesTag[] = "TRACKING_BOXES";
+constexpr char kCancelObjectIdTag[] = "CANCEL_OBJECT_ID";
+constexpr char kBoxesTag[] = "BOXES";
+constexpr char kPreviousLoopbackCalculatorName[] = "PreviousLoopbackCalculator";
+constexpr char kBoxTrackerCalculatorName[] = "BoxTrackerCalculator";
+constexpr char kTrackedDetectionManagerCalculatorName[] =
+    "TrackedDetectionManagerCalculator";
+
+struct DetectionTrackingOutputStreams {
+  Source<Image> detector_image;
+  std::optional<Source<NormalizedRect>> detector_norm_rect;
+  Source<std::vector<Detection>> detections;
+};
+
+absl::Status SanityCheckOptions(
+    const proto::DetectionTrackingGraphOptions& options) {
+  if (options.detection_interval() < 1) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Invalid `detection_interval` option: expected a value "
+                        ">= 1, found %d.",
+                        options.detection_interval()),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  if (options.tracking_image_width() <= 0 ||
+      options.tracking_image_height() <= 0) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Invalid tracking image size: width and height must be > 0.",
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  return absl::OkStatus();
+}
+
+// Sets the options of the motion analysis used to track boxes, as in
+// mediapipe/graphs/tracking/subgraphs/box_tracking_cpu.pbtxt.
+void ConfigureMotionAnalysis(MotionAnalysisCalculatorOptions& options) {
+  auto* analysis_options = options.mutable_analysis_options();
+  analysis_options->set_analysis_policy(
+      MotionAnalysisOptions::ANALYSIS_POLICY_CAMERA_MOBILE);
+  auto* flow_options = analysis_options->mutable_flow_options();
+  flow_options->set_fast_estimation_min_block_size(100);
+  flow_options->set_top_inlier_sets(1);
+  flow_options->set_frac_inlier_error_threshold(3e-3);
+  flow_options->set_downsample_mode(
+      RegionFlowComputationOptions::DOWNSAMPLE_TO_INPUT_SIZE);
+  flow_options->set_verification_distance(5.0);
+  flow_options->set_verify_long_feature_acceleration(true);
+  flow_options->set_verify_long_feature_trigger_ratio(0.1);
+  auto* tracking_options = flow_options->mutable_tracking_options();
+  tracking_options->set_max_features(500);
+  tracking_options->set_adaptive_extraction_levels(2);
+  tracking_options->mutable_min_eig_val_settings()
+      ->set_adaptive_lowest_quality_level(2e-4);
+  tracking_options->set_klt_tracker_implementation(
+      TrackingOptions::KLT_OPENCV);
+}
+
+void ConfigureBoxTracker(BoxTrackerCalculatorOptions& options) {
+  auto* track_step_options =
+      options.mutable_tracker_options()->mutable_track_step_options();
+  track_step_options->set_track_object_and_camera(true);
+  track_step_options->set_tracking_degrees(
+      TrackStepOptions::TRACKING_DEGREE_OBJECT_SCALE);
+  track_step_options->set_inlier_spring_force(0.0);
+  track_step_options->set_static_motion_temporal_ratio(3e-2);
+  options.set_visualize_tracking_data(false);
+  options.set_streaming_track_data_cache_size(100);
+}
+
+// Adds a SyncSetInputStreamHandler to `node`, with one sync set per group of
+// tag indices.
+void AddSyncSets(const std::vector<std::vector<std::string>>& sync_sets,
+                 CalculatorGraphConfig::Node& node) {
+  auto* handler = node.mutable_input_stream_handler();
+  handler->set_input_stream_handler("SyncSetInputStreamHandler");
+  auto* handler_options = handler->mutable_options()->MutableExtension(
+      SyncSetInputStreamHandlerOptions::ext);
+  for (const auto& tag_indices : sync_sets) {
+    auto* sync_set = handler_options->add_sync_set();
+    for (const auto& tag_index : tag_indices) {
+      sync_set->add_tag_index(tag_index);
+    }
+  }
+}
+
+void AddBackEdge(const std::string& tag_index,
+                 CalculatorGraphConfig::Node& node) {
+  auto* info = node.add_input_stream_info();
+  info->set_tag_index(tag_index);
+  info->set_back_edge(true);
+}
+
+}  // namespace
+
+bool IsDetectionTrackingEnabled(
+    const proto::DetectionTrackingGraphOptions& options) {
+  return options.detection_interval() > 1;
+}
+
+// A "mediapipe.tasks.components.processors.DetectionTrackingGraph" runs a
+// detector on a subset of the frames of a video stream and tracks the detected
+// objects on the other frames.
+//
+// Inputs:
+//   IMAGE - Image
+//     The input video frames.
+//   NORM_RECT - NormalizedRect @Optional
+//     The region of interest of the detector on each frame.
+//   DETECTIONS - std::vector<Detection>
+//     The detector detections on the DETECTOR_IMAGE frames, with relative
+//     bounding boxes.
+// Outputs:
+//   DETECTOR_IMAGE - Image
+//     The frames the detector must run on.
+//   DETECTOR_NORM_RECT - NormalizedRect @Optional
+//     The NORM_RECT input on the DETECTOR_IMAGE frames.
+//   DETECTIONS - std::vector<Detection>
+//     The detections on every frame, with relative bounding boxes.
+//
+// Example:
+// node {
+//   calculator: "mediapipe.tasks.components.processors.DetectionTrackingGraph"
+//   input_stream: "IMAGE:image"
+//   input_stream: "DETECTIONS:detector_detections"
+//   output_stream: "DETECTOR_IMAGE:detector_image"
+//   output_stream: "DETECTIONS:detections"
+//   options {
+//     [mediapipe.tasks.components.processors.proto.DetectionTrackingGraphOptions.ext]
+//     {
+//       detection_interval: 5
+//       min_tracking_confidence: 0.5
+//     }
+//   }
+// }
+//
+// See the header file for how to wire it around a detector.
+class DetectionTrackingGraph : public Subgraph {
+ public:
+  absl::StatusOr<CalculatorGraphConfig> GetConfig(
+      SubgraphContext* sc) override {
+    Graph graph;
+    std::optional<Source<NormalizedRect>> norm_rect_in;
+    if (HasInput(sc->OriginalNode(), kNormRectTag)) {
+      norm_rect_in = graph[Input<NormalizedRect>(kNormRectTag)];
+    }
+    ASSIGN_OR_RETURN(
+        auto output_streams,
+        BuildDetectionTracking(
+            sc->Options<proto::DetectionTrackingGraphOptions>(),
+            graph[Input<Image>(kImageTag)], norm_rect_in,
+            graph[Input<std::vector<Detection>>(kDetectionsTag)], graph));
+    output_streams.detector_image >> graph[Output<Image>(kDetectorImageTag)];
+    if (output_streams.detector_norm_rect) {
+      *output_streams.detector_norm_rect >>
+          graph[Output<NormalizedRect>(kDetectorNormRectTag)];
+    }
+    output_streams.detections >>
+        graph[Output<std::vector<Detection>>(kDetectionsTag)];
+
+    // As mediapipe GraphBuilder currently doesn't support configuring
+    // InputStreamInfo nor input stream handlers, modifying the
+    // CalculatorGraphConfig proto directly.
+    CalculatorGraphConfig config = graph.GetConfig();
+    for (auto& node : *config.mutable_node()) {
+      if (node.calculator() == kPreviousLoopbackCalculatorName) {
+        AddBackEdge("LOOP", node);
+      } else if (node.calculator() == kBoxTrackerCalculatorName) {
+        AddBackEdge(kCancelObjectIdTag, node);
+        AddSyncSets({{"TRACKING", "TRACK_TIME"}, {"START_POS"},
+                     {kCancelObjectIdTag}},
+                    node);
+      } else if (node.calculator() == kTrackedDetectionManagerCalculatorName) {
+        AddSyncSets({{kTrackingBoxesTag}, {kDetectionsTag}}, node);
+      }
+    }
+    return config;
+  }
+
+ private:
+  // Adds the detector scheduling and box tracking calculators into the
+  // provided builder::Graph instance.
+  //
+  // options: the DetectionTrackingGraphOptions.
+  // image_in: (mediapipe::Image) the input video frames.
+  // norm_rect_in: (mediapipe::NormalizedRect) the optional detector region of
+  //   interest.
+  // detections_in: (std::vector<Detection>) the detector detections.
+  // graph: the mediapipe builder::Graph instance to be updated.
+  absl::StatusOr<DetectionTrackingOutputStreams> BuildDetectionTracking(
+      const proto::DetectionTrackingGraphOptions& options,
+      Source<Image> image_in,
+      std::optional<Source<NormalizedRect>> norm_rect_in,
+      Source<std::vector<Detection>> detections_in, Graph& graph) {
+    MP_RETURN_IF_ERROR(SanityCheckOptions(options));
+
+    // Decides whether the detector runs on the current frame, based on the
+    // boxes tracked on the previous frame.
+    auto& previous_loopback = graph.AddNode(kPreviousLoopbackCalculatorName);
+    image_in >> previous_loopback.In("MAIN");
+    auto prev_tracked_boxes =
+        previous_loopback[Output<TimedBoxProtoList>("PREV_LOOP")];
+    auto& scheduler = graph.AddNode("DetectionSchedulerCalculator");
+    auto& scheduler_options =
+        scheduler.GetOptions<DetectionSchedulerCalculatorOptions>();
+    scheduler_options.set_detection_interval(options.detection_interval());
+    scheduler_options.set_min_tracking_confidence(
+        options.min_tracking_confidence());
+    image_in >> scheduler.In("TICK");
+    prev_tracked_boxes >> scheduler.In("PREV_TRACKED_BOXES");
+    auto detect = scheduler.Out("DETECT").Cast<bool>();
+    AllowGate detector_gate(detect, graph);
+    auto detector_image = detector_gate.Allow(image_in);
+    std::optional<Source<NormalizedRect>> detector_norm_rect;
+    if (norm_rect_in) {
+      detector_norm_rect = detector_gate.Allow(*norm_rect_in);
+    }
+
+    // Estimates the motion between consecutive downscaled frames.
+    auto& from_image = graph.AddNode("FromImageCalculator");
+    image_in >> from_image.In(kImageTag);
+    auto& downscale = graph.AddNode("ImageTransformationCalculator");
+    auto& downscale_options =
+        downscale.GetOptions<ImageTransformationCalculatorOptions>();
+    downscale_options.set_output_width(options.tracking_image_width());
+    downscale_options.set_output_height(options.tracking_image_height());
+    from_image.Out(kImageCpuTag) >> downscale.In(kImageTag);
+    auto& motion_analysis = graph.AddNode("MotionAnalysisCalculator");
+    ConfigureMotionAnalysis(
+        motion_analysis.GetOptions<MotionAnalysisCalculatorOptions>());
+    downscale.Out(kImageTag) >> motion_analysis.In("VIDEO");
+    auto& flow_packager = graph.AddNode("FlowPackagerCalculator");
+    flow_packager.GetOptions<FlowPackagerCalculatorOptions>()
+        .mutable_flow_packager_options()
+        ->set_binary_tracking_data_support(false);
+    motion_analysis.Out("FLOW") >> flow_packager.In("FLOW");
+    motion_analysis.Out("CAMERA") >> flow_packager.In("CAMERA");
+
+    // Starts tracking the detector detections.
+    auto& unique_id = graph.AddNode("DetectionUniqueIdCalculator");
+    detections_in >> unique_id.In(kDetectionsTag);
+    auto detections_with_id = unique_id.Out(kDetectionsTag);
+    auto& detections_to_boxes =
+        graph.AddNode("DetectionsToTimedBoxListCalculator");
+    detections_with_id >> detections_to_boxes.In(kDetectionsTag);
+
+    auto& box_tracker = graph.AddNode(kBoxTrackerCalculatorName);
+    ConfigureBoxTracker(box_tracker.GetOptions<BoxTrackerCalculatorOptions>());
+    flow_packager.Out("TRACKING") >> box_tracker.In("TRACKING");
+    image_in >> box_tracker.In("TRACK_TIME");
+    detections_to_boxes.Out(kBoxesTag) >> box_tracker.In("START_POS");
+    auto tracked_boxes = box_tracker[Output<TimedBoxProtoList>(kBoxesTag)];
+    tracked_boxes >> previous_loopback.In("LOOP");
+
+    // Turns the tracked boxes back into detections, and cancels the tracking
+    // of the boxes superseded by new detections.
+    auto& tracked_detection_manager =
+        graph.AddNode(kTrackedDetectionManagerCalculatorName);
+    detections_with_id >> tracked_detection_manager.In(kDetectionsTag);
+    tracked_boxes >> tracked_detection_manager.In(kTrackingBoxesTag);
+    tracked_detection_manager.Out(kCancelObjectIdTag) >>
+        box_tracker.In(kCancelObjectIdTag);
+
+    auto& tracked_detections = graph.AddNode("TrackedDetectionsCalculator");
+    detections_with_id >> tracked_detections.In(kDetectionsTag);
+    tracked_detection_manager.Out(kDetectionsTag) >>
+        tracked_detections.In(kTrackedDetectionsTag);
+
+    return {{
+        /* detector_image= */ detector_image,
+        /* detector_norm_rect= */ detector_norm_rect,
+        /* detections= */
+        tracked_detections[Output<std::vector<Detection>>(kDetectionsTag)],
+    }};
+  }
+};
+
+// REGISTER_MEDIAPIPE_GRAPH argument has to fit on one line to work properly.
+// clang-format off
+REGISTER_MEDIAPIPE_GRAPH(
+  ::mediapipe::tasks::components::processors::DetectionTrackingGraph); // NOLINT
+// clang-format on
+
+}  // namespace processors
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
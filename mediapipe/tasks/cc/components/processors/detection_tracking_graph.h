@@ -0,0 +1,77 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_COMPONENTS_PROCESSORS_DETECTION_TRACKING_GRAPH_H_
+#define MEDIAPIPE_TASKS_CC_COMPONENTS_PROCESSORS_DETECTION_TRACKING_GRAPH_H_
+
+#include "mediapipe/tasks/cc/components/processors/proto/detection_tracking_graph_options.pb.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace processors {
+
+// Returns whether the provided options make a DetectionTrackingGraph skip any
+// detector run, i.e. whether adding the graph is worthwhile.
+bool IsDetectionTrackingEnabled(
+    const proto::DetectionTrackingGraphOptions& options);
+
+// A DetectionTrackingGraph lets a detector run on a subset of the frames of a
+// video stream, and tracks the detected objects on the other frames using the
+// BoxTracker from mediapipe/util/tracking. The detector runs on the first
+// frame, then at least once every `detection_interval` frames, and on any
+// frame following one where a tracked box has a low tracking confidence.
+//
+// The graph sits around the detector: it forwards the input images the
+// detector must run on, and takes the resulting detections back. For
+// instance:
+//
+//   auto& tracking = graph.AddNode(
+//       "mediapipe.tasks.components.processors.DetectionTrackingGraph");
+//   tracking.GetOptions<DetectionTrackingGraphOptions>()
+//       .set_detection_interval(5);
+//   image >> tracking.In("IMAGE");
+//   tracking.Out("DETECTOR_IMAGE") >> detector.In("IMAGE");
+//   detector.Out("DETECTIONS") >> tracking.In("DETECTIONS");
+//   auto detections = tracking.Out("DETECTIONS");
+//
+// Tracked detections only keep the bounding box, labels, label ids, display
+// names and scores of the detector detections. The graph must be used with
+// the VIDEO or LIVE_STREAM running modes.
+//
+// Inputs:
+//   IMAGE - Image
+//     The input video frames.
+//   NORM_RECT - NormalizedRect @Optional
+//     The region of interest of the detector on each frame.
+//   DETECTIONS - std::vector<Detection>
+//     The detector detections on the DETECTOR_IMAGE frames, with relative
+//     bounding boxes.
+// Outputs:
+//   DETECTOR_IMAGE - Image
+//     The frames the detector must run on.
+//   DETECTOR_NORM_RECT - NormalizedRect @Optional
+//     The NORM_RECT input on the DETECTOR_IMAGE frames.
+//   DETECTIONS - std::vector<Detection>
+//     The detections on every frame, with relative bounding boxes: the
+//     detector detections on the frames it ran on, the tracked detections
+//     otherwise.
+
+}  // namespace processors
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_TASKS_CC_COMPONENTS_PROCESSORS_DETECTION_TRACKING_GRAPH_H_
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/components/processors/embedding_postprocessing_graph.h"
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -28,11 +29,13 @@ limitations under the License.
 #include "mediapipe/framework/tool/options_map.h"
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/components/calculators/tensors_to_embeddings_calculator.pb.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
 #include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedder_options.pb.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedding_postprocessing_graph_options.pb.h"
 #include "mediapipe/tasks/cc/core/model_resources.h"
 #include "mediapipe/tasks/cc/metadata/metadata_extractor.h"
+#include "mediapipe/util/graph_builder_utils.h"
 #include "tensorflow/lite/schema/schema_generated.h"
 
 namespace mediapipe {
@@ -52,14 +55,16 @@ using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
 using ::mediapipe::tasks::core::ModelResources;
 
 constexpr char kTensorsTag[] = "TENSORS";
+constexpr char kEmbeddingResultTag[] = "EMBEDDING_RESULT";
 constexpr char kEmbeddingsTag[] = "EMBEDDINGS";
 constexpr char kTimestampedEmbeddingsTag[] = "TIMESTAMPED_EMBEDDINGS";
 constexpr char kTimestampsTag[] = "TIMESTAMPS";
 
 // Struct holding the different output streams produced by the graph.
 struct EmbeddingPostprocessingOutputStreams {
-  Source<EmbeddingResult> embeddings;
-  Source<std::vector<EmbeddingResult>> timestamped_embeddings;
+  std::optional<Source<EmbeddingResult>> embeddings;
+  std::optional<Source<std::vector<EmbeddingResult>>> timestamped_embeddings;
+  std::optional<Source<containers::EmbeddingResult>> embedding_result;
 };
 
 // Identifies whether or not the model has quantized outputs, and performs
@@ -188,6 +193,11 @@ absl::Status ConfigureEmbeddingPostprocessingGraph(
 //     The embedding result aggregated by timestamp, then by head. Must be
 //     connected if the TIMESTAMPS input is connected, as it signals that
 //     timestamp aggregation is required.
+//   EMBEDDING_RESULT - components::containers::EmbeddingResult @Optional
+//     The embedding results aggregated by head, as a struct. Can only be
+//     connected if the TIMESTAMPS input is not connected. If neither the
+//     EMBEDDINGS nor the TIMESTAMPED_EMBEDDINGS outputs are connected, the
+//     EmbeddingResult protos are not built at all.
 //
 // The recommended way of using this graph is through the GraphBuilder API using
 // the 'ConfigureEmbeddingPostprocessingGraph()' function. See header file for
@@ -196,35 +206,64 @@ class EmbeddingPostprocessingGraph : public mediapipe::Subgraph {
  public:
   absl::StatusOr<mediapipe::CalculatorGraphConfig> GetConfig(
       mediapipe::SubgraphContext* sc) override {
+    const bool output_embedding_result =
+        HasOutput(sc->OriginalNode(), kEmbeddingResultTag);
+    if (output_embedding_result &&
+        HasInput(sc->OriginalNode(), kTimestampsTag)) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "The EMBEDDING_RESULT output does not support timestamp "
+          "aggregation and can't be used with the TIMESTAMPS input.",
+          MediaPipeTasksStatus::kInvalidArgumentError);
+    }
+    const bool output_protos =
+        !output_embedding_result ||
+        HasOutput(sc->OriginalNode(), kEmbeddingsTag) ||
+        HasOutput(sc->OriginalNode(), kTimestampedEmbeddingsTag);
     Graph graph;
     ASSIGN_OR_RETURN(
         auto output_streams,
         BuildEmbeddingPostprocessing(
             sc->Options<proto::EmbeddingPostprocessingGraphOptions>(),
             graph[Input<std::vector<Tensor>>(kTensorsTag)],
-            graph[Input<std::vector<Timestamp>>(kTimestampsTag)], graph));
-    output_streams.embeddings >> graph[Output<EmbeddingResult>(kEmbeddingsTag)];
-    output_streams.timestamped_embeddings >>
-        graph[Output<std::vector<EmbeddingResult>>(kTimestampedEmbeddingsTag)];
+            graph[Input<std::vector<Timestamp>>(kTimestampsTag)],
+            output_protos, output_embedding_result, graph));
+    if (output_streams.embeddings) {
+      *output_streams.embeddings >>
+          graph[Output<EmbeddingResult>(kEmbeddingsTag)];
+    }
+    if (output_streams.timestamped_embeddings) {
+      *output_streams.timestamped_embeddings >>
+          graph[Output<std::vector<EmbeddingResult>>(
+              kTimestampedEmbeddingsTag)];
+    }
+    if (output_streams.embedding_result) {
+      *output_streams.embedding_result >>
+          graph[Output<containers::EmbeddingResult>(kEmbeddingResultTag)];
+    }
     return graph.GetConfig();
   }
 
  private:
   // Adds an on-device embedding postprocessing graph into the provided
   // builder::Graph instance. The embedding postprocessing graph takes tensors
-  // (std::vector<mediapipe::Tensor>) as input and returns one output stream
+  // (std::vector<mediapipe::Tensor>) as input and returns the output streams
   // containing the output embedding results (EmbeddingResult).
   //
   // options: the on-device EmbeddingPostprocessingGraphOptions
   // tensors_in: (std::vector<mediapipe::Tensor>) tensors to postprocess.
   // timestamps_in: (std::vector<mediapipe::Timestamp>) optional collection of
   //   timestamps that should be used to aggregate embedding results.
+  // output_protos: whether to output the EmbeddingResult protos, aggregated
+  //   by the EmbeddingAggregationCalculator.
+  // output_embedding_result: whether to output the EmbeddingResult struct.
   // graph: the mediapipe builder::Graph instance to be updated.
   absl::StatusOr<EmbeddingPostprocessingOutputStreams>
   BuildEmbeddingPostprocessing(
       const proto::EmbeddingPostprocessingGraphOptions options,
       Source<std::vector<Tensor>> tensors_in,
-      Source<std::vector<Timestamp>> timestamps_in, Graph& graph) {
+      Source<std::vector<Timestamp>> timestamps_in, bool output_protos,
+      bool output_embedding_result, Graph& graph) {
     // If output tensors are quantized, they must be dequantized first.
     Source<std::vector<Tensor>> dequantized_tensors = tensors_in;
     if (options.has_quantized_outputs()) {
@@ -243,19 +282,26 @@ class EmbeddingPostprocessingGraph : public mediapipe::Subgraph {
         .CopyFrom(options.tensors_to_embeddings_options());
     dequantized_tensors >> tensors_to_embeddings_node.In(kTensorsTag);
 
-    // Adds EmbeddingAggregationCalculator.
-    GenericNode& aggregation_node =
-        graph.AddNode("EmbeddingAggregationCalculator");
-    tensors_to_embeddings_node[Output<EmbeddingResult>(kEmbeddingsTag)] >>
-        aggregation_node.In(kEmbeddingsTag);
-    timestamps_in >> aggregation_node.In(kTimestampsTag);
-
-    // Connects outputs.
-    return EmbeddingPostprocessingOutputStreams{
-        /*embeddings=*/aggregation_node[Output<EmbeddingResult>(
-            kEmbeddingsTag)],
-        /*timestamped_embeddings=*/aggregation_node
-            [Output<std::vector<EmbeddingResult>>(kTimestampedEmbeddingsTag)]};
+    EmbeddingPostprocessingOutputStreams output_streams;
+    if (output_embedding_result) {
+      output_streams.embedding_result =
+          tensors_to_embeddings_node[Output<containers::EmbeddingResult>(
+              kEmbeddingResultTag)];
+    }
+    if (output_protos) {
+      // Adds EmbeddingAggregationCalculator.
+      GenericNode& aggregation_node =
+          graph.AddNode("EmbeddingAggregationCalculator");
+      tensors_to_embeddings_node[Output<EmbeddingResult>(kEmbeddingsTag)] >>
+          aggregation_node.In(kEmbeddingsTag);
+      timestamps_in >> aggregation_node.In(kTimestampsTag);
+      output_streams.embeddings =
+          aggregation_node[Output<EmbeddingResult>(kEmbeddingsTag)];
+      output_streams.timestamped_embeddings =
+          aggregation_node[Output<std::vector<EmbeddingResult>>(
+              kTimestampedEmbeddingsTag)];
+    }
+    return output_streams;
   }
 };
 REGISTER_MEDIAPIPE_GRAPH(
@@ -58,6 +58,11 @@ namespace processors {
 //     The embedding result aggregated by timestamp, then by head. Must be
 //     connected if the TIMESTAMPS input is connected, as it signals that
 //     timestamp aggregation is required.
+//   EMBEDDING_RESULT - components::containers::EmbeddingResult @Optional
+//     The embedding results aggregated by head, as a struct. Can only be
+//     connected if the TIMESTAMPS input is not connected. If neither the
+//     EMBEDDINGS nor the TIMESTAMPED_EMBEDDINGS outputs are connected, the
+//     EmbeddingResult protos are not built at all.
 absl::Status ConfigureEmbeddingPostprocessingGraph(
     const tasks::core::ModelResources& model_resources,
     const proto::EmbedderOptions& embedder_options,
@@ -34,6 +34,7 @@ limitations under the License.
 #include "mediapipe/framework/port/status_matchers.h"
 #include "mediapipe/framework/timestamp.h"
 #include "mediapipe/tasks/cc/components/calculators/tensors_to_embeddings_calculator.pb.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
 #include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedder_options.pb.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedding_postprocessing_graph_options.pb.h"
@@ -76,6 +77,8 @@ constexpr char kEmbeddingsTag[] = "EMBEDDINGS";
 constexpr char kEmbeddingsName[] = "embeddings";
 constexpr char kTimestampedEmbeddingsTag[] = "TIMESTAMPED_EMBEDDINGS";
 constexpr char kTimestampedEmbeddingsName[] = "timestamped_embeddings";
+constexpr char kEmbeddingResultTag[] = "EMBEDDING_RESULT";
+constexpr char kEmbeddingResultName[] = "embedding_result";
 
 // Helper function to get ModelResources.
 absl::StatusOr<std::unique_ptr<ModelResources>> CreateModelResourcesForModel(
@@ -158,7 +161,8 @@ class PostprocessingTest : public tflite::testing::Test {
   absl::StatusOr<OutputStreamPoller> BuildGraph(
       absl::string_view model_name, const proto::EmbedderOptions& options,
       bool connect_timestamps = false,
-      const std::vector<absl::string_view>& ignored_head_names = {}) {
+      const std::vector<absl::string_view>& ignored_head_names = {},
+      bool output_embedding_result = false) {
     ASSIGN_OR_RETURN(auto model_resources,
                      CreateModelResourcesForModel(model_name));
 
@@ -185,12 +189,22 @@ class PostprocessingTest : public tflite::testing::Test {
               .SetName(kTimestampedEmbeddingsName) >>
           graph[Output<std::vector<EmbeddingResult>>(
               kTimestampedEmbeddingsTag)];
-    } else {
+    } else if (!output_embedding_result) {
       postprocessing.Out(kEmbeddingsTag).SetName(kEmbeddingsName) >>
           graph[Output<EmbeddingResult>(kEmbeddingsTag)];
     }
+    if (output_embedding_result) {
+      postprocessing.Out(kEmbeddingResultTag).SetName(kEmbeddingResultName) >>
+          graph[Output<containers::EmbeddingResult>(kEmbeddingResultTag)];
+    }
 
     MP_RETURN_IF_ERROR(calculator_graph_.Initialize(graph.GetConfig()));
+    if (output_embedding_result) {
+      ASSIGN_OR_RETURN(auto poller, calculator_graph_.AddOutputStreamPoller(
+                                        kEmbeddingResultName));
+      MP_RETURN_IF_ERROR(calculator_graph_.StartRun(/*extra_side_packets=*/{}));
+      return poller;
+    }
     if (connect_timestamps) {
       ASSIGN_OR_RETURN(auto poller, calculator_graph_.AddOutputStreamPoller(
                                         kTimestampedEmbeddingsName));
@@ -303,6 +317,49 @@ TEST_F(PostprocessingTest, SucceedsWithFilter) {
   EXPECT_EQ(results.embeddings_size(), 0);
 }
 
+TEST_F(PostprocessingTest, SucceedsWithEmbeddingResult) {
+  // Build graph.
+  proto::EmbedderOptions options;
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto poller,
+      BuildGraph(kMobileNetV3Embedder, options, /*connect_timestamps=*/false,
+                 /*ignored_head_names=*/{},
+                 /*output_embedding_result=*/true));
+  // Build input tensor.
+  std::vector<float> tensor(kMobileNetV3EmbedderEmbeddingSize, 0);
+  tensor[0] = 1.0;
+
+  // Send tensor and get results.
+  AddTensor(tensor, Tensor::ElementType::kFloat32);
+  MP_ASSERT_OK(Run(/*aggregation_timestamps=*/std::nullopt,
+                   /*timestamp=*/1000));
+  MP_ASSERT_OK_AND_ASSIGN(auto results,
+                          GetResult<containers::EmbeddingResult>(poller));
+
+  // Validate results.
+  EXPECT_EQ(results.timestamp_ms, 1);
+  ASSERT_EQ(results.embeddings.size(), 1);
+  EXPECT_EQ(results.embeddings[0].head_index, 0);
+  EXPECT_EQ(results.embeddings[0].head_name, "feature");
+  ASSERT_EQ(results.embeddings[0].float_embedding.size(),
+            kMobileNetV3EmbedderEmbeddingSize);
+  EXPECT_FLOAT_EQ(results.embeddings[0].float_embedding[0], 1.0);
+  for (int i = 1; i < kMobileNetV3EmbedderEmbeddingSize; ++i) {
+    EXPECT_FLOAT_EQ(results.embeddings[0].float_embedding[i], 0.0);
+  }
+}
+
+TEST_F(PostprocessingTest, FailsWithEmbeddingResultAndAggregation) {
+  proto::EmbedderOptions options;
+  auto poller_or =
+      BuildGraph(kMobileNetV3Embedder, options, /*connect_timestamps=*/true,
+                 /*ignored_head_names=*/{},
+                 /*output_embedding_result=*/true);
+
+  EXPECT_THAT(poller_or.status().message(),
+              ::testing::HasSubstr("does not support timestamp aggregation"));
+}
+
 TEST_F(PostprocessingTest, SucceedsWithAggregation) {
   // Build graph.
   proto::EmbedderOptions options;
@@ -260,6 +260,8 @@ class TextPreprocessingGraph : public mediapipe::Subgraph {
             .set_bert_max_seq_len(options.max_seq_len());
         text_preprocessor.GetOptions<BertPreprocessorCalculatorOptions>()
             .set_has_dynamic_input_tensors(options.has_dynamic_input_tensors());
+        text_preprocessor.GetOptions<BertPreprocessorCalculatorOptions>()
+            .set_bucket_dynamic_seq_len(options.bucket_dynamic_seq_len());
         metadata_extractor_in >>
             text_preprocessor.SideIn(kMetadataExtractorTag);
         break;
@@ -28,6 +28,10 @@ namespace processors {
 // Configures a TextPreprocessingGraph using the provided `model_resources`
 // and TextPreprocessingGraphOptions.
 // - Accepts a std::string input and outputs CPU tensors.
+// - For BERT models with dynamic input tensors, `bucket_dynamic_seq_len` can be
+//   set in the options to pad the tensors to the next power of two of the
+//   input length, so that the model's tensors are only resized when the input
+//   length falls into a different bucket. It is preserved by this function.
 //
 // Example usage:
 //
@@ -0,0 +1,606 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/components/utils/embedding_index.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_format.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/framework/deps/file_helpers.h"
+#include "mediapipe/framework/port/status_macros.h"
+#include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
+#include "mediapipe/tasks/cc/core/external_file_handler.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace utils {
+
+namespace {
+
+using ::mediapipe::tasks::components::containers::Embedding;
+using ::mediapipe::tasks::core::ExternalFileHandler;
+
+// Index files consist of a header made of the fields below, followed by:
+// - the inverse L2-norms of the embeddings (`size` floats),
+// - the embeddings (`size` x `dimension` floats or int8 values, padded to a
+//   multiple of 4 bytes),
+// - the partition centroids (`num_partitions` x `dimension` floats),
+// - the partition offsets in the partition members (`num_partitions` + 1
+//   uint32 values),
+// - the partition members, i.e. the indices of the embeddings of each
+//   partition (`size` uint32 values if `num_partitions` > 0).
+// All values are stored in native byte order.
+constexpr char kFileMagic[4] = {'M', 'P', 'E', 'I'};
+constexpr uint32_t kFileVersion = 1;
+
+struct FileHeader {
+  char magic[4];
+  uint32_t version;
+  uint32_t quantized;
+  uint32_t dimension;
+  uint32_t size;
+  uint32_t num_partitions;
+};
+
+size_t PaddedSize(size_t num_bytes) { return (num_bytes + 3) / 4 * 4; }
+
+void AppendBytes(const void* data, size_t num_bytes, std::string* output) {
+  output->append(static_cast<const char*>(data), num_bytes);
+  output->resize(PaddedSize(output->size()), '\0');
+}
+
+absl::Status CreateInvalidFileError(absl::string_view message) {
+  return CreateStatusWithPayload(
+      absl::StatusCode::kInvalidArgument,
+      absl::StrFormat("Invalid embedding index file: %s", message),
+      MediaPipeTasksStatus::kInvalidArgumentError);
+}
+
+// Returns `a` * `b`, or an error if the product overflows.
+absl::StatusOr<size_t> CheckedMultiply(size_t a, size_t b) {
+  if (a != 0 && b > std::numeric_limits<size_t>::max() / a) {
+    return CreateInvalidFileError("section sizes overflow");
+  }
+  return a * b;
+}
+
+// Returns `a` + `b`, or an error if the sum overflows.
+absl::StatusOr<size_t> CheckedAdd(size_t a, size_t b) {
+  if (b > std::numeric_limits<size_t>::max() - a) {
+    return CreateInvalidFileError("section sizes overflow");
+  }
+  return a + b;
+}
+
+// Returns the end of a section of `count` values of `value_size` bytes
+// starting at `offset`, padded to a multiple of 4 bytes, or an error if it
+// overflows. `offset` must be a multiple of 4.
+absl::StatusOr<size_t> SectionEnd(size_t offset, size_t count,
+                                  size_t value_size) {
+  ASSIGN_OR_RETURN(size_t num_bytes, CheckedMultiply(count, value_size));
+  ASSIGN_OR_RETURN(size_t end, CheckedAdd(offset, num_bytes));
+  ASSIGN_OR_RETURN(size_t padded_end, CheckedAdd(end, 3));
+  return padded_end / 4 * 4;
+}
+
+// Dot product kernels. The float kernel accumulates into independent partial
+// sums, which lets the compiler vectorize the loop without having to reorder
+// floating-point additions. The int8 kernel accumulates exactly into 32-bit
+// integers, which vectorizes as is.
+template <typename T>
+float DotProduct(const float* u, const T* v, int num_elements) {
+  constexpr int kNumSums = 8;
+  float sums[kNumSums] = {};
+  int i = 0;
+  for (; i + kNumSums <= num_elements; i += kNumSums) {
+    for (int j = 0; j < kNumSums; ++j) {
+      sums[j] += u[i + j] * v[i + j];
+    }
+  }
+  float sum = 0.0f;
+  for (int j = 0; j < kNumSums; ++j) {
+    sum += sums[j];
+  }
+  for (; i < num_elements; ++i) {
+    sum += u[i] * v[i];
+  }
+  return sum;
+}
+
+float DotProduct(const int8_t* u, const int8_t* v, int num_elements) {
+  int32_t sum = 0;
+  for (int i = 0; i < num_elements; ++i) {
+    sum += static_cast<int32_t>(u[i]) * static_cast<int32_t>(v[i]);
+  }
+  return static_cast<float>(sum);
+}
+
+const int8_t* QuantizedData(const Embedding& embedding) {
+  return reinterpret_cast<const int8_t*>(embedding.quantized_embedding.data());
+}
+
+// Keeps track of the results with the highest similarities.
+class TopResults {
+ public:
+  explicit TopResults(int max_results) : max_results_(max_results) {
+    heap_.reserve(max_results);
+  }
+
+  void Add(int index, float similarity) {
+    if (static_cast<int>(heap_.size()) < max_results_) {
+      heap_.push_back({index, similarity});
+      std::push_heap(heap_.begin(), heap_.end(), IsMoreSimilar);
+    } else if (similarity > heap_.front().similarity) {
+      std::pop_heap(heap_.begin(), heap_.end(), IsMoreSimilar);
+      heap_.back() = {index, similarity};
+      std::push_heap(heap_.begin(), heap_.end(), IsMoreSimilar);
+    }
+  }
+
+  // Returns the results sorted by decreasing similarity, and by increasing
+  // index for equal similarities.
+  std::vector<EmbeddingSearchResult> Sorted() && {
+    std::sort(heap_.begin(), heap_.end(), IsMoreSimilar);
+    return std::move(heap_);
+  }
+
+ private:
+  static bool IsMoreSimilar(const EmbeddingSearchResult& a,
+                            const EmbeddingSearchResult& b) {
+    if (a.similarity != b.similarity) return a.similarity > b.similarity;
+    return a.index < b.index;
+  }
+
+  const int max_results_;
+  // Min-heap on similarity of the best results so far.
+  std::vector<EmbeddingSearchResult> heap_;
+};
+
+}  // namespace
+
+absl::StatusOr<std::unique_ptr<EmbeddingIndex>> EmbeddingIndex::Create(
+    const EmbeddingIndexOptions& options) {
+  if (options.num_partitions < 0 || options.num_partitions_to_search < 1 ||
+      options.num_partitioning_iterations < 1) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Expected num_partitions >= 0, num_partitions_to_search >= 1 and "
+        "num_partitioning_iterations >= 1",
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  return std::unique_ptr<EmbeddingIndex>(new EmbeddingIndex(options));
+}
+
+absl::StatusOr<std::unique_ptr<EmbeddingIndex>> EmbeddingIndex::CreateFromFile(
+    const core::proto::ExternalFile* external_file,
+    const EmbeddingIndexOptions& options) {
+  ASSIGN_OR_RETURN(auto index, Create(options));
+  ASSIGN_OR_RETURN(index->file_handler_,
+                   ExternalFileHandler::CreateFromExternalFile(external_file));
+  absl::string_view content = index->file_handler_->GetFileContent();
+
+  FileHeader header;
+  if (content.size() < sizeof(header)) {
+    return CreateInvalidFileError("file is too small");
+  }
+  std::memcpy(&header, content.data(), sizeof(header));
+  if (std::memcmp(header.magic, kFileMagic, sizeof(kFileMagic)) != 0) {
+    return CreateInvalidFileError("missing file identifier");
+  }
+  if (header.version != kFileVersion) {
+    return CreateInvalidFileError(
+        absl::StrFormat("unsupported version %d", header.version));
+  }
+  // The dimension, size and number of partitions are stored as ints.
+  constexpr uint32_t kMaxCount = std::numeric_limits<int>::max();
+  if (header.quantized > 1) {
+    return CreateInvalidFileError(
+        absl::StrFormat("invalid quantized flag %d", header.quantized));
+  }
+  if (header.dimension > kMaxCount || header.size > kMaxCount ||
+      header.num_partitions > kMaxCount) {
+    return CreateInvalidFileError(absl::StrFormat(
+        "dimension %d, size %d or number of partitions %d is too large",
+        header.dimension, header.size, header.num_partitions));
+  }
+  if (header.dimension == 0 && (header.size > 0 || header.num_partitions > 0)) {
+    return CreateInvalidFileError("embeddings have a dimension of 0");
+  }
+  ASSIGN_OR_RETURN(const size_t num_values,
+                   CheckedMultiply(header.size, header.dimension));
+  ASSIGN_OR_RETURN(
+      const size_t num_centroid_values,
+      CheckedMultiply(header.num_partitions, header.dimension));
+  const size_t num_offsets =
+      header.num_partitions > 0
+          ? static_cast<size_t>(header.num_partitions) + 1
+          : 0;
+  const size_t num_members = header.num_partitions > 0 ? header.size : 0;
+  const size_t norms_offset = sizeof(header);
+  ASSIGN_OR_RETURN(const size_t data_offset,
+                   SectionEnd(norms_offset, header.size, sizeof(float)));
+  ASSIGN_OR_RETURN(
+      const size_t centroids_offset,
+      SectionEnd(data_offset, num_values, header.quantized ? 1 : 4));
+  ASSIGN_OR_RETURN(const size_t offsets_offset,
+                   SectionEnd(centroids_offset, num_centroid_values, 4));
+  ASSIGN_OR_RETURN(const size_t members_offset,
+                   SectionEnd(offsets_offset, num_offsets, 4));
+  ASSIGN_OR_RETURN(const size_t file_size,
+                   SectionEnd(members_offset, num_members, 4));
+  if (content.size() != file_size) {
+    return CreateInvalidFileError(absl::StrFormat(
+        "expected %d bytes, got %d", file_size, content.size()));
+  }
+
+  index->quantized_ = header.quantized != 0;
+  index->dimension_ = header.dimension;
+  index->size_ = header.size;
+  // Mapped files are page-aligned, but in-memory file contents may not be
+  // aligned for floats, in which case the embeddings are copied.
+  if (reinterpret_cast<uintptr_t>(content.data()) % alignof(float) == 0) {
+    index->inverse_norms_ =
+        reinterpret_cast<const float*>(content.data() + norms_offset);
+    if (index->quantized_) {
+      index->quantized_data_ =
+          reinterpret_cast<const int8_t*>(content.data() + data_offset);
+    } else {
+      index->float_data_ =
+          reinterpret_cast<const float*>(content.data() + data_offset);
+    }
+  } else {
+    index->owned_inverse_norms_.resize(header.size);
+    std::memcpy(index->owned_inverse_norms_.data(),
+                content.data() + norms_offset, header.size * sizeof(float));
+    index->inverse_norms_ = index->owned_inverse_norms_.data();
+    if (index->quantized_) {
+      index->owned_quantized_data_.resize(num_values);
+      std::memcpy(index->owned_quantized_data_.data(),
+                  content.data() + data_offset, num_values);
+      index->quantized_data_ = index->owned_quantized_data_.data();
+    } else {
+      index->owned_float_data_.resize(num_values);
+      std::memcpy(index->owned_float_data_.data(),
+                  content.data() + data_offset, num_values * sizeof(float));
+      index->float_data_ = index->owned_float_data_.data();
+    }
+    index->file_handler_.reset();
+  }
+
+  if (header.num_partitions > 0) {
+    index->centroids_.resize(static_cast<size_t>(header.num_partitions) *
+                             header.dimension);
+    std::memcpy(index->centroids_.data(), content.data() + centroids_offset,
+                index->centroids_.size() * sizeof(float));
+    std::vector<uint32_t> offsets(num_offsets);
+    std::memcpy(offsets.data(), content.data() + offsets_offset,
+                offsets.size() * sizeof(uint32_t));
+    std::vector<uint32_t> members(header.size);
+    std::memcpy(members.data(), content.data() + members_offset,
+                members.size() * sizeof(uint32_t));
+    if (offsets.front() != 0 || offsets.back() != header.size) {
+      return CreateInvalidFileError("invalid partition offsets");
+    }
+    index->partitions_.resize(header.num_partitions);
+    for (int p = 0; p < header.num_partitions; ++p) {
+      if (offsets[p] > offsets[p + 1]) {
+        return CreateInvalidFileError("invalid partition offsets");
+      }
+      for (uint32_t m = offsets[p]; m < offsets[p + 1]; ++m) {
+        if (members[m] >= header.size) {
+          return CreateInvalidFileError("invalid partition members");
+        }
+        index->partitions_[p].push_back(members[m]);
+      }
+    }
+  }
+  return index;
+}
+
+absl::StatusOr<float> EmbeddingIndex::CheckEmbedding(
+    const Embedding& embedding) const {
+  const bool quantized = embedding.float_embedding.empty();
+  const int dimension = quantized ? embedding.quantized_embedding.size()
+                                  : embedding.float_embedding.size();
+  if (dimension == 0) {
+    return CreateStatusWithPayload(absl::StatusCode::kInvalidArgument,
+                                   "Expected a non-empty embedding",
+                                   MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  if (quantized != quantized_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected a %s embedding, got a %s one",
+                        quantized_ ? "quantized" : "float",
+                        quantized ? "quantized" : "float"),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  if (dimension != dimension_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected an embedding of size %d, got %d", dimension_,
+                        dimension),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  const float squared_norm =
+      quantized ? DotProduct(QuantizedData(embedding), QuantizedData(embedding),
+                             dimension)
+                : DotProduct(embedding.float_embedding.data(),
+                             embedding.float_embedding.data(), dimension);
+  if (squared_norm <= 0.0f) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Cannot compute cosine similarity on embedding with 0 norm",
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  return 1.0f / std::sqrt(squared_norm);
+}
+
+void EmbeddingIndex::CopyMappedEmbeddings() {
+  if (file_handler_ == nullptr) return;
+  const size_t num_values = static_cast<size_t>(size_) * dimension_;
+  owned_inverse_norms_.assign(inverse_norms_, inverse_norms_ + size_);
+  inverse_norms_ = owned_inverse_norms_.data();
+  if (quantized_) {
+    owned_quantized_data_.assign(quantized_data_, quantized_data_ + num_values);
+    quantized_data_ = owned_quantized_data_.data();
+  } else {
+    owned_float_data_.assign(float_data_, float_data_ + num_values);
+    float_data_ = owned_float_data_.data();
+  }
+  file_handler_.reset();
+}
+
+absl::StatusOr<int> EmbeddingIndex::Add(const Embedding& embedding) {
+  if (size_ == 0) {
+    quantized_ = embedding.float_embedding.empty();
+    dimension_ = quantized_ ? embedding.quantized_embedding.size()
+                            : embedding.float_embedding.size();
+  }
+  ASSIGN_OR_RETURN(float inverse_norm, CheckEmbedding(embedding));
+  CopyMappedEmbeddings();
+  owned_inverse_norms_.push_back(inverse_norm);
+  inverse_norms_ = owned_inverse_norms_.data();
+  if (quantized_) {
+    const int8_t* data = QuantizedData(embedding);
+    owned_quantized_data_.insert(owned_quantized_data_.end(), data,
+                                 data + dimension_);
+    quantized_data_ = owned_quantized_data_.data();
+  } else {
+    owned_float_data_.insert(owned_float_data_.end(),
+                             embedding.float_embedding.begin(),
+                             embedding.float_embedding.end());
+    float_data_ = owned_float_data_.data();
+  }
+  if (is_partitioned()) {
+    partitions_[ClosestPartition(size_)].push_back(size_);
+  }
+  return size_++;
+}
+
+float EmbeddingIndex::Similarity(const Embedding& query,
+                                 float query_inverse_norm, int i) const {
+  const size_t offset = static_cast<size_t>(i) * dimension_;
+  const float dot_product =
+      quantized_
+          ? DotProduct(QuantizedData(query), quantized_data_ + offset,
+                       dimension_)
+          : DotProduct(query.float_embedding.data(), float_data_ + offset,
+                       dimension_);
+  return dot_product * query_inverse_norm * inverse_norms_[i];
+}
+
+float EmbeddingIndex::CentroidDotProduct(const float* centroid, int i) const {
+  const size_t offset = static_cast<size_t>(i) * dimension_;
+  return quantized_
+             ? DotProduct(centroid, quantized_data_ + offset, dimension_)
+             : DotProduct(centroid, float_data_ + offset, dimension_);
+}
+
+int EmbeddingIndex::ClosestPartition(int i) const {
+  int closest_partition = 0;
+  float max_dot_product = -std::numeric_limits<float>::infinity();
+  for (int p = 0; p < partitions_.size(); ++p) {
+    const float dot_product =
+        CentroidDotProduct(centroids_.data() + p * dimension_, i);
+    if (dot_product > max_dot_product) {
+      max_dot_product = dot_product;
+      closest_partition = p;
+    }
+  }
+  return closest_partition;
+}
+
+absl::Status EmbeddingIndex::Partition() {
+  const int num_partitions = options_.num_partitions;
+  if (num_partitions < 1 || num_partitions > size_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Cannot split %d embeddings into %d partitions", size_,
+                        num_partitions),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  // Runs spherical k-means, i.e. k-means on the L2-normalized embeddings,
+  // initialized with evenly spaced embeddings.
+  centroids_.assign(static_cast<size_t>(num_partitions) * dimension_, 0.0f);
+  partitions_.assign(num_partitions, {});
+  std::vector<int> assignments(size_);
+  std::vector<float> sums(centroids_.size());
+  std::vector<int> counts(num_partitions);
+  // Adds the L2-normalized `i`-th embedding to `output`.
+  auto add_normalized_embedding = [this](int i, float* output) {
+    const size_t offset = static_cast<size_t>(i) * dimension_;
+    for (int d = 0; d < dimension_; ++d) {
+      output[d] +=
+          (quantized_ ? quantized_data_[offset + d] : float_data_[offset + d]) *
+          inverse_norms_[i];
+    }
+  };
+  for (int p = 0; p < num_partitions; ++p) {
+    add_normalized_embedding(static_cast<int64_t>(p) * size_ / num_partitions,
+                             centroids_.data() + p * dimension_);
+  }
+  for (int iteration = 0; iteration < options_.num_partitioning_iterations;
+       ++iteration) {
+    for (int i = 0; i < size_; ++i) {
+      assignments[i] = ClosestPartition(i);
+    }
+    std::fill(sums.begin(), sums.end(), 0.0f);
+    std::fill(counts.begin(), counts.end(), 0);
+    for (int i = 0; i < size_; ++i) {
+      add_normalized_embedding(i, sums.data() + assignments[i] * dimension_);
+      ++counts[assignments[i]];
+    }
+    for (int p = 0; p < num_partitions; ++p) {
+      // Empty partitions keep their previous centroid.
+      if (counts[p] == 0) continue;
+      const float* sum = sums.data() + p * dimension_;
+      const float norm = std::sqrt(DotProduct(sum, sum, dimension_));
+      if (norm <= 0.0f) continue;
+      for (int d = 0; d < dimension_; ++d) {
+        centroids_[p * dimension_ + d] = sum[d] / norm;
+      }
+    }
+  }
+  for (int i = 0; i < size_; ++i) {
+    partitions_[ClosestPartition(i)].push_back(i);
+  }
+  return absl::OkStatus();
+}
+
+std::vector<int> EmbeddingIndex::PartitionsToSearch(
+    const Embedding& query) const {
+  TopResults closest_partitions(options_.num_partitions_to_search);
+  for (int p = 0; p < partitions_.size(); ++p) {
+    const float* centroid = centroids_.data() + p * dimension_;
+    closest_partitions.Add(
+        p, quantized_
+               ? DotProduct(centroid, QuantizedData(query), dimension_)
+               : DotProduct(centroid, query.float_embedding.data(),
+                            dimension_));
+  }
+  std::vector<int> partitions;
+  for (const auto& result : std::move(closest_partitions).Sorted()) {
+    partitions.push_back(result.index);
+  }
+  return partitions;
+}
+
+absl::StatusOr<std::vector<EmbeddingSearchResult>> EmbeddingIndex::Search(
+    const Embedding& query, int max_results) const {
+  ASSIGN_OR_RETURN(auto results, SearchBatch({query}, max_results));
+  return std::move(results.front());
+}
+
+absl::StatusOr<std::vector<std::vector<EmbeddingSearchResult>>>
+EmbeddingIndex::SearchBatch(const std::vector<Embedding>& queries,
+                            int max_results) const {
+  if (max_results < 1) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::StrFormat("Expected max_results >= 1, got %d", max_results),
+        MediaPipeTasksStatus::kInvalidArgumentError);
+  }
+  if (size_ == 0) {
+    return std::vector<std::vector<EmbeddingSearchResult>>(queries.size());
+  }
+  std::vector<float> query_inverse_norms;
+  query_inverse_norms.reserve(queries.size());
+  for (const auto& query : queries) {
+    ASSIGN_OR_RETURN(float inverse_norm, CheckEmbedding(query));
+    query_inverse_norms.push_back(inverse_norm);
+  }
+
+  std::vector<TopResults> top_results(queries.size(), TopResults(max_results));
+  if (is_partitioned()) {
+    for (int q = 0; q < queries.size(); ++q) {
+      for (int p : PartitionsToSearch(queries[q])) {
+        for (int i : partitions_[p]) {
+          top_results[q].Add(
+              i, Similarity(queries[q], query_inverse_norms[q], i));
+        }
+      }
+    }
+  } else {
+    // Goes through the embeddings in the outer loop, so that each of them is
+    // loaded once for all the queries.
+    for (int i = 0; i < size_; ++i) {
+      for (int q = 0; q < queries.size(); ++q) {
+        top_results[q].Add(i,
+                           Similarity(queries[q], query_inverse_norms[q], i));
+      }
+    }
+  }
+
+  std::vector<std::vector<EmbeddingSearchResult>> results;
+  results.reserve(queries.size());
+  for (auto& top : top_results) {
+    results.push_back(std::move(top).Sorted());
+  }
+  return results;
+}
+
+absl::Status EmbeddingIndex::WriteToFile(absl::string_view path) const {
+  FileHeader header;
+  std::memcpy(header.magic, kFileMagic, sizeof(kFileMagic));
+  header.version = kFileVersion;
+  header.quantized = quantized_ ? 1 : 0;
+  header.dimension = dimension_;
+  header.size = size_;
+  header.num_partitions = partitions_.size();
+
+  const size_t num_values = static_cast<size_t>(size_) * dimension_;
+  std::string content;
+  AppendBytes(&header, sizeof(header), &content);
+  AppendBytes(inverse_norms_, size_ * sizeof(float), &content);
+  if (quantized_) {
+    AppendBytes(quantized_data_, num_values, &content);
+  } else {
+    AppendBytes(float_data_, num_values * sizeof(float), &content);
+  }
+  if (is_partitioned()) {
+    AppendBytes(centroids_.data(), centroids_.size() * sizeof(float),
+                &content);
+    std::vector<uint32_t> offsets = {0};
+    std::vector<uint32_t> members;
+    members.reserve(size_);
+    for (const auto& partition : partitions_) {
+      members.insert(members.end(), partition.begin(), partition.end());
+      offsets.push_back(members.size());
+    }
+    AppendBytes(offsets.data(), offsets.size() * sizeof(uint32_t), &content);
+    AppendBytes(members.data(), members.size() * sizeof(uint32_t), &content);
+  }
+  return file::SetContents(path, content);
+}
+
+}  // namespace utils
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
@@ -0,0 +1,205 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_EMBEDDING_INDEX_H_
+#define MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_EMBEDDING_INDEX_H_
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
+#include "mediapipe/tasks/cc/core/external_file_handler.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace utils {
+
+// Options for configuring an EmbeddingIndex.
+struct EmbeddingIndexOptions {
+  // The number of partitions of the inverted file (IVF) built by
+  // EmbeddingIndex::Partition(), which lets searches only go through the
+  // embeddings of the partitions closest to the query instead of through all
+  // of them. If 0, the index always performs an exact, exhaustive search.
+  int num_partitions = 0;
+
+  // The number of partitions, closest to the query, that searches go through
+  // once the index is partitioned. Larger values increase recall at the cost
+  // of latency.
+  int num_partitions_to_search = 1;
+
+  // The number of k-means iterations used to compute the partitions.
+  int num_partitioning_iterations = 10;
+};
+
+// A search result of an EmbeddingIndex.
+struct EmbeddingSearchResult {
+  // The index of the embedding in the EmbeddingIndex, i.e. the value returned
+  // by EmbeddingIndex::Add() when it was added.
+  int index;
+  // The cosine similarity between the query and the embedding.
+  double similarity;
+};
+
+// An in-memory index of embeddings, returning the embeddings that are the most
+// similar to a query in terms of cosine similarity [1].
+//
+// The index accepts the embeddings produced by the embedder tasks, e.g. one of
+// the `embeddings` of an ImageEmbedderResult or TextEmbedderResult. All the
+// embeddings of an index must have the same type, float or quantized, and the
+// same size. Similarities are the same as the ones computed by
+// CosineSimilarity(), so they don't depend on whether the embedder was
+// configured to L2-normalize its embeddings.
+//
+// By default, searches compare the query to every embedding of the index. For
+// large indices, setting `num_partitions` and calling Partition() after adding
+// the embeddings clusters them with k-means, so that searches only go through
+// the `num_partitions_to_search` clusters closest to the query. Embeddings
+// added after Partition() are assigned to their closest cluster.
+//
+// Indices can be written to a file with WriteToFile(), and loaded back with
+// CreateFromFile(), which maps the embeddings in memory instead of copying
+// them.
+//
+// Example:
+//
+//   ASSIGN_OR_RETURN(auto index, EmbeddingIndex::Create());
+//   for (const auto& result : results) {
+//     ASSIGN_OR_RETURN(int id, index->Add(result.embeddings[0]));
+//   }
+//   ASSIGN_OR_RETURN(auto neighbors,
+//                    index->Search(query.embeddings[0], /*max_results=*/5));
+//
+// This class is not thread-safe for writes: Add() and Partition() must not be
+// called concurrently with any other method. Concurrent searches are safe.
+//
+// [1]: https://en.wikipedia.org/wiki/Cosine_similarity
+class EmbeddingIndex {
+ public:
+  // Creates an empty index.
+  static absl::StatusOr<std::unique_ptr<EmbeddingIndex>> Create(
+      const EmbeddingIndexOptions& options = {});
+
+  // Creates an index from a file written by WriteToFile(). The embeddings are
+  // mapped in memory from the file when it is specified by path or file
+  // descriptor. The partitions are the ones of the written index, and
+  // `options.num_partitions` is ignored.
+  //
+  // Warning: Does not take ownership of `external_file`, which must outlive
+  // the returned index.
+  static absl::StatusOr<std::unique_ptr<EmbeddingIndex>> CreateFromFile(
+      const core::proto::ExternalFile* external_file,
+      const EmbeddingIndexOptions& options = {});
+
+  EmbeddingIndex(const EmbeddingIndex&) = delete;
+  EmbeddingIndex& operator=(const EmbeddingIndex&) = delete;
+
+  // Adds an embedding to the index and returns its index, i.e. the number of
+  // embeddings added before it. Returns an InvalidArgumentError if the type or
+  // size of the embedding doesn't match the ones of the previous embeddings, or
+  // if its L2-norm is 0.
+  absl::StatusOr<int> Add(const containers::Embedding& embedding);
+
+  // Clusters the embeddings into `num_partitions` partitions. Returns an
+  // InvalidArgumentError if `num_partitions` is 0 or larger than the number of
+  // embeddings in the index.
+  absl::Status Partition();
+
+  // Returns the `max_results` embeddings that are the most similar to `query`,
+  // sorted by decreasing similarity. Returns an InvalidArgumentError if the
+  // type or size of `query` doesn't match the ones of the index embeddings.
+  absl::StatusOr<std::vector<EmbeddingSearchResult>> Search(
+      const containers::Embedding& query, int max_results) const;
+
+  // Same as Search() for several queries. Exhaustive searches go through the
+  // index embeddings once for all the queries, which is faster than searching
+  // for each query separately.
+  absl::StatusOr<std::vector<std::vector<EmbeddingSearchResult>>> SearchBatch(
+      const std::vector<containers::Embedding>& queries,
+      int max_results) const;
+
+  // Writes the index to the file at `path`.
+  absl::Status WriteToFile(absl::string_view path) const;
+
+  // Returns the number of embeddings in the index.
+  int size() const { return size_; }
+
+  // Returns whether Partition() was called on the index, or on the index it
+  // was written from.
+  bool is_partitioned() const { return !partitions_.empty(); }
+
+ private:
+  explicit EmbeddingIndex(const EmbeddingIndexOptions& options)
+      : options_(options) {}
+
+  // Checks that `embedding` matches the type and size of the index
+  // embeddings, and returns its inverse L2-norm.
+  absl::StatusOr<float> CheckEmbedding(
+      const containers::Embedding& embedding) const;
+
+  // Copies the mapped embeddings into owned memory so that more embeddings
+  // can be added.
+  void CopyMappedEmbeddings();
+
+  // Returns the cosine similarity between `query`, which has the type and size
+  // of the index embeddings, and the `i`-th embedding.
+  float Similarity(const containers::Embedding& query,
+                   float query_inverse_norm, int i) const;
+
+  // Returns the dot product between `centroid` and the `i`-th embedding.
+  float CentroidDotProduct(const float* centroid, int i) const;
+
+  // Returns the index of the partition closest to the `i`-th embedding.
+  int ClosestPartition(int i) const;
+
+  // Returns the indices of the partitions to search for `query`.
+  std::vector<int> PartitionsToSearch(
+      const containers::Embedding& query) const;
+
+  EmbeddingIndexOptions options_;
+
+  // Whether the index holds quantized embeddings, and their size. Only
+  // meaningful if the index is not empty.
+  bool quantized_ = false;
+  int dimension_ = 0;
+  int size_ = 0;
+
+  // The index embeddings, stored contiguously, and their inverse L2-norms.
+  // They point either to the owned vectors below, or to a mapped file.
+  const float* float_data_ = nullptr;
+  const int8_t* quantized_data_ = nullptr;
+  const float* inverse_norms_ = nullptr;
+  std::vector<float> owned_float_data_;
+  std::vector<int8_t> owned_quantized_data_;
+  std::vector<float> owned_inverse_norms_;
+  std::unique_ptr<core::ExternalFileHandler> file_handler_;
+
+  // The L2-normalized partition centroids, stored contiguously, and the
+  // indices of the embeddings of each partition.
+  std::vector<float> centroids_;
+  std::vector<std::vector<int>> partitions_;
+};
+
+}  // namespace utils
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_TASKS_CC_COMPONENTS_UTILS_EMBEDDING_INDEX_H_
@@ -0,0 +1,301 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/components/utils/embedding_index.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "mediapipe/framework/port/file_helpers.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/status_matchers.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
+#include "mediapipe/tasks/cc/components/utils/cosine_similarity.h"
+#include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace components {
+namespace utils {
+namespace {
+
+using ::mediapipe::tasks::components::containers::Embedding;
+using ::testing::DoubleNear;
+using ::testing::ElementsAre;
+using ::testing::Field;
+using ::testing::HasSubstr;
+using ::testing::IsEmpty;
+
+constexpr double kSimilarityTolerance = 1e-6;
+
+// Helper function to generate float Embedding.
+Embedding BuildFloatEmbedding(std::vector<float> values) {
+  Embedding embedding;
+  embedding.float_embedding = values;
+  return embedding;
+}
+
+// Helper function to generate quantized Embedding.
+Embedding BuildQuantizedEmbedding(std::vector<int8_t> values) {
+  Embedding embedding;
+  uint8_t* data = reinterpret_cast<uint8_t*>(values.data());
+  embedding.quantized_embedding = {data, data + values.size()};
+  return embedding;
+}
+
+std::vector<int> GetIndices(const std::vector<EmbeddingSearchResult>& results) {
+  std::vector<int> indices;
+  for (const auto& result : results) {
+    indices.push_back(result.index);
+  }
+  return indices;
+}
+
+// Returns embeddings forming two clusters around the first and second axes.
+std::vector<Embedding> BuildClusteredEmbeddings() {
+  return {
+      BuildFloatEmbedding({1.0, 0.1, 0.0}),
+      BuildFloatEmbedding({0.1, 1.0, 0.0}),
+      BuildFloatEmbedding({1.0, 0.0, 0.2}),
+      BuildFloatEmbedding({0.0, 1.0, 0.15}),
+      BuildFloatEmbedding({1.0, 0.2, 0.1}),
+      BuildFloatEmbedding({0.2, 1.0, 0.2}),
+  };
+}
+
+TEST(EmbeddingIndexTest, SucceedsWithFloatEmbeddings) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index, EmbeddingIndex::Create());
+  const std::vector<Embedding> embeddings = {
+      BuildFloatEmbedding({1.0, 0.0, 0.0, 0.0}),
+      BuildFloatEmbedding({0.5, 0.5, 0.5, 0.5}),
+      BuildFloatEmbedding({0.0, 2.0, 0.0, 0.0}),
+  };
+  for (int i = 0; i < embeddings.size(); ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(int id, index->Add(embeddings[i]));
+    EXPECT_EQ(id, i);
+  }
+  const Embedding query = BuildFloatEmbedding({0.9, 0.1, 0.0, 0.0});
+
+  MP_ASSERT_OK_AND_ASSIGN(auto results, index->Search(query, 2));
+
+  EXPECT_THAT(GetIndices(results), ElementsAre(0, 1));
+  for (const auto& result : results) {
+    MP_ASSERT_OK_AND_ASSIGN(double expected_similarity,
+                            CosineSimilarity(query, embeddings[result.index]));
+    EXPECT_THAT(result.similarity,
+                DoubleNear(expected_similarity, kSimilarityTolerance));
+  }
+}
+
+TEST(EmbeddingIndexTest, SucceedsWithQuantizedEmbeddings) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index, EmbeddingIndex::Create());
+  MP_ASSERT_OK(index->Add(BuildQuantizedEmbedding({127, 0, 0, 0})));
+  MP_ASSERT_OK(index->Add(BuildQuantizedEmbedding({-128, 0, 0, 0})));
+  MP_ASSERT_OK(index->Add(BuildQuantizedEmbedding({64, 64, 0, 0})));
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto results,
+      index->Search(BuildQuantizedEmbedding({100, 0, 0, 0}), 5));
+
+  EXPECT_THAT(GetIndices(results), ElementsAre(0, 2, 1));
+  EXPECT_THAT(results.back().similarity, DoubleNear(-1, kSimilarityTolerance));
+}
+
+TEST(EmbeddingIndexTest, SearchBatchMatchesSearch) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index, EmbeddingIndex::Create());
+  for (const auto& embedding : BuildClusteredEmbeddings()) {
+    MP_ASSERT_OK(index->Add(embedding));
+  }
+  const std::vector<Embedding> queries = {
+      BuildFloatEmbedding({1.0, 0.0, 0.0}),
+      BuildFloatEmbedding({0.0, 1.0, 0.0}),
+  };
+
+  MP_ASSERT_OK_AND_ASSIGN(auto batch_results, index->SearchBatch(queries, 3));
+
+  ASSERT_EQ(batch_results.size(), queries.size());
+  for (int q = 0; q < queries.size(); ++q) {
+    MP_ASSERT_OK_AND_ASSIGN(auto results, index->Search(queries[q], 3));
+    EXPECT_EQ(GetIndices(batch_results[q]), GetIndices(results));
+  }
+  EXPECT_THAT(GetIndices(batch_results[0]), ElementsAre(0, 2, 4));
+  EXPECT_THAT(GetIndices(batch_results[1]), ElementsAre(1, 3, 5));
+}
+
+TEST(EmbeddingIndexTest, SucceedsWithPartitions) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index,
+                          EmbeddingIndex::Create({.num_partitions = 2}));
+  for (const auto& embedding : BuildClusteredEmbeddings()) {
+    MP_ASSERT_OK(index->Add(embedding));
+  }
+  MP_ASSERT_OK(index->Partition());
+  EXPECT_TRUE(index->is_partitioned());
+  MP_ASSERT_OK_AND_ASSIGN(int id,
+                          index->Add(BuildFloatEmbedding({1.0, 0.0, 0.0})));
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto results, index->Search(BuildFloatEmbedding({1.0, 0.0, 0.0}), 10));
+
+  // Only the partition of the embeddings close to the first axis is searched.
+  EXPECT_THAT(GetIndices(results), ElementsAre(id, 0, 2, 4));
+}
+
+TEST(EmbeddingIndexTest, SucceedsWithEmptyIndex) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index, EmbeddingIndex::Create());
+
+  MP_ASSERT_OK_AND_ASSIGN(auto results,
+                          index->Search(BuildFloatEmbedding({1.0, 0.0}), 1));
+
+  EXPECT_THAT(results, IsEmpty());
+}
+
+TEST(EmbeddingIndexTest, FailsWithQuantizedAndFloatEmbeddings) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index, EmbeddingIndex::Create());
+  MP_ASSERT_OK(index->Add(BuildFloatEmbedding({0.1, 0.2})));
+
+  auto status = index->Add(BuildQuantizedEmbedding({0, 1})).status();
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(),
+              HasSubstr("Expected a float embedding, got a quantized one"));
+}
+
+TEST(EmbeddingIndexTest, FailsWithDifferentSizes) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index, EmbeddingIndex::Create());
+  MP_ASSERT_OK(index->Add(BuildFloatEmbedding({0.1, 0.2})));
+
+  auto status = index->Search(BuildFloatEmbedding({0.1, 0.2, 0.3}), 1).status();
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(),
+              HasSubstr("Expected an embedding of size 2, got 3"));
+}
+
+TEST(EmbeddingIndexTest, FailsWithZeroNorm) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index, EmbeddingIndex::Create());
+
+  auto status = index->Add(BuildFloatEmbedding({0.0, 0.0})).status();
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(
+      status.message(),
+      HasSubstr("Cannot compute cosine similarity on embedding with 0 norm"));
+}
+
+TEST(EmbeddingIndexTest, FailsWithTooManyPartitions) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index,
+                          EmbeddingIndex::Create({.num_partitions = 2}));
+  MP_ASSERT_OK(index->Add(BuildFloatEmbedding({0.1, 0.2})));
+
+  auto status = index->Partition();
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(),
+              HasSubstr("Cannot split 1 embeddings into 2 partitions"));
+}
+
+TEST(EmbeddingIndexTest, SucceedsWithIndexFile) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index,
+                          EmbeddingIndex::Create({.num_partitions = 2}));
+  for (const auto& embedding : BuildClusteredEmbeddings()) {
+    MP_ASSERT_OK(index->Add(embedding));
+  }
+  MP_ASSERT_OK(index->Partition());
+  const std::string path =
+      file::JoinPath(::testing::TempDir(), "embedding_index.bin");
+  MP_ASSERT_OK(index->WriteToFile(path));
+  const Embedding query = BuildFloatEmbedding({0.0, 1.0, 0.0});
+  MP_ASSERT_OK_AND_ASSIGN(auto expected_results, index->Search(query, 3));
+
+  core::proto::ExternalFile external_file;
+  external_file.set_file_name(path);
+  MP_ASSERT_OK_AND_ASSIGN(auto loaded_index,
+                          EmbeddingIndex::CreateFromFile(&external_file));
+  EXPECT_EQ(loaded_index->size(), index->size());
+  EXPECT_TRUE(loaded_index->is_partitioned());
+  MP_ASSERT_OK_AND_ASSIGN(auto results, loaded_index->Search(query, 3));
+  EXPECT_EQ(GetIndices(results), GetIndices(expected_results));
+
+  // Adding embeddings to a loaded index copies the mapped embeddings.
+  MP_ASSERT_OK_AND_ASSIGN(
+      int id, loaded_index->Add(BuildFloatEmbedding({0.0, 1.0, 0.0})));
+  MP_ASSERT_OK_AND_ASSIGN(results, loaded_index->Search(query, 1));
+  EXPECT_THAT(results, ElementsAre(Field(&EmbeddingSearchResult::index, id)));
+}
+
+TEST(EmbeddingIndexTest, FailsWithInvalidIndexFile) {
+  core::proto::ExternalFile external_file;
+  external_file.set_file_content("not an index file");
+
+  auto status = EmbeddingIndex::CreateFromFile(&external_file).status();
+
+  EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status.message(), HasSubstr("Invalid embedding index file"));
+}
+
+TEST(EmbeddingIndexTest, FailsWithCorruptedIndexFileHeader) {
+  MP_ASSERT_OK_AND_ASSIGN(auto index,
+                          EmbeddingIndex::Create({.num_partitions = 2}));
+  for (const auto& embedding : BuildClusteredEmbeddings()) {
+    MP_ASSERT_OK(index->Add(embedding));
+  }
+  MP_ASSERT_OK(index->Partition());
+  const std::string path =
+      file::JoinPath(::testing::TempDir(), "corrupted_embedding_index.bin");
+  MP_ASSERT_OK(index->WriteToFile(path));
+  std::string content;
+  MP_ASSERT_OK(file::GetContents(path, &content));
+
+  struct Corruption {
+    // The byte offset of the corrupted header field.
+    int offset;
+    uint32_t value;
+    std::string expected_message;
+  };
+  const std::vector<Corruption> corruptions = {
+      {/*quantized*/ 8, 2, "invalid quantized flag"},
+      {/*dimension*/ 12, 0x80000000, "is too large"},
+      {/*size*/ 16, 0xFFFFFFFF, "is too large"},
+      // Used to wrap the number of partition offsets around to 0.
+      {/*num_partitions*/ 20, 0xFFFFFFFF, "is too large"},
+      {/*dimension*/ 12, 0, "dimension of 0"},
+      {/*dimension*/ 12, 0x7FFFFFFF, "expected"},
+      {/*size*/ 16, 0x7FFFFFFF, "expected"},
+      {/*num_partitions*/ 20, 0x7FFFFFFF, "expected"},
+  };
+  for (const auto& corruption : corruptions) {
+    SCOPED_TRACE(corruption.expected_message);
+    std::string corrupted_content = content;
+    std::memcpy(corrupted_content.data() + corruption.offset,
+                &corruption.value, sizeof(corruption.value));
+    core::proto::ExternalFile external_file;
+    external_file.set_file_content(corrupted_content);
+
+    auto status = EmbeddingIndex::CreateFromFile(&external_file).status();
+
+    EXPECT_EQ(status.code(), absl::StatusCode::kInvalidArgument);
+    EXPECT_THAT(status.message(), HasSubstr(corruption.expected_message));
+  }
+}
+
+}  // namespace
+}  // namespace utils
+}  // namespace components
+}  // namespace tasks
+}  // namespace mediapipe
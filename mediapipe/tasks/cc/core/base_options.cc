@@ -15,11 +15,13 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/core/base_options.h"
 
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <variant>
 
 #include "absl/log/absl_log.h"
+#include "mediapipe/calculators/core/flow_limiter_calculator.pb.h"
 #include "mediapipe/calculators/tensor/inference_calculator.pb.h"
 #include "mediapipe/tasks/cc/core/proto/acceleration.pb.h"
 #include "mediapipe/tasks/cc/core/proto/base_options.pb.h"
@@ -29,6 +31,8 @@ namespace mediapipe {
 namespace tasks {
 namespace core {
 
+constexpr int64_t kMicroSecondsPerMilliSecond = 1000;
+
 proto::Acceleration ConvertDelegateOptionsToAccelerationProto(
     const BaseOptions::CpuOptions& options) {
   proto::Acceleration acceleration_proto = proto::Acceleration();
@@ -116,6 +120,35 @@ proto::BaseOptions ConvertBaseOptionsToProto(BaseOptions* base_options) {
           ->set_accelerator_name("google-edgetpu");
       break;
   }
+  const BaseOptions::LiveStreamOptions default_live_stream_options;
+  const auto& live_stream_options = base_options->live_stream_options;
+  FlowLimiterCalculatorOptions flow_limiter_options;
+  if (live_stream_options.drop_policy ==
+      BaseOptions::LiveStreamOptions::DROP_NEWEST) {
+    flow_limiter_options.set_drop_policy(
+        FlowLimiterCalculatorOptions::DROP_NEWEST);
+  }
+  if (live_stream_options.max_in_flight !=
+      default_live_stream_options.max_in_flight) {
+    flow_limiter_options.set_max_in_flight(live_stream_options.max_in_flight);
+  }
+  if (live_stream_options.max_in_queue !=
+      default_live_stream_options.max_in_queue) {
+    flow_limiter_options.set_max_in_queue(live_stream_options.max_in_queue);
+  }
+  if (live_stream_options.target_latency_ms > 0) {
+    flow_limiter_options.set_target_latency(
+        live_stream_options.target_latency_ms * kMicroSecondsPerMilliSecond);
+  }
+  if (live_stream_options.max_queue_delay_ms > 0) {
+    flow_limiter_options.set_max_queue_delay(
+        live_stream_options.max_queue_delay_ms * kMicroSecondsPerMilliSecond);
+  }
+  // Only the settings differing from the task defaults are set.
+  if (flow_limiter_options.ByteSizeLong() > 0) {
+    base_options_proto.mutable_flow_limiter_options()->Swap(
+        &flow_limiter_options);
+  }
   return base_options_proto;
 }
 }  // namespace core
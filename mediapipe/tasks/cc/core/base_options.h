@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_CORE_BASE_OPTIONS_H_
 #define MEDIAPIPE_TASKS_CC_CORE_BASE_OPTIONS_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -99,6 +101,49 @@ struct BaseOptions {
   // Options for the chosen delegate. If not set, the default delegate options
   // is used.
   std::optional<std::variant<CpuOptions, GpuOptions>> delegate_options;
+
+  // The number of graph replicas used to serve synchronous calls of tasks that
+  // support it. The replicas share the model buffer, so calls from multiple
+  // threads run concurrently without loading the model several times.
+  int num_replicas = 1;
+
+  // Frame dropping of tasks running in the live stream mode. Frames arriving
+  // while the task is busy wait in a queue, and are dropped once it is full.
+  struct LiveStreamOptions {
+    enum DropPolicy {
+      // Drops the oldest queued frame, so that the latest frames are processed.
+      DROP_OLDEST = 0,
+      // Drops the arriving frame, so that queued frames are processed in
+      // arrival order.
+      DROP_NEWEST = 1,
+    };
+
+    // Which frame is dropped when a frame arrives while the queue is full.
+    DropPolicy drop_policy = DROP_OLDEST;
+
+    // The maximum number of frames processed at one time.
+    int max_in_flight = 1;
+
+    // The maximum number of frames waiting to be processed.
+    int max_in_queue = 1;
+
+    // If positive, the number of frames processed at one time is lowered,
+    // down to 1, while results are delivered more than this many milliseconds
+    // behind the latest input frame, and raised back up to `max_in_flight`
+    // once they catch up.
+    int64_t target_latency_ms = 0;
+
+    // If positive, queued frames lagging more than this many milliseconds
+    // behind the latest input frame are dropped instead of being processed.
+    int64_t max_queue_delay_ms = 0;
+
+    // If set, called with the timestamp in milliseconds of an input frame
+    // that was dropped instead of being processed. The input frames sent
+    // after it are dropped as well until the next frame whose result reaches
+    // the result callback, and may not be reported individually.
+    std::function<void(int64_t timestamp_ms)> frame_dropped_callback =
+        nullptr;
+  } live_stream_options;
 };
 
 // Converts a BaseOptions to a BaseOptionsProto.
@@ -5,6 +5,7 @@
 #include <string>
 #include <variant>
 
+#include "mediapipe/calculators/core/flow_limiter_calculator.pb.h"
 #include "mediapipe/calculators/tensor/inference_calculator.pb.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
@@ -45,6 +46,24 @@ TEST(BaseOptionsTest, ConvertBaseOptionsToProtoWithAcceleration) {
   EXPECT_EQ(proto.acceleration().nnapi().accelerator_name(), "google-edgetpu");
 }
 
+TEST(BaseOptionsTest, ConvertBaseOptionsToProtoWithLiveStreamOptions) {
+  BaseOptions base_options;
+  proto::BaseOptions proto = ConvertBaseOptionsToProto(&base_options);
+  EXPECT_FALSE(proto.has_flow_limiter_options());
+
+  base_options.live_stream_options.drop_policy =
+      BaseOptions::LiveStreamOptions::DROP_NEWEST;
+  base_options.live_stream_options.max_in_flight = 2;
+  base_options.live_stream_options.target_latency_ms = 50;
+  proto = ConvertBaseOptionsToProto(&base_options);
+  EXPECT_EQ(proto.flow_limiter_options().drop_policy(),
+            FlowLimiterCalculatorOptions::DROP_NEWEST);
+  EXPECT_EQ(proto.flow_limiter_options().max_in_flight(), 2);
+  EXPECT_FALSE(proto.flow_limiter_options().has_max_in_queue());
+  EXPECT_EQ(proto.flow_limiter_options().target_latency(), 50000);
+  EXPECT_FALSE(proto.flow_limiter_options().has_max_queue_delay());
+}
+
 TEST(DelegateOptionsTest, SucceedCpuOptions) {
   BaseOptions base_options;
   base_options.delegate = BaseOptions::Delegate::CPU;
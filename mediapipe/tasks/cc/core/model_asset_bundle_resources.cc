@@ -15,10 +15,16 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/core/model_asset_bundle_resources.h"
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/metadata/utils/zip_utils.h"
@@ -71,7 +77,9 @@ absl::Status ModelAssetBundleResources::ExtractFilesFromExternalFileProto() {
       model_asset_bundle_file_handler_->GetFileContent().data();
   size_t buffer_size =
       model_asset_bundle_file_handler_->GetFileContent().size();
-  return metadata::ExtractFilesfromZipFile(buffer_data, buffer_size, &files_);
+  // Only locates the files in the bundle buffer, which stays alive with the
+  // file handler, so that uncompressed files are never copied.
+  return metadata::ListZipFileEntries(buffer_data, buffer_size, &files_);
 }
 
 absl::StatusOr<absl::string_view> ModelAssetBundleResources::GetFile(
@@ -88,7 +96,18 @@ absl::StatusOr<absl::string_view> ModelAssetBundleResources::GetFile(
                         filename, all_files),
         MediaPipeTasksStatus::kFileNotFoundError);
   }
-  return it->second;
+  const metadata::ZipFileEntry& entry = it->second;
+  if (!entry.is_compressed) {
+    return entry.data;
+  }
+  absl::MutexLock lock(&inflated_files_mutex_);
+  auto inflated_it = inflated_files_.find(filename);
+  if (inflated_it == inflated_files_.end()) {
+    ASSIGN_OR_RETURN(std::string contents,
+                     metadata::InflateZipFileEntry(entry));
+    inflated_it = inflated_files_.emplace(filename, std::move(contents)).first;
+  }
+  return inflated_it->second;
 }
 
 std::vector<std::string> ModelAssetBundleResources::ListFiles() const {
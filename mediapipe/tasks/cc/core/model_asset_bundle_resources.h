@@ -16,10 +16,19 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_CORE_MODEL_ASSET_BUNDLE_RESOURCES_H_
 #define MEDIAPIPE_TASKS_CC_CORE_MODEL_ASSET_BUNDLE_RESOURCES_H_
 
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
 #include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "mediapipe/tasks/cc/core/external_file_handler.h"
 #include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
+#include "mediapipe/tasks/cc/metadata/utils/zip_utils.h"
 
 namespace mediapipe {
 namespace tasks {
@@ -32,6 +41,10 @@ namespace core {
 // sub-tasks. As the resources are owned by the ModelAssetBundleResources object
 // callers must keep ModelAssetBundleResources alive while using any of the
 // resources.
+//
+// Files stored uncompressed in the bundle are not copied: their contents point
+// into the bundle buffer, which is mmapped when the bundle is provided as a
+// file. Compressed files are only inflated the first time they are requested.
 class ModelAssetBundleResources {
  public:
   // Takes the ownership of the provided ExternalFile proto and creates
@@ -52,7 +65,7 @@ class ModelAssetBundleResources {
 
   // Gets the contents of the model file (either tflite model file, resource
   // file or model bundle file) with the provided name. An error is returned if
-  // there is no such model file.
+  // there is no such model file. This method is thread-safe.
   absl::StatusOr<absl::string_view> GetFile(const std::string& filename) const;
 
   // Lists all the file names in the model asset model.
@@ -79,9 +92,15 @@ class ModelAssetBundleResources {
 
   // The files bundled in model asset bundle, as a map with the filename
   // (corresponding to a basename, e.g. "hand_detector.tflite") as key and
-  // a pointer to the file contents as value. Each file can be either a TFLite
-  // model file, resource file or a model bundle file for sub-task.
-  absl::flat_hash_map<std::string, absl::string_view> files_;
+  // the location of the file data in the bundle as value. Each file can be
+  // either a TFLite model file, resource file or a model bundle file for
+  // sub-task.
+  absl::flat_hash_map<std::string, metadata::ZipFileEntry> files_;
+
+  // The contents of the compressed files inflated so far, by filename.
+  mutable absl::node_hash_map<std::string, std::string> inflated_files_
+      ABSL_GUARDED_BY(inflated_files_mutex_);
+  mutable absl::Mutex inflated_files_mutex_;
 };
 
 }  // namespace core
@@ -22,8 +22,13 @@ limitations under the License.
 #include <iosfwd>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
+#include "absl/container/flat_hash_map.h"
+#include "contrib/minizip/ioapi.h"
+#include "contrib/minizip/zip.h"
+
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/framework/port/status_macros.h"
@@ -33,6 +38,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
 #include "mediapipe/tasks/cc/core/utils.h"
 #include "mediapipe/tasks/cc/metadata/utils/zip_utils.h"
+#include "mediapipe/tasks/cc/metadata/utils/zip_writable_mem_file.h"
 
 namespace mediapipe {
 namespace tasks {
@@ -56,6 +62,30 @@ constexpr char kTestModelBundlePath[] =
 constexpr char kInvalidTestModelBundlePath[] =
     "mediapipe/tasks/testdata/core/i_do_not_exist.task";
 
+// Creates a zip archive in memory with the provided files, using the provided
+// compression method.
+std::string CreateZipArchive(
+    const std::vector<std::pair<std::string, std::string>>& files,
+    int method) {
+  metadata::ZipWritableMemFile mem_file(/*buffer=*/"", /*size=*/0);
+  zipFile zf = zipOpen2_64(/*pathname=*/nullptr, APPEND_STATUS_CREATE,
+                           /*globalcomment=*/nullptr,
+                           &mem_file.GetFileFunc64Def());
+  for (const auto& [name, contents] : files) {
+    zipOpenNewFileInZip64(zf, name.c_str(), /*zipfi=*/nullptr,
+                          /*extrafield_local=*/nullptr,
+                          /*size_extrafield_local=*/0,
+                          /*extrafield_global=*/nullptr,
+                          /*size_extrafield_global=*/0, /*comment=*/nullptr,
+                          method, /*level=*/Z_DEFAULT_COMPRESSION,
+                          /*zip64=*/0);
+    zipWriteInFileInZip(zf, contents.data(), contents.length());
+    zipCloseFileInZip(zf);
+  }
+  zipClose(zf, /*global_comment=*/nullptr);
+  return std::string(mem_file.GetFileContent());
+}
+
 }  // namespace
 
 TEST(ModelAssetBundleResourcesTest, CreateFromBinaryContent) {
@@ -207,6 +237,71 @@ TEST(ModelAssetBundleResourcesTest, ExtractInvalidModelFile) {
                   absl::StrCat(MediaPipeTasksStatus::kFileNotFoundError))));
 }
 
+TEST(ModelAssetBundleResourcesTest, GetUncompressedFileWithoutCopy) {
+  const std::string zip_content =
+      CreateZipArchive({{"a.txt", "first file"}, {"b.txt", "second file"}},
+                       /*method=*/0);
+  auto model_file = std::make_unique<proto::ExternalFile>();
+  metadata::SetExternalFile(zip_content, model_file.get());
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_bundle_resources,
+      ModelAssetBundleResources::Create(kTestModelBundleResourcesTag,
+                                        std::move(model_file)));
+  MP_ASSERT_OK_AND_ASSIGN(auto file, model_bundle_resources->GetFile("b.txt"));
+  EXPECT_EQ(file, "second file");
+  // The contents point into the bundle buffer.
+  EXPECT_GE(file.data(), zip_content.data());
+  EXPECT_LE(file.data() + file.size(),
+            zip_content.data() + zip_content.size());
+}
+
+TEST(ModelAssetBundleResourcesTest, GetCompressedFile) {
+  const std::string contents(10000, 'x');
+  const std::string zip_content =
+      CreateZipArchive({{"a.txt", contents}, {"b.txt", "second file"}},
+                       /*method=*/Z_DEFLATED);
+  auto model_file = std::make_unique<proto::ExternalFile>();
+  metadata::SetExternalFile(zip_content, model_file.get());
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_bundle_resources,
+      ModelAssetBundleResources::Create(kTestModelBundleResourcesTag,
+                                        std::move(model_file)));
+  MP_ASSERT_OK_AND_ASSIGN(auto file, model_bundle_resources->GetFile("a.txt"));
+  EXPECT_EQ(file, contents);
+  // The file is only inflated once.
+  MP_ASSERT_OK_AND_ASSIGN(auto file_again,
+                          model_bundle_resources->GetFile("a.txt"));
+  EXPECT_EQ(file_again.data(), file.data());
+  MP_ASSERT_OK_AND_ASSIGN(file, model_bundle_resources->GetFile("b.txt"));
+  EXPECT_EQ(file, "second file");
+}
+
+TEST(ModelAssetBundleResourcesTest, InflateChecksUncompressedSize) {
+  const std::string zip_content =
+      CreateZipArchive({{"a.txt", std::string(10000, 'x')}},
+                       /*method=*/Z_DEFLATED);
+  absl::flat_hash_map<std::string, metadata::ZipFileEntry> entries;
+  MP_ASSERT_OK(metadata::ListZipFileEntries(
+      zip_content.data(), zip_content.size(), &entries));
+  ASSERT_TRUE(entries.contains("a.txt"));
+  metadata::ZipFileEntry entry = entries["a.txt"];
+
+  // A size the compressed data can't hold is rejected before allocating.
+  entry.uncompressed_size = size_t{1} << 40;
+  auto status = metadata::InflateZipFileEntry(entry).status();
+  EXPECT_EQ(status.code(), absl::StatusCode::kUnknown);
+  EXPECT_THAT(status.message(),
+              testing::HasSubstr("Invalid uncompressed size"));
+
+  // The inflated data must have exactly the announced size.
+  for (const size_t size : {9999, 10001}) {
+    entry.uncompressed_size = size;
+    status = metadata::InflateZipFileEntry(entry).status();
+    EXPECT_EQ(status.code(), absl::StatusCode::kUnknown);
+    EXPECT_THAT(status.message(), testing::HasSubstr("Unable to inflate"));
+  }
+}
+
 TEST(ModelAssetBundleResourcesTest, ListModelFiles) {
   // Creates top-level model asset bundle resources.
   auto model_file = std::make_unique<proto::ExternalFile>();
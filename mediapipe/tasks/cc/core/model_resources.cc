@@ -19,13 +19,20 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
+#include "absl/base/attributes.h"
+#include "absl/base/const_init.h"
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/hash/hash.h"
 #include "absl/memory/memory.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
 #include "mediapipe/framework/api2/packet.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
@@ -38,6 +45,8 @@ limitations under the License.
 #include "tensorflow/lite/core/api/error_reporter.h"
 #include "tensorflow/lite/core/api/op_resolver.h"
 #include "tensorflow/lite/model_builder.h"
+#include "tensorflow/lite/schema/schema_generated.h"
+#include "tensorflow/lite/schema/schema_utils.h"
 #include "tensorflow/lite/tools/verifier.h"
 
 namespace mediapipe {
@@ -50,6 +59,89 @@ using ::mediapipe::api2::Packet;
 using ::mediapipe::api2::PacketAdopting;
 using ::mediapipe::tasks::metadata::ModelMetadataExtractor;
 
+namespace {
+
+ABSL_CONST_INIT absl::Mutex shared_models_mutex(absl::kConstInit);
+bool model_sharing_enabled ABSL_GUARDED_BY(shared_models_mutex) = false;
+
+// A model shared across ModelResources. The content view points into the file
+// content owned by `data`, so it must only be read while `data` is alive.
+struct SharedModel {
+  absl::string_view content;
+  std::weak_ptr<const void> data;
+};
+
+// The shared models, indexed by the hash of their content.
+absl::flat_hash_map<size_t, std::vector<SharedModel>>& GetSharedModels()
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(shared_models_mutex) {
+  static auto* shared_models =
+      new absl::flat_hash_map<size_t, std::vector<SharedModel>>();
+  return *shared_models;
+}
+
+// A shared model kept alive while its content is compared.
+struct LiveSharedModel {
+  absl::string_view content;
+  std::shared_ptr<const void> data;
+};
+
+// Returns the live shared models with the given content hash. Drops the
+// expired ones on the way.
+std::vector<LiveSharedModel> GetLiveSharedModels(size_t hash)
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(shared_models_mutex) {
+  std::vector<LiveSharedModel> live_models;
+  auto& shared_models = GetSharedModels();
+  auto it = shared_models.find(hash);
+  if (it == shared_models.end()) return live_models;
+  auto& models = it->second;
+  for (auto model = models.begin(); model != models.end();) {
+    std::shared_ptr<const void> data = model->data.lock();
+    if (data == nullptr) {
+      model = models.erase(model);
+      continue;
+    }
+    live_models.push_back({model->content, std::move(data)});
+    ++model;
+  }
+  if (models.empty()) shared_models.erase(it);
+  return live_models;
+}
+
+// Returns the live shared model with the given content, or nullptr if there
+// is none. Only the hash lookup holds the lock, the contents of the models
+// with the same hash are compared outside of it.
+std::shared_ptr<const void> FindSharedModel(size_t hash,
+                                            absl::string_view content)
+    ABSL_LOCKS_EXCLUDED(shared_models_mutex) {
+  std::vector<LiveSharedModel> candidates;
+  {
+    absl::MutexLock lock(&shared_models_mutex);
+    candidates = GetLiveSharedModels(hash);
+  }
+  for (auto& candidate : candidates) {
+    if (candidate.content == content) return std::move(candidate.data);
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+void SetModelSharingEnabled(bool enabled) {
+  absl::MutexLock lock(&shared_models_mutex);
+  model_sharing_enabled = enabled;
+}
+
+int GetNumSharedModels() {
+  absl::MutexLock lock(&shared_models_mutex);
+  int num_shared_models = 0;
+  for (const auto& [hash, models] : GetSharedModels()) {
+    for (const auto& model : models) {
+      if (!model.data.expired()) ++num_shared_models;
+    }
+  }
+  return num_shared_models;
+}
+
 bool ModelResources::Verifier::Verify(const char* data, int length,
                                       tflite::ErrorReporter* reporter) {
   return tflite::Verify(data, length, reporter);
@@ -94,7 +186,8 @@ const tflite::Model* ModelResources::GetTfLiteModel() const {
 #if !TFLITE_IN_GMSCORE
   return model_packet_.Get()->GetModel();
 #else
-  return tflite::GetModel(model_file_handler_->GetFileContent().data());
+  return tflite::GetModel(
+      model_data_->model_file_handler->GetFileContent().data());
 #endif
 }
 
@@ -116,10 +209,88 @@ absl::Status ModelResources::BuildModelFromExternalFileProto() {
     }
   }
   ASSIGN_OR_RETURN(
-      model_file_handler_,
+      auto model_file_handler,
       ExternalFileHandler::CreateFromExternalFile(model_file_.get()));
-  const char* buffer_data = model_file_handler_->GetFileContent().data();
-  size_t buffer_size = model_file_handler_->GetFileContent().size();
+  bool model_sharing;
+  {
+    absl::MutexLock lock(&shared_models_mutex);
+    model_sharing = model_sharing_enabled;
+  }
+  if (!model_sharing) {
+    ASSIGN_OR_RETURN(model_data_,
+                     BuildModelData(std::move(model_file_handler)));
+  } else {
+    // The content, read by the handler from model_file_, stays alive with
+    // this ModelResources or with the model data built from it.
+    const absl::string_view content = model_file_handler->GetFileContent();
+    const size_t hash = absl::Hash<absl::string_view>()(content);
+    model_data_ = std::static_pointer_cast<const ModelData>(
+        FindSharedModel(hash, content));
+    if (model_data_ == nullptr) {
+      // Builds the model outside of the lock, as verification is expensive.
+      // If another ModelResources shared the same model in the meantime, the
+      // model built here is discarded in favor of the shared one. Two
+      // ModelResources racing past this check both register their model,
+      // which is harmless: later lookups share the first live one.
+      ASSIGN_OR_RETURN(auto model_data,
+                       BuildModelData(std::move(model_file_handler)));
+      model_data_ = std::static_pointer_cast<const ModelData>(
+          FindSharedModel(hash, content));
+      if (model_data_ == nullptr) {
+        absl::MutexLock lock(&shared_models_mutex);
+        GetSharedModels()[hash].push_back({content, model_data});
+        model_data_ = std::move(model_data);
+      }
+    }
+  }
+  model_packet_ = model_data_->model_packet;
+  metadata_extractor_packet_ = model_data_->metadata_extractor_packet;
+  if (model_sharing) {
+    // The shared model may have been built by a ModelResources with another
+    // op resolver.
+    MP_RETURN_IF_ERROR(CheckOpResolver());
+  }
+  return absl::OkStatus();
+}
+
+absl::Status ModelResources::CheckOpResolver() const {
+  const tflite::Model* model = GetTfLiteModel();
+  if (model->operator_codes() == nullptr) {
+    return absl::OkStatus();
+  }
+  const tflite::OpResolver& op_resolver = op_resolver_packet_.Get();
+  for (const tflite::OperatorCode* op_code : *model->operator_codes()) {
+    const tflite::BuiltinOperator builtin_code =
+        tflite::GetBuiltinCode(op_code);
+    std::string op_name;
+    const TfLiteRegistration* registration = nullptr;
+    if (builtin_code == tflite::BuiltinOperator_CUSTOM) {
+      if (op_code->custom_code() != nullptr) {
+        op_name = op_code->custom_code()->str();
+        registration = op_resolver.FindOp(op_name.c_str(), op_code->version());
+      }
+    } else {
+      op_name = tflite::EnumNameBuiltinOperator(builtin_code);
+      registration = op_resolver.FindOp(builtin_code, op_code->version());
+    }
+    if (registration == nullptr) {
+      return CreateStatusWithPayload(
+          StatusCode::kInvalidArgument,
+          absl::StrCat("The op resolver doesn't support op '", op_name,
+                       "' version ", op_code->version(), " of the model."),
+          MediaPipeTasksStatus::kInvalidArgumentError);
+    }
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::shared_ptr<ModelResources::ModelData>>
+ModelResources::BuildModelData(
+    std::unique_ptr<ExternalFileHandler> model_file_handler) {
+  auto model_data = std::make_shared<ModelData>();
+  model_data->model_file = model_file_;
+  const char* buffer_data = model_file_handler->GetFileContent().data();
+  size_t buffer_size = model_file_handler->GetFileContent().size();
   // Verifies that the supplied buffer refers to a valid flatbuffer model,
   // and that it uses only operators that are supported by the OpResolver
   // that was passed to the ModelResources constructor, and then builds
@@ -150,14 +321,16 @@ absl::Status ModelResources::BuildModelFromExternalFileProto() {
     }
   }
 
-  model_packet_ = MakePacket<ModelPtr>(
+  model_data->model_packet = MakePacket<ModelPtr>(
       model.release(), [](tflite::FlatBufferModel* model) { delete model; });
   ASSIGN_OR_RETURN(auto model_metadata_extractor,
                    metadata::ModelMetadataExtractor::CreateFromModelBuffer(
                        buffer_data, buffer_size));
-  metadata_extractor_packet_ = PacketAdopting<metadata::ModelMetadataExtractor>(
-      std::move(model_metadata_extractor));
-  return absl::OkStatus();
+  model_data->metadata_extractor_packet =
+      PacketAdopting<metadata::ModelMetadataExtractor>(
+          std::move(model_metadata_extractor));
+  model_data->model_file_handler = std::move(model_file_handler);
+  return model_data;
 }
 
 }  // namespace core
@@ -41,12 +41,28 @@ namespace mediapipe {
 namespace tasks {
 namespace core {
 
+// Enables or disables process-wide sharing of loaded models. When enabled,
+// ModelResources objects created from identical model contents, e.g. by
+// several instances of the same task, share a single verified
+// tflite::FlatBufferModel, model metadata extractor and model file content
+// instead of loading their own copy. A shared model is released as soon as
+// the last ModelResources referencing it is destroyed. Only affects the
+// ModelResources created after the call. Disabled by default. While enabled,
+// the creation of a ModelResources fails if its op resolver doesn't support
+// all the ops of the model.
+void SetModelSharingEnabled(bool enabled);
+
+// Returns the number of models currently shared across ModelResources.
+int GetNumSharedModels();
+
 // The mediapipe task model resources class.
 // A ModelResources object, created from an external file proto, bundles the
 // model-related resources that are needed by a mediapipe task. As the
 // resources, including flatbuffer model, op resolver, model metadata extractor,
 // and external file handler, are owned by the ModelResources object, callers
-// must keep ModelResources alive while using any of the resources.
+// must keep ModelResources alive while using any of the resources. If model
+// sharing is enabled, the model, the metadata extractor and the external file
+// handler may be co-owned by other ModelResources with the same model.
 class ModelResources {
  public:
   // Represents a TfLite model as a FlatBuffer.
@@ -124,16 +140,35 @@ class ModelResources {
 
   // The model resources tag.
   const std::string tag_;
-  // The model file.
-  std::unique_ptr<proto::ExternalFile> model_file_;
+  // The model file, also owned by the model data which reads it.
+  std::shared_ptr<proto::ExternalFile> model_file_;
   // The packet stores the TFLite op resolver.
   api2::Packet<tflite::OpResolver> op_resolver_packet_;
 
-  // The ExternalFileHandler for the model.
-  std::unique_ptr<ExternalFileHandler> model_file_handler_;
-  // The packet stores the TFLite model for actual inference.
+  // The resources built from the model file content, possibly shared with
+  // other ModelResources if model sharing is enabled.
+  struct ModelData {
+    // The model file proto read by model_file_handler, kept alive for as long
+    // as the model data, which may outlive the ModelResources sharing it.
+    std::shared_ptr<const proto::ExternalFile> model_file;
+    // The ExternalFileHandler for the model.
+    std::unique_ptr<ExternalFileHandler> model_file_handler;
+    // The packet stores the TFLite model for actual inference.
+    api2::Packet<ModelPtr> model_packet;
+    // The packet stores the TFLite Metadata extractor built from the model.
+    api2::Packet<metadata::ModelMetadataExtractor> metadata_extractor_packet;
+  };
+
+  // Builds the model data from the file content held by `model_file_handler`.
+  absl::StatusOr<std::shared_ptr<ModelData>> BuildModelData(
+      std::unique_ptr<ExternalFileHandler> model_file_handler);
+
+  // Checks that the op resolver supports all the ops of the model.
+  absl::Status CheckOpResolver() const;
+
+  std::shared_ptr<const ModelData> model_data_;
+  // Shallow copies of the packets in model_data_.
   api2::Packet<ModelPtr> model_packet_;
-  // The packet stores the TFLite Metadata extractor built from the model.
   api2::Packet<metadata::ModelMetadataExtractor> metadata_extractor_packet_;
 
   // Extra verifier for FlatBuffer input data.
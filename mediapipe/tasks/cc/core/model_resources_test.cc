@@ -295,6 +295,120 @@ TEST_F(ModelResourcesTest, CreateSuccessWithCustomOpsPacket) {
                                ->custom_name);
 }
 
+TEST_F(ModelResourcesTest, SharesIdenticalModels) {
+  SetModelSharingEnabled(true);
+  auto model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_name(kTestModelPath);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources1,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_content(LoadBinaryContent(kTestModelPath));
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources2,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_name(kTestModelWithMetadataPath);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources3,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  SetModelSharingEnabled(false);
+
+  EXPECT_EQ(GetNumSharedModels(), 2);
+  EXPECT_EQ(model_resources1->GetModelPacket().Get().get(),
+            model_resources2->GetModelPacket().Get().get());
+  EXPECT_NE(model_resources1->GetModelPacket().Get().get(),
+            model_resources3->GetModelPacket().Get().get());
+  CheckModelResourcesPackets(model_resources2.get());
+
+  model_resources1.reset();
+  EXPECT_EQ(GetNumSharedModels(), 2);
+  CheckModelResourcesPackets(model_resources2.get());
+  model_resources2.reset();
+  model_resources3.reset();
+  EXPECT_EQ(GetNumSharedModels(), 0);
+}
+
+TEST_F(ModelResourcesTest, SharedModelOutlivesModelResourcesThatBuiltIt) {
+  const std::string model_content =
+      LoadBinaryContent(kTestModelWithMetadataPath);
+  SetModelSharingEnabled(true);
+  auto model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_content(model_content);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources1,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_content(model_content);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources2,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  const auto* shared_model = model_resources1->GetModelPacket().Get().get();
+
+  // Destroys the ExternalFile proto of the ModelResources that built the
+  // shared model before using and sharing the model again.
+  model_resources1.reset();
+  CheckModelResourcesPackets(model_resources2.get());
+  EXPECT_TRUE(model_resources2->GetTfLiteModel()->subgraphs());
+  EXPECT_TRUE(model_resources2->GetMetadataExtractor()->GetModelMetadata());
+  model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_content(model_content);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources3,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  SetModelSharingEnabled(false);
+
+  EXPECT_EQ(GetNumSharedModels(), 1);
+  EXPECT_EQ(model_resources2->GetModelPacket().Get().get(), shared_model);
+  EXPECT_EQ(model_resources3->GetModelPacket().Get().get(), shared_model);
+}
+
+TEST_F(ModelResourcesTest, SharedModelIsCheckedAgainstEachOpResolver) {
+  tflite::MutableOpResolver resolver;
+  resolver.AddBuiltin(::tflite::BuiltinOperator_ADD,
+                      ::tflite::ops::builtin::Register_ADD());
+  resolver.AddCustom("MY_CUSTOM_OP",
+                     ::tflite::ops::custom::Register_MY_CUSTOM_OP());
+  SetModelSharingEnabled(true);
+  auto model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_name(kTestModelWithCustomOpsPath);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources,
+      ModelResources::Create(
+          kTestModelResourcesTag, std::move(model_file),
+          absl::make_unique<tflite::MutableOpResolver>(resolver)));
+  model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_name(kTestModelWithCustomOpsPath);
+  auto status_or_model_resources =
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file));
+  SetModelSharingEnabled(false);
+
+  EXPECT_EQ(status_or_model_resources.status().code(),
+            absl::StatusCode::kInvalidArgument);
+  EXPECT_THAT(status_or_model_resources.status().message(),
+              testing::HasSubstr("doesn't support op 'MY_CUSTOM_OP'"));
+  AssertStatusHasMediaPipeTasksStatusCode(
+      status_or_model_resources.status(),
+      MediaPipeTasksStatus::kInvalidArgumentError);
+}
+
+TEST_F(ModelResourcesTest, DoesNotShareModelsByDefault) {
+  auto model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_name(kTestModelPath);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources1,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+  model_file = std::make_unique<proto::ExternalFile>();
+  model_file->set_file_name(kTestModelPath);
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto model_resources2,
+      ModelResources::Create(kTestModelResourcesTag, std::move(model_file)));
+
+  EXPECT_EQ(GetNumSharedModels(), 0);
+  EXPECT_NE(model_resources1->GetModelPacket().Get().get(),
+            model_resources2->GetModelPacket().Get().get());
+}
+
 }  // namespace core
 }  // namespace tasks
 }  // namespace mediapipe
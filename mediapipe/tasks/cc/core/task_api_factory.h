@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_CORE_TASK_API_FACTORY_H_
 #define MEDIAPIPE_TASKS_CC_CORE_TASK_API_FACTORY_H_
 
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <string>
 #include <type_traits>
@@ -25,6 +27,7 @@ limitations under the License.
 #include "absl/status/statusor.h"
 #include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
+#include "mediapipe/calculators/core/flow_limiter_calculator.pb.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/port/requires.h"
 #include "mediapipe/framework/port/status_macros.h"
@@ -56,7 +59,7 @@ class TaskApiFactory {
   static absl::StatusOr<std::unique_ptr<T>> Create(
       CalculatorGraphConfig graph_config,
       std::unique_ptr<tflite::OpResolver> resolver,
-      PacketsCallback packets_callback = nullptr) {
+      PacketsCallback packets_callback = nullptr, int num_replicas = 1) {
     bool found_task_subgraph = false;
     // This for-loop ensures there's only one subgraph besides
     // FlowLimiterCalculator.
@@ -77,10 +80,66 @@ class TaskApiFactory {
     ASSIGN_OR_RETURN(
         auto runner,
         core::TaskRunner::Create(std::move(graph_config), std::move(resolver),
-                                 std::move(packets_callback)));
+                                 std::move(packets_callback), num_replicas));
     return std::make_unique<T>(std::move(runner));
   }
 
+  // Returns a packets callback that reports the input frames dropped by the
+  // FlowLimiterCalculator of the task graph, if any, to
+  // `frame_dropped_callback` and forwards all packets to `packets_callback`.
+  static PacketsCallback AddFrameDroppedCallback(
+      PacketsCallback packets_callback,
+      std::function<void(int64_t timestamp_ms)> frame_dropped_callback) {
+    if (packets_callback == nullptr || frame_dropped_callback == nullptr) {
+      return packets_callback;
+    }
+    return [packets_callback = std::move(packets_callback),
+            frame_dropped_callback = std::move(frame_dropped_callback)](
+               absl::StatusOr<PacketMap> status_or_packets) {
+      if (status_or_packets.ok()) {
+        auto it = status_or_packets->find(kFlowLimiterAllowStreamName);
+        if (it != status_or_packets->end() && !it->second.IsEmpty() &&
+            !it->second.Get<bool>()) {
+          constexpr int64_t kMicroSecondsPerMilliSecond = 1000;
+          frame_dropped_callback(it->second.Timestamp().Value() /
+                                 kMicroSecondsPerMilliSecond);
+        }
+      }
+      packets_callback(std::move(status_or_packets));
+    };
+  }
+
+  // Merges the FlowLimiterCalculator options set in the base options of the
+  // task subgraph node into the FlowLimiterCalculator nodes of
+  // `graph_config`, if any.
+  template <typename Options>
+  static void ApplyFlowLimiterOptions(CalculatorGraphConfig& graph_config) {
+    if constexpr (mediapipe::Requires<Options>(
+                      [](auto&& o) -> decltype(o.ext) {}) &&
+                  mediapipe::Requires<Options>(
+                      [](auto&& o) -> decltype(o.base_options()) {})) {
+      const FlowLimiterCalculatorOptions* flow_limiter_options = nullptr;
+      for (const auto& node : graph_config.node()) {
+        if (node.options().HasExtension(Options::ext)) {
+          const auto& base_options =
+              node.options().GetExtension(Options::ext).base_options();
+          if (base_options.has_flow_limiter_options()) {
+            flow_limiter_options = &base_options.flow_limiter_options();
+          }
+        }
+      }
+      if (flow_limiter_options == nullptr) return;
+      const FlowLimiterCalculatorOptions options = *flow_limiter_options;
+      for (auto& node : *graph_config.mutable_node()) {
+        if (node.calculator() == "FlowLimiterCalculator") {
+          node.mutable_options()
+              ->MutableExtension(FlowLimiterCalculatorOptions::ext)
+              ->MergeFrom(options);
+        }
+      }
+    }
+  }
+
   template <typename Options>
   static absl::Status CheckHasValidOptions(
       const CalculatorGraphConfig::Node& node) {
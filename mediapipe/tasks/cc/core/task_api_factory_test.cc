@@ -0,0 +1,89 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/tasks/cc/core/task_api_factory.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "mediapipe/framework/api2/builder.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/packet.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/timestamp.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
+#include "mediapipe/tasks/cc/core/utils.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace core {
+namespace {
+
+constexpr char kImageTag[] = "IMAGE";
+constexpr char kImageStreamName[] = "image";
+
+TEST(AddFlowLimiterCalculatorTest, ExportsAllowStream) {
+  api2::builder::Graph graph;
+  graph.In(kImageTag).SetName("image_in");
+  auto& task_subgraph = graph.AddNode("PassThroughCalculator");
+  task_subgraph.Out(kImageTag).SetName(kImageStreamName) >>
+      graph.Out(kImageTag);
+  CalculatorGraphConfig config =
+      AddFlowLimiterCalculator(graph, task_subgraph, {kImageTag}, kImageTag);
+
+  EXPECT_THAT(config.output_stream(),
+              testing::Contains(
+                  absl::StrCat("ALLOW:", kFlowLimiterAllowStreamName)));
+}
+
+TEST(AddFrameDroppedCallbackTest, ReportsDroppedFrames) {
+  std::vector<int64_t> dropped_timestamps_ms;
+  int num_callbacks = 0;
+  PacketsCallback packets_callback = TaskApiFactory::AddFrameDroppedCallback(
+      [&num_callbacks](absl::StatusOr<PacketMap>) { ++num_callbacks; },
+      [&dropped_timestamps_ms](int64_t timestamp_ms) {
+        dropped_timestamps_ms.push_back(timestamp_ms);
+      });
+
+  packets_callback(PacketMap{
+      {kImageStreamName, MakePacket<int>(0).At(Timestamp(10000))},
+      {kFlowLimiterAllowStreamName,
+       MakePacket<bool>(true).At(Timestamp(10000))}});
+  packets_callback(PacketMap{
+      {kImageStreamName, Packet()},
+      {kFlowLimiterAllowStreamName,
+       MakePacket<bool>(false).At(Timestamp(20000))}});
+  packets_callback(PacketMap{
+      {kImageStreamName, MakePacket<int>(0).At(Timestamp(30000))},
+      {kFlowLimiterAllowStreamName, Packet()}});
+  packets_callback(absl::InternalError("An intended error for testing"));
+
+  EXPECT_THAT(dropped_timestamps_ms, testing::ElementsAre(20));
+  EXPECT_EQ(num_callbacks, 4);
+}
+
+TEST(AddFrameDroppedCallbackTest, KeepsPacketsCallbackWithoutCallback) {
+  EXPECT_EQ(TaskApiFactory::AddFrameDroppedCallback(
+                nullptr, [](int64_t timestamp_ms) {}),
+            nullptr);
+}
+
+}  // namespace
+}  // namespace core
+}  // namespace tasks
+}  // namespace mediapipe
@@ -31,6 +31,8 @@ limitations under the License.
 #include "absl/status/statusor.h"
 #include "absl/strings/substitute.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/clock.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/tool/name_util.h"
@@ -89,17 +91,45 @@ absl::StatusOr<PacketMap> GenerateOutputPacketMap(
 absl::StatusOr<std::unique_ptr<TaskRunner>> TaskRunner::Create(
     CalculatorGraphConfig config,
     std::unique_ptr<tflite::OpResolver> op_resolver,
-    PacketsCallback packets_callback) {
+    PacketsCallback packets_callback, int num_replicas) {
+  if (num_replicas < 1) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        absl::Substitute("Expected at least one graph replica, got $0.",
+                         num_replicas),
+        MediaPipeTasksStatus::kRunnerInitializationError);
+  }
+  if (num_replicas > 1 && packets_callback) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Graph replicas are only supported when the result callback is not "
+        "provided.",
+        MediaPipeTasksStatus::kRunnerInitializationError);
+  }
+  // All the replicas share the cache, so that the model resources created by
+  // the first graph are reused by the others.
+  auto model_resources_cache =
+      std::make_shared<ModelResourcesCache>(std::move(op_resolver));
   auto task_runner = absl::WrapUnique(new TaskRunner(packets_callback));
+  for (int i = 1; i < num_replicas; ++i) {
+    auto replica = absl::WrapUnique(new TaskRunner());
+    MP_RETURN_IF_ERROR(replica->Initialize(config, model_resources_cache));
+    task_runner->replicas_.push_back(std::move(replica));
+  }
   MP_RETURN_IF_ERROR(
-      task_runner->Initialize(std::move(config), std::move(op_resolver)));
+      task_runner->Initialize(std::move(config), model_resources_cache));
+  {
+    absl::MutexLock lock(&task_runner->replicas_mutex_);
+    task_runner->num_in_flight_.resize(num_replicas);
+    task_runner->replica_stats_.resize(num_replicas);
+  }
   MP_RETURN_IF_ERROR(task_runner->Start());
   return task_runner;
 }
 
 absl::Status TaskRunner::Initialize(
     CalculatorGraphConfig config,
-    std::unique_ptr<tflite::OpResolver> op_resolver) {
+    std::shared_ptr<ModelResourcesCache> model_resources_cache) {
   if (initialized_) {
     return CreateStatusWithPayload(
         absl::StatusCode::kInvalidArgument,
@@ -138,14 +168,21 @@ absl::Status TaskRunner::Initialize(
     mediapipe::tool::AddMultiStreamCallback(
         output_stream_names_,
         [this](const std::vector<Packet>& packets) {
+          if (batch_output_packets_ != nullptr) {
+            for (int i = 0; i < packets.size(); ++i) {
+              if (!packets[i].IsEmpty()) {
+                (*batch_output_packets_)[packets[i].Timestamp()]
+                                        [output_stream_names_[i]] = packets[i];
+              }
+            }
+            return;
+          }
           status_or_output_packets_ =
               GenerateOutputPacketMap(packets, output_stream_names_);
           return;
         },
         &config, &input_side_packets, /*observe_timestamp_bounds=*/true);
   }
-  auto model_resources_cache =
-      std::make_shared<ModelResourcesCache>(std::move(op_resolver));
   MP_RETURN_IF_ERROR(
       AddPayload(graph_.SetServiceObject(kModelResourcesCacheService,
                                          model_resources_cache),
@@ -170,6 +207,9 @@ absl::Status TaskRunner::Start() {
         absl::StatusCode::kInvalidArgument, "Task runner is already running.",
         MediaPipeTasksStatus::kRunnerFailsToStartError);
   }
+  for (auto& replica : replicas_) {
+    MP_RETURN_IF_ERROR(replica->Start());
+  }
   {
     absl::MutexLock lock(&mutex_);
     last_seen_ = Timestamp::Unset();
@@ -189,6 +229,37 @@ absl::Status TaskRunner::Start() {
 }
 
 absl::StatusOr<PacketMap> TaskRunner::Process(PacketMap inputs) {
+  // Timestamped inputs must stay on one graph to keep timestamps in order.
+  const bool use_any_replica =
+      !replicas_.empty() && !inputs.empty() &&
+      inputs.begin()->second.Timestamp() == Timestamp::Unset();
+  int replica = 0;
+  {
+    absl::MutexLock lock(&replicas_mutex_);
+    if (use_any_replica) {
+      replica = std::min_element(num_in_flight_.begin(), num_in_flight_.end()) -
+                num_in_flight_.begin();
+    }
+    ++num_in_flight_[replica];
+  }
+  TaskRunner* runner = replica == 0 ? this : replicas_[replica - 1].get();
+  const absl::Time start_time = absl::Now();
+  auto status_or_output_packets = runner->ProcessInGraph(std::move(inputs));
+  absl::MutexLock lock(&replicas_mutex_);
+  --num_in_flight_[replica];
+  auto& stats = replica_stats_[replica];
+  ++stats.num_invocations;
+  stats.num_errors += !status_or_output_packets.ok();
+  stats.total_processing_time += absl::Now() - start_time;
+  return status_or_output_packets;
+}
+
+std::vector<TaskRunnerReplicaStats> TaskRunner::GetReplicaStats() const {
+  absl::MutexLock lock(&replicas_mutex_);
+  return replica_stats_;
+}
+
+absl::StatusOr<PacketMap> TaskRunner::ProcessInGraph(PacketMap inputs) {
   if (!is_running_) {
     return CreateStatusWithPayload(
         absl::StatusCode::kInvalidArgument,
@@ -250,6 +321,85 @@ absl::StatusOr<PacketMap> TaskRunner::Process(PacketMap inputs) {
   return status_or_output_packets_;
 }
 
+absl::StatusOr<std::vector<PacketMap>> TaskRunner::ProcessBatch(
+    std::vector<PacketMap> inputs) {
+  if (!is_running_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Task runner is currently not running.",
+        MediaPipeTasksStatus::kRunnerNotStartedError);
+  }
+  if (packets_callback_) {
+    return CreateStatusWithPayload(
+        absl::StatusCode::kInvalidArgument,
+        "Calling TaskRunner::ProcessBatch method is illegal when the result "
+        "callback is provided.",
+        MediaPipeTasksStatus::kRunnerApiCalledInWrongModeError);
+  }
+  for (const auto& input : inputs) {
+    ASSIGN_OR_RETURN(auto input_timestamp,
+                     ValidateAndGetPacketTimestamp(input));
+    if (input_timestamp != Timestamp::Unset()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "Calling TaskRunner::ProcessBatch method with packets having a "
+          "timestamp.",
+          MediaPipeTasksStatus::kRunnerInvalidTimestampError);
+    }
+  }
+  if (inputs.empty()) {
+    return std::vector<PacketMap>();
+  }
+  // See Process() for why only one invocation runs in the graph at a time.
+  absl::MutexLock lock(&mutex_);
+  std::map<Timestamp, PacketMap> batch_output_packets;
+  batch_output_packets_ = &batch_output_packets;
+  std::vector<Timestamp> input_timestamps;
+  input_timestamps.reserve(inputs.size());
+  absl::Status status;
+  for (auto& input : inputs) {
+    const Timestamp input_timestamp =
+        last_seen_ == Timestamp::Unset()
+            ? Timestamp(0)
+            : last_seen_ + Timestamp::kTimestampUnitsPerSecond;
+    for (auto& [stream_name, packet] : input) {
+      status = AddPayload(
+          graph_.AddPacketToInputStream(stream_name,
+                                        std::move(packet).At(input_timestamp)),
+          absl::StrCat("Failed to add packet to the graph input stream: ",
+                       stream_name),
+          MediaPipeTasksStatus::kRunnerUnexpectedInputError);
+      if (!status.ok()) break;
+    }
+    if (!status.ok()) break;
+    input_timestamps.push_back(input_timestamp);
+    last_seen_ = input_timestamp;
+  }
+  // Waits for the inputs that were added even on failure, so that the graph
+  // no longer writes to batch_output_packets afterwards.
+  if (!graph_.WaitUntilIdle().ok()) {
+    graph_.GetCombinedErrors(&status);
+  }
+  batch_output_packets_ = nullptr;
+  MP_RETURN_IF_ERROR(status);
+  if (!batch_output_packets.empty()) {
+    last_seen_ = std::max(batch_output_packets.rbegin()->first, last_seen_);
+  }
+  // As in Process(), an output stream without a packet for an input gets an
+  // empty packet.
+  std::vector<PacketMap> outputs;
+  outputs.reserve(input_timestamps.size());
+  for (const Timestamp input_timestamp : input_timestamps) {
+    PacketMap& output_packets = outputs.emplace_back();
+    auto it = batch_output_packets.find(input_timestamp);
+    for (const auto& stream_name : output_stream_names_) {
+      output_packets[stream_name] =
+          it == batch_output_packets.end() ? Packet() : it->second[stream_name];
+    }
+  }
+  return outputs;
+}
+
 absl::Status TaskRunner::Send(PacketMap inputs) {
   if (!is_running_) {
     return CreateStatusWithPayload(
@@ -300,13 +450,19 @@ absl::Status TaskRunner::Close() {
         MediaPipeTasksStatus::kRunnerFailsToCloseError);
   }
   is_running_ = false;
-  MP_RETURN_IF_ERROR(
+  // Shuts down every graph even if some fail to close, and reports the first
+  // error.
+  absl::Status status;
+  for (auto& replica : replicas_) {
+    status.Update(replica->Close());
+  }
+  status.Update(
       AddPayload(graph_.CloseAllInputStreams(), "Fail to close input streams",
                  MediaPipeTasksStatus::kRunnerFailsToCloseError));
-  MP_RETURN_IF_ERROR(AddPayload(
+  status.Update(AddPayload(
       graph_.WaitUntilDone(), "Fail to shutdown the MediaPipe graph.",
       MediaPipeTasksStatus::kRunnerFailsToCloseError));
-  return absl::OkStatus();
+  return status;
 }
 
 absl::Status TaskRunner::Restart() {
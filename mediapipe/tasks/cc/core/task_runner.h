@@ -21,6 +21,7 @@ limitations under the License.
 #endif
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <map>
 #include <memory>
@@ -32,6 +33,7 @@ limitations under the License.
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
 #include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/port/status_macros.h"
@@ -49,6 +51,16 @@ using PacketMap = std::map<std::string, Packet>;
 // A callback method to get output packets from the task runner.
 using PacketsCallback = std::function<void(absl::StatusOr<PacketMap>)>;
 
+// Processing statistics of one graph replica of a TaskRunner.
+struct TaskRunnerReplicaStats {
+  // Number of invocations processed by the replica, including failed ones.
+  int64_t num_invocations = 0;
+  // Number of invocations that returned an error.
+  int64_t num_errors = 0;
+  // Total time spent processing invocations in the replica.
+  absl::Duration total_processing_time = absl::ZeroDuration();
+};
+
 // The mediapipe task runner class.
 // The runner has two processing modes: synchronous mode and asynchronous mode.
 // In the synchronous mode, clients send input data using the blocking API,
@@ -60,6 +72,11 @@ using PacketsCallback = std::function<void(absl::StatusOr<PacketMap>)>;
 // operate in only one processing mode, which is defined at construction time
 // based on whether a PacketsCallback is provided (asynchronous mode) or not
 // (synchronous mode).
+//
+// In the synchronous mode, the runner can also own several replicas of the
+// graph, all sharing the same ModelResourcesCache and thus the same model
+// buffers. Process() calls from multiple threads are then load-balanced across
+// the replicas instead of being serialized on a single graph.
 class TaskRunner {
  public:
   // Creates the task runner with a CalculatorGraphConfig proto.
@@ -70,10 +87,14 @@ class TaskRunner {
   // asynchronous method, Send(), to provide the input packets. If the packets
   // callback is absent, clients must use the synchronous method, Process(), to
   // provide the input packets and receive the output packets.
+  // If `num_replicas` is greater than 1, the runner creates that many graphs
+  // from the config, which is only supported in the synchronous mode. The
+  // graphs share the model resources they create through
+  // GetOrCreateModelResources().
   static absl::StatusOr<std::unique_ptr<TaskRunner>> Create(
       CalculatorGraphConfig config,
       std::unique_ptr<tflite::OpResolver> op_resolver = nullptr,
-      PacketsCallback packets_callback = nullptr);
+      PacketsCallback packets_callback = nullptr, int num_replicas = 1);
 
   // TaskRunner is neither copyable nor movable.
   TaskRunner(const TaskRunner&) = delete;
@@ -90,8 +111,23 @@ class TaskRunner {
   // thread-unsafe and it is the caller's responsibility to synchronize access
   // to this method across multiple threads and to ensure that the input packet
   // timestamps are in order.
+  // If the runner has several graph replicas, calls with input packets that
+  // have no timestamp are thread-safe and run on the least busy replica. Calls
+  // with timestamped input packets always run on the first replica.
   absl::StatusOr<PacketMap> Process(PacketMap inputs);
 
+  // A synchronous method that processes a batch of unrelated inputs, such as
+  // images or texts, and returns one output packet map per input, in order.
+  // Unlike calling Process() on each input, all the inputs are added to the
+  // graph before waiting for it to become idle, so that the graph can run the
+  // different stages of its pipeline on consecutive inputs concurrently. The
+  // input packets must have no timestamp: the inputs are assigned consecutive
+  // internal timestamps, and the graph is expected to emit the outputs of an
+  // input at its timestamp. If the graph fails on any input, an error status is
+  // returned for the whole batch. This method is thread-unsafe, like Process().
+  absl::StatusOr<std::vector<PacketMap>> ProcessBatch(
+      std::vector<PacketMap> inputs);
+
   // An asynchronous method that is designed for handling live streaming data
   // such as live camera and microphone data. A user-defined PacketsCallback
   // function must be provided in the constructor to receive the output packets.
@@ -113,6 +149,10 @@ class TaskRunner {
   // Returns the canonicalized CalculatorGraphConfig of the underlying graph.
   const CalculatorGraphConfig& GetGraphConfig() { return graph_.Config(); }
 
+  // Returns the processing statistics of each graph replica. Statistics are
+  // only collected by Process() calls.
+  std::vector<TaskRunnerReplicaStats> GetReplicaStats() const;
+
  private:
   // Constructor.
   // Creates a TaskRunner instance with an optional PacketsCallback method.
@@ -125,13 +165,16 @@ class TaskRunner {
   // be only initialized once.
   absl::Status Initialize(
       CalculatorGraphConfig config,
-      std::unique_ptr<tflite::OpResolver> op_resolver = nullptr);
+      std::shared_ptr<ModelResourcesCache> model_resources_cache);
 
   // Starts the task runner. Returns an ok status to indicate that the
   // runner is ready to accept input data. Otherwise, returns an error status to
   // indicate that the runner isn't started successfully.
   absl::Status Start();
 
+  // Processes the inputs in the graph of this runner, ignoring the replicas.
+  absl::StatusOr<PacketMap> ProcessInGraph(PacketMap inputs);
+
   PacketsCallback packets_callback_;
   std::vector<std::string> output_stream_names_;
   CalculatorGraph graph_;
@@ -139,8 +182,20 @@ class TaskRunner {
   std::atomic_bool is_running_ = false;
 
   absl::StatusOr<PacketMap> status_or_output_packets_;
+  // Collects the output packets of all the inputs, by timestamp, while
+  // ProcessBatch() is running.
+  std::map<Timestamp, PacketMap>* batch_output_packets_ = nullptr;
   Timestamp last_seen_ ABSL_GUARDED_BY(mutex_);
   absl::Mutex mutex_;
+
+  // The other graph replicas, if any. This runner is the first replica.
+  std::vector<std::unique_ptr<TaskRunner>> replicas_;
+  // Number of in-flight invocations and statistics of each replica, starting
+  // with this runner.
+  std::vector<int> num_in_flight_ ABSL_GUARDED_BY(replicas_mutex_);
+  std::vector<TaskRunnerReplicaStats> replica_stats_
+      ABSL_GUARDED_BY(replicas_mutex_);
+  mutable absl::Mutex replicas_mutex_;
 };
 
 }  // namespace core
@@ -22,6 +22,7 @@ limitations under the License.
 #include <string>
 #include <thread>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -254,6 +255,82 @@ TEST_F(TaskRunnerTest, MultiThreadSyncAPICallsWithoutTimestamp) {
   MP_ASSERT_OK(runner->Close());
 }
 
+TEST_F(TaskRunnerTest, BatchSyncAPICalls) {
+  MP_ASSERT_OK_AND_ASSIGN(auto runner,
+                          TaskRunner::Create(GetPassThroughGraphConfig()));
+  std::vector<PacketMap> inputs;
+  for (int i = 0; i < 100; ++i) {
+    inputs.push_back({{"in", MakePacket<int>(i)}});
+  }
+  MP_ASSERT_OK_AND_ASSIGN(auto results, runner->ProcessBatch(inputs));
+  ASSERT_EQ(results.size(), 100);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(i, results[i]["out"].Get<int>());
+  }
+  // Single and batch calls can be interleaved.
+  auto status_or_result = runner->Process({{"in", MakePacket<int>(100)}});
+  ASSERT_TRUE(status_or_result.ok());
+  EXPECT_EQ(100, status_or_result.value()["out"].Get<int>());
+  MP_ASSERT_OK_AND_ASSIGN(results, runner->ProcessBatch(inputs));
+  ASSERT_EQ(results.size(), 100);
+  EXPECT_EQ(99, results[99]["out"].Get<int>());
+  MP_ASSERT_OK(runner->Close());
+}
+
+TEST_F(TaskRunnerTest, BatchSyncAPICallWithTimestamp) {
+  MP_ASSERT_OK_AND_ASSIGN(auto runner,
+                          TaskRunner::Create(GetPassThroughGraphConfig()));
+  auto status_or_results =
+      runner->ProcessBatch({{{"in", MakePacket<int>(0).At(Timestamp(0))}}});
+  ASSERT_FALSE(status_or_results.ok());
+  EXPECT_THAT(status_or_results.status().message(),
+              testing::HasSubstr("having a timestamp"));
+  MP_ASSERT_OK(runner->Close());
+}
+
+TEST_F(TaskRunnerTest, MultiThreadSyncAPICallsWithReplicas) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto runner, TaskRunner::Create(GetPassThroughGraphConfig(),
+                                      /*op_resolver=*/nullptr,
+                                      /*packets_callback=*/nullptr,
+                                      /*num_replicas=*/4));
+  constexpr int kNumThreads = 8;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([i, &runner]() {
+      for (int j = 0; j < 30; ++j) {
+        auto status_or_result =
+            runner->Process({{"in", MakePacket<int>(i * j)}});
+        ASSERT_TRUE(status_or_result.ok());
+        EXPECT_EQ(i * j, status_or_result.value()["out"].Get<int>());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto replica_stats = runner->GetReplicaStats();
+  ASSERT_EQ(replica_stats.size(), 4);
+  int num_invocations = 0;
+  for (const auto& stats : replica_stats) {
+    num_invocations += stats.num_invocations;
+    EXPECT_EQ(stats.num_errors, 0);
+  }
+  EXPECT_EQ(num_invocations, kNumThreads * 30);
+  MP_ASSERT_OK(runner->Restart());
+  auto status_or_result = runner->Process({{"in", MakePacket<int>(1)}});
+  ASSERT_TRUE(status_or_result.ok());
+  MP_ASSERT_OK(runner->Close());
+}
+
+TEST_F(TaskRunnerTest, ReplicasRequireSyncMode) {
+  auto status_or_runner = TaskRunner::Create(
+      GetPassThroughGraphConfig(), /*op_resolver=*/nullptr,
+      [](absl::StatusOr<PacketMap>) {}, /*num_replicas=*/2);
+  EXPECT_EQ(status_or_runner.status().code(),
+            absl::StatusCode::kInvalidArgument);
+}
+
 TEST_F(TaskRunnerTest, AsyncAPICalls) {
   std::function<void(absl::StatusOr<PacketMap>)> callback(
       [](absl::StatusOr<PacketMap> status_or_packets) {
@@ -284,6 +361,16 @@ TEST_F(TaskRunnerTest, ReportErrorInSyncAPICall) {
               testing::HasSubstr("An intended error for testing"));
 }
 
+TEST_F(TaskRunnerTest, ReportErrorInBatchSyncAPICall) {
+  MP_ASSERT_OK_AND_ASSIGN(auto runner,
+                          TaskRunner::Create(GetErrorCalculatorGraphConfig()));
+  auto status_or_results = runner->ProcessBatch(
+      {{{"in", MakePacket<int>(0)}}, {{"in", MakePacket<int>(1)}}});
+  ASSERT_FALSE(status_or_results.ok());
+  ASSERT_THAT(status_or_results.status().message(),
+              testing::HasSubstr("An intended error for testing"));
+}
+
 TEST_F(TaskRunnerTest, ReportErrorInAsyncAPICall) {
   std::function<void(absl::StatusOr<PacketMap>)> callback(
       [](absl::StatusOr<PacketMap> status_or_packets) {
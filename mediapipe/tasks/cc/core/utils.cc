@@ -30,6 +30,7 @@ namespace mediapipe {
 namespace tasks {
 namespace core {
 namespace {
+constexpr char kAllowTag[] = "ALLOW";
 constexpr char kFinishedTag[] = "FINISHED";
 constexpr char kFlowLimiterCalculatorName[] = "FlowLimiterCalculator";
 
@@ -72,6 +73,8 @@ CalculatorGraphConfig AddFlowLimiterCalculator(
     graph.In(input_stream_tags[i]) >> flow_limiter.In("")[i];
     flow_limiter.Out("")[i] >> task_subgraph.In(input_stream_tags[i]);
   }
+  flow_limiter.Out(kAllowTag).SetName(kFlowLimiterAllowStreamName) >>
+      graph.Out(kAllowTag);
   // Back edge.
   task_subgraph.Out(finished_stream_tag) >> flow_limiter.In(kFinishedTag);
 
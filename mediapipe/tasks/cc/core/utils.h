@@ -77,8 +77,13 @@ static TensorType* FindTensorByName(
   return index == -1 ? nullptr : tensors[index];
 }
 
+// The name of the graph output stream carrying the "ALLOW" packets of the
+// FlowLimiterCalculator added by AddFlowLimiterCalculator().
+constexpr char kFlowLimiterAllowStreamName[] = "flow_limiter_allow";
+
 // Adds a FlowLimiterCalculator to limit the number of packets in flight and
-// in queue.
+// in queue. Its "ALLOW" stream, which reports the dropped input frames, is
+// exported as the graph output stream kFlowLimiterAllowStreamName.
 ::mediapipe::CalculatorGraphConfig AddFlowLimiterCalculator(
     api2::builder::Graph& graph, api2::builder::GenericNode& task_subgraph,
     std::vector<std::string> input_stream_tags, std::string finished_stream_tag,
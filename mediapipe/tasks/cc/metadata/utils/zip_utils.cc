@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/metadata/utils/zip_utils.h"
 
+#include <cstddef>
+#include <limits>
 #include <string>
 
 #include "absl/cleanup/cleanup.h"
@@ -22,8 +24,10 @@ limitations under the License.
 #include "absl/log/absl_log.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
 #include "contrib/minizip/ioapi.h"
 #include "contrib/minizip/unzip.h"
+#include "zlib.h"
 #include "mediapipe/framework/port/status_macros.h"
 #include "mediapipe/tasks/cc/common.h"
 #include "mediapipe/tasks/cc/metadata/utils/zip_readonly_mem_file.h"
@@ -36,6 +40,10 @@ namespace {
 
 using ::absl::StatusCode;
 
+// Upper bound of the deflate compression ratio: deflate encodes at most 258
+// bytes in a 2-bit symbol, i.e. 1032 bytes per compressed byte.
+constexpr size_t kMaxDeflateCompressionRatio = 1032;
+
 // Wrapper function around calls to unzip to avoid repeating conversion logic
 // from error code to Status.
 absl::Status UnzipErrorToStatus(int error) {
@@ -47,17 +55,20 @@ absl::Status UnzipErrorToStatus(int error) {
   return absl::OkStatus();
 }
 
-// Stores a file name, position in zip buffer and size.
+// Stores a file name, position in zip buffer and sizes.
 struct ZipFileInfo {
   std::string name;
   ZPOS64_T position;
+  // Size of the data stored in the zip buffer.
   ZPOS64_T size;
+  ZPOS64_T uncompressed_size;
+  bool is_compressed;
 };
 
 // Returns the ZipFileInfo corresponding to the current file in the provided
 // unzFile object.
 absl::StatusOr<ZipFileInfo> GetCurrentZipFileInfo(const unzFile& zf) {
-  // Open file in raw mode, as data is expected to be uncompressed.
+  // Open file in raw mode, to locate the stored data without inflating it.
   int method;
   MP_RETURN_IF_ERROR(UnzipErrorToStatus(
       unzOpenCurrentFile2(zf, &method, /*level=*/nullptr, /*raw=*/1)));
@@ -67,10 +78,11 @@ absl::StatusOr<ZipFileInfo> GetCurrentZipFileInfo(const unzFile& zf) {
       ABSL_LOG(ERROR) << "Failed to close the current zip file: " << status;
     }
   };
-  if (method != Z_NO_COMPRESSION) {
-    return CreateStatusWithPayload(StatusCode::kUnknown,
-                                   "Expected uncompressed zip archive.",
-                                   MediaPipeTasksStatus::kFileZipError);
+  if (method != Z_NO_COMPRESSION && method != Z_DEFLATED) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        "Expected uncompressed or deflate-compressed zip archive.",
+        MediaPipeTasksStatus::kFileZipError);
   }
 
   // Get file info a first time to get filename size.
@@ -106,15 +118,18 @@ absl::StatusOr<ZipFileInfo> GetCurrentZipFileInfo(const unzFile& zf) {
   ZipFileInfo result{};
   result.name = file_name;
   result.position = position;
-  result.size = file_info.uncompressed_size;
+  result.is_compressed = method == Z_DEFLATED;
+  result.size = result.is_compressed ? file_info.compressed_size
+                                     : file_info.uncompressed_size;
+  result.uncompressed_size = file_info.uncompressed_size;
   return result;
 }
 
 }  // namespace
 
-absl::Status ExtractFilesfromZipFile(
+absl::Status ListZipFileEntries(
     const char* buffer_data, const size_t buffer_size,
-    absl::flat_hash_map<std::string, absl::string_view>* files) {
+    absl::flat_hash_map<std::string, ZipFileEntry>* entries) {
   // Create in-memory read-only zip file.
   ZipReadOnlyMemFile mem_file = ZipReadOnlyMemFile(buffer_data, buffer_size);
   // Open zip.
@@ -142,9 +157,17 @@ absl::Status ExtractFilesfromZipFile(
     int error = unzGoToFirstFile(zf);
     while (error == UNZ_OK) {
       ASSIGN_OR_RETURN(auto zip_file_info, GetCurrentZipFileInfo(zf));
+      if (zip_file_info.position + zip_file_info.size > buffer_size) {
+        return CreateStatusWithPayload(
+            StatusCode::kUnknown, "Zip archive entry is out of bounds.",
+            MediaPipeTasksStatus::kFileZipError);
+      }
       // Store result in map.
-      (*files)[zip_file_info.name] = absl::string_view(
-          buffer_data + zip_file_info.position, zip_file_info.size);
+      ZipFileEntry& entry = (*entries)[zip_file_info.name];
+      entry.data = absl::string_view(buffer_data + zip_file_info.position,
+                                     zip_file_info.size);
+      entry.is_compressed = zip_file_info.is_compressed;
+      entry.uncompressed_size = zip_file_info.uncompressed_size;
       error = unzGoToNextFile(zf);
     }
     if (error != UNZ_END_OF_LIST_OF_FILE) {
@@ -165,6 +188,77 @@ absl::Status ExtractFilesfromZipFile(
   return absl::OkStatus();
 }
 
+absl::Status ExtractFilesfromZipFile(
+    const char* buffer_data, const size_t buffer_size,
+    absl::flat_hash_map<std::string, absl::string_view>* files) {
+  absl::flat_hash_map<std::string, ZipFileEntry> entries;
+  MP_RETURN_IF_ERROR(ListZipFileEntries(buffer_data, buffer_size, &entries));
+  for (const auto& [name, entry] : entries) {
+    if (entry.is_compressed) {
+      return CreateStatusWithPayload(StatusCode::kUnknown,
+                                     "Expected uncompressed zip archive.",
+                                     MediaPipeTasksStatus::kFileZipError);
+    }
+    (*files)[name] = entry.data;
+  }
+  return absl::OkStatus();
+}
+
+absl::StatusOr<std::string> InflateZipFileEntry(const ZipFileEntry& entry) {
+  if (!entry.is_compressed) {
+    return std::string(entry.data);
+  }
+  if (entry.uncompressed_size == 0) {
+    return std::string();
+  }
+  // The uncompressed size comes from the archive, so it is checked against
+  // what the compressed data can actually hold before allocating for it.
+  if (entry.uncompressed_size / kMaxDeflateCompressionRatio >
+      entry.data.size()) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrCat("Invalid uncompressed size ", entry.uncompressed_size,
+                     " for ", entry.data.size(),
+                     " bytes of compressed data in zip archive."),
+        MediaPipeTasksStatus::kFileZipError);
+  }
+  // zlib counts the input and output sizes with 32-bit integers.
+  if (entry.uncompressed_size > std::numeric_limits<uInt>::max()) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrCat("File of ", entry.uncompressed_size,
+                     " bytes in zip archive is too large to inflate."),
+        MediaPipeTasksStatus::kFileZipError);
+  }
+  std::string contents(entry.uncompressed_size, '\0');
+  z_stream stream{};
+  // Negative window bits for a raw deflate stream, as stored in zip archives.
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+    return CreateStatusWithPayload(StatusCode::kUnknown,
+                                   "Unable to initialize zlib inflation.",
+                                   MediaPipeTasksStatus::kFileZipError);
+  }
+  stream.next_in =
+      reinterpret_cast<Bytef*>(const_cast<char*>(entry.data.data()));
+  stream.avail_in = entry.data.size();
+  stream.next_out = reinterpret_cast<Bytef*>(contents.data());
+  stream.avail_out = contents.size();
+  const int result = inflate(&stream, Z_FINISH);
+  const size_t inflated_size = stream.total_out;
+  inflateEnd(&stream);
+  // Z_FINISH stops at the end of the output buffer, so a stream holding more
+  // data than the uncompressed size doesn't reach Z_STREAM_END.
+  if (result != Z_STREAM_END || inflated_size != contents.size()) {
+    return CreateStatusWithPayload(
+        StatusCode::kUnknown,
+        absl::StrCat("Unable to inflate file in zip archive: expected ",
+                     contents.size(), " bytes, inflated ", inflated_size,
+                     " bytes with status ", result, "."),
+        MediaPipeTasksStatus::kFileZipError);
+  }
+  return contents;
+}
+
 void SetExternalFile(const absl::string_view& file_content,
                      core::proto::ExternalFile* model_file, bool is_copy) {
   if (is_copy) {
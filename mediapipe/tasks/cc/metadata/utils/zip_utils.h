@@ -16,25 +16,53 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_METADATA_UTILS_ZIP_UTILS_H_
 #define MEDIAPIPE_TASKS_CC_METADATA_UTILS_ZIP_UTILS_H_
 
+#include <cstddef>
 #include <string>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/string_view.h"
 #include "mediapipe/tasks/cc/core/proto/external_file.pb.h"
 
 namespace mediapipe {
 namespace tasks {
 namespace metadata {
 
+// A file stored in a zip archive.
+struct ZipFileEntry {
+  // The file data as stored in the zip buffer, i.e. the raw deflate stream if
+  // the file is compressed.
+  absl::string_view data;
+  // Whether the file is deflate-compressed.
+  bool is_compressed = false;
+  // The size of the file contents once inflated.
+  size_t uncompressed_size = 0;
+};
+
 // Extract files from the zip file.
 // Input: Pointer and length of the zip file in memory.
 // Outputs: A map with the filename as key and a pointer to the file contents
 // as value. The file contents returned by this function are only guaranteed to
 // stay valid while buffer_data is alive.
+// All the files must be stored uncompressed in the zip file.
 absl::Status ExtractFilesfromZipFile(
     const char* buffer_data, const size_t buffer_size,
     absl::flat_hash_map<std::string, absl::string_view>* files);
 
+// Lists the files of the zip file without decompressing them.
+// Input: Pointer and length of the zip file in memory.
+// Outputs: A map with the filename as key and the location of the file in the
+// zip buffer as value. Files can be stored uncompressed or deflate-compressed.
+// The entries returned by this function are only guaranteed to stay valid
+// while buffer_data is alive.
+absl::Status ListZipFileEntries(
+    const char* buffer_data, const size_t buffer_size,
+    absl::flat_hash_map<std::string, ZipFileEntry>* entries);
+
+// Returns the contents of a compressed zip file entry.
+absl::StatusOr<std::string> InflateZipFileEntry(const ZipFileEntry& entry);
+
 // Set the ExternalFile object by file_content in memory. By default,
 // `is_copy=false` which means to set `file_pointer_meta` in ExternalFile which
 // is the pointer points to location of a file in memory. Otherwise, if
@@ -15,8 +15,10 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/custom_ops/ragged/ragged_tensor_to_tensor_tflite.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <memory>
+#include <vector>
 
 #include "flatbuffers/flexbuffers.h"
 #include "tensorflow/core/util/ragged_to_dense_util_common.h"
@@ -50,6 +52,11 @@ struct ConversionAttributes {
   std::vector<tensorflow::RowPartitionType> partition_types;
   int ragged_rank = 0;
 
+  // Output index buffers, reused across invocations to avoid reallocating
+  // them for each input.
+  std::vector<int> output_index;
+  std::vector<int> new_output_index;
+
   tensorflow::RowPartitionType GetRowPartitionTypeByDimension(
       int dimension) const {
     if (partition_types.front() ==
@@ -286,6 +293,20 @@ TfLiteIntArray* IntArrayFromShape(const RuntimeShape& shape) {
   return result;
 }
 
+// Resizes the dynamic `output_tensor` to `shape`, unless it is already
+// allocated with that shape, e.g. when consecutive inputs are densified to
+// the same shape.
+TfLiteStatus ResizeOutput(TfLiteContext* context, const RuntimeShape& shape,
+                          TfLiteTensor* output_tensor) {
+  if (output_tensor->data.raw != nullptr && output_tensor->dims != nullptr &&
+      TfLiteIntArrayEqualsArray(output_tensor->dims, shape.DimensionsCount(),
+                                shape.DimsData())) {
+    return kTfLiteOk;
+  }
+  return context->ResizeTensor(context, output_tensor,
+                               IntArrayFromShape(shape));
+}
+
 /**
  * The output_index represents the index in the output tensor
  * where the first element of a particular dimension would be written.
@@ -526,6 +547,97 @@ void SetOutputT(TfLiteContext* context, int ragged_rank,
   }
 }
 
+// Densifies a ragged tensor with a single ROW_SPLITS partition: each row is
+// copied as a block from the values at its row split offset, and padded with
+// the default value, without computing the output index of each value.
+template <typename VALUE_TYPE, typename INDEX_TYPE>
+void SetOutputFromRowSplitsT(int first_dimension,
+                             const TfLiteTensor& row_splits_tensor,
+                             const TfLiteTensor& values_tensor,
+                             const TfLiteTensor& default_value_tensor,
+                             TfLiteTensor* output_tensor) {
+  const INDEX_TYPE* row_splits = GetTensorData<INDEX_TYPE>(&row_splits_tensor);
+  const VALUE_TYPE* values = GetTensorData<VALUE_TYPE>(&values_tensor);
+  const VALUE_TYPE default_value =
+      *GetTensorData<VALUE_TYPE>(&default_value_tensor);
+  VALUE_TYPE* output = GetTensorData<VALUE_TYPE>(output_tensor);
+
+  const RuntimeShape output_shape = GetTensorShape(output_tensor);
+  const int num_output_rows = output_shape.Dims(0);
+  const int num_output_columns = output_shape.Dims(1);
+  const int value_element_size =
+      output_shape.FlatSize() / (num_output_rows * num_output_columns);
+  const int output_row_size = num_output_columns * value_element_size;
+  const int num_rows = std::min(
+      first_dimension,
+      std::max(static_cast<int>(tflite::NumElements(&row_splits_tensor)) - 1,
+               0));
+
+  for (int row = 0; row < num_output_rows; ++row) {
+    VALUE_TYPE* dst = output + row * output_row_size;
+    int num_copied = 0;
+    if (row < num_rows) {
+      const int row_length =
+          static_cast<int>(row_splits[row + 1] - row_splits[row]);
+      num_copied = std::clamp(row_length, 0, num_output_columns) *
+                   value_element_size;
+      const VALUE_TYPE* src =
+          values + static_cast<int>(row_splits[row]) * value_element_size;
+      std::copy(src, src + num_copied, dst);
+    }
+    std::fill(dst + num_copied, dst + output_row_size, default_value);
+  }
+}
+
+template <typename VALUE_TYPE>
+void SetOutputFromRowSplitsT(TfLiteContext* context, int first_dimension,
+                             const TfLiteTensor& row_splits_tensor,
+                             const TfLiteTensor& values_tensor,
+                             const TfLiteTensor& default_value_tensor,
+                             TfLiteTensor* output_tensor) {
+  switch (row_splits_tensor.type) {
+    case kTfLiteInt32:
+      SetOutputFromRowSplitsT<VALUE_TYPE, int32_t>(
+          first_dimension, row_splits_tensor, values_tensor,
+          default_value_tensor, output_tensor);
+      break;
+    case kTfLiteInt64:
+      SetOutputFromRowSplitsT<VALUE_TYPE, int64_t>(
+          first_dimension, row_splits_tensor, values_tensor,
+          default_value_tensor, output_tensor);
+      break;
+    default:
+      context->ReportError(context,
+                           "Not supported row partitioning tensor type");
+  }
+}
+
+void SetOutputFromRowSplits(TfLiteContext* context, int first_dimension,
+                            const TfLiteTensor& row_splits_tensor,
+                            const TfLiteTensor& values_tensor,
+                            const TfLiteTensor& default_value_tensor,
+                            TfLiteTensor* output_tensor) {
+  switch (output_tensor->type) {
+    case kTfLiteInt32:
+      SetOutputFromRowSplitsT<int32_t>(context, first_dimension,
+                                       row_splits_tensor, values_tensor,
+                                       default_value_tensor, output_tensor);
+      break;
+    case kTfLiteInt64:
+      SetOutputFromRowSplitsT<int64_t>(context, first_dimension,
+                                       row_splits_tensor, values_tensor,
+                                       default_value_tensor, output_tensor);
+      break;
+    case kTfLiteFloat32:
+      SetOutputFromRowSplitsT<float>(context, first_dimension,
+                                     row_splits_tensor, values_tensor,
+                                     default_value_tensor, output_tensor);
+      break;
+    default:
+      context->ReportError(context, "Not supported values type");
+  }
+}
+
 void SetOutput(TfLiteContext* context, int ragged_rank,
                const std::vector<int>& output_index,
                const TfLiteTensor& values_tensor,
@@ -609,7 +721,7 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 }
 
 TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
-  const ConversionAttributes* attributes =
+  ConversionAttributes* attributes =
       reinterpret_cast<ConversionAttributes*>(node->user_data);
   TfLiteTensor& input_shape = context->tensors[node->inputs->data[kShapeInput]];
   TfLiteTensor& input_values =
@@ -650,13 +762,22 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       context->tensors[node->outputs->data[kOutputTensor]];
 
   TF_LITE_ENSURE_OK(context,
-                    context->ResizeTensor(context, &output_tensor,
-                                          IntArrayFromShape(output_shape)));
+                    ResizeOutput(context, output_shape, &output_tensor));
 
   // Copy data.
   const int full_size = multiplier.front() * output_shape.Dims(0);
-  if (full_size > 0) {
-    std::vector<int> output_index, new_output_index;
+  if (full_size > 0 && attributes->ragged_rank == 1 &&
+      attributes->GetRowPartitionTypeByDimension(0) ==
+          tensorflow::RowPartitionType::ROW_SPLITS) {
+    SetOutputFromRowSplits(
+        context, first_dimension,
+        *GetRowPartitionTensor(*attributes, context, node, /*dimension=*/0),
+        input_values, default_value, &output_tensor);
+  } else if (full_size > 0) {
+    std::vector<int>& output_index = attributes->output_index;
+    std::vector<int>& new_output_index = attributes->new_output_index;
+    output_index.clear();
+    new_output_index.clear();
     int nvals = input_values.dims->data[0];
     output_index.reserve(nvals);
     new_output_index.reserve(nvals);
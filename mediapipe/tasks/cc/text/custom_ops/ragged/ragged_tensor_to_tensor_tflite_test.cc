@@ -151,6 +151,37 @@ TEST(RaggedTensorToTensorTest, RaggedTensorToTensorRowSplits) {
                                          .4, .5, .6, .7, .8, .9, 1.5, 1.5}));
 }
 
+TEST(RaggedTensorToTensorTest, RaggedTensorToTensorRowSplitsMultipleInvokes) {
+  // params = [[.1, .2, .3], [], [.4, .5, .6, .7], [.8, .9]]
+  RaggedTensorToTensorOpModel model(2,      // output_shape_dims
+                                    {9},    // values_shape
+                                    {{5}},  // partition_tensors_shapes
+                                    std::vector<std::string>({"ROW_SPLITS"}));
+  const std::vector<float> values = {.1, .2, .3, .4, .5, .6, .7, .8, .9};
+  const std::vector<std::vector<int>> row_splits = {{0, 3, 3, 7, 9}};
+
+  model.InvokeFloat({4, 4}, values, 1.5, row_splits);
+  EXPECT_THAT(model.GetOutputShape(), testing::ElementsAreArray({4, 4}));
+  EXPECT_THAT(model.GetOutputFloat(),
+              testing::ElementsAreArray({.1, .2, .3, 1.5, 1.5, 1.5, 1.5, 1.5,
+                                         .4, .5, .6, .7, .8, .9, 1.5, 1.5}));
+
+  // Truncates rows and columns.
+  model.InvokeFloat({3, 2}, values, 2.5, row_splits);
+  EXPECT_THAT(model.GetOutputShape(), testing::ElementsAreArray({3, 2}));
+  EXPECT_THAT(model.GetOutputFloat(),
+              testing::ElementsAreArray({.1, .2, 2.5, 2.5, .4, .5}));
+
+  // Pads rows, with an output of the same shape as the previous one.
+  model.InvokeFloat({5, 4}, values, 1.5, row_splits);
+  model.InvokeFloat({5, 4}, values, 0.5, row_splits);
+  EXPECT_THAT(model.GetOutputShape(), testing::ElementsAreArray({5, 4}));
+  EXPECT_THAT(model.GetOutputFloat(),
+              testing::ElementsAreArray({.1, .2, .3, 0.5, 0.5, 0.5, 0.5,
+                                         0.5, .4, .5, .6, .7, .8, .9,
+                                         0.5, 0.5, 0.5, 0.5, 0.5, 0.5}));
+}
+
 TEST(RaggedTensorToTensorTest, RaggedTensorToTensor_3DParams) {
   // params = [
   //           [[]],
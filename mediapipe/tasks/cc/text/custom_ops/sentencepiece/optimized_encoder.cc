@@ -16,8 +16,14 @@ limitations under the License.
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/optimized_encoder.h"
 
 #include <algorithm>
+#include <numeric>
+#include <string>
 #include <tuple>
+#include <utility>
+#include <vector>
 
+#include "absl/synchronization/blocking_counter.h"
+#include "mediapipe/framework/port/threadpool.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/double_array_trie.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/encoder_config_generated.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/utils.h"
@@ -27,13 +33,37 @@ namespace {
 
 const char kSpaceSymbol[] = "\xe2\x96\x81";
 
+struct LatticeElement {
+  float score = 0;
+  int code = -1;
+  int prev_position = -1;
+  LatticeElement(float score_, int code_, int prev_position_)
+      : score(score_), code(code_), prev_position(prev_position_) {}
+  LatticeElement() {}
+};
+
+// Buffers reused across the strings encoded by one thread, so that encoding a
+// batch doesn't allocate memory for each string once they are large enough.
+struct EncoderBuffers {
+  // The normalized string and the offsets of its bytes in the input string.
+  std::string normalized;
+  std::vector<int> offsets;
+  // The output of the current normalization step, swapped with the above.
+  std::string processed;
+  std::vector<int> processed_offsets;
+  std::vector<LatticeElement> lattice;
+};
+
+// Applies `pc` to `buffers->normalized`, and swaps the result into it.
 template <typename processing_callback>
-std::tuple<std::string, std::vector<int>> process_string(
-    const std::string& input, const std::vector<int>& offsets,
-    const processing_callback& pc) {
-  std::string result_string;
+void process_string(const processing_callback& pc, EncoderBuffers* buffers) {
+  const std::string& input = buffers->normalized;
+  const std::vector<int>& offsets = buffers->offsets;
+  std::string& result_string = buffers->processed;
+  std::vector<int>& result_offsets = buffers->processed_offsets;
+  result_string.clear();
   result_string.reserve(input.size());
-  std::vector<int> result_offsets;
+  result_offsets.clear();
   result_offsets.reserve(offsets.size());
   for (int i = 0, j = 0; i < input.size();) {
     auto result = pc(input.data() + i, input.size() - i);
@@ -48,13 +78,13 @@ std::tuple<std::string, std::vector<int>> process_string(
       continue;
     }
     result_string.append(new_string.data(), new_string.length());
-    for (int i = 0; i < new_string.length(); ++i) {
-      result_offsets.push_back(offsets[j]);
-    }
+    result_offsets.insert(result_offsets.end(), new_string.length(),
+                          offsets[j]);
     j += consumed;
     i += consumed;
   }
-  return std::make_tuple(result_string, result_offsets);
+  buffers->normalized.swap(result_string);
+  buffers->offsets.swap(result_offsets);
 }
 
 inline char is_whitespace(char c) {
@@ -89,18 +119,18 @@ std::tuple<int, utils::string_view> find_replacement(
   }
   return std::make_tuple(0, utils::string_view(nullptr, 0));
 }
-}  // namespace
 
-std::tuple<std::string, std::vector<int>> NormalizeString(
-    const std::string& in_string, const EncoderConfig& config) {
-  std::vector<int> output_offsets;
-  std::string result = in_string;
-  output_offsets.reserve(in_string.length());
-  for (int i = 0; i < in_string.length(); ++i) {
-    output_offsets.push_back(i);
-  }
+// Normalizes `in_string` into `buffers->normalized` and `buffers->offsets`.
+void NormalizeStringInto(const std::string& in_string,
+                         const EncoderConfig& config,
+                         EncoderBuffers* buffers) {
+  std::string& result = buffers->normalized;
+  std::vector<int>& output_offsets = buffers->offsets;
+  result.assign(in_string);
+  output_offsets.resize(in_string.length());
+  std::iota(output_offsets.begin(), output_offsets.end(), 0);
   if (in_string.empty()) {
-    return std::make_tuple(result, output_offsets);
+    return;
   }
   if (config.add_dummy_prefix()) {
     result.insert(result.begin(), ' ');
@@ -116,12 +146,10 @@ std::tuple<std::string, std::vector<int>> NormalizeString(
       return find_replacement(data, len, normalized_prefixes_matcher,
                               *config.normalized_replacements());
     };
-    std::tie(result, output_offsets) =
-        process_string(result, output_offsets, norm_replace);
+    process_string(norm_replace, buffers);
   }
   if (config.remove_extra_whitespaces()) {
-    std::tie(result, output_offsets) =
-        process_string(result, output_offsets, remove_extra_whitespaces);
+    process_string(remove_extra_whitespaces, buffers);
     if (!result.empty() && is_whitespace(result.back())) {
       result.pop_back();
       output_offsets.pop_back();
@@ -134,31 +162,21 @@ std::tuple<std::string, std::vector<int>> NormalizeString(
       }
       return std::make_tuple(0, utils::string_view(nullptr, 0));
     };
-    std::tie(result, output_offsets) =
-        process_string(result, output_offsets, replace_whitespaces);
+    process_string(replace_whitespaces, buffers);
   }
-
-  return std::make_tuple(result, output_offsets);
 }
 
 EncoderResult EncodeNormalizedString(const std::string& str,
                                      const std::vector<int>& offsets,
                                      const EncoderConfig& config, bool add_bos,
-                                     bool add_eos, bool reverse) {
+                                     bool add_eos, bool reverse,
+                                     std::vector<LatticeElement>& lattice) {
   const DoubleArrayTrie piece_matcher(config.pieces()->nodes());
   const flatbuffers::Vector<float>* piece_scores = config.pieces_scores();
   const int unknown_code = config.unknown_code();
   const float unknown_penalty = config.unknown_penalty();
-  struct LatticeElement {
-    float score = 0;
-    int code = -1;
-    int prev_position = -1;
-    LatticeElement(float score_, int code_, int prev_position_)
-        : score(score_), code(code_), prev_position(prev_position_) {}
-    LatticeElement() {}
-  };
   const int length = str.length();
-  std::vector<LatticeElement> lattice(length + 1);
+  lattice.assign(length + 1, LatticeElement());
   for (int i = 0; i < length; ++i) {
     if (i > 0 && lattice[i].prev_position < 0) {
       // This state is unreachable.
@@ -217,6 +235,30 @@ EncoderResult EncodeNormalizedString(const std::string& str,
   return result;
 }
 
+// Encodes `strings[begin, end)` into `results[begin, end)`.
+void EncodeStringRange(const std::vector<std::string>& strings, int begin,
+                       int end, const EncoderConfig& config, bool add_bos,
+                       bool add_eos, bool reverse,
+                       std::vector<EncoderResult>& results) {
+  EncoderBuffers buffers;
+  for (int i = begin; i < end; ++i) {
+    NormalizeStringInto(strings[i], config, &buffers);
+    results[i] = EncodeNormalizedString(buffers.normalized, buffers.offsets,
+                                        config, add_bos, add_eos, reverse,
+                                        buffers.lattice);
+  }
+}
+
+}  // namespace
+
+std::tuple<std::string, std::vector<int>> NormalizeString(
+    const std::string& in_string, const EncoderConfig& config) {
+  EncoderBuffers buffers;
+  NormalizeStringInto(in_string, config, &buffers);
+  return std::make_tuple(std::move(buffers.normalized),
+                         std::move(buffers.offsets));
+}
+
 EncoderResult EncodeString(const std::string& string, const void* config_buffer,
                            bool add_bos, bool add_eos, bool reverse) {
   // Get the config from the buffer.
@@ -226,11 +268,54 @@ EncoderResult EncodeString(const std::string& string, const void* config_buffer,
     result.type = EncoderResultType::WRONG_CONFIG;
     return result;
   }
-  std::string normalized_string;
-  std::vector<int> offsets;
-  std::tie(normalized_string, offsets) = NormalizeString(string, *config);
-  return EncodeNormalizedString(normalized_string, offsets, *config, add_bos,
-                                add_eos, reverse);
+  EncoderBuffers buffers;
+  NormalizeStringInto(string, *config, &buffers);
+  return EncodeNormalizedString(buffers.normalized, buffers.offsets, *config,
+                                add_bos, add_eos, reverse, buffers.lattice);
+}
+
+std::vector<EncoderResult> EncodeStrings(
+    const std::vector<std::string>& strings, const void* config_buffer,
+    bool add_bos, bool add_eos, bool reverse, ThreadPool* thread_pool) {
+  std::vector<EncoderResult> results(strings.size());
+  const EncoderConfig* config = GetEncoderConfig(config_buffer);
+  if (config->version() != EncoderVersion::EncoderVersion_SENTENCE_PIECE) {
+    for (auto& result : results) {
+      result.type = EncoderResultType::WRONG_CONFIG;
+    }
+    return results;
+  }
+  const int num_strings = strings.size();
+  const int num_ranges =
+      thread_pool == nullptr
+          ? 1
+          : std::max(1, std::min(thread_pool->num_threads() + 1, num_strings));
+  if (num_ranges == 1) {
+    EncodeStringRange(strings, 0, num_strings, *config, add_bos, add_eos,
+                      reverse, results);
+    return results;
+  }
+  // Splits the strings into contiguous ranges of similar sizes, one per pool
+  // thread plus the last one, which is encoded by the calling thread.
+  absl::BlockingCounter counter(num_ranges - 1);
+  int begin = 0;
+  for (int r = 0; r < num_ranges; ++r) {
+    const int end = begin + num_strings / num_ranges +
+                    (r < num_strings % num_ranges ? 1 : 0);
+    if (r == num_ranges - 1) {
+      EncodeStringRange(strings, begin, end, *config, add_bos, add_eos,
+                        reverse, results);
+    } else {
+      thread_pool->Schedule([&, begin, end]() {
+        EncodeStringRange(strings, begin, end, *config, add_bos, add_eos,
+                          reverse, results);
+        counter.DecrementCount();
+      });
+    }
+    begin = end;
+  }
+  counter.Wait();
+  return results;
 }
 
 }  // namespace mediapipe::tflite_operations::sentencepiece
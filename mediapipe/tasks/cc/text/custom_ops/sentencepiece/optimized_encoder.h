@@ -22,6 +22,7 @@ limitations under the License.
 #include <tuple>
 #include <vector>
 
+#include "mediapipe/framework/port/threadpool.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/encoder_config_generated.h"
 
 namespace mediapipe::tflite_operations::sentencepiece {
@@ -41,6 +42,18 @@ std::tuple<std::string, std::vector<int>> NormalizeString(
 EncoderResult EncodeString(const std::string& string, const void* config_buffer,
                            bool add_bos, bool add_eos, bool reverse);
 
+// Encodes a batch of strings and returns the ids and offsets of each string, in
+// order. The normalization and encoding buffers are reused across the strings,
+// which is faster than calling EncodeString() on each of them. If
+// `thread_pool` is not null, the batch is split into contiguous ranges of
+// strings encoded in parallel, one per thread of the pool and one by the
+// calling thread. The pool must have been started with StartWorkers(), and is
+// typically shared across calls.
+std::vector<EncoderResult> EncodeStrings(
+    const std::vector<std::string>& strings, const void* config_buffer,
+    bool add_bos, bool add_eos, bool reverse,
+    ThreadPool* thread_pool = nullptr);
+
 }  // namespace mediapipe::tflite_operations::sentencepiece
 
 #endif  // MEDIAPIPE_TASKS_CC_TEXT_CUSTOM_OPS_SENTENCEPIECE_OPTIMIZED_ENCODER_H_
@@ -0,0 +1,117 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Benchmark for the optimized SentencePiece encoder, comparing EncodeString()
+// on each string of a batch to EncodeStrings() on the whole batch.
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/deps/file_path.h"
+#include "mediapipe/framework/port/threadpool.h"
+#include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/model_converter.h"
+#include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/optimized_encoder.h"
+
+namespace mediapipe::tflite_operations::sentencepiece {
+namespace {
+
+constexpr char kModelFilePath[] =
+    "/mediapipe/tasks/cc/text/custom_ops/"
+    "sentencepiece/testdata/sentencepiece.model";
+
+// Returns the encoder configuration converted from the test model.
+const std::string& GetEncoderConfig() {
+  static const std::string* config = []() {
+    std::ifstream file(file::JoinPath("./", kModelFilePath),
+                       std::ios::binary);
+    ABSL_CHECK(file.is_open());
+    const std::string model((std::istreambuf_iterator<char>(file)),
+                            std::istreambuf_iterator<char>());
+    return new std::string(ConvertSentencepieceModel(model));
+  }();
+  return *config;
+}
+
+// Returns `num_strings` short messages, made of common words separated by
+// spaces and punctuation, like the inputs of text classifiers and embedders.
+std::vector<std::string> GenerateMessages(int num_strings) {
+  static constexpr const char* kWords[] = {
+      "the",     "a",        "movie", "was",   "really", "good",  "bad",
+      "I",       "loved",    "it",    "and",   "this",   "is",    "not",
+      "what",    "expected", "great", "story", "acting", "plot",  "boring",
+      "amazing", "Hello",    "world", "today", "we",     "went",  "there"};
+  static constexpr const char* kSeparators[] = {" ", " ", " ", ", ",
+                                                "  ", ". ", "! "};
+  std::mt19937 rng(0 /*seed*/);
+  std::uniform_int_distribution<int> num_words_dist(3, 30);
+  std::uniform_int_distribution<int> word_dist(0, std::size(kWords) - 1);
+  std::uniform_int_distribution<int> separator_dist(
+      0, std::size(kSeparators) - 1);
+  std::vector<std::string> messages(num_strings);
+  for (auto& message : messages) {
+    const int num_words = num_words_dist(rng);
+    for (int i = 0; i < num_words; ++i) {
+      if (i > 0) message += kSeparators[separator_dist(rng)];
+      message += kWords[word_dist(rng)];
+    }
+  }
+  return messages;
+}
+
+void BM_EncodeString(benchmark::State& state) {
+  const std::string& config = GetEncoderConfig();
+  const std::vector<std::string> messages = GenerateMessages(state.range(0));
+  for (auto _ : state) {
+    for (const auto& message : messages) {
+      benchmark::DoNotOptimize(
+          EncodeString(message, config.data(), /*add_bos=*/false,
+                       /*add_eos=*/false, /*reverse=*/false));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * messages.size());
+}
+BENCHMARK(BM_EncodeString)->Arg(1)->Arg(64)->Arg(1024);
+
+void BM_EncodeStrings(benchmark::State& state) {
+  const std::string& config = GetEncoderConfig();
+  const std::vector<std::string> messages = GenerateMessages(state.range(0));
+  // The calling thread encodes strings too, so the pool has one thread less
+  // than the total number of threads.
+  const int num_threads = state.range(1);
+  std::unique_ptr<ThreadPool> thread_pool;
+  if (num_threads > 1) {
+    thread_pool = std::make_unique<ThreadPool>("EncodeStrings", num_threads - 1);
+    thread_pool->StartWorkers();
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(EncodeStrings(
+        messages, config.data(), /*add_bos=*/false, /*add_eos=*/false,
+        /*reverse=*/false, thread_pool.get()));
+  }
+  state.SetItemsProcessed(state.iterations() * messages.size());
+}
+BENCHMARK(BM_EncodeStrings)
+    ->ArgsProduct({{1, 64, 1024}, {1, 2, 4}})
+    ->UseRealTime();
+
+}  // namespace
+}  // namespace mediapipe::tflite_operations::sentencepiece
+
+BENCHMARK_MAIN();
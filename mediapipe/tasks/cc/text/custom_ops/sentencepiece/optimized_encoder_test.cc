@@ -16,6 +16,9 @@ limitations under the License.
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/optimized_encoder.h"
 
 #include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
@@ -23,6 +26,7 @@ limitations under the License.
 #include "mediapipe/framework/deps/file_path.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/threadpool.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/double_array_trie_builder.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/encoder_config_generated.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/model_converter.h"
@@ -167,5 +171,39 @@ TEST(OptimizedEncoder, ConfigConverter) {
   }
 }
 
+TEST(OptimizedEncoder, EncodeStringsMatchesEncodeString) {
+  std::string config;
+  auto status =
+      internal::TFReadFileToString(JoinPath("./", kConfigFilePath), &config);
+  ASSERT_TRUE(status.ok());
+  const auto converted_model = ConvertSentencepieceModel(config);
+  const std::vector<std::string> test_strings = {
+      "Hello world!",     "",
+      "  extra   spaces", "The quick brown fox jumps over the lazy dog.",
+      "\xF0\x9F\x8D\x95", "Hello world!",
+  };
+
+  for (const int num_pool_threads : {0, 1, 3, 7}) {
+    std::unique_ptr<ThreadPool> thread_pool;
+    if (num_pool_threads > 0) {
+      thread_pool =
+          std::make_unique<ThreadPool>("EncodeStrings", num_pool_threads);
+      thread_pool->StartWorkers();
+    }
+    const auto encoded_strings =
+        EncodeStrings(test_strings, converted_model.data(), /*add_bos=*/true,
+                      /*add_eos=*/true, /*reverse=*/false, thread_pool.get());
+    ASSERT_EQ(encoded_strings.size(), test_strings.size());
+    for (int i = 0; i < test_strings.size(); ++i) {
+      const auto encoded =
+          EncodeString(test_strings[i], converted_model.data(),
+                       /*add_bos=*/true, /*add_eos=*/true, /*reverse=*/false);
+      EXPECT_EQ(encoded_strings[i].type, EncoderResultType::SUCCESS);
+      EXPECT_EQ(encoded_strings[i].codes, encoded.codes);
+      EXPECT_EQ(encoded_strings[i].offsets, encoded.offsets);
+    }
+  }
+}
+
 }  // namespace
 }  // namespace mediapipe::tflite_operations::sentencepiece
@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/sentencepiece_tokenizer_tflite.h"
 
+#include <string>
+#include <vector>
+
 #include "flatbuffers/flexbuffers.h"
 #include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/optimized_encoder.h"
 #include "tensorflow/lite/c/common.h"
@@ -85,13 +88,20 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
       context->tensors[node->inputs->data[kReverseInput]];
   const bool reverse = reverse_tensor.data.b[0];
 
-  std::vector<int32> encoded;
-  std::vector<int32> splits;
   const int num_strings = tflite::GetStringCount(&input_text);
+  std::vector<std::string> strings;
+  strings.reserve(num_strings);
   for (int i = 0; i < num_strings; ++i) {
     const auto strref = tflite::GetString(&input_text, i);
-    const auto res = EncodeString(std::string(strref.str, strref.len),
-                                  model_buffer_data, add_bos, add_eos, reverse);
+    strings.emplace_back(strref.str, strref.len);
+  }
+  // Encoding the strings as a batch reuses the encoder buffers.
+  const std::vector<EncoderResult> results =
+      EncodeStrings(strings, model_buffer_data, add_bos, add_eos, reverse);
+  std::vector<int32> encoded;
+  std::vector<int32> splits;
+  splits.reserve(num_strings);
+  for (const auto& res : results) {
     TF_LITE_ENSURE_MSG(context, res.type == EncoderResultType::SUCCESS,
                        "Sentencepiece conversion failed");
     std::copy(res.codes.begin(), res.codes.end(), std::back_inserter(encoded));
@@ -78,39 +78,45 @@ TfLiteStatus Prepare(TfLiteContext* context, TfLiteNode* node) {
 
 // This is the core method that generates the aggregated embedding from the
 // given input, encoding table and codebook tensors.
+//
+// The embeddings are accumulated in place in `data`: for each token, the
+// codebook rows selected by its encoding are contiguous blocks added to
+// contiguous output blocks, which the compiler vectorizes. Each output value
+// still sums the tokens in order, so the result is unchanged.
 void GetEmbedding(const TfLiteTensor* input, const TfLiteTensor* encoding_table,
                   const TfLiteTensor* codebook, float* data) {
   const int input_encoding_size = encoding_table->dims->data[1];
   const int block_size = codebook->dims->data[1];
   const int num_tokens = input->dims->data[1];
   const int output_embedding_size = input_encoding_size * block_size;
+  const int32_t* input_data = GetTensorData<int32_t>(input);
+  const uint8_t* encoding_table_data = GetTensorData<uint8_t>(encoding_table);
+  const float* codebook_data = GetTensorData<float>(codebook);
 
+  std::fill(data, data + output_embedding_size, 0.0f);
   int num_embeddings = 0;
-  std::vector<float> final_embedding(output_embedding_size, 0.0);
-  for (int token_idx = 0; token_idx < num_tokens; token_idx++) {
-    const int32_t token = GetTensorData<int32_t>(input)[token_idx];
+  for (; num_embeddings < num_tokens; num_embeddings++) {
+    const int32_t token = input_data[num_embeddings];
     if (token == 0) {
       break;
     }
-    ++num_embeddings;
-
+    const uint8_t* encoding = encoding_table_data + token * input_encoding_size;
     for (int encoding_dim_idx = 0; encoding_dim_idx < input_encoding_size;
          encoding_dim_idx++) {
-      int codebook_idx = GetTensorData<uint8_t>(
-          encoding_table)[token * input_encoding_size + encoding_dim_idx];
+      const float* codebook_row =
+          codebook_data + encoding[encoding_dim_idx] * block_size;
+      float* output_block = data + encoding_dim_idx * block_size;
       for (int block_offset = 0; block_offset < block_size; block_offset++) {
-        final_embedding[encoding_dim_idx * block_size + block_offset] +=
-            GetTensorData<float>(
-                codebook)[codebook_idx * block_size + block_offset];
+        output_block[block_offset] += codebook_row[block_offset];
       }
     }
   }
 
   // Compute the mean of the embeddings.
+  const float divisor = std::max(num_embeddings, 1);
   for (int embed_dim_idx = 0; embed_dim_idx < output_embedding_size;
        embed_dim_idx++) {
-    data[embed_dim_idx] =
-        final_embedding[embed_dim_idx] / (std::max(num_embeddings, 1));
+    data[embed_dim_idx] /= divisor;
   }
 }
 
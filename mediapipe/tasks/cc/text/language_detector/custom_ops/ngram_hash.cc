@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/language_detector/custom_ops/ngram_hash.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -113,11 +114,11 @@ class NGramHashParams {
     // Obtain and tokenize the input.
     StringRef inputref = GetString(input_t, /*string_index=*/0);
     if (lower_case_input_) {
-      std::string lower_cased_str;
-      LowercaseUnicodeStr(inputref.str, inputref.len, &lower_cased_str);
+      lower_cased_str_.clear();
+      LowercaseUnicodeStr(inputref.str, inputref.len, &lower_cased_str_);
 
       tokenized_output_ =
-          Tokenize(lower_cased_str.c_str(), inputref.len, max_splits_,
+          Tokenize(lower_cased_str_.c_str(), inputref.len, max_splits_,
                    /*exclude_nonalphaspace_tokens=*/true);
     } else {
       tokenized_output_ = Tokenize(inputref.str, inputref.len, max_splits_,
@@ -131,9 +132,9 @@ class NGramHashParams {
 
   int GetNumNGrams() const { return ngram_lengths_.size(); }
 
-  std::vector<int> GetNGramLengths() const { return ngram_lengths_; }
+  const std::vector<int>& GetNGramLengths() const { return ngram_lengths_; }
 
-  std::vector<int> GetVocabSizes() const { return vocab_sizes_; }
+  const std::vector<int>& GetVocabSizes() const { return vocab_sizes_; }
 
   const TokenizedOutput& GetTokenizedOutput() const {
     return tokenized_output_;
@@ -147,6 +148,8 @@ class NGramHashParams {
   std::vector<int> vocab_sizes_;
   const int max_splits_;
   const bool lower_case_input_;
+  // Reused across invocations to avoid reallocating the lower-cased input.
+  std::string lower_cased_str_;
 };
 
 // Convert the TypedVector into a regular std::vector.
@@ -158,36 +161,41 @@ std::vector<int> GetIntVector(TypedVector typed_vec) {
   return vec;
 }
 
+// Computes the vocab index of the ngrams of every length starting at each
+// token, in a single pass over the tokens.
+//
+// Tokens are laid out contiguously in `tokenized_output.str`, so the number of
+// bytes of an ngram is the distance between the start of its first token and
+// the end of its last token. The Murmur hash is seeded with the ngram length
+// in bytes, so ngrams of different lengths can't share a rolling hash without
+// changing the model inputs; instead, the ngrams of all lengths starting at a
+// token are hashed while its bytes are still in cache.
 void GetNGramHashIndices(NGramHashParams* params, int32_t* data) {
-  const int max_unicode_length = params->GetNumTokens();
-  const auto ngram_lengths = params->GetNGramLengths();
-  const auto vocab_sizes = params->GetVocabSizes();
+  const std::vector<int>& ngram_lengths = params->GetNGramLengths();
+  const std::vector<int>& vocab_sizes = params->GetVocabSizes();
   const auto& tokenized_output = params->GetTokenizedOutput();
-  const auto seed = params->GetSeed();
-
-  // Compute for each ngram.
-  for (int ngram = 0; ngram < ngram_lengths.size(); ngram++) {
-    const int vocab_size = vocab_sizes[ngram];
-    const int ngram_length = ngram_lengths[ngram];
-
-    // Compute for each token within the input.
-    for (int start = 0; start < tokenized_output.tokens.size(); start++) {
-      // Compute the number of bytes for the ngram starting at the given
-      // token.
-      int num_bytes = 0;
-      for (int i = start;
-           i < tokenized_output.tokens.size() && i < (start + ngram_length);
-           i++) {
-        num_bytes += tokenized_output.tokens[i].second;
-      }
+  const auto& tokens = tokenized_output.tokens;
+  const char* str = tokenized_output.str.data();
+  const int num_tokens = tokens.size();
+  const int num_ngrams = ngram_lengths.size();
+  const uint64_t seed = params->GetSeed();
+
+  for (int start = 0; start < num_tokens; start++) {
+    const size_t start_offset = tokens[start].first;
+    for (int ngram = 0; ngram < num_ngrams; ngram++) {
+      // Ngrams extending past the last token are truncated to it.
+      const int last = std::min(start + ngram_lengths[ngram], num_tokens) - 1;
+      const size_t end_offset = last < start
+                                    ? start_offset
+                                    : tokens[last].first + tokens[last].second;
+      const size_t num_bytes = end_offset - start_offset;
 
       // Compute the hash for the ngram starting at the token.
-      const auto str_hash = MurmurHash64WithSeed(
-          tokenized_output.str.c_str() + tokenized_output.tokens[start].first,
-          num_bytes, seed);
+      const auto str_hash =
+          MurmurHash64WithSeed(str + start_offset, num_bytes, seed);
 
       // Map the hash to an index in the vocab.
-      data[ngram * max_unicode_length + start] = (str_hash % vocab_size) + 1;
+      data[ngram * num_tokens + start] = (str_hash % vocab_sizes[ngram]) + 1;
     }
   }
 }
@@ -16,7 +16,9 @@ limitations under the License.
 #include "mediapipe/tasks/cc/text/language_detector/language_detector.h"
 
 #include <memory>
+#include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -24,6 +26,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/containers/category.h"
 #include "mediapipe/tasks/cc/components/containers/classification_result.h"
 #include "mediapipe/tasks/cc/core/task_api_factory.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
 #include "mediapipe/tasks/cc/text/text_classifier/proto/text_classifier_graph_options.pb.h"
 
 namespace mediapipe::tasks::text::language_detector {
@@ -123,4 +126,27 @@ absl::StatusOr<LanguageDetectorResult> LanguageDetector::Detect(
       classification_result);
 }
 
+absl::StatusOr<std::vector<LanguageDetectorResult>>
+LanguageDetector::DetectBatch(const std::vector<std::string>& texts) {
+  std::vector<core::PacketMap> inputs;
+  inputs.reserve(texts.size());
+  for (const std::string& text : texts) {
+    inputs.push_back({{kTextStreamName, MakePacket<std::string>(text)}});
+  }
+  ASSIGN_OR_RETURN(auto output_packets,
+                   runner_->ProcessBatch(std::move(inputs)));
+  std::vector<LanguageDetectorResult> results;
+  results.reserve(texts.size());
+  for (auto& packets : output_packets) {
+    ASSIGN_OR_RETURN(
+        auto result,
+        ExtractLanguageDetectorResultFromClassificationResult(
+            ConvertToClassificationResult(
+                packets[kClassificationsStreamName]
+                    .Get<ClassificationResultProto>())));
+    results.push_back(std::move(result));
+  }
+  return results;
+}
+
 }  // namespace mediapipe::tasks::text::language_detector
@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -75,6 +76,15 @@ class LanguageDetector : core::BaseTaskApi {
   // Predicts the language of the input `text`.
   absl::StatusOr<LanguageDetectorResult> Detect(absl::string_view text);
 
+  // Predicts the language of each of the provided independent `texts`,
+  // returning one result per text in the same order.
+  //
+  // The texts are pipelined through the underlying graph instead of waiting
+  // for each prediction before sending the next text, which is faster than
+  // calling Detect() on each text for offline workloads.
+  absl::StatusOr<std::vector<LanguageDetectorResult>> DetectBatch(
+      const std::vector<std::string>& texts);
+
   // Shuts down the LanguageDetector instance when all the work is done.
   absl::Status Close() { return runner_->Close(); }
 };
@@ -20,6 +20,7 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
@@ -119,6 +120,30 @@ TEST_F(LanguageDetectorTest, TestL2CModel) {
       kTolerance));
 }
 
+TEST_F(LanguageDetectorTest, TestDetectBatch) {
+  auto options = std::make_unique<LanguageDetectorOptions>();
+  options->base_options.model_asset_path = GetFullPath(kLanguageDetector);
+  options->classifier_options.score_threshold = 0.3;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<LanguageDetector> language_detector,
+                          LanguageDetector::Create(std::move(options)));
+  const std::vector<std::string> texts = {
+      "To be, or not to be, that is the question",
+      "Il y a beaucoup de bouches qui parlent et fort peu "
+      "de têtes qui pensent.",
+      "это какой-то английский язык", "分久必合合久必分"};
+
+  MP_ASSERT_OK_AND_ASSIGN(std::vector<LanguageDetectorResult> results,
+                          language_detector->DetectBatch(texts));
+
+  ASSERT_EQ(results.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(LanguageDetectorResult expected,
+                            language_detector->Detect(texts[i]));
+    MP_EXPECT_OK(
+        MatchesLanguageDetectorResult(expected, results[i], kTolerance));
+  }
+}
+
 TEST_F(LanguageDetectorTest, TestMultiplePredictions) {
   auto options = std::make_unique<LanguageDetectorOptions>();
   options->base_options.model_asset_path = GetFullPath(kLanguageDetector);
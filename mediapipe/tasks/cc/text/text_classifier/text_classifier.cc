@@ -15,10 +15,12 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/text_classifier/text_classifier.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "absl/strings/string_view.h"
@@ -75,6 +77,7 @@ ConvertTextClassifierOptionsToProto(TextClassifierOptions* options) {
               &(options->classifier_options)));
   options_proto->mutable_classifier_options()->Swap(
       classifier_options_proto.get());
+  options_proto->set_bucket_dynamic_seq_len(options->bucket_dynamic_seq_len);
   return options_proto;
 }
 
@@ -83,20 +86,75 @@ ConvertTextClassifierOptionsToProto(TextClassifierOptions* options) {
 absl::StatusOr<std::unique_ptr<TextClassifier>> TextClassifier::Create(
     std::unique_ptr<TextClassifierOptions> options) {
   auto options_proto = ConvertTextClassifierOptionsToProto(options.get());
-  return core::TaskApiFactory::Create<TextClassifier,
-                                      proto::TextClassifierGraphOptions>(
-      CreateGraphConfig(std::move(options_proto)),
-      std::move(options->base_options.op_resolver));
+  ASSIGN_OR_RETURN(
+      auto classifier,
+      (core::TaskApiFactory::Create<TextClassifier,
+                                    proto::TextClassifierGraphOptions>(
+          CreateGraphConfig(std::move(options_proto)),
+          std::move(options->base_options.op_resolver),
+          /*packets_callback=*/nullptr, options->base_options.num_replicas)));
+  if (options->result_cache_options.max_entries > 0) {
+    classifier->result_cache_ =
+        std::make_unique<utils::TextResultCache<TextClassifierResult>>(
+            options->result_cache_options);
+  }
+  return classifier;
 }
 
 absl::StatusOr<TextClassifierResult> TextClassifier::Classify(
     absl::string_view text) {
+  if (result_cache_ != nullptr) {
+    if (auto result = result_cache_->Lookup(text); result.has_value()) {
+      return *std::move(result);
+    }
+  }
   ASSIGN_OR_RETURN(
       auto output_packets,
       runner_->Process(
           {{kTextStreamName, MakePacket<std::string>(std::string(text))}}));
-  return ConvertToClassificationResult(
+  TextClassifierResult result = ConvertToClassificationResult(
       output_packets[kClassificationsStreamName].Get<ClassificationResult>());
+  if (result_cache_ != nullptr) {
+    result_cache_->Insert(text, result);
+  }
+  return result;
+}
+
+absl::StatusOr<std::vector<TextClassifierResult>>
+TextClassifier::ClassifyBatch(const std::vector<std::string>& texts) {
+  std::vector<TextClassifierResult> results(texts.size());
+  // Only the texts without a cached result are classified, sorted by length
+  // as a proxy for their number of tokens.
+  std::vector<int> order;
+  order.reserve(texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    if (result_cache_ != nullptr) {
+      if (auto result = result_cache_->Lookup(texts[i]); result.has_value()) {
+        results[i] = *std::move(result);
+        continue;
+      }
+    }
+    order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&texts](int i, int j) {
+    return texts[i].size() < texts[j].size();
+  });
+  std::vector<core::PacketMap> inputs;
+  inputs.reserve(order.size());
+  for (int i : order) {
+    inputs.push_back({{kTextStreamName, MakePacket<std::string>(texts[i])}});
+  }
+  ASSIGN_OR_RETURN(auto output_packets,
+                   runner_->ProcessBatch(std::move(inputs)));
+  for (int i = 0; i < order.size(); ++i) {
+    results[order[i]] = ConvertToClassificationResult(
+        output_packets[i][kClassificationsStreamName]
+            .Get<ClassificationResult>());
+    if (result_cache_ != nullptr) {
+      result_cache_->Insert(texts[order[i]], results[order[i]]);
+    }
+  }
+  return results;
 }
 
 }  // namespace text_classifier
@@ -85,9 +85,10 @@ class TextClassifierGraph : public core::ModelTaskGraph {
  public:
   absl::StatusOr<CalculatorGraphConfig> GetConfig(
       SubgraphContext* sc) override {
+    // Graph replicas of the same task share the model resources.
     ASSIGN_OR_RETURN(
         const ModelResources* model_resources,
-        CreateModelResources<proto::TextClassifierGraphOptions>(sc));
+        GetOrCreateModelResources<proto::TextClassifierGraphOptions>(sc));
     Graph graph;
     ASSIGN_OR_RETURN(
         auto classifications,
@@ -117,10 +118,12 @@ class TextClassifierGraph : public core::ModelTaskGraph {
     // stream.
     auto& preprocessing = graph.AddNode(
         "mediapipe.tasks.components.processors.TextPreprocessingGraph");
+    auto& preprocessing_options = preprocessing.GetOptions<
+        components::processors::proto::TextPreprocessingGraphOptions>();
+    preprocessing_options.set_bucket_dynamic_seq_len(
+        task_options.bucket_dynamic_seq_len());
     MP_RETURN_IF_ERROR(components::processors::ConfigureTextPreprocessingGraph(
-        model_resources,
-        preprocessing.GetOptions<
-            components::processors::proto::TextPreprocessingGraphOptions>()));
+        model_resources, preprocessing_options));
     text_in >> preprocessing.In(kTextTag);
 
     // Adds both InferenceCalculator and ModelResourcesCalculator.
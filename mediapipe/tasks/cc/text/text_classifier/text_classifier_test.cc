@@ -18,7 +18,9 @@ limitations under the License.
 #include <memory>
 #include <sstream>
 #include <string>
+#include <thread>  // NOLINT(build/c++11)
 #include <utility>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
@@ -177,6 +179,52 @@ TEST_F(TextClassifierTest, TextClassifierWithBert) {
   MP_ASSERT_OK(classifier->Close());
 }
 
+TEST_F(TextClassifierTest, ClassifyBatchWithBert) {
+  auto options = std::make_unique<TextClassifierOptions>();
+  options->base_options.model_asset_path = GetFullPath(kTestBertModelPath);
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextClassifier> classifier,
+                          TextClassifier::Create(std::move(options)));
+  const std::vector<std::string> texts = {
+      "it's a charming and often affecting journey",
+      "unflinchingly bleak and desperate",
+      "what a great and fantastic trip",
+  };
+
+  MP_ASSERT_OK_AND_ASSIGN(std::vector<TextClassifierResult> results,
+                          classifier->ClassifyBatch(texts));
+
+  ASSERT_EQ(results.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(TextClassifierResult expected,
+                            classifier->Classify(texts[i]));
+    ExpectApproximatelyEqual(results[i], expected);
+  }
+  MP_ASSERT_OK(classifier->Close());
+}
+
+TEST_F(TextClassifierTest, ClassifyWithResultCache) {
+  auto options = std::make_unique<TextClassifierOptions>();
+  options->base_options.model_asset_path = GetFullPath(kTestBertModelPath);
+  options->result_cache_options.max_entries = 2;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextClassifier> classifier,
+                          TextClassifier::Create(std::move(options)));
+  const std::string text = "it's a charming and often affecting journey";
+
+  MP_ASSERT_OK_AND_ASSIGN(TextClassifierResult result,
+                          classifier->Classify(text));
+  MP_ASSERT_OK_AND_ASSIGN(TextClassifierResult cached_result,
+                          classifier->Classify(text));
+  MP_ASSERT_OK_AND_ASSIGN(
+      std::vector<TextClassifierResult> batch_results,
+      classifier->ClassifyBatch({text, "unflinchingly bleak and desperate"}));
+
+  ExpectApproximatelyEqual(cached_result, result);
+  ExpectApproximatelyEqual(batch_results[0], result);
+  EXPECT_EQ(classifier->GetResultCacheStats().num_hits, 2);
+  EXPECT_EQ(classifier->GetResultCacheStats().num_misses, 2);
+  MP_ASSERT_OK(classifier->Close());
+}
+
 TEST_F(TextClassifierTest, TextClassifierWithIntInputs) {
   auto options = std::make_unique<TextClassifierOptions>();
   options->base_options.model_asset_path = GetFullPath(kTestRegexModelPath);
@@ -209,6 +257,48 @@ TEST_F(TextClassifierTest, TextClassifierWithIntInputs) {
   MP_ASSERT_OK(classifier->Close());
 }
 
+TEST_F(TextClassifierTest, TextClassifierWithReplicas) {
+  auto options = std::make_unique<TextClassifierOptions>();
+  options->base_options.model_asset_path = GetFullPath(kTestRegexModelPath);
+  options->base_options.num_replicas = 3;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextClassifier> classifier,
+                          TextClassifier::Create(std::move(options)));
+  TextClassifierResult expected;
+  expected.classifications.emplace_back(Classifications{
+      /*categories=*/{
+          {/*index=*/0, /*score=*/0.813130, /*category_name=*/"Negative"},
+          {/*index=*/1, /*score=*/0.186870, /*category_name=*/"Positive"}},
+      /*head_index=*/0,
+      /*head_name=*/"probability"});
+
+  constexpr int kNumThreads = 6;
+  constexpr int kNumCallsPerThread = 10;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&classifier, &expected]() {
+      for (int j = 0; j < kNumCallsPerThread; ++j) {
+        MP_ASSERT_OK_AND_ASSIGN(
+            TextClassifierResult result,
+            classifier->Classify("What a waste of my time."));
+        ExpectApproximatelyEqual(result, expected);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const auto replica_stats = classifier->GetReplicaStats();
+  ASSERT_EQ(replica_stats.size(), 3);
+  int num_invocations = 0;
+  for (const auto& stats : replica_stats) {
+    num_invocations += stats.num_invocations;
+    EXPECT_EQ(stats.num_errors, 0);
+  }
+  EXPECT_EQ(num_invocations, kNumThreads * kNumCallsPerThread);
+  MP_ASSERT_OK(classifier->Close());
+}
+
 TEST_F(TextClassifierTest, TextClassifierWithStringToBool) {
   auto options = std::make_unique<TextClassifierOptions>();
   options->base_options.model_asset_path = GetFullPath(kStringToBoolModelPath);
@@ -15,14 +15,17 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/text_embedder/text_embedder.h"
 
+#include <algorithm>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "mediapipe/calculators/tensor/inference_calculator.pb.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/tasks/cc/components/containers/embedding_result.h"
-#include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 #include "mediapipe/tasks/cc/components/processors/embedder_options.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedder_options.pb.h"
 #include "mediapipe/tasks/cc/components/utils/cosine_similarity.h"
@@ -35,15 +38,12 @@ namespace mediapipe::tasks::text::text_embedder {
 namespace {
 
 constexpr char kTextTag[] = "TEXT";
-constexpr char kEmbeddingsTag[] = "EMBEDDINGS";
+constexpr char kEmbeddingResultTag[] = "EMBEDDING_RESULT";
 constexpr char kTextInStreamName[] = "text_in";
-constexpr char kEmbeddingsStreamName[] = "embeddings_out";
+constexpr char kEmbeddingResultStreamName[] = "embedding_result_out";
 constexpr char kGraphTypeName[] =
     "mediapipe.tasks.text.text_embedder.TextEmbedderGraph";
 
-using ::mediapipe::tasks::components::containers::ConvertToEmbeddingResult;
-using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
-
 // Creates a MediaPipe graph config that contains a single node of type
 // "mediapipe.tasks.text.text_embedder.TextEmbedderGraph".
 CalculatorGraphConfig CreateGraphConfig(
@@ -53,8 +53,8 @@ CalculatorGraphConfig CreateGraphConfig(
   task_graph.GetOptions<proto::TextEmbedderGraphOptions>().Swap(
       options_proto.get());
   graph.In(kTextTag).SetName(kTextInStreamName) >> task_graph.In(kTextTag);
-  task_graph.Out(kEmbeddingsTag).SetName(kEmbeddingsStreamName) >>
-      graph.Out(kEmbeddingsTag);
+  task_graph.Out(kEmbeddingResultTag).SetName(kEmbeddingResultStreamName) >>
+      graph.Out(kEmbeddingResultTag);
   return graph.GetConfig();
 }
 
@@ -71,6 +71,7 @@ ConvertTextEmbedderOptionsToProto(TextEmbedderOptions* options) {
           components::processors::ConvertEmbedderOptionsToProto(
               &(options->embedder_options)));
   options_proto->mutable_embedder_options()->Swap(embedder_options_proto.get());
+  options_proto->set_bucket_dynamic_seq_len(options->bucket_dynamic_seq_len);
   return options_proto;
 }
 
@@ -80,19 +81,73 @@ absl::StatusOr<std::unique_ptr<TextEmbedder>> TextEmbedder::Create(
     std::unique_ptr<TextEmbedderOptions> options) {
   std::unique_ptr<proto::TextEmbedderGraphOptions> options_proto =
       ConvertTextEmbedderOptionsToProto(options.get());
-  return core::TaskApiFactory::Create<TextEmbedder,
-                                      proto::TextEmbedderGraphOptions>(
-      CreateGraphConfig(std::move(options_proto)),
-      std::move(options->base_options.op_resolver));
+  ASSIGN_OR_RETURN(
+      auto embedder,
+      (core::TaskApiFactory::Create<TextEmbedder,
+                                    proto::TextEmbedderGraphOptions>(
+          CreateGraphConfig(std::move(options_proto)),
+          std::move(options->base_options.op_resolver),
+          /*packets_callback=*/nullptr, options->base_options.num_replicas)));
+  if (options->result_cache_options.max_entries > 0) {
+    embedder->result_cache_ =
+        std::make_unique<utils::TextResultCache<TextEmbedderResult>>(
+            options->result_cache_options);
+  }
+  return embedder;
 }
 
 absl::StatusOr<TextEmbedderResult> TextEmbedder::Embed(absl::string_view text) {
+  if (result_cache_ != nullptr) {
+    if (auto result = result_cache_->Lookup(text); result.has_value()) {
+      return *std::move(result);
+    }
+  }
   ASSIGN_OR_RETURN(
       auto output_packets,
       runner_->Process(
           {{kTextInStreamName, MakePacket<std::string>(std::string(text))}}));
-  return ConvertToEmbeddingResult(
-      output_packets[kEmbeddingsStreamName].Get<EmbeddingResult>());
+  TextEmbedderResult result =
+      output_packets[kEmbeddingResultStreamName].Get<TextEmbedderResult>();
+  if (result_cache_ != nullptr) {
+    result_cache_->Insert(text, result);
+  }
+  return result;
+}
+
+absl::StatusOr<std::vector<TextEmbedderResult>> TextEmbedder::EmbedBatch(
+    const std::vector<std::string>& texts) {
+  std::vector<TextEmbedderResult> results(texts.size());
+  // Only the texts without a cached result are embedded, sorted by length as
+  // a proxy for their number of tokens.
+  std::vector<int> order;
+  order.reserve(texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    if (result_cache_ != nullptr) {
+      if (auto result = result_cache_->Lookup(texts[i]); result.has_value()) {
+        results[i] = *std::move(result);
+        continue;
+      }
+    }
+    order.push_back(i);
+  }
+  std::stable_sort(order.begin(), order.end(), [&texts](int i, int j) {
+    return texts[i].size() < texts[j].size();
+  });
+  std::vector<core::PacketMap> inputs;
+  inputs.reserve(order.size());
+  for (int i : order) {
+    inputs.push_back({{kTextInStreamName, MakePacket<std::string>(texts[i])}});
+  }
+  ASSIGN_OR_RETURN(auto output_packets,
+                   runner_->ProcessBatch(std::move(inputs)));
+  for (int i = 0; i < order.size(); ++i) {
+    results[order[i]] =
+        output_packets[i][kEmbeddingResultStreamName].Get<TextEmbedderResult>();
+    if (result_cache_ != nullptr) {
+      result_cache_->Insert(texts[order[i]], results[order[i]]);
+    }
+  }
+  return results;
 }
 
 absl::StatusOr<double> TextEmbedder::CosineSimilarity(
@@ -17,6 +17,8 @@ limitations under the License.
 #define MEDIAPIPE_TASKS_CC_TEXT_TEXT_EMBEDDER_TEXT_EMBEDDER_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -25,6 +27,8 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/processors/embedder_options.h"
 #include "mediapipe/tasks/cc/core/base_options.h"
 #include "mediapipe/tasks/cc/core/base_task_api.h"
+#include "mediapipe/tasks/cc/core/task_runner.h"
+#include "mediapipe/tasks/cc/text/utils/text_result_cache.h"
 
 namespace mediapipe::tasks::text::text_embedder {
 
@@ -41,6 +45,18 @@ struct TextEmbedderOptions {
   // Options for configuring the embedder behavior, such as L2-normalization or
   // scalar-quantization.
   components::processors::EmbedderOptions embedder_options;
+
+  // Options for caching the results of repeated input texts, which are then
+  // returned without running the model. Disabled by default.
+  utils::TextResultCacheOptions result_cache_options;
+
+  // Whether to round the sequence length of the input tensors of BERT models
+  // with dynamic input tensors up to the next power of two. Inputs of similar
+  // lengths then share the same tensor shapes, which avoids resizing the
+  // model's tensors between inputs, e.g. with EmbedBatch(). The padded tokens
+  // are masked out, but the results may differ slightly from the unpadded
+  // ones. Disabled by default.
+  bool bucket_dynamic_seq_len = false;
 };
 
 // Performs embedding extraction on text.
@@ -80,9 +96,34 @@ class TextEmbedder : core::BaseTaskApi {
   static absl::StatusOr<std::unique_ptr<TextEmbedder>> Create(
       std::unique_ptr<TextEmbedderOptions> options);
 
-  // Performs embedding extraction on the input `text`.
+  // Performs embedding extraction on the input `text`. If the embedder is
+  // created with `base_options.num_replicas` greater than 1, this method is
+  // thread-safe and concurrent calls run on different graph replicas.
   absl::StatusOr<TextEmbedderResult> Embed(absl::string_view text);
 
+  // Performs embedding extraction on the provided batch of independent
+  // `texts`, returning one result per text in the same order.
+  //
+  // The texts are pipelined through the underlying graph by increasing
+  // length, so that consecutive texts are more likely to share the same tensor
+  // shapes, in particular with `bucket_dynamic_seq_len` enabled in the
+  // options. This is faster than calling Embed() on each text for offline
+  // workloads.
+  absl::StatusOr<std::vector<TextEmbedderResult>> EmbedBatch(
+      const std::vector<std::string>& texts);
+
+  // Returns the processing statistics of each graph replica.
+  std::vector<core::TaskRunnerReplicaStats> GetReplicaStats() const {
+    return runner_->GetReplicaStats();
+  }
+
+  // Returns the lookup statistics of the result cache, which are all 0 if the
+  // cache is disabled.
+  utils::TextResultCacheStats GetResultCacheStats() const {
+    return result_cache_ != nullptr ? result_cache_->GetStats()
+                                    : utils::TextResultCacheStats();
+  }
+
   // Shuts down the TextEmbedder when all the work is done.
   absl::Status Close() { return runner_->Close(); }
 
@@ -95,6 +136,10 @@ class TextEmbedder : core::BaseTaskApi {
   static absl::StatusOr<double> CosineSimilarity(
       const components::containers::Embedding& u,
       const components::containers::Embedding& v);
+
+ private:
+  // The cache of the results of previous texts, or nullptr if disabled.
+  std::unique_ptr<utils::TextResultCache<TextEmbedderResult>> result_cache_;
 };
 
 }  // namespace mediapipe::tasks::text::text_embedder
@@ -13,6 +13,10 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <optional>
+#include <string>
+#include <vector>
+
 #include "absl/log/absl_check.h"
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -23,6 +27,7 @@ limitations under the License.
 #include "mediapipe/framework/calculator.pb.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/tasks/cc/components/calculators/tensors_to_embeddings_calculator.pb.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
 #include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 #include "mediapipe/tasks/cc/components/processors/embedding_postprocessing_graph.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedding_postprocessing_graph_options.pb.h"
@@ -34,6 +39,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/core/proto/model_resources_calculator.pb.h"
 #include "mediapipe/tasks/cc/text/text_embedder/proto/text_embedder_graph_options.pb.h"
 #include "mediapipe/tasks/cc/text/utils/text_model_utils.h"
+#include "mediapipe/util/graph_builder_utils.h"
 
 namespace mediapipe::tasks::text::text_embedder {
 namespace {
@@ -47,6 +53,7 @@ using ::mediapipe::tasks::components::processors::proto::TextModelType;
 using ::mediapipe::tasks::core::ModelResources;
 using ::mediapipe::tasks::text::utils::GetModelType;
 
+constexpr char kEmbeddingResultTag[] = "EMBEDDING_RESULT";
 constexpr char kEmbeddingsTag[] = "EMBEDDINGS";
 constexpr char kTextTag[] = "TEXT";
 constexpr char kMetadataExtractorTag[] = "METADATA_EXTRACTOR";
@@ -54,6 +61,14 @@ constexpr char kTensorsTag[] = "TENSORS";
 
 constexpr char kUSEQueryTensorName[] = "query_encoding";
 
+// Struct holding the different output streams produced by the text embedder
+// graph.
+struct TextEmbedderOutputStreams {
+  std::optional<Source<EmbeddingResult>> embeddings;
+  std::optional<Source<components::containers::EmbeddingResult>>
+      embedding_result;
+};
+
 }  // namespace
 
 // A "mediapipe.tasks.text.TextEmbedderGraph" performs text embedding
@@ -65,8 +80,11 @@ constexpr char kUSEQueryTensorName[] = "query_encoding";
 //     Input text to perform embedding extraction on.
 //
 // Outputs:
-//   EMBEDDINGS - EmbeddingResult
-//     The embedding result.
+//   EMBEDDINGS - EmbeddingResult @Optional
+//     The embedding result, as a proto. Output by default if the
+//     EMBEDDING_RESULT output is not connected.
+//   EMBEDDING_RESULT - components::containers::EmbeddingResult @Optional
+//     The embedding result, as a struct.
 //
 // Example:
 // node {
@@ -88,40 +106,61 @@ class TextEmbedderGraph : public core::ModelTaskGraph {
   absl::StatusOr<CalculatorGraphConfig> GetConfig(
       SubgraphContext* sc) override {
     ABSL_CHECK(sc != nullptr);
-    ASSIGN_OR_RETURN(const ModelResources* model_resources,
-                     CreateModelResources<proto::TextEmbedderGraphOptions>(sc));
+    // Graph replicas of the same task share the model resources.
+    ASSIGN_OR_RETURN(
+        const ModelResources* model_resources,
+        GetOrCreateModelResources<proto::TextEmbedderGraphOptions>(sc));
+    const bool output_embedding_result =
+        HasOutput(sc->OriginalNode(), kEmbeddingResultTag);
+    const bool output_embeddings =
+        !output_embedding_result ||
+        HasOutput(sc->OriginalNode(), kEmbeddingsTag);
     Graph graph;
     ASSIGN_OR_RETURN(
-        Source<EmbeddingResult> embedding_result_out,
+        TextEmbedderOutputStreams output_streams,
         BuildTextEmbedderTask(sc->Options<proto::TextEmbedderGraphOptions>(),
                               *model_resources,
-                              graph[Input<std::string>(kTextTag)], graph));
-    embedding_result_out >> graph[Output<EmbeddingResult>(kEmbeddingsTag)];
+                              graph[Input<std::string>(kTextTag)],
+                              output_embeddings, output_embedding_result,
+                              graph));
+    if (output_streams.embeddings) {
+      *output_streams.embeddings >>
+          graph[Output<EmbeddingResult>(kEmbeddingsTag)];
+    }
+    if (output_streams.embedding_result) {
+      *output_streams.embedding_result >>
+          graph[Output<components::containers::EmbeddingResult>(
+              kEmbeddingResultTag)];
+    }
     return graph.GetConfig();
   }
 
  private:
   // Adds a mediapipe TextEmbedder task graph into the provided
   // builder::Graph instance. The TextEmbedder task takes an input
-  // text (std::string) and returns an embedding result.
+  // text (std::string) and returns the embedding result streams.
   //
   // task_options: the mediapipe tasks TextEmbedderGraphOptions proto.
   // model_resources: the ModelResources object initialized from a
   //   TextEmbedder model file with model metadata.
   // text_in: (std::string) stream to run embedding extraction on.
+  // output_embeddings: whether to output the EmbeddingResult proto.
+  // output_embedding_result: whether to output the EmbeddingResult struct.
   // graph: the mediapipe builder::Graph instance to be updated.
-  absl::StatusOr<Source<EmbeddingResult>> BuildTextEmbedderTask(
+  absl::StatusOr<TextEmbedderOutputStreams> BuildTextEmbedderTask(
       const proto::TextEmbedderGraphOptions& task_options,
       const ModelResources& model_resources, Source<std::string> text_in,
-      Graph& graph) {
+      bool output_embeddings, bool output_embedding_result, Graph& graph) {
     // Adds preprocessing calculators and connects them to the text input
     // stream.
     auto& preprocessing = graph.AddNode(
         "mediapipe.tasks.components.processors.TextPreprocessingGraph");
+    auto& preprocessing_options = preprocessing.GetOptions<
+        components::processors::proto::TextPreprocessingGraphOptions>();
+    preprocessing_options.set_bucket_dynamic_seq_len(
+        task_options.bucket_dynamic_seq_len());
     MP_RETURN_IF_ERROR(components::processors::ConfigureTextPreprocessingGraph(
-        model_resources,
-        preprocessing.GetOptions<
-            components::processors::proto::TextPreprocessingGraphOptions>()));
+        model_resources, preprocessing_options));
     text_in >> preprocessing.In(kTextTag);
 
     // Adds both InferenceCalculator and ModelResourcesCalculator.
@@ -156,7 +195,17 @@ class TextEmbedderGraph : public core::ModelTaskGraph {
     inference.Out(kTensorsTag) >> postprocessing.In(kTensorsTag);
 
     // Outputs the embedding result.
-    return postprocessing[Output<EmbeddingResult>(kEmbeddingsTag)];
+    TextEmbedderOutputStreams output_streams;
+    if (output_embeddings) {
+      output_streams.embeddings =
+          postprocessing[Output<EmbeddingResult>(kEmbeddingsTag)];
+    }
+    if (output_embedding_result) {
+      output_streams.embedding_result =
+          postprocessing[Output<components::containers::EmbeddingResult>(
+              kEmbeddingResultTag)];
+    }
+    return output_streams;
   }
 };
 
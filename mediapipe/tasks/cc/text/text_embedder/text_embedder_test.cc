@@ -16,6 +16,8 @@ limitations under the License.
 #include "mediapipe/tasks/cc/text/text_embedder/text_embedder.h"
 
 #include <memory>
+#include <string>
+#include <vector>
 
 #include "absl/flags/flag.h"
 #include "absl/status/status.h"
@@ -108,6 +110,80 @@ TEST_F(EmbedderTest, SucceedsWithMobileBert) {
   MP_ASSERT_OK(text_embedder->Close());
 }
 
+TEST_F(EmbedderTest, EmbedBatchSucceedsWithMobileBert) {
+  auto options = std::make_unique<TextEmbedderOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kMobileBert);
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextEmbedder> text_embedder,
+                          TextEmbedder::Create(std::move(options)));
+  const std::vector<std::string> texts = {
+      "it's a charming and often affecting journey",
+      "what a great and fantastic trip",
+      "unflinchingly bleak and desperate",
+  };
+
+  MP_ASSERT_OK_AND_ASSIGN(std::vector<TextEmbedderResult> results,
+                          text_embedder->EmbedBatch(texts));
+
+  ASSERT_EQ(results.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(TextEmbedderResult expected,
+                            text_embedder->Embed(texts[i]));
+    ASSERT_EQ(results[i].embeddings.size(), 1);
+    ASSERT_EQ(results[i].embeddings[0].float_embedding.size(), 512);
+    EXPECT_NEAR(results[i].embeddings[0].float_embedding[0],
+                expected.embeddings[0].float_embedding[0], kEpsilon);
+  }
+  MP_ASSERT_OK(text_embedder->Close());
+}
+
+TEST_F(EmbedderTest, EmbedBatchSucceedsWithBucketedSeqLen) {
+  auto options = std::make_unique<TextEmbedderOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kMobileBert);
+  options->bucket_dynamic_seq_len = true;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextEmbedder> text_embedder,
+                          TextEmbedder::Create(std::move(options)));
+  const std::vector<std::string> texts = {
+      "it's a charming and often affecting journey",
+      "what a great and fantastic trip",
+      "unflinchingly bleak and desperate",
+  };
+
+  MP_ASSERT_OK_AND_ASSIGN(std::vector<TextEmbedderResult> results,
+                          text_embedder->EmbedBatch(texts));
+
+  ASSERT_EQ(results.size(), texts.size());
+  for (int i = 0; i < texts.size(); ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(TextEmbedderResult expected,
+                            text_embedder->Embed(texts[i]));
+    ASSERT_EQ(results[i].embeddings.size(), 1);
+    ASSERT_EQ(results[i].embeddings[0].float_embedding.size(), 512);
+    EXPECT_NEAR(results[i].embeddings[0].float_embedding[0],
+                expected.embeddings[0].float_embedding[0], kEpsilon);
+  }
+  MP_ASSERT_OK(text_embedder->Close());
+}
+
+TEST_F(EmbedderTest, EmbedWithResultCache) {
+  auto options = std::make_unique<TextEmbedderOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kMobileBert);
+  options->result_cache_options.max_entries = 1;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<TextEmbedder> text_embedder,
+                          TextEmbedder::Create(std::move(options)));
+  const std::string text = "it's a charming and often affecting journey";
+
+  MP_ASSERT_OK_AND_ASSIGN(auto result, text_embedder->Embed(text));
+  MP_ASSERT_OK_AND_ASSIGN(auto cached_result, text_embedder->Embed(text));
+
+  EXPECT_EQ(cached_result.embeddings[0].float_embedding,
+            result.embeddings[0].float_embedding);
+  EXPECT_EQ(text_embedder->GetResultCacheStats().num_hits, 1);
+  EXPECT_EQ(text_embedder->GetResultCacheStats().num_misses, 1);
+  MP_ASSERT_OK(text_embedder->Close());
+}
+
 TEST(EmbedTest, SucceedsWithRegexOneEmbeddingModel) {
   auto options = std::make_unique<TextEmbedderOptions>();
   options->base_options.model_asset_path =
@@ -15,7 +15,22 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/bert_tokenizer.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/string_view.h"
+#include "absl/strings/strip.h"
+#include "absl/types/span.h"
+#include "flatbuffers/flatbuffers.h"
 #include "mediapipe/framework/port/integral_types.h"
+#include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/config_generated.h"
+#include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/double_array_trie.h"
+#include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/double_array_trie_builder.h"
+#include "mediapipe/tasks/cc/text/custom_ops/sentencepiece/utils.h"
 #include "tensorflow_text/core/kernels/regex_split.h"
 
 namespace mediapipe {
@@ -23,6 +38,115 @@ namespace tasks {
 namespace text {
 namespace tokenizers {
 
+namespace {
+
+using ::mediapipe::tflite_operations::sentencepiece::BuildTrie;
+using ::mediapipe::tflite_operations::sentencepiece::DoubleArrayTrie;
+using ::mediapipe::tflite_operations::sentencepiece::Trie;
+using ::mediapipe::tflite_operations::sentencepiece::TrieBuilder;
+
+// Returns the byte offset of the character following the one starting at byte
+// offset `i` of `text`. Like ICU's U8_NEXT, ill-formed sequences are skipped
+// up to their first invalid byte.
+int NextCharBoundary(absl::string_view text, int i) {
+  const unsigned char lead = text[i];
+  int length = 1;
+  if (lead >= 0xF0 && lead < 0xF8) {
+    length = 4;
+  } else if (lead >= 0xE0) {
+    length = lead < 0xF0 ? 3 : 1;
+  } else if (lead >= 0xC0) {
+    length = 2;
+  }
+  int end = i + 1;
+  while (end < i + length && end < text.size() &&
+         (static_cast<unsigned char>(text[end]) & 0xC0) == 0x80) {
+    ++end;
+  }
+  return end;
+}
+
+// Builds a serialized Trie of `keys`, mapping each of them to its id in
+// `ids`. Returns an empty buffer if `keys` is empty.
+flatbuffers::DetachedBuffer SerializeTrie(const std::vector<std::string>& keys,
+                                          const std::vector<int>& ids) {
+  if (keys.empty()) {
+    return {};
+  }
+  flatbuffers::FlatBufferBuilder builder;
+  const auto nodes = builder.CreateVector(BuildTrie(keys, ids));
+  TrieBuilder trie_builder(builder);
+  trie_builder.add_nodes(nodes);
+  builder.Finish(trie_builder.Finish());
+  return builder.Release();
+}
+
+}  // namespace
+
+WordpieceTrie::WordpieceTrie(const std::vector<std::string>& vocab,
+                             absl::string_view suffix_indicator) {
+  // Later duplicates override earlier ones, as in FlatHashMapBackedWordpiece.
+  absl::flat_hash_map<absl::string_view, int> prefix_ids;
+  absl::flat_hash_map<absl::string_view, int> suffix_ids;
+  for (int i = 0; i < vocab.size(); ++i) {
+    absl::string_view piece = vocab[i];
+    // The trie keys are null-terminated, so they can't hold null characters.
+    if (piece.find('\0') != absl::string_view::npos) {
+      continue;
+    }
+    prefix_ids[piece] = i;
+    if (absl::ConsumePrefix(&piece, suffix_indicator) && !piece.empty()) {
+      suffix_ids[piece] = i;
+    }
+  }
+  for (auto [trie, ids] : {std::make_pair(&prefix_trie_, &prefix_ids),
+                           std::make_pair(&suffix_trie_, &suffix_ids)}) {
+    std::vector<std::string> keys;
+    std::vector<int> key_ids;
+    keys.reserve(ids->size());
+    key_ids.reserve(ids->size());
+    for (const auto& [key, id] : *ids) {
+      keys.emplace_back(key);
+      key_ids.push_back(id);
+    }
+    *trie = SerializeTrie(keys, key_ids);
+  }
+}
+
+int WordpieceTrie::LongestMatch(absl::string_view text, bool is_suffix,
+                                int max_chars, int* id) const {
+  const flatbuffers::DetachedBuffer& buffer =
+      is_suffix ? suffix_trie_ : prefix_trie_;
+  if (buffer.size() == 0) {
+    return 0;
+  }
+  // Limit the text to `max_chars` characters.
+  int text_end = 0;
+  for (int num_chars = 0; text_end < text.size() && num_chars < max_chars;
+       ++num_chars) {
+    text_end = NextCharBoundary(text, text_end);
+  }
+  const DoubleArrayTrie trie(
+      flatbuffers::GetRoot<Trie>(buffer.data())->nodes());
+  // Matches are found by increasing length, so the character boundaries can
+  // be computed along the way.
+  int match_length = 0;
+  int char_boundary = 0;
+  trie.IteratePrefixMatches(
+      tflite_operations::sentencepiece::utils::string_view(text.data(),
+                                                           text_end),
+      [&](const DoubleArrayTrie::Match& match) {
+        while (char_boundary < match.match_length) {
+          char_boundary = NextCharBoundary(text, char_boundary);
+        }
+        if (char_boundary == match.match_length) {
+          match_length = match.match_length;
+          *id = match.id;
+        }
+      });
+  return match_length;
+}
+
 FlatHashMapBackedWordpiece::FlatHashMapBackedWordpiece(
     const std::vector<std::string>& vocab)
     : vocab_{vocab} {
@@ -56,17 +180,90 @@ bool FlatHashMapBackedWordpiece::LookupWord(int vocab_id,
   return true;
 }
 
+BertTokenizer::BertTokenizer(const std::vector<std::string>& vocab,
+                             const BertTokenizerOptions& options)
+    : vocab_{FlatHashMapBackedWordpiece(vocab)},
+      trie_{vocab, options.suffix_indicator},
+      options_{options},
+      delim_re_{options.delim_str},
+      include_delim_re_{options.include_delim_str} {
+  if (!vocab_.LookupId(options_.unknown_token, &unknown_token_id_)) {
+    unknown_token_id_ = -1;
+  }
+}
+
 TokenizerResult BertTokenizer::Tokenize(const std::string& input) {
   return TokenizeWordpiece(input);
 }
 
-WordpieceTokenizerResult BertTokenizer::TokenizeWordpiece(
-    const std::string& input) const {
-  WordpieceTokenizerResult result;
-  std::vector<std::string>& subwords = result.subwords;
-  std::vector<int>& wp_absolute_begin_offset = result.wp_begin_offset;
-  std::vector<int>& wp_absolute_end_offset = result.wp_end_offset;
+template <typename Callback>
+void BertTokenizer::TokenizeWord(absl::string_view word,
+                                 Callback callback) const {
+  // Words that are too long or can't be split into wordpieces are replaced by
+  // the unknown token if `use_unknown_token` is true, or kept as a single
+  // wordpiece otherwise.
+  auto add_whole_word = [&]() {
+    Wordpiece piece{-1, 0, static_cast<int>(word.size()),
+                    options_.use_unknown_token};
+    if (options_.use_unknown_token) {
+      piece.id = unknown_token_id_;
+    } else {
+      vocab_.LookupId(word, &piece.id);
+    }
+    callback(piece);
+  };
+  if (word.size() > options_.max_bytes_per_token) {
+    add_whole_word();
+    return;
+  }
+  // The wordpieces are only reported once the whole word was split, as the
+  // word is replaced by a single wordpiece if it can't be. They are buffered
+  // on the stack unless the word has more than `kMaxInlinePieces` of them.
+  constexpr int kMaxInlinePieces = 32;
+  Wordpiece inline_pieces[kMaxInlinePieces];
+  std::vector<Wordpiece> pieces;
+  int num_pieces = 0;
+  auto add_piece = [&](const Wordpiece& piece) {
+    if (num_pieces < kMaxInlinePieces) {
+      inline_pieces[num_pieces] = piece;
+    } else {
+      if (pieces.empty()) {
+        pieces.assign(inline_pieces, inline_pieces + kMaxInlinePieces);
+      }
+      pieces.push_back(piece);
+    }
+    ++num_pieces;
+  };
+  const int max_chars = options_.max_chars_per_subtoken > 0
+                            ? options_.max_chars_per_subtoken
+                            : word.size();
+  for (int begin = 0; begin < word.size();) {
+    int id = -1;
+    const int length = trie_.LongestMatch(word.substr(begin), begin > 0,
+                                          max_chars, &id);
+    if (length > 0) {
+      add_piece({id, begin, begin + length, false});
+      begin += length;
+    } else if (options_.split_unknown_chars) {
+      const int end = NextCharBoundary(word, begin);
+      add_piece({options_.use_unknown_token ? unknown_token_id_ : -1, begin,
+                 end, options_.use_unknown_token});
+      begin = end;
+    } else {
+      add_whole_word();
+      return;
+    }
+  }
+  const Wordpiece* all_pieces =
+      num_pieces <= kMaxInlinePieces ? inline_pieces : pieces.data();
+  for (int i = 0; i < num_pieces; ++i) {
+    callback(all_pieces[i]);
+  }
+}
 
+template <typename Callback, typename RowCallback>
+void BertTokenizer::TokenizeWords(absl::string_view input, Callback callback,
+                                  RowCallback row_callback) const {
   std::vector<absl::string_view> tokens;
   std::vector<long long> begin_offsets;
   std::vector<long long> end_offsets;
@@ -76,33 +273,62 @@ WordpieceTokenizerResult BertTokenizer::TokenizeWordpiece(
                                &tokens, &begin_offsets, &end_offsets);
 
   for (int token_index = 0; token_index < tokens.size(); token_index++) {
-    auto& token = tokens[token_index];
+    const int word_offset = begin_offsets[token_index];
     int num_word_pieces = 0;
-    tensorflow::text::LookupStatus status = WordpieceTokenize(
-        token, options_.max_bytes_per_token, options_.max_chars_per_subtoken,
-        options_.suffix_indicator, options_.use_unknown_token,
-        options_.unknown_token, options_.split_unknown_chars, &vocab_,
-        &subwords, &wp_absolute_begin_offset, &wp_absolute_end_offset,
-        &num_word_pieces);
-
-    result.row_lengths.emplace_back(num_word_pieces);
-    // for the last num_word_pieces added into wp_absolute_begin_offset and
-    // wp_absolute_end_offset, offset them with begin_offsets[token_index]
-    int absolute_offset_size = wp_absolute_begin_offset.size();
-    for (int i = num_word_pieces; i > 0; i--) {
-      wp_absolute_begin_offset[absolute_offset_size - i] +=
-          begin_offsets[token_index];
-      wp_absolute_end_offset[absolute_offset_size - i] +=
-          begin_offsets[token_index];
-    }
-    if (!status.success) {
-      return result;
-    }
+    TokenizeWord(tokens[token_index], [&](const Wordpiece& piece) {
+      callback(tokens[token_index], word_offset, piece);
+      ++num_word_pieces;
+    });
+    row_callback(num_word_pieces);
   }
+}
 
+WordpieceTokenizerResult BertTokenizer::TokenizeWordpiece(
+    const std::string& input) const {
+  WordpieceTokenizerResult result;
+  TokenizeWords(
+      input,
+      [&](absl::string_view word, int word_offset, const Wordpiece& piece) {
+        if (piece.is_unknown) {
+          result.subwords.push_back(options_.unknown_token);
+        } else if (piece.begin > 0) {
+          result.subwords.push_back(absl::StrCat(
+              options_.suffix_indicator,
+              word.substr(piece.begin, piece.end - piece.begin)));
+        } else {
+          result.subwords.emplace_back(word.substr(0, piece.end));
+        }
+        result.wp_begin_offset.push_back(word_offset + piece.begin);
+        result.wp_end_offset.push_back(word_offset + piece.end);
+      },
+      [&](int num_word_pieces) {
+        result.row_lengths.push_back(num_word_pieces);
+      });
   return result;
 }
 
+int BertTokenizer::TokenizeWordpieceIds(
+    absl::string_view input, absl::Span<int32_t> ids,
+    absl::Span<int32_t> begin_offsets, absl::Span<int32_t> end_offsets) const {
+  int num_word_pieces = 0;
+  TokenizeWords(
+      input,
+      [&](absl::string_view word, int word_offset, const Wordpiece& piece) {
+        if (num_word_pieces < ids.size()) {
+          ids[num_word_pieces] = std::max(piece.id, 0);
+        }
+        if (num_word_pieces < begin_offsets.size()) {
+          begin_offsets[num_word_pieces] = word_offset + piece.begin;
+        }
+        if (num_word_pieces < end_offsets.size()) {
+          end_offsets[num_word_pieces] = word_offset + piece.end;
+        }
+        ++num_word_pieces;
+      },
+      [](int num_word_pieces) {});
+  return num_word_pieces;
+}
+
 }  // namespace tokenizers
 }  // namespace text
 }  // namespace tasks
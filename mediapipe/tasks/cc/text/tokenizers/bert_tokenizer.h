@@ -17,12 +17,15 @@ limitations under the License.
 #define MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_BERT_TOKENIZER_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
 
 #include "absl/container/flat_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
+#include "flatbuffers/flatbuffers.h"
 #include "mediapipe/tasks/cc/text/tokenizers/tokenizer.h"
 #include "mediapipe/tasks/cc/text/utils/vocab_utils.h"
 #include "re2/re2.h"
@@ -86,16 +89,48 @@ class FlatHashMapBackedWordpiece : public tensorflow::text::WordpieceVocab {
   absl::flat_hash_map<absl::string_view, int> index_map_;
 };
 
+// A double-array-trie based index of a wordpiece vocabulary, used in
+// BertTokenizer to find the longest wordpiece starting at a given position of
+// a word with a single walk down the trie, instead of looking up every
+// candidate substring in a hash map.
+//
+// Wordpieces starting with the suffix indicator are indexed without it in a
+// separate trie, so that matching the continuation of a word doesn't require
+// prepending the suffix indicator to it.
+class WordpieceTrie {
+ public:
+  WordpieceTrie(const std::vector<std::string>& vocab,
+                absl::string_view suffix_indicator);
+
+  // Returns the length in bytes of the longest wordpiece that is a prefix of
+  // `text`, ends at a UTF-8 character boundary and has at most `max_chars`
+  // characters, and sets `id` to its id. Only matches wordpieces starting with
+  // the suffix indicator if `is_suffix` is true, in which case `text` must not
+  // include the suffix indicator. Returns 0 if there is no such wordpiece.
+  int LongestMatch(absl::string_view text, bool is_suffix, int max_chars,
+                   int* id) const;
+
+ private:
+  // The serialized tries of the wordpieces that don't start with the suffix
+  // indicator, and of the ones that do. Empty if there are no such
+  // wordpieces.
+  flatbuffers::DetachedBuffer prefix_trie_;
+  flatbuffers::DetachedBuffer suffix_trie_;
+};
+
 // Wordpiece tokenizer for bert models. Initialized with a vocab file or vector.
+//
+// Words are split into wordpieces with the greedy longest-match-first
+// algorithm of tensorflow::text::WordpieceTokenize, using a WordpieceTrie to
+// find each wordpiece with a single walk down a trie. TokenizeWordpieceIds()
+// additionally writes the ids and offsets of the wordpieces to preallocated
+// buffers, e.g. the ones of the model input tensors, without materializing the
+// wordpieces as strings.
 class BertTokenizer : public mediapipe::tasks::text::tokenizers::Tokenizer {
  public:
   // Initialize the tokenizer from vocab vector and tokenizer configs.
   explicit BertTokenizer(const std::vector<std::string>& vocab,
-                         const BertTokenizerOptions& options = {})
-      : vocab_{FlatHashMapBackedWordpiece(vocab)},
-        options_{options},
-        delim_re_{options.delim_str},
-        include_delim_re_{options.include_delim_str} {}
+                         const BertTokenizerOptions& options = {});
 
   // Initialize the tokenizer from file path to vocab and tokenizer configs.
   explicit BertTokenizer(const std::string& path_to_vocab,
@@ -118,6 +153,21 @@ class BertTokenizer : public mediapipe::tasks::text::tokenizers::Tokenizer {
   // subwords and offsets
   WordpieceTokenizerResult TokenizeWordpiece(const std::string& input) const;
 
+  // Perform tokenization, writing the ids of the first `ids.size()` wordpieces
+  // to `ids`, and their begin and end byte offsets in `input` to the first
+  // elements of `begin_offsets` and `end_offsets`, which may be empty. The id
+  // of wordpieces missing from the vocab, which can only happen if
+  // `use_unknown_token` is false, is 0. Returns the total number of
+  // wordpieces, which may be larger than `ids.size()`.
+  int TokenizeWordpieceIds(absl::string_view input, absl::Span<int32_t> ids,
+                           absl::Span<int32_t> begin_offsets = {},
+                           absl::Span<int32_t> end_offsets = {}) const;
+
+  // Perform tokenization, writing the wordpiece ids to `ids`.
+  int TokenizeIds(const std::string& input, absl::Span<int32_t> ids) override {
+    return TokenizeWordpieceIds(input, ids);
+  }
+
   // Check if a certain key is included in the vocab.
   tensorflow::text::LookupStatus Contains(const absl::string_view key,
                                           bool* value) const {
@@ -137,10 +187,36 @@ class BertTokenizer : public mediapipe::tasks::text::tokenizers::Tokenizer {
   int VocabularySize() const { return vocab_.VocabularySize(); }
 
  private:
+  // A wordpiece of a word, as found by TokenizeWord().
+  struct Wordpiece {
+    // The id of the wordpiece, or -1 if it is not in the vocab.
+    int id;
+    // The begin and end byte offsets of the wordpiece in the word.
+    int begin;
+    int end;
+    // Whether the wordpiece is the unknown token, replacing either the whole
+    // word or, if `split_unknown_chars` is true, a single character.
+    bool is_unknown;
+  };
+
+  // Splits `word` into wordpieces, and calls `callback` on each of them.
+  template <typename Callback>
+  void TokenizeWord(absl::string_view word, Callback callback) const;
+
+  // Splits `input` into words, and calls `callback` with the byte offset of
+  // each word in `input` and each of its wordpieces. Calls `row_callback`
+  // with the number of wordpieces of each word.
+  template <typename Callback, typename RowCallback>
+  void TokenizeWords(absl::string_view input, Callback callback,
+                     RowCallback row_callback) const;
+
   mediapipe::tasks::text::tokenizers::FlatHashMapBackedWordpiece vocab_;
+  WordpieceTrie trie_;
   BertTokenizerOptions options_;
   RE2 delim_re_;
   RE2 include_delim_re_;
+  // The id of `options_.unknown_token`, or -1 if it is not in the vocab.
+  int unknown_token_id_ = -1;
 };
 
 }  // namespace tokenizers
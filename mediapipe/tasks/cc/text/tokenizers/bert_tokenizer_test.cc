@@ -15,6 +15,11 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/bert_tokenizer.h"
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "absl/types/span.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/tasks/cc/core/utils.h"
@@ -106,6 +111,72 @@ TEST(TokenizerTest, TestTokenizerUnknownTokens) {
   EXPECT_THAT(results.row_lengths, ElementsAre(1, 1, 1, 1));
 }
 
+TEST(TokenizerTest, TestTokenizerSplitUnknownChars) {
+  std::vector<std::string> vocab = {"[UNK]", "ab", "##c"};
+  auto tokenizer = absl::make_unique<BertTokenizer>(
+      vocab, BertTokenizerOptions{.split_unknown_chars = true});
+
+  auto results = tokenizer->TokenizeWordpiece("abxc ab\xc3\xa9");
+
+  EXPECT_THAT(results.subwords, ElementsAre("ab", kDefaultUnknownToken, "##c",
+                                            "ab", kDefaultUnknownToken));
+  EXPECT_THAT(results.wp_begin_offset, ElementsAre(0, 2, 3, 5, 7));
+  EXPECT_THAT(results.wp_end_offset, ElementsAre(2, 3, 4, 7, 9));
+  EXPECT_THAT(results.row_lengths, ElementsAre(3, 2));
+}
+
+TEST(TokenizerTest, TestTokenizerMaxCharsPerSubtoken) {
+  std::vector<std::string> vocab = {"[UNK]", "a", "ab", "abc", "##c"};
+  auto tokenizer = absl::make_unique<BertTokenizer>(
+      vocab, BertTokenizerOptions{.max_chars_per_subtoken = 2});
+
+  auto results = tokenizer->TokenizeWordpiece("abc");
+
+  EXPECT_THAT(results.subwords, ElementsAre("ab", "##c"));
+}
+
+TEST(TokenizerTest, TestTokenizeWordpieceIds) {
+#ifdef _WIN32
+  // TODO: Investigate why these tests are failing
+  GTEST_SKIP("Unexpected result on Windows");
+#endif  // _WIN32
+  auto tokenizer = absl::make_unique<BertTokenizer>(kTestVocabPath);
+  const std::string input = "i'm questionansweraskask";
+  auto results = tokenizer->TokenizeWordpiece(input);
+  std::vector<int> expected_ids;
+  for (const auto& subword : results.subwords) {
+    int id;
+    ASSERT_TRUE(tokenizer->LookupId(subword, &id));
+    expected_ids.push_back(id);
+  }
+
+  std::vector<int32_t> ids(10, -1);
+  std::vector<int32_t> begin_offsets(10, -1);
+  std::vector<int32_t> end_offsets(10, -1);
+  int num_ids = tokenizer->TokenizeWordpieceIds(
+      input, absl::MakeSpan(ids), absl::MakeSpan(begin_offsets),
+      absl::MakeSpan(end_offsets));
+
+  ASSERT_EQ(num_ids, 8);
+  EXPECT_EQ(std::vector<int>(ids.begin(), ids.begin() + num_ids),
+            expected_ids);
+  EXPECT_THAT(begin_offsets,
+              ElementsAre(0, 1, 2, 4, 12, 15, 18, 21, -1, -1));
+  EXPECT_THAT(end_offsets, ElementsAre(1, 2, 3, 12, 15, 18, 21, 24, -1, -1));
+}
+
+TEST(TokenizerTest, TestTokenizeIdsTruncates) {
+  std::vector<std::string> vocab = {"[UNK]", "i", "'", "m", "question"};
+  auto tokenizer = absl::make_unique<BertTokenizer>(vocab);
+
+  std::vector<int32_t> ids(3, -1);
+  int num_ids =
+      tokenizer->TokenizeIds("i'm question unknown", absl::MakeSpan(ids));
+
+  EXPECT_EQ(num_ids, 5);
+  EXPECT_THAT(ids, ElementsAre(1, 2, 3));
+}
+
 TEST(TokenizerTest, TestLookupId) {
   std::vector<std::string> vocab;
   vocab.emplace_back("i");
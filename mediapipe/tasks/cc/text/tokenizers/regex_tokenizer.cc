@@ -15,9 +15,14 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/regex_tokenizer.h"
 
-#include <iostream>
-
-#include "absl/strings/substitute.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "absl/container/flat_hash_map.h"
+#include "absl/container/node_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "mediapipe/tasks/cc/text/utils/vocab_utils.h"
 
 namespace mediapipe {
@@ -35,7 +40,7 @@ constexpr char kPad[] = "<PAD>";
 constexpr char kUnknown[] = "<UNKNOWN>";
 
 void buildIndexTokenMap(
-    const absl::node_hash_map<std::string, int>& token_index_map,
+    const absl::flat_hash_map<std::string, int>& token_index_map,
     absl::node_hash_map<int, absl::string_view>* index_token_map) {
   for (const auto& token : token_index_map) {
     (*index_token_map)[token.second] = token.first;
@@ -44,55 +49,81 @@ void buildIndexTokenMap(
 
 }  // namespace
 
-// RE2::FindAndConsume requires the delim_re_ to have a matching group in order
-// to capture the matched delimiter length. Surround the regex with a
-// parenthesis to create a matching group, it's fine if the regex is already
-// surrounded by parenthesis.
 RegexTokenizer::RegexTokenizer(const std::string& regex_pattern,
                                const std::string& path_to_vocab)
-    : delim_re_{absl::Substitute("($0)", regex_pattern)},
-      token_index_map_{LoadVocabAndIndexFromFile(path_to_vocab)} {
+    : delim_re_{regex_pattern} {
+  auto token_index_map = LoadVocabAndIndexFromFile(path_to_vocab);
+  token_index_map_.insert(token_index_map.begin(), token_index_map.end());
   buildIndexTokenMap(token_index_map_, &index_token_map_);
+  GetUnknownToken(&unknown_token_id_);
 }
 
 RegexTokenizer::RegexTokenizer(const std::string& regex_pattern,
                                const char* vocab_buffer_data,
                                size_t vocab_buffer_size)
-    : delim_re_{absl::Substitute("($0)", regex_pattern)},
-      token_index_map_{
-          LoadVocabAndIndexFromBuffer(vocab_buffer_data, vocab_buffer_size)} {
+    : delim_re_{regex_pattern} {
+  auto token_index_map =
+      LoadVocabAndIndexFromBuffer(vocab_buffer_data, vocab_buffer_size);
+  token_index_map_.insert(token_index_map.begin(), token_index_map.end());
   buildIndexTokenMap(token_index_map_, &index_token_map_);
+  GetUnknownToken(&unknown_token_id_);
 }
 
-TokenizerResult RegexTokenizer::Tokenize(const std::string& input) {
-  absl::string_view leftover(input.data());
-  absl::string_view last_end = leftover;
-
-  TokenizerResult result;
-
-  // Keep looking for split points until we have reached the end of the input.
-  absl::string_view extracted_delim_token;
-  while (RE2::FindAndConsume(&leftover, delim_re_, &extracted_delim_token)) {
-    absl::string_view token(last_end.data(),
-                            extracted_delim_token.data() - last_end.data());
-    bool has_non_empty_token = token.length() > 0;
-
-    last_end = leftover;
-
+template <typename Callback>
+void RegexTokenizer::ForEachToken(absl::string_view input,
+                                  Callback callback) const {
+  // The input is searched from the end of the previous delimiter on, as if it
+  // was a new text, so that anchors match at the start of each search.
+  absl::string_view leftover = input;
+  size_t search_begin = 0;
+  absl::string_view delim;
+  // Only asking for the overall match lets RE2 find the delimiters with its
+  // forward and reverse DFAs, without running the slower NFA for submatches.
+  while (search_begin <= leftover.size() &&
+         delim_re_.Match(leftover, search_begin, leftover.size(),
+                         RE2::UNANCHORED, &delim, 1)) {
+    if (delim.empty()) {
+      // Empty delimiters don't split the text.
+      search_begin = delim.data() - leftover.data() + 1;
+      continue;
+    }
+    const size_t token_size = delim.data() - leftover.data();
     // Mark the end of the previous token, only if there was something.
-    if (has_non_empty_token) {
-      result.subwords.push_back(std::string(token));
+    if (token_size > 0) {
+      callback(leftover.substr(0, token_size));
     }
+    leftover.remove_prefix(token_size + delim.size());
+    search_begin = 0;
   }
 
   // Close the last token.
   if (!leftover.empty()) {
-    result.subwords.push_back(std::string(leftover));
+    callback(leftover);
   }
+}
 
+TokenizerResult RegexTokenizer::Tokenize(const std::string& input) {
+  TokenizerResult result;
+  ForEachToken(input.c_str(), [&result](absl::string_view token) {
+    result.subwords.push_back(std::string(token));
+  });
   return result;
 }
 
+int RegexTokenizer::TokenizeIds(const std::string& input,
+                                absl::Span<int32_t> ids) {
+  int num_tokens = 0;
+  ForEachToken(input.c_str(), [&](absl::string_view token) {
+    if (num_tokens < ids.size()) {
+      auto it = token_index_map_.find(token);
+      ids[num_tokens] =
+          it == token_index_map_.end() ? unknown_token_id_ : it->second;
+    }
+    ++num_tokens;
+  });
+  return num_tokens;
+}
+
 bool RegexTokenizer::LookupId(absl::string_view key, int* result) const {
   auto it = token_index_map_.find(key);
   if (it == token_index_map_.end()) {
@@ -17,10 +17,13 @@ limitations under the License.
 #define MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_REGEX_TOKENIZER_H_
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
+#include "absl/container/flat_hash_map.h"
 #include "absl/container/node_hash_map.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 #include "mediapipe/tasks/cc/text/tokenizers/tokenizer.h"
 #include "re2/re2.h"
 
@@ -30,6 +33,11 @@ namespace text {
 namespace tokenizers {
 
 // Tokenizer to load a vocabulary and split text by regular expressions.
+//
+// The text is split at the matches of the delimiter regular expression, which
+// are found by RE2's DFA alone as no capture group is needed, and the tokens
+// are looked up in the vocabulary as views into the input text. TokenizeIds()
+// therefore doesn't allocate any memory per token.
 class RegexTokenizer : public Tokenizer {
  public:
   explicit RegexTokenizer(const std::string& regex_pattern,
@@ -41,6 +49,11 @@ class RegexTokenizer : public Tokenizer {
 
   TokenizerResult Tokenize(const std::string& input) override;
 
+  // Same as Tokenizer::TokenizeIds(), except that the id of tokens missing
+  // from the vocabulary is the id of the "<UNKNOWN>" token, if the vocabulary
+  // has one.
+  int TokenizeIds(const std::string& input, absl::Span<int32_t> ids) override;
+
   bool LookupId(absl::string_view key, int* result) const override;
 
   bool LookupWord(int vocab_id, absl::string_view* result) const override;
@@ -50,9 +63,17 @@ class RegexTokenizer : public Tokenizer {
   bool GetUnknownToken(int* unknown_token);
 
  private:
+  // Calls `callback` with each non-empty token of `input`, in order.
+  template <typename Callback>
+  void ForEachToken(absl::string_view input, Callback callback) const;
+
   RE2 delim_re_;
-  absl::node_hash_map<std::string, int> token_index_map_;
+  // Not modified after construction, so that the views of
+  // `index_token_map_` into its keys remain valid.
+  absl::flat_hash_map<std::string, int> token_index_map_;
   absl::node_hash_map<int, absl::string_view> index_token_map_;
+  // The id of the "<UNKNOWN>" token, or 0 if the vocabulary doesn't have one.
+  int unknown_token_id_ = 0;
 };
 
 }  // namespace tokenizers
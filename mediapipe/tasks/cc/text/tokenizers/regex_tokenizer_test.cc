@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/text/tokenizers/regex_tokenizer.h"
 
+#include <cstdint>
+#include <vector>
+
+#include "absl/types/span.h"
 #include "mediapipe/framework/port/gmock.h"
 #include "mediapipe/framework/port/gtest.h"
 #include "mediapipe/tasks/cc/core/utils.h"
@@ -60,6 +64,31 @@ TEST(RegexTokenizerTest, TestTokenizeFromFileBuffer) {
               ElementsAre("good", "morning", "i'm", "your", "teacher"));
 }
 
+TEST(RegexTokenizerTest, TestTokenizeWithDelimitersAtBothEnds) {
+  auto tokenizer = CreateRegexTokenizer(kRegex, kTestRegexVocabPath);
+  auto results = tokenizer->Tokenize(", good morning!");
+  EXPECT_THAT(results.subwords, ElementsAre("good", "morning"));
+}
+
+TEST(RegexTokenizerTest, TestTokenizeIds) {
+  auto tokenizer = CreateRegexTokenizer(kRegex, kTestRegexVocabPath);
+  std::vector<int32_t> ids(8, -1);
+  int num_tokens = tokenizer->TokenizeIds(
+      "good    morning, i'm your xyzzyx teacher.\n", absl::MakeSpan(ids));
+  // Unknown tokens get the id of <UNKNOWN>.
+  EXPECT_EQ(num_tokens, 6);
+  EXPECT_THAT(ids, ElementsAre(52, 1972, 146, 129, 2, 1750, -1, -1));
+}
+
+TEST(RegexTokenizerTest, TestTokenizeIdsTruncates) {
+  auto tokenizer = CreateRegexTokenizer(kRegex, kTestRegexVocabPath);
+  std::vector<int32_t> ids(2, -1);
+  int num_tokens = tokenizer->TokenizeIds(
+      "good    morning, i'm your teacher.\n", absl::MakeSpan(ids));
+  EXPECT_EQ(num_tokens, 5);
+  EXPECT_THAT(ids, ElementsAre(52, 1972));
+}
+
 TEST(RegexTokenizerTest, TestLookupId) {
   std::string buffer = LoadBinaryContent(kTestRegexVocabPath);
   auto tokenizer = CreateRegexTokenizer(kRegex, kTestRegexVocabPath);
@@ -16,11 +16,13 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_TOKENIZER_H_
 #define MEDIAPIPE_TASKS_CC_TEXT_TOKENIZERS_TOKENIZER_H_
 
+#include <cstdint>
 #include <fstream>
 #include <string>
 #include <vector>
 
 #include "absl/strings/string_view.h"
+#include "absl/types/span.h"
 
 namespace mediapipe {
 namespace tasks {
@@ -37,6 +39,22 @@ class Tokenizer {
   // Perform tokenization to get tokenized results.
   virtual TokenizerResult Tokenize(const std::string& input) = 0;
 
+  // Perform tokenization, writing the ids of the first `ids.size()` tokens to
+  // `ids`. The id of tokens missing from the vocabulary is 0. Returns the total
+  // number of tokens, which may be larger than `ids.size()`.
+  //
+  // Tokenizers that can find the token ids while tokenizing should override
+  // this to avoid materializing the tokens as strings.
+  virtual int TokenizeIds(const std::string& input, absl::Span<int32_t> ids) {
+    TokenizerResult result = Tokenize(input);
+    for (int i = 0; i < result.subwords.size() && i < ids.size(); ++i) {
+      int id = 0;
+      LookupId(result.subwords[i], &id);
+      ids[i] = id;
+    }
+    return result.subwords.size();
+  }
+
   // Find the id of a string token.
   virtual bool LookupId(absl::string_view key, int* result) const = 0;
 
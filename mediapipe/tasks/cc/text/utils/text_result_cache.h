@@ -0,0 +1,149 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef MEDIAPIPE_TASKS_CC_TEXT_UTILS_TEXT_RESULT_CACHE_H_
+#define MEDIAPIPE_TASKS_CC_TEXT_UTILS_TEXT_RESULT_CACHE_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <optional>
+#include <string>
+#include <utility>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/container/flat_hash_map.h"
+#include "absl/strings/string_view.h"
+#include "absl/synchronization/mutex.h"
+#include "absl/time/time.h"
+#include "mediapipe/framework/deps/clock.h"
+
+namespace mediapipe::tasks::text::utils {
+
+// Options for configuring the result cache of a text task.
+struct TextResultCacheOptions {
+  // The maximum number of results kept in the cache. If 0, the default, the
+  // results are not cached.
+  int max_entries = 0;
+
+  // How long a result can be returned from the cache after it was computed.
+  absl::Duration ttl = absl::InfiniteDuration();
+};
+
+// Lookup statistics of a TextResultCache.
+struct TextResultCacheStats {
+  // Number of lookups that returned a cached result.
+  int64_t num_hits = 0;
+  // Number of lookups that didn't find a result, or found an expired one.
+  int64_t num_misses = 0;
+};
+
+// A bounded cache of the results of a text task, keyed by input text, which
+// evicts the least recently used result once it is full.
+//
+// Texts are compared exactly: tokenizers may map texts that only differ by
+// case or whitespace to different tokens, e.g. for cased models, so the cache
+// can't normalize them without changing the results. A cache is owned by a
+// single task instance, so its results always come from the same model.
+//
+// This class is thread-safe, so that it can be shared by concurrent calls to a
+// task with several graph replicas.
+template <typename T>
+class TextResultCache {
+ public:
+  explicit TextResultCache(const TextResultCacheOptions& options,
+                           Clock* clock = Clock::RealClock())
+      : options_(options), clock_(clock) {}
+
+  TextResultCache(const TextResultCache&) = delete;
+  TextResultCache& operator=(const TextResultCache&) = delete;
+
+  // Returns a copy of the result cached for `text`, if it didn't expire, and
+  // marks it as the most recently used one.
+  std::optional<T> Lookup(absl::string_view text) {
+    absl::MutexLock lock(&mutex_);
+    auto it = index_.find(text);
+    if (it == index_.end()) {
+      ++stats_.num_misses;
+      return std::nullopt;
+    }
+    if (clock_->TimeNow() - it->second->insertion_time >= options_.ttl) {
+      entries_.erase(it->second);
+      index_.erase(it);
+      ++stats_.num_misses;
+      return std::nullopt;
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    ++stats_.num_hits;
+    return it->second->result;
+  }
+
+  // Caches `result` for `text` as the most recently used result, replacing
+  // any result already cached for it.
+  void Insert(absl::string_view text, T result) {
+    if (options_.max_entries <= 0) return;
+    absl::MutexLock lock(&mutex_);
+    const absl::Time now = clock_->TimeNow();
+    auto it = index_.find(text);
+    if (it != index_.end()) {
+      it->second->result = std::move(result);
+      it->second->insertion_time = now;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      return;
+    }
+    entries_.push_front({std::string(text), std::move(result), now});
+    // The key views the text owned by the entry, whose address is stable.
+    index_.emplace(entries_.front().text, entries_.begin());
+    if (entries_.size() > static_cast<size_t>(options_.max_entries)) {
+      index_.erase(entries_.back().text);
+      entries_.pop_back();
+    }
+  }
+
+  // Returns the lookup statistics since the cache was created.
+  TextResultCacheStats GetStats() const {
+    absl::MutexLock lock(&mutex_);
+    return stats_;
+  }
+
+  // Returns the number of cached results, including expired ones that
+  // weren't looked up since they expired.
+  int size() const {
+    absl::MutexLock lock(&mutex_);
+    return entries_.size();
+  }
+
+ private:
+  struct Entry {
+    std::string text;
+    T result;
+    absl::Time insertion_time;
+  };
+  using EntryList = std::list<Entry>;
+
+  const TextResultCacheOptions options_;
+  Clock* const clock_;
+
+  mutable absl::Mutex mutex_;
+  // The cached results, from the most to the least recently used.
+  EntryList entries_ ABSL_GUARDED_BY(mutex_);
+  absl::flat_hash_map<absl::string_view, typename EntryList::iterator> index_
+      ABSL_GUARDED_BY(mutex_);
+  TextResultCacheStats stats_ ABSL_GUARDED_BY(mutex_);
+};
+
+}  // namespace mediapipe::tasks::text::utils
+
+#endif  // MEDIAPIPE_TASKS_CC_TEXT_UTILS_TEXT_RESULT_CACHE_H_
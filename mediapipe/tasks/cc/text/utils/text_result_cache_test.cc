@@ -0,0 +1,129 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "mediapipe/tasks/cc/text/utils/text_result_cache.h"
+
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "absl/time/time.h"
+#include "mediapipe/framework/deps/clock.h"
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+
+namespace mediapipe::tasks::text::utils {
+namespace {
+
+using ::testing::Eq;
+using ::testing::Optional;
+
+// A clock whose time only changes when advanced by the test.
+class FakeClock : public Clock {
+ public:
+  absl::Time TimeNow() override { return now_; }
+  void Sleep(absl::Duration d) override { now_ += d; }
+  void SleepUntil(absl::Time wakeup_time) override { now_ = wakeup_time; }
+
+ private:
+  absl::Time now_ = absl::UnixEpoch();
+};
+
+TEST(TextResultCacheTest, ReturnsCachedResults) {
+  TextResultCache<int> cache({.max_entries = 2});
+  EXPECT_EQ(cache.Lookup("hello"), std::nullopt);
+
+  cache.Insert("hello", 1);
+  cache.Insert("world", 2);
+
+  EXPECT_THAT(cache.Lookup("hello"), Optional(Eq(1)));
+  EXPECT_THAT(cache.Lookup("world"), Optional(Eq(2)));
+  EXPECT_EQ(cache.Lookup("Hello"), std::nullopt);
+  const TextResultCacheStats stats = cache.GetStats();
+  EXPECT_EQ(stats.num_hits, 2);
+  EXPECT_EQ(stats.num_misses, 2);
+}
+
+TEST(TextResultCacheTest, EvictsLeastRecentlyUsedResult) {
+  TextResultCache<int> cache({.max_entries = 2});
+  cache.Insert("a", 1);
+  cache.Insert("b", 2);
+  ASSERT_THAT(cache.Lookup("a"), Optional(Eq(1)));
+
+  cache.Insert("c", 3);
+
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_THAT(cache.Lookup("a"), Optional(Eq(1)));
+  EXPECT_EQ(cache.Lookup("b"), std::nullopt);
+  EXPECT_THAT(cache.Lookup("c"), Optional(Eq(3)));
+}
+
+TEST(TextResultCacheTest, ReplacesExistingResult) {
+  TextResultCache<int> cache({.max_entries = 2});
+  cache.Insert("a", 1);
+  cache.Insert("a", 2);
+
+  EXPECT_EQ(cache.size(), 1);
+  EXPECT_THAT(cache.Lookup("a"), Optional(Eq(2)));
+}
+
+TEST(TextResultCacheTest, ExpiresResultsAfterTtl) {
+  FakeClock clock;
+  TextResultCache<int> cache({.max_entries = 2, .ttl = absl::Seconds(10)},
+                             &clock);
+  cache.Insert("a", 1);
+  clock.Sleep(absl::Seconds(5));
+  cache.Insert("b", 2);
+  clock.Sleep(absl::Seconds(5));
+
+  EXPECT_EQ(cache.Lookup("a"), std::nullopt);
+  EXPECT_THAT(cache.Lookup("b"), Optional(Eq(2)));
+  EXPECT_EQ(cache.size(), 1);
+}
+
+TEST(TextResultCacheTest, DoesNotCacheWithZeroEntries) {
+  TextResultCache<int> cache({.max_entries = 0});
+  cache.Insert("a", 1);
+
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.Lookup("a"), std::nullopt);
+}
+
+TEST(TextResultCacheTest, SupportsConcurrentCalls) {
+  TextResultCache<std::string> cache({.max_entries = 8});
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t) {
+    threads.emplace_back([&cache, t]() {
+      for (int i = 0; i < 100; ++i) {
+        const std::string text = std::to_string((i + t) % 16);
+        if (auto result = cache.Lookup(text); result.has_value()) {
+          EXPECT_EQ(*result, text);
+        } else {
+          cache.Insert(text, text);
+        }
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  const TextResultCacheStats stats = cache.GetStats();
+  EXPECT_EQ(stats.num_hits + stats.num_misses, 400);
+  EXPECT_LE(cache.size(), 8);
+}
+
+}  // namespace
+}  // namespace mediapipe::tasks::text::utils
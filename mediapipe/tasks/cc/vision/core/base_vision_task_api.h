@@ -22,6 +22,7 @@ limitations under the License.
 #include <optional>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -102,6 +103,23 @@ class BaseVisionTaskApi : public tasks::core::BaseTaskApi {
     return runner_->Process(std::move(inputs));
   }
 
+  // A synchronous method to process a batch of independent image inputs,
+  // returning the outputs of each input in order. The images are pipelined
+  // through the graph, which is more efficient than calling ProcessImageData()
+  // on each of them.
+  absl::StatusOr<std::vector<tasks::core::PacketMap>> ProcessImageDataBatch(
+      std::vector<tasks::core::PacketMap> inputs) {
+    if (running_mode_ != RunningMode::IMAGE) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrCat("Task is not initialized with the image mode. Current "
+                       "running mode:",
+                       GetRunningModeName(running_mode_)),
+          MediaPipeTasksStatus::kRunnerApiCalledInWrongModeError);
+    }
+    return runner_->ProcessBatch(std::move(inputs));
+  }
+
   // A synchronous method to process continuous video frames.
   // The call blocks the current thread until a failure status or a successful
   // result is returned.
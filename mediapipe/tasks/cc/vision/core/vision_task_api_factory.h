@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef MEDIAPIPE_TASKS_CC_VISION_CORE_BASE_VISION_TASK_API_FACTORY_H_
 #define MEDIAPIPE_TASKS_CC_VISION_CORE_BASE_VISION_TASK_API_FACTORY_H_
 
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <string>
@@ -49,7 +50,9 @@ class VisionTaskApiFactory {
   static absl::StatusOr<std::unique_ptr<T>> Create(
       CalculatorGraphConfig graph_config,
       std::unique_ptr<tflite::OpResolver> resolver, RunningMode running_mode,
-      tasks::core::PacketsCallback packets_callback = nullptr) {
+      tasks::core::PacketsCallback packets_callback = nullptr,
+      std::function<void(int64_t timestamp_ms)> frame_dropped_callback =
+          nullptr) {
     bool found_task_subgraph = false;
     for (const auto& node : graph_config.node()) {
       if (node.calculator() == "FlowLimiterCalculator") {
@@ -81,6 +84,10 @@ class VisionTaskApiFactory {
           "callback shouldn't be provided.",
           MediaPipeTasksStatus::kInvalidTaskGraphConfigError);
     }
+    tasks::core::TaskApiFactory::ApplyFlowLimiterOptions<Options>(
+        graph_config);
+    packets_callback = tasks::core::TaskApiFactory::AddFrameDroppedCallback(
+        std::move(packets_callback), std::move(frame_dropped_callback));
     ASSIGN_OR_RETURN(auto runner,
                      tasks::core::TaskRunner::Create(
                          std::move(graph_config), std::move(resolver),
@@ -130,7 +130,9 @@ absl::StatusOr<std::unique_ptr<FaceDetector>> FaceDetector::Create(
           std::move(options_proto),
           options->running_mode == core::RunningMode::LIVE_STREAM),
       std::move(options->base_options.op_resolver), options->running_mode,
-      std::move(packets_callback));
+      std::move(packets_callback),
+      std::move(
+          options->base_options.live_stream_options.frame_dropped_callback));
 }
 
 absl::StatusOr<FaceDetectorResult> FaceDetector::Detect(
@@ -117,6 +117,8 @@ ConvertFaceLandmarkerGraphOptionsProto(FaceLandmarkerOptions* options) {
       options_proto->mutable_face_landmarks_detector_graph_options();
   face_landmarks_detector_graph_options->set_min_detection_confidence(
       options->min_face_presence_confidence);
+  face_landmarks_detector_graph_options->set_num_inference_replicas(
+      options->num_inference_replicas);
 
   return options_proto;
 }
@@ -187,7 +189,9 @@ absl::StatusOr<std::unique_ptr<FaceLandmarker>> FaceLandmarker::Create(
           options->output_facial_transformation_matrixes,
           options->running_mode == core::RunningMode::LIVE_STREAM),
       std::move(options->base_options.op_resolver), options->running_mode,
-      std::move(packets_callback));
+      std::move(packets_callback),
+      std::move(
+          options->base_options.live_stream_options.frame_dropped_callback));
 }
 
 absl::StatusOr<FaceLandmarkerResult> FaceLandmarker::Detect(
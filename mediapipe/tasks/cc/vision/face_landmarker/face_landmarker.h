@@ -64,6 +64,12 @@ struct FaceLandmarkerOptions {
   // successful.
   float min_tracking_confidence = 0.5;
 
+  // The number of face landmark model replicas the faces of an image are
+  // distributed across. The replicas each own an interpreter and run
+  // concurrently, at the cost of the memory of the additional interpreters.
+  // Values above `num_faces` are lowered to `num_faces`.
+  int num_inference_replicas = 1;
+
   // Whether FaceLandmarker outputs face blendshapes classification. Face
   // blendshapes are used for rendering the 3D face model.
   bool output_face_blendshapes = false;
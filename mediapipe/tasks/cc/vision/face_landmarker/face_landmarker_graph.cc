@@ -306,6 +306,7 @@ absl::Status SetSubTaskBaseOptions(const ModelAssetBundleResources& resources,
 //       }
 //       face_landmarks_detector_graph_options {
 //         min_detection_confidence: 0.5
+//         num_inference_replicas: 2
 //       }
 //     }
 //   }
@@ -433,9 +434,17 @@ class FaceLandmarkerGraph : public core::ModelTaskGraph {
     auto& face_landmarks_detector_graph = graph.AddNode(
         "mediapipe.tasks.vision.face_landmarker."
         "MultiFaceLandmarksDetectorGraph");
-    face_landmarks_detector_graph
-        .GetOptions<FaceLandmarksDetectorGraphOptions>()
-        .Swap(tasks_options.mutable_face_landmarks_detector_graph_options());
+    auto& face_landmarks_detector_graph_options =
+        face_landmarks_detector_graph
+            .GetOptions<FaceLandmarksDetectorGraphOptions>();
+    face_landmarks_detector_graph_options.Swap(
+        tasks_options.mutable_face_landmarks_detector_graph_options());
+    // Replicas beyond the maximum number of faces would never run.
+    if (face_landmarks_detector_graph_options.num_inference_replicas() >
+        max_num_faces) {
+      face_landmarks_detector_graph_options.set_num_inference_replicas(
+          max_num_faces);
+    }
     image_in >> face_landmarks_detector_graph.In(kImageTag);
     clipped_face_rects >> face_landmarks_detector_graph.In(kNormRectTag);
 
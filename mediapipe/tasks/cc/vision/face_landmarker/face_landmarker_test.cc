@@ -226,6 +226,29 @@ TEST_P(ImageModeTest, Succeeds) {
   MP_ASSERT_OK(face_landmarker->Close());
 }
 
+TEST(FaceLandmarkerTest, SucceedsWithInferenceReplicas) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      Image image, DecodeImageFromFile(file::JoinPath(
+                       "./", kTestDataDirectory, kPortraitImageName)));
+  auto options = std::make_unique<FaceLandmarkerOptions>();
+  options->base_options.model_asset_path = file::JoinPath(
+      "./", kTestDataDirectory, kFaceLandmarkerWithBlendshapesModelBundleName);
+  options->running_mode = core::RunningMode::IMAGE;
+  options->num_faces = 2;
+  // More replicas than faces are lowered to `num_faces`.
+  options->num_inference_replicas = 4;
+
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<FaceLandmarker> face_landmarker,
+                          FaceLandmarker::Create(std::move(options)));
+  MP_ASSERT_OK_AND_ASSIGN(FaceLandmarkerResult actual_result,
+                          face_landmarker->Detect(image));
+  ExpectFaceLandmarkerResultCorrect(
+      actual_result,
+      ConvertToFaceLandmarkerResult({GetExpectedProto<NormalizedLandmarkList>(
+          kPortraitExpectedFaceLandmarksName)}));
+  MP_ASSERT_OK(face_landmarker->Close());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     FaceLandmarkerTest, ImageModeTest,
     Values(
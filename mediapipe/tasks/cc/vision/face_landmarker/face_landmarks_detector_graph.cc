@@ -85,6 +85,7 @@ constexpr char kBlendshapesTag[] = "BLENDSHAPES";
 constexpr char kNormFilteredLandmarksTag[] = "NORM_FILTERED_LANDMARKS";
 constexpr char kSizeTag[] = "SIZE";
 constexpr char kVectorTag[] = "VECTOR";
+constexpr char kChunkTag[] = "CHUNK";
 
 // a landmarks tensor and a scores tensor
 constexpr int kFaceLandmarksOutputTensorsNum = 2;
@@ -386,6 +387,10 @@ REGISTER_MEDIAPIPE_GRAPH(
 //   multiple face landmarks enclosed by the RoIs. Output vectors of
 //   face landmarks related results, where each element in the vectors
 //   corresponds to the result of the same face.
+// - The face rects are processed one after another by a single face landmark
+//   model, unless `num_inference_replicas` is greater than 1, in which case
+//   they are distributed across that many model replicas running
+//   concurrently.
 //
 // Inputs:
 //   IMAGE - Image
@@ -522,56 +527,14 @@ class MultiFaceLandmarksDetectorGraph : public core::ModelTaskGraph {
       proto::FaceLandmarksDetectorGraphOptions& subgraph_options,
       Stream<Image> image_in,
       Stream<std::vector<NormalizedRect>> multi_face_rects, Graph& graph) {
-    auto& face_landmark_subgraph = graph.AddNode(
-        "mediapipe.tasks.vision.face_landmarker."
-        "SingleFaceLandmarksDetectorGraph");
-    face_landmark_subgraph
-        .GetOptions<proto::FaceLandmarksDetectorGraphOptions>()
-        .Swap(&subgraph_options);
-
-    auto& begin_loop_multi_face_rects =
-        graph.AddNode("BeginLoopNormalizedRectCalculator");
-
-    image_in >> begin_loop_multi_face_rects.In(kCloneTag);
-    multi_face_rects >> begin_loop_multi_face_rects.In(kIterableTag);
-    auto batch_end = begin_loop_multi_face_rects.Out(kBatchEndTag);
-    auto image = begin_loop_multi_face_rects.Out(kCloneTag);
-    auto face_rect = begin_loop_multi_face_rects.Out(kItemTag);
-
-    image >> face_landmark_subgraph.In(kImageTag);
-    face_rect >> face_landmark_subgraph.In(kNormRectTag);
-    auto presence = face_landmark_subgraph.Out(kPresenceTag);
-    auto presence_score = face_landmark_subgraph.Out(kPresenceScoreTag);
-    auto face_rect_next_frame =
-        face_landmark_subgraph.Out(kFaceRectNextFrameTag);
-    auto landmarks = face_landmark_subgraph.Out(kNormLandmarksTag);
-
-    auto& end_loop_presence = graph.AddNode("EndLoopBooleanCalculator");
-    batch_end >> end_loop_presence.In(kBatchEndTag);
-    presence >> end_loop_presence.In(kItemTag);
-    auto presences =
-        end_loop_presence.Out(kIterableTag).Cast<std::vector<bool>>();
-
-    auto& end_loop_presence_score = graph.AddNode("EndLoopFloatCalculator");
-    batch_end >> end_loop_presence_score.In(kBatchEndTag);
-    presence_score >> end_loop_presence_score.In(kItemTag);
-    auto presence_scores =
-        end_loop_presence_score.Out(kIterableTag).Cast<std::vector<float>>();
-
-    auto& end_loop_landmarks =
-        graph.AddNode("EndLoopNormalizedLandmarkListVectorCalculator");
-    batch_end >> end_loop_landmarks.In(kBatchEndTag);
-    landmarks >> end_loop_landmarks.In(kItemTag);
+    MultiFaceLandmarksOutputs outs =
+        subgraph_options.num_inference_replicas() > 1
+            ? BuildReplicatedFaceLandmarksDetector(subgraph_options, image_in,
+                                                   multi_face_rects, graph)
+            : BuildFaceLandmarksDetectorReplica(subgraph_options, image_in,
+                                                multi_face_rects, graph);
     Stream<std::vector<NormalizedLandmarkList>> landmark_lists =
-        end_loop_landmarks.Out(kIterableTag)
-            .Cast<std::vector<NormalizedLandmarkList>>();
-
-    auto& end_loop_rects_next_frame =
-        graph.AddNode("EndLoopNormalizedRectCalculator");
-    batch_end >> end_loop_rects_next_frame.In(kBatchEndTag);
-    face_rect_next_frame >> end_loop_rects_next_frame.In(kItemTag);
-    auto face_rects_next_frame = end_loop_rects_next_frame.Out(kIterableTag)
-                                     .Cast<std::vector<NormalizedRect>>();
+        outs.landmarks_lists;
 
     // Apply smoothing filter only on the single face landmarks, because
     // landmarks smoothing calculator doesn't support multiple landmarks yet.
@@ -579,9 +542,7 @@ class MultiFaceLandmarksDetectorGraph : public core::ModelTaskGraph {
     // loop calculator, because the smoothing calculator utilize the timestamp
     // to smoote landmarks across frames but the for loop calculator makes fake
     // timestamps for the streams.
-    if (face_landmark_subgraph
-            .GetOptions<proto::FaceLandmarksDetectorGraphOptions>()
-            .smooth_landmarks()) {
+    if (subgraph_options.smooth_landmarks()) {
       // Get the single face landmarks
       auto& get_vector_item =
           graph.AddNode("GetNormalizedLandmarkListVectorItemCalculator");
@@ -615,9 +576,7 @@ class MultiFaceLandmarksDetectorGraph : public core::ModelTaskGraph {
 
     std::optional<Stream<std::vector<ClassificationList>>>
         face_blendshapes_vector;
-    if (face_landmark_subgraph
-            .GetOptions<proto::FaceLandmarksDetectorGraphOptions>()
-            .has_face_blendshapes_graph_options()) {
+    if (subgraph_options.has_face_blendshapes_graph_options()) {
       auto& begin_loop_multi_face_landmarks =
           graph.AddNode("BeginLoopNormalizedLandmarkListVectorCalculator");
       landmark_lists >> begin_loop_multi_face_landmarks.In(kIterableTag);
@@ -633,9 +592,7 @@ class MultiFaceLandmarksDetectorGraph : public core::ModelTaskGraph {
       auto& face_blendshapes_graph = graph.AddNode(
           "mediapipe.tasks.vision.face_landmarker.FaceBlendshapesGraph");
       face_blendshapes_graph.GetOptions<proto::FaceBlendshapesGraphOptions>()
-          .Swap(face_landmark_subgraph
-                    .GetOptions<proto::FaceLandmarksDetectorGraphOptions>()
-                    .mutable_face_blendshapes_graph_options());
+          .Swap(subgraph_options.mutable_face_blendshapes_graph_options());
       landmarks >> face_blendshapes_graph.In(kLandmarksTag);
       image_size >> face_blendshapes_graph.In(kImageSizeTag);
       auto face_blendshapes = face_blendshapes_graph.Out(kBlendshapesTag)
@@ -650,13 +607,125 @@ class MultiFaceLandmarksDetectorGraph : public core::ModelTaskGraph {
                                  .Cast<std::vector<ClassificationList>>());
     }
 
-    return {{
+    outs.landmarks_lists = landmark_lists;
+    outs.face_blendshapes = face_blendshapes_vector;
+    return outs;
+  }
+
+  // Distributes the face rects across `num_inference_replicas` replicas of the
+  // face landmark model, which run concurrently. The returned outputs have no
+  // face blendshapes.
+  MultiFaceLandmarksOutputs BuildReplicatedFaceLandmarksDetector(
+      const proto::FaceLandmarksDetectorGraphOptions& subgraph_options,
+      Stream<Image> image_in,
+      Stream<std::vector<NormalizedRect>> multi_face_rects, Graph& graph) {
+    // Splits the face rects into one contiguous chunk per replica.
+    auto& split_face_rects =
+        graph.AddNode("SplitNormalizedRectVectorIntoChunksCalculator");
+    multi_face_rects >> split_face_rects.In(kVectorTag);
+
+    // Concatenates the replica results in chunk order, which restores the
+    // order of the face rects.
+    auto& concatenate_landmarks =
+        graph.AddNode("ConcatenateNormalizedLandmarkListVectorCalculator");
+    auto& concatenate_rects_next_frame =
+        graph.AddNode("ConcatenateNormalizedRectVectorCalculator");
+    auto& concatenate_presences =
+        graph.AddNode("ConcatenateBoolVectorCalculator");
+    auto& concatenate_presence_scores =
+        graph.AddNode("ConcatenateFloatVectorCalculator");
+    for (int i = 0; i < subgraph_options.num_inference_replicas(); ++i) {
+      MultiFaceLandmarksOutputs replica_outs =
+          BuildFaceLandmarksDetectorReplica(
+              subgraph_options, image_in,
+              split_face_rects.Out(kChunkTag)[i]
+                  .Cast<std::vector<NormalizedRect>>(),
+              graph);
+      replica_outs.landmarks_lists >> concatenate_landmarks.In("")[i];
+      replica_outs.rects_next_frame >> concatenate_rects_next_frame.In("")[i];
+      replica_outs.presences >> concatenate_presences.In("")[i];
+      replica_outs.presence_scores >> concatenate_presence_scores.In("")[i];
+    }
+
+    return {
+        /* landmarks_lists= */ concatenate_landmarks.Out("")
+            .Cast<std::vector<NormalizedLandmarkList>>(),
+        /* rects_next_frame= */ concatenate_rects_next_frame.Out("")
+            .Cast<std::vector<NormalizedRect>>(),
+        /* presences= */ concatenate_presences.Out("")
+            .Cast<std::vector<bool>>(),
+        /* presence_scores= */ concatenate_presence_scores.Out("")
+            .Cast<std::vector<float>>(),
+        /* face_blendshapes= */ std::nullopt,
+    };
+  }
+
+  // Adds a SingleFaceLandmarksDetectorGraph that runs on each of the face
+  // rects in turn, and collects its results into vectors. The returned outputs
+  // have no face blendshapes.
+  MultiFaceLandmarksOutputs BuildFaceLandmarksDetectorReplica(
+      const proto::FaceLandmarksDetectorGraphOptions& subgraph_options,
+      Stream<Image> image_in,
+      Stream<std::vector<NormalizedRect>> multi_face_rects, Graph& graph) {
+    auto& face_landmark_subgraph = graph.AddNode(
+        "mediapipe.tasks.vision.face_landmarker."
+        "SingleFaceLandmarksDetectorGraph");
+    auto& face_landmark_subgraph_options =
+        face_landmark_subgraph
+            .GetOptions<proto::FaceLandmarksDetectorGraphOptions>();
+    face_landmark_subgraph_options.CopyFrom(subgraph_options);
+    face_landmark_subgraph_options.clear_face_blendshapes_graph_options();
+
+    auto& begin_loop_multi_face_rects =
+        graph.AddNode("BeginLoopNormalizedRectCalculator");
+
+    image_in >> begin_loop_multi_face_rects.In(kCloneTag);
+    multi_face_rects >> begin_loop_multi_face_rects.In(kIterableTag);
+    auto batch_end = begin_loop_multi_face_rects.Out(kBatchEndTag);
+    auto image = begin_loop_multi_face_rects.Out(kCloneTag);
+    auto face_rect = begin_loop_multi_face_rects.Out(kItemTag);
+
+    image >> face_landmark_subgraph.In(kImageTag);
+    face_rect >> face_landmark_subgraph.In(kNormRectTag);
+    auto presence = face_landmark_subgraph.Out(kPresenceTag);
+    auto presence_score = face_landmark_subgraph.Out(kPresenceScoreTag);
+    auto face_rect_next_frame =
+        face_landmark_subgraph.Out(kFaceRectNextFrameTag);
+    auto landmarks = face_landmark_subgraph.Out(kNormLandmarksTag);
+
+    auto& end_loop_presence = graph.AddNode("EndLoopBooleanCalculator");
+    batch_end >> end_loop_presence.In(kBatchEndTag);
+    presence >> end_loop_presence.In(kItemTag);
+    auto presences =
+        end_loop_presence.Out(kIterableTag).Cast<std::vector<bool>>();
+
+    auto& end_loop_presence_score = graph.AddNode("EndLoopFloatCalculator");
+    batch_end >> end_loop_presence_score.In(kBatchEndTag);
+    presence_score >> end_loop_presence_score.In(kItemTag);
+    auto presence_scores =
+        end_loop_presence_score.Out(kIterableTag).Cast<std::vector<float>>();
+
+    auto& end_loop_landmarks =
+        graph.AddNode("EndLoopNormalizedLandmarkListVectorCalculator");
+    batch_end >> end_loop_landmarks.In(kBatchEndTag);
+    landmarks >> end_loop_landmarks.In(kItemTag);
+    auto landmark_lists = end_loop_landmarks.Out(kIterableTag)
+                              .Cast<std::vector<NormalizedLandmarkList>>();
+
+    auto& end_loop_rects_next_frame =
+        graph.AddNode("EndLoopNormalizedRectCalculator");
+    batch_end >> end_loop_rects_next_frame.In(kBatchEndTag);
+    face_rect_next_frame >> end_loop_rects_next_frame.In(kItemTag);
+    auto face_rects_next_frame = end_loop_rects_next_frame.Out(kIterableTag)
+                                     .Cast<std::vector<NormalizedRect>>();
+
+    return {
         /* landmarks_lists= */ landmark_lists,
-        /* face_rects_next_frame= */ face_rects_next_frame,
+        /* rects_next_frame= */ face_rects_next_frame,
         /* presences= */ presences,
         /* presence_scores= */ presence_scores,
-        /* face_blendshapes= */ face_blendshapes_vector,
-    }};
+        /* face_blendshapes= */ std::nullopt,
+    };
   }
 };
 
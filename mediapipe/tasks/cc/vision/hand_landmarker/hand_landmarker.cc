@@ -116,6 +116,8 @@ ConvertHandLandmarkerGraphOptionsProto(HandLandmarkerOptions* options) {
       options_proto->mutable_hand_landmarks_detector_graph_options();
   hand_landmarks_detector_graph_options->set_min_detection_confidence(
       options->min_hand_presence_confidence);
+  hand_landmarks_detector_graph_options->set_num_inference_replicas(
+      options->num_inference_replicas);
 
   return options_proto;
 }
@@ -173,7 +175,9 @@ absl::StatusOr<std::unique_ptr<HandLandmarker>> HandLandmarker::Create(
           std::move(options_proto),
           options->running_mode == core::RunningMode::LIVE_STREAM),
       std::move(options->base_options.op_resolver), options->running_mode,
-      std::move(packets_callback));
+      std::move(packets_callback),
+      std::move(
+          options->base_options.live_stream_options.frame_dropped_callback));
 }
 
 absl::StatusOr<HandLandmarkerResult> HandLandmarker::Detect(
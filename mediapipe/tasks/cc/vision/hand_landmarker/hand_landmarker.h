@@ -67,6 +67,12 @@ struct HandLandmarkerOptions {
   // successful.
   float min_tracking_confidence = 0.5;
 
+  // The number of hand landmark model replicas the hands of an image are
+  // distributed across. The replicas each own an interpreter and run
+  // concurrently, at the cost of the memory of the additional interpreters.
+  // Values above `num_hands` are lowered to `num_hands`.
+  int num_inference_replicas = 1;
+
   // The user-defined result callback for processing live stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::LIVE_STREAM.
@@ -203,6 +203,7 @@ absl::Status SetSubTaskBaseOptions(const ModelAssetBundleResources& resources,
 //              }
 //           }
 //           min_detection_confidence: 0.5
+//           num_inference_replicas: 2
 //       }
 //     }
 //   }
@@ -339,9 +340,17 @@ class HandLandmarkerGraph : public core::ModelTaskGraph {
     auto& hand_landmarks_detector_graph = graph.AddNode(
         "mediapipe.tasks.vision.hand_landmarker."
         "MultipleHandLandmarksDetectorGraph");
-    hand_landmarks_detector_graph
-        .GetOptions<HandLandmarksDetectorGraphOptions>()
-        .CopyFrom(tasks_options.hand_landmarks_detector_graph_options());
+    auto& hand_landmarks_detector_graph_options =
+        hand_landmarks_detector_graph
+            .GetOptions<HandLandmarksDetectorGraphOptions>();
+    hand_landmarks_detector_graph_options.CopyFrom(
+        tasks_options.hand_landmarks_detector_graph_options());
+    // Replicas beyond the maximum number of hands would never run.
+    if (hand_landmarks_detector_graph_options.num_inference_replicas() >
+        max_num_hands) {
+      hand_landmarks_detector_graph_options.set_num_inference_replicas(
+          max_num_hands);
+    }
     image_in >> hand_landmarks_detector_graph.In("IMAGE");
     clipped_hand_rects >> hand_landmarks_detector_graph.In("HAND_RECT");
 
@@ -260,6 +260,28 @@ TEST_P(ImageModeTest, Succeeds) {
   MP_ASSERT_OK(hand_landmarker->Close());
 }
 
+TEST_F(ImageModeTest, SucceedsWithInferenceReplicas) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      Image image,
+      DecodeImageFromFile(JoinPath("./", kTestDataDirectory, kThumbUpImage)));
+  auto options = std::make_unique<HandLandmarkerOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kHandLandmarkerBundleAsset);
+  options->running_mode = core::RunningMode::IMAGE;
+  options->num_hands = 2;
+  // More replicas than hands are lowered to `num_hands`.
+  options->num_inference_replicas = 4;
+
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HandLandmarker> hand_landmarker,
+                          HandLandmarker::Create(std::move(options)));
+  MP_ASSERT_OK_AND_ASSIGN(HandLandmarkerResult hand_landmarker_results,
+                          hand_landmarker->Detect(image));
+  ExpectHandLandmarkerResultsCorrect(
+      hand_landmarker_results,
+      GetExpectedHandLandmarkerResult({kThumbUpLandmarksFilename}));
+  MP_ASSERT_OK(hand_landmarker->Close());
+}
+
 INSTANTIATE_TEST_SUITE_P(
     HandGestureTest, ImageModeTest,
     Values(TestParams{
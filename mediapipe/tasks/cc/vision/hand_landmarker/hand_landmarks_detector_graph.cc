@@ -409,6 +409,10 @@ REGISTER_MEDIAPIPE_GRAPH(
 //   multiple hands landmarks enclosed by the RoIs. Output vectors of
 //   hand landmarks related results, where each element in the vectors
 //   corresponds to the result of the same hand.
+// - The hand rects are processed one after another by a single hand landmark
+//   model, unless `num_inference_replicas` is greater than 1, in which case
+//   they are distributed across that many model replicas running
+//   concurrently.
 //
 // Inputs:
 //   IMAGE - Image
@@ -489,6 +493,71 @@ class MultipleHandLandmarksDetectorGraph : public core::ModelTaskGraph {
       const HandLandmarksDetectorGraphOptions& subgraph_options,
       Source<Image> image_in,
       Source<std::vector<NormalizedRect>> multi_hand_rects, Graph& graph) {
+    const int num_replicas = subgraph_options.num_inference_replicas();
+    if (num_replicas <= 1) {
+      return BuildHandLandmarksDetectorReplica(subgraph_options, image_in,
+                                               multi_hand_rects, graph);
+    }
+
+    // Splits the hand rects into one contiguous chunk per replica, so that the
+    // replicas run their landmark models concurrently.
+    auto& split_hand_rects =
+        graph.AddNode("SplitNormalizedRectVectorIntoChunksCalculator");
+    multi_hand_rects >> split_hand_rects.In("VECTOR");
+
+    // Concatenates the replica results in chunk order, which restores the
+    // order of the hand rects.
+    auto& concatenate_landmarks =
+        graph.AddNode("ConcatenateNormalizedLandmarkListVectorCalculator");
+    auto& concatenate_world_landmarks =
+        graph.AddNode("ConcatenateLandmarkListVectorCalculator");
+    auto& concatenate_rects_next_frame =
+        graph.AddNode("ConcatenateNormalizedRectVectorCalculator");
+    auto& concatenate_presences =
+        graph.AddNode("ConcatenateBoolVectorCalculator");
+    auto& concatenate_presence_scores =
+        graph.AddNode("ConcatenateFloatVectorCalculator");
+    auto& concatenate_handedness =
+        graph.AddNode("ConcatenateClassificationListVectorCalculator");
+    for (int i = 0; i < num_replicas; ++i) {
+      ASSIGN_OR_RETURN(
+          auto replica_outputs,
+          BuildHandLandmarksDetectorReplica(
+              subgraph_options, image_in,
+              split_hand_rects.Out("CHUNK")[i]
+                  .Cast<std::vector<NormalizedRect>>(),
+              graph));
+      replica_outputs.landmark_lists >> concatenate_landmarks.In("")[i];
+      replica_outputs.world_landmark_lists >>
+          concatenate_world_landmarks.In("")[i];
+      replica_outputs.hand_rects_next_frame >>
+          concatenate_rects_next_frame.In("")[i];
+      replica_outputs.presences >> concatenate_presences.In("")[i];
+      replica_outputs.presence_scores >> concatenate_presence_scores.In("")[i];
+      replica_outputs.handedness >> concatenate_handedness.In("")[i];
+    }
+
+    return {{
+        /* landmark_lists= */ concatenate_landmarks
+            [Output<std::vector<NormalizedLandmarkList>>("")],
+        /* world_landmark_lists= */ concatenate_world_landmarks
+            [Output<std::vector<LandmarkList>>("")],
+        /* hand_rects_next_frame= */ concatenate_rects_next_frame
+            [Output<std::vector<NormalizedRect>>("")],
+        /* presences= */ concatenate_presences[Output<std::vector<bool>>("")],
+        /* presence_scores= */ concatenate_presence_scores
+            [Output<std::vector<float>>("")],
+        /* handedness= */ concatenate_handedness
+            [Output<std::vector<ClassificationList>>("")],
+    }};
+  }
+
+  // Adds a SingleHandLandmarksDetectorGraph that runs on each of the hand
+  // rects in turn, and collects its results into vectors.
+  absl::StatusOr<HandLandmarkerOutputs> BuildHandLandmarksDetectorReplica(
+      const HandLandmarksDetectorGraphOptions& subgraph_options,
+      Source<Image> image_in,
+      Source<std::vector<NormalizedRect>> multi_hand_rects, Graph& graph) {
     auto& hand_landmark_subgraph = graph.AddNode(
         "mediapipe.tasks.vision.hand_landmarker."
         "SingleHandLandmarksDetectorGraph");
@@ -151,7 +151,7 @@ absl::StatusOr<std::unique_ptr<TaskRunner>> CreateSingleHandTaskRunner(
 
 // Helper function to create a Multi Hand Landmark TaskRunner.
 absl::StatusOr<std::unique_ptr<TaskRunner>> CreateMultiHandTaskRunner(
-    absl::string_view model_name) {
+    absl::string_view model_name, int num_inference_replicas) {
   Graph graph;
 
   auto& multi_hand_landmark_detection = graph.AddNode(
@@ -161,6 +161,7 @@ absl::StatusOr<std::unique_ptr<TaskRunner>> CreateMultiHandTaskRunner(
   auto options = std::make_unique<HandLandmarksDetectorGraphOptions>();
   options->mutable_base_options()->mutable_model_asset()->set_file_name(
       JoinPath("./", kTestDataDirectory, model_name));
+  options->set_num_inference_replicas(num_inference_replicas);
   multi_hand_landmark_detection.GetOptions<HandLandmarksDetectorGraphOptions>()
       .Swap(options.get());
 
@@ -247,6 +248,8 @@ struct MultiHandTestParams {
   std::vector<ClassificationList> expected_handedness;
   // The max value difference between expected_positions and detected positions.
   float landmarks_diff_threshold;
+  // The number of hand landmark model replicas to run the hand rects on.
+  int num_inference_replicas = 1;
 };
 
 // Helper function to construct NormalizeRect proto.
@@ -309,7 +312,9 @@ TEST_P(MultiHandLandmarkerTest, Succeeds) {
       Image image, DecodeImageFromFile(JoinPath("./", kTestDataDirectory,
                                                 GetParam().test_image_name)));
   MP_ASSERT_OK_AND_ASSIGN(
-      auto task_runner, CreateMultiHandTaskRunner(GetParam().input_model_name));
+      auto task_runner,
+      CreateMultiHandTaskRunner(GetParam().input_model_name,
+                                GetParam().num_inference_replicas));
 
   auto output_packets = task_runner->Process(
       {{kImageName, MakePacket<Image>(std::move(image))},
@@ -460,6 +465,44 @@ INSTANTIATE_TEST_SUITE_P(
             .expected_handedness = {GetExpectedHandedness({"Left"}),
                                     GetExpectedHandedness({"Left"})},
             .landmarks_diff_threshold = kLiteModelFractionDiff,
+        },
+        MultiHandTestParams{
+            .test_name = "MultiHandLandmarkerRightHandsWithReplicas",
+            .input_model_name = kHandLandmarkerLiteModel,
+            .test_image_name = kRightHandsImage,
+            .hand_rects =
+                {
+                    MakeHandRect(0.75, 0.5, 0.5, 1.0, 0),
+                    MakeHandRect(0.25, 0.5, 0.5, 1.0, M_PI),
+                },
+            .expected_presences = {true, true},
+            .expected_landmark_lists =
+                {GetExpectedLandmarkList(kExpectedRightUpHandLandmarksFilename),
+                 GetExpectedLandmarkList(
+                     kExpectedRightDownHandLandmarksFilename)},
+            .expected_handedness = {GetExpectedHandedness({"Right"}),
+                                    GetExpectedHandedness({"Right"})},
+            .landmarks_diff_threshold = kLiteModelFractionDiff,
+            .num_inference_replicas = 2,
+        },
+        MultiHandTestParams{
+            .test_name = "MultiHandLandmarkerLeftHandsWithIdleReplica",
+            .input_model_name = kHandLandmarkerLiteModel,
+            .test_image_name = kLeftHandsImage,
+            .hand_rects =
+                {
+                    MakeHandRect(0.25, 0.5, 0.5, 1.0, 0),
+                    MakeHandRect(0.75, 0.5, 0.5, 1.0, M_PI),
+                },
+            .expected_presences = {true, true},
+            .expected_landmark_lists =
+                {GetExpectedLandmarkList(kExpectedLeftUpHandLandmarksFilename),
+                 GetExpectedLandmarkList(
+                     kExpectedLeftDownHandLandmarksFilename)},
+            .expected_handedness = {GetExpectedHandedness({"Left"}),
+                                    GetExpectedHandedness({"Left"})},
+            .landmarks_diff_threshold = kLiteModelFractionDiff,
+            .num_inference_replicas = 3,
         }),
     [](const TestParamInfo<MultiHandLandmarkerTest::ParamType>& info) {
       return info.param.test_name;
@@ -18,6 +18,7 @@ limitations under the License.
 #include <memory>
 #include <optional>
 #include <utility>
+#include <vector>
 
 #include "absl/status/status.h"
 #include "absl/status/statusor.h"
@@ -143,7 +144,9 @@ absl::StatusOr<std::unique_ptr<ImageClassifier>> ImageClassifier::Create(
           std::move(options_proto),
           options->running_mode == core::RunningMode::LIVE_STREAM),
       std::move(options->base_options.op_resolver), options->running_mode,
-      std::move(packets_callback));
+      std::move(packets_callback),
+      std::move(
+          options->base_options.live_stream_options.frame_dropped_callback));
 }
 
 absl::StatusOr<ImageClassifierResult> ImageClassifier::Classify(
@@ -166,6 +169,36 @@ absl::StatusOr<ImageClassifierResult> ImageClassifier::Classify(
       output_packets[kClassificationsStreamName].Get<ClassificationResult>());
 }
 
+absl::StatusOr<std::vector<ImageClassifierResult>>
+ImageClassifier::ClassifyBatch(
+    std::vector<Image> images,
+    std::optional<core::ImageProcessingOptions> image_processing_options) {
+  std::vector<tasks::core::PacketMap> inputs;
+  inputs.reserve(images.size());
+  for (auto& image : images) {
+    if (image.UsesGpu()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "GPU input images are currently not supported.",
+          MediaPipeTasksStatus::kRunnerUnexpectedInputError);
+    }
+    ASSIGN_OR_RETURN(NormalizedRect norm_rect,
+                     ConvertToNormalizedRect(image_processing_options, image));
+    inputs.push_back(
+        {{kImageInStreamName, MakePacket<Image>(std::move(image))},
+         {kNormRectName, MakePacket<NormalizedRect>(std::move(norm_rect))}});
+  }
+  ASSIGN_OR_RETURN(auto output_packets,
+                   ProcessImageDataBatch(std::move(inputs)));
+  std::vector<ImageClassifierResult> results;
+  results.reserve(output_packets.size());
+  for (auto& packets : output_packets) {
+    results.push_back(ConvertToClassificationResult(
+        packets[kClassificationsStreamName].Get<ClassificationResult>()));
+  }
+  return results;
+}
+
 absl::StatusOr<ImageClassifierResult> ImageClassifier::ClassifyForVideo(
     Image image, int64_t timestamp_ms,
     std::optional<core::ImageProcessingOptions> image_processing_options) {
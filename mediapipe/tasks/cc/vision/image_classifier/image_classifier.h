@@ -19,6 +19,7 @@ limitations under the License.
 #include <functional>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/formats/image.h"
@@ -130,6 +131,21 @@ class ImageClassifier : tasks::vision::core::BaseVisionTaskApi {
       std::optional<core::ImageProcessingOptions> image_processing_options =
           std::nullopt);
 
+  // Performs image classification on the provided batch of independent
+  // images, returning one result per image in the same order. The optional
+  // 'image_processing_options' parameter applies to all the images, as
+  // described in Classify().
+  //
+  // The images are pipelined through the underlying graph, so this is faster
+  // than calling Classify() on each image for offline workloads.
+  //
+  // Only use this method when the ImageClassifier is created with the image
+  // running mode.
+  absl::StatusOr<std::vector<ImageClassifierResult>> ClassifyBatch(
+      std::vector<mediapipe::Image> images,
+      std::optional<core::ImageProcessingOptions> image_processing_options =
+          std::nullopt);
+
   // Performs image classification on the provided video frame.
   //
   // The optional 'image_processing_options' parameter can be used to specify:
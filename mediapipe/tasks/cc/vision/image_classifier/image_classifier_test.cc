@@ -311,6 +311,30 @@ TEST_F(ImageModeTest, SucceedsWithFloatModel) {
   ExpectApproximatelyEqual(results, GenerateBurgerResults());
 }
 
+TEST_F(ImageModeTest, SucceedsWithBatch) {
+  MP_ASSERT_OK_AND_ASSIGN(
+      Image image,
+      DecodeImageFromFile(JoinPath("./", kTestDataDirectory, "burger.jpg")));
+  auto options = std::make_unique<ImageClassifierOptions>();
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kMobileNetFloatWithMetadata);
+  options->classifier_options.max_results = 3;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ImageClassifier> image_classifier,
+                          ImageClassifier::Create(std::move(options)));
+
+  MP_ASSERT_OK_AND_ASSIGN(
+      auto results, image_classifier->ClassifyBatch({image, image, image}));
+
+  ASSERT_EQ(results.size(), 3);
+  for (const auto& result : results) {
+    ExpectApproximatelyEqual(result, GenerateBurgerResults());
+  }
+  // Single and batch calls can be interleaved.
+  MP_ASSERT_OK_AND_ASSIGN(auto result, image_classifier->Classify(image));
+  ExpectApproximatelyEqual(result, GenerateBurgerResults());
+  MP_ASSERT_OK(image_classifier->Close());
+}
+
 TEST_F(ImageModeTest, SucceedsWithQuantizedModel) {
   MP_ASSERT_OK_AND_ASSIGN(
       Image image,
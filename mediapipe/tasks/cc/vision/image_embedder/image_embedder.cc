@@ -16,13 +16,13 @@ limitations under the License.
 #include "mediapipe/tasks/cc/vision/image_embedder/image_embedder.h"
 
 #include <memory>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/formats/rect.pb.h"
 #include "mediapipe/framework/tool/options_map.h"
 #include "mediapipe/tasks/cc/components/containers/embedding_result.h"
-#include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 #include "mediapipe/tasks/cc/components/processors/embedder_options.h"
 #include "mediapipe/tasks/cc/components/processors/proto/embedder_options.pb.h"
 #include "mediapipe/tasks/cc/components/utils/cosine_similarity.h"
@@ -42,8 +42,8 @@ namespace image_embedder {
 
 namespace {
 
-constexpr char kEmbeddingsStreamName[] = "embeddings_out";
-constexpr char kEmbeddingsTag[] = "EMBEDDINGS";
+constexpr char kEmbeddingResultStreamName[] = "embedding_result_out";
+constexpr char kEmbeddingResultTag[] = "EMBEDDING_RESULT";
 constexpr char kImageInStreamName[] = "image_in";
 constexpr char kImageOutStreamName[] = "image_out";
 constexpr char kImageTag[] = "IMAGE";
@@ -55,8 +55,6 @@ constexpr char kGraphTypeName[] =
 constexpr int kMicroSecondsPerMilliSecond = 1000;
 
 using ::mediapipe::NormalizedRect;
-using ::mediapipe::tasks::components::containers::ConvertToEmbeddingResult;
-using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
 using ::mediapipe::tasks::core::PacketMap;
 using ::mediapipe::tasks::vision::image_embedder::proto::
     ImageEmbedderGraphOptions;
@@ -73,13 +71,13 @@ CalculatorGraphConfig CreateGraphConfig(
   graph.In(kNormRectTag).SetName(kNormRectStreamName);
   auto& task_graph = graph.AddNode(kGraphTypeName);
   task_graph.GetOptions<ImageEmbedderGraphOptions>().Swap(options_proto.get());
-  task_graph.Out(kEmbeddingsTag).SetName(kEmbeddingsStreamName) >>
-      graph.Out(kEmbeddingsTag);
+  task_graph.Out(kEmbeddingResultTag).SetName(kEmbeddingResultStreamName) >>
+      graph.Out(kEmbeddingResultTag);
   task_graph.Out(kImageTag).SetName(kImageOutStreamName) >>
       graph.Out(kImageTag);
   if (enable_flow_limiting) {
     return tasks::core::AddFlowLimiterCalculator(
-        graph, task_graph, {kImageTag, kNormRectTag}, kEmbeddingsTag);
+        graph, task_graph, {kImageTag, kNormRectTag}, kEmbeddingResultTag);
   }
   graph.In(kImageTag) >> task_graph.In(kImageTag);
   graph.In(kNormRectTag) >> task_graph.In(kNormRectTag);
@@ -123,10 +121,9 @@ absl::StatusOr<std::unique_ptr<ImageEmbedder>> ImageEmbedder::Create(
             return;
           }
           Packet embedding_result_packet =
-              status_or_packets.value()[kEmbeddingsStreamName];
+              status_or_packets.value()[kEmbeddingResultStreamName];
           Packet image_packet = status_or_packets.value()[kImageOutStreamName];
-          result_callback(ConvertToEmbeddingResult(
-                              embedding_result_packet.Get<EmbeddingResult>()),
+          result_callback(embedding_result_packet.Get<ImageEmbedderResult>(),
                           image_packet.Get<Image>(),
                           embedding_result_packet.Timestamp().Value() /
                               kMicroSecondsPerMilliSecond);
@@ -138,7 +135,9 @@ absl::StatusOr<std::unique_ptr<ImageEmbedder>> ImageEmbedder::Create(
           std::move(options_proto),
           options->running_mode == core::RunningMode::LIVE_STREAM),
       std::move(options->base_options.op_resolver), options->running_mode,
-      std::move(packets_callback));
+      std::move(packets_callback),
+      std::move(
+          options->base_options.live_stream_options.frame_dropped_callback));
 }
 
 absl::StatusOr<ImageEmbedderResult> ImageEmbedder::Embed(
@@ -158,8 +157,37 @@ absl::StatusOr<ImageEmbedderResult> ImageEmbedder::Embed(
           {{kImageInStreamName, MakePacket<Image>(std::move(image))},
            {kNormRectStreamName,
             MakePacket<NormalizedRect>(std::move(norm_rect))}}));
-  return ConvertToEmbeddingResult(
-      output_packets[kEmbeddingsStreamName].Get<EmbeddingResult>());
+  return output_packets[kEmbeddingResultStreamName].Get<ImageEmbedderResult>();
+}
+
+absl::StatusOr<std::vector<ImageEmbedderResult>> ImageEmbedder::EmbedBatch(
+    std::vector<Image> images,
+    std::optional<core::ImageProcessingOptions> image_processing_options) {
+  std::vector<tasks::core::PacketMap> inputs;
+  inputs.reserve(images.size());
+  for (auto& image : images) {
+    if (image.UsesGpu()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "GPU input images are currently not supported.",
+          MediaPipeTasksStatus::kRunnerUnexpectedInputError);
+    }
+    ASSIGN_OR_RETURN(NormalizedRect norm_rect,
+                     ConvertToNormalizedRect(image_processing_options, image));
+    inputs.push_back(
+        {{kImageInStreamName, MakePacket<Image>(std::move(image))},
+         {kNormRectStreamName,
+          MakePacket<NormalizedRect>(std::move(norm_rect))}});
+  }
+  ASSIGN_OR_RETURN(auto output_packets,
+                   ProcessImageDataBatch(std::move(inputs)));
+  std::vector<ImageEmbedderResult> results;
+  results.reserve(output_packets.size());
+  for (auto& packets : output_packets) {
+    results.push_back(
+        packets[kEmbeddingResultStreamName].Get<ImageEmbedderResult>());
+  }
+  return results;
 }
 
 absl::StatusOr<ImageEmbedderResult> ImageEmbedder::EmbedForVideo(
@@ -182,8 +210,7 @@ absl::StatusOr<ImageEmbedderResult> ImageEmbedder::EmbedForVideo(
            {kNormRectStreamName,
             MakePacket<NormalizedRect>(std::move(norm_rect))
                 .At(Timestamp(timestamp_ms * kMicroSecondsPerMilliSecond))}}));
-  return ConvertToEmbeddingResult(
-      output_packets[kEmbeddingsStreamName].Get<EmbeddingResult>());
+  return output_packets[kEmbeddingResultStreamName].Get<ImageEmbedderResult>();
 }
 
 absl::Status ImageEmbedder::EmbedAsync(
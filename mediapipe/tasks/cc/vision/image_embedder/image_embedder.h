@@ -18,6 +18,7 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/formats/image.h"
@@ -111,6 +112,21 @@ class ImageEmbedder : core::BaseVisionTaskApi {
       std::optional<core::ImageProcessingOptions> image_processing_options =
           std::nullopt);
 
+  // Performs embedding extraction on the provided batch of independent images,
+  // returning one result per image in the same order. The optional
+  // 'image_processing_options' parameter applies to all the images, as
+  // described in Embed().
+  //
+  // The images are pipelined through the underlying graph, so this is faster
+  // than calling Embed() on each image for offline workloads.
+  //
+  // Only use this method when the ImageEmbedder is created with the image
+  // running mode.
+  absl::StatusOr<std::vector<ImageEmbedderResult>> EmbedBatch(
+      std::vector<mediapipe::Image> images,
+      std::optional<core::ImageProcessingOptions> image_processing_options =
+          std::nullopt);
+
   // Performs embedding extraction on the provided video frame.
   //
   // The optional 'image_processing_options' parameter can be used to specify:
@@ -13,12 +13,15 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <optional>
+
 #include "absl/status/statusor.h"
 #include "mediapipe/framework/api2/builder.h"
 #include "mediapipe/framework/api2/port.h"
 #include "mediapipe/framework/calculator_framework.h"
 #include "mediapipe/framework/formats/image.h"
 #include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/tasks/cc/components/containers/embedding_result.h"
 #include "mediapipe/tasks/cc/components/containers/proto/embeddings.pb.h"
 #include "mediapipe/tasks/cc/components/processors/embedding_postprocessing_graph.h"
 #include "mediapipe/tasks/cc/components/processors/image_preprocessing_graph.h"
@@ -26,6 +29,7 @@ limitations under the License.
 #include "mediapipe/tasks/cc/components/processors/proto/image_preprocessing_graph_options.pb.h"
 #include "mediapipe/tasks/cc/core/model_task_graph.h"
 #include "mediapipe/tasks/cc/vision/image_embedder/proto/image_embedder_graph_options.pb.h"
+#include "mediapipe/util/graph_builder_utils.h"
 
 namespace mediapipe {
 namespace tasks {
@@ -42,6 +46,7 @@ using ::mediapipe::api2::builder::Graph;
 using ::mediapipe::api2::builder::Source;
 using ::mediapipe::tasks::components::containers::proto::EmbeddingResult;
 
+constexpr char kEmbeddingResultTag[] = "EMBEDDING_RESULT";
 constexpr char kEmbeddingsTag[] = "EMBEDDINGS";
 constexpr char kImageTag[] = "IMAGE";
 constexpr char kNormRectTag[] = "NORM_RECT";
@@ -50,7 +55,9 @@ constexpr char kTensorsTag[] = "TENSORS";
 // Struct holding the different output streams produced by the image embedder
 // graph.
 struct ImageEmbedderOutputStreams {
-  Source<EmbeddingResult> embedding_result;
+  std::optional<Source<EmbeddingResult>> embeddings;
+  std::optional<Source<components::containers::EmbeddingResult>>
+      embedding_result;
   Source<Image> image;
 };
 
@@ -66,8 +73,11 @@ struct ImageEmbedderOutputStreams {
 //     Describes region of image to perform embedding extraction on.
 //     @Optional: rect covering the whole image is used if not specified.
 // Outputs:
-//   EMBEDDINGS - EmbeddingResult
-//     The embedding result.
+//   EMBEDDINGS - EmbeddingResult @Optional
+//     The embedding result, as a proto. Output by default if the
+//     EMBEDDING_RESULT output is not connected.
+//   EMBEDDING_RESULT - components::containers::EmbeddingResult @Optional
+//     The embedding result, as a struct.
 //   IMAGE - Image
 //     The image that embedding extraction runs on.
 //
@@ -98,15 +108,28 @@ class ImageEmbedderGraph : public core::ModelTaskGraph {
     ASSIGN_OR_RETURN(
         const auto* model_resources,
         CreateModelResources<proto::ImageEmbedderGraphOptions>(sc));
+    const bool output_embedding_result =
+        HasOutput(sc->OriginalNode(), kEmbeddingResultTag);
+    const bool output_embeddings =
+        !output_embedding_result ||
+        HasOutput(sc->OriginalNode(), kEmbeddingsTag);
     Graph graph;
     ASSIGN_OR_RETURN(
         auto output_streams,
         BuildImageEmbedderTask(
             sc->Options<proto::ImageEmbedderGraphOptions>(), *model_resources,
             graph[Input<Image>(kImageTag)],
-            graph[Input<NormalizedRect>::Optional(kNormRectTag)], graph));
-    output_streams.embedding_result >>
-        graph[Output<EmbeddingResult>(kEmbeddingsTag)];
+            graph[Input<NormalizedRect>::Optional(kNormRectTag)],
+            output_embeddings, output_embedding_result, graph));
+    if (output_streams.embeddings) {
+      *output_streams.embeddings >>
+          graph[Output<EmbeddingResult>(kEmbeddingsTag)];
+    }
+    if (output_streams.embedding_result) {
+      *output_streams.embedding_result >>
+          graph[Output<components::containers::EmbeddingResult>(
+              kEmbeddingResultTag)];
+    }
     output_streams.image >> graph[Output<Image>(kImageTag)];
     return graph.GetConfig();
   }
@@ -124,11 +147,14 @@ class ImageEmbedderGraph : public core::ModelTaskGraph {
   // image_in: (mediapipe::Image) stream to run embedding extraction on.
   // norm_rect_in: (mediapipe::NormalizedRect) optional region-of-interest to
   // perform embedding extraction on.
+  // output_embeddings: whether to output the EmbeddingResult proto.
+  // output_embedding_result: whether to output the EmbeddingResult struct.
   // graph: the mediapipe builder::Graph instance to be updated.
   absl::StatusOr<ImageEmbedderOutputStreams> BuildImageEmbedderTask(
       const proto::ImageEmbedderGraphOptions& task_options,
       const core::ModelResources& model_resources, Source<Image> image_in,
-      Source<NormalizedRect> norm_rect_in, Graph& graph) {
+      Source<NormalizedRect> norm_rect_in, bool output_embeddings,
+      bool output_embedding_result, Graph& graph) {
     // Adds preprocessing calculators and connects them to the graph input image
     // stream.
     auto& preprocessing = graph.AddNode(
@@ -162,10 +188,19 @@ class ImageEmbedderGraph : public core::ModelTaskGraph {
     inference.Out(kTensorsTag) >> postprocessing.In(kTensorsTag);
 
     // Outputs the embedding results.
-    return ImageEmbedderOutputStreams{
-        /*embedding_result=*/postprocessing[Output<EmbeddingResult>(
-            kEmbeddingsTag)],
+    ImageEmbedderOutputStreams output_streams{
+        /*embeddings=*/std::nullopt, /*embedding_result=*/std::nullopt,
         /*image=*/preprocessing[Output<Image>(kImageTag)]};
+    if (output_embeddings) {
+      output_streams.embeddings =
+          postprocessing[Output<EmbeddingResult>(kEmbeddingsTag)];
+    }
+    if (output_embedding_result) {
+      output_streams.embedding_result =
+          postprocessing[Output<components::containers::EmbeddingResult>(
+              kEmbeddingResultTag)];
+    }
+    return output_streams;
   }
 };
 REGISTER_MEDIAPIPE_GRAPH(
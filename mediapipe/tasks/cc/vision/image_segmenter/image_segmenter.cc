@@ -201,7 +201,9 @@ absl::StatusOr<std::unique_ptr<ImageSegmenter>> ImageSegmenter::Create(
               options->output_category_mask,
               options->running_mode == core::RunningMode::LIVE_STREAM),
           std::move(options->base_options.op_resolver), options->running_mode,
-          std::move(packets_callback));
+          std::move(packets_callback),
+          std::move(options->base_options.live_stream_options
+                        .frame_dropped_callback));
   if (!image_segmenter.ok()) {
     return image_segmenter.status();
   }
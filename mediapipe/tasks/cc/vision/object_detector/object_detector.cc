@@ -55,6 +55,8 @@ constexpr char kNormRectName[] = "norm_rect_in";
 constexpr char kNormRectTag[] = "NORM_RECT";
 constexpr char kSubgraphTypeName[] =
     "mediapipe.tasks.vision.ObjectDetectorGraph";
+constexpr char kTrackingSubgraphTypeName[] =
+    "mediapipe.tasks.vision.ObjectDetectorTrackingGraph";
 constexpr int kMicroSecondsPerMilliSecond = 1000;
 
 using ::mediapipe::NormalizedRect;
@@ -63,7 +65,9 @@ using ObjectDetectorOptionsProto =
     object_detector::proto::ObjectDetectorOptions;
 
 // Creates a MediaPipe graph config that contains a subgraph node of
-// "mediapipe.tasks.vision.ObjectDetectorGraph". If the task is running in the
+// "mediapipe.tasks.vision.ObjectDetectorGraph", or of
+// "mediapipe.tasks.vision.ObjectDetectorTrackingGraph" if the detected objects
+// are tracked between detector runs. If the task is running in the
 // live stream mode, a "FlowLimiterCalculator" will be added to limit the
 // number of frames in flight.
 CalculatorGraphConfig CreateGraphConfig(
@@ -72,7 +76,12 @@ CalculatorGraphConfig CreateGraphConfig(
   api2::builder::Graph graph;
   graph.In(kImageTag).SetName(kImageInStreamName);
   graph.In(kNormRectTag).SetName(kNormRectName);
-  auto& task_subgraph = graph.AddNode(kSubgraphTypeName);
+  // The tracking graph is only linked in with the
+  // ":object_detector_tracking_graph" target.
+  auto& task_subgraph = graph.AddNode(
+      options_proto->has_detection_tracking_options()
+          ? kTrackingSubgraphTypeName
+          : kSubgraphTypeName);
   task_subgraph.GetOptions<ObjectDetectorOptionsProto>().Swap(
       options_proto.get());
   task_subgraph.Out(kDetectionsTag).SetName(kDetectionsOutStreamName) >>
@@ -107,6 +116,15 @@ std::unique_ptr<ObjectDetectorOptionsProto> ConvertObjectDetectorOptionsToProto(
   for (const std::string& category : options->category_denylist) {
     options_proto->add_category_denylist(category);
   }
+  if (options->running_mode != core::RunningMode::IMAGE &&
+      options->detection_tracking_options.detection_interval > 1) {
+    auto* tracking_options =
+        options_proto->mutable_detection_tracking_options();
+    tracking_options->set_detection_interval(
+        options->detection_tracking_options.detection_interval);
+    tracking_options->set_min_tracking_confidence(
+        options->detection_tracking_options.min_tracking_confidence);
+  }
   return options_proto;
 }
 
@@ -153,7 +171,9 @@ absl::StatusOr<std::unique_ptr<ObjectDetector>> ObjectDetector::Create(
           std::move(options_proto),
           options->running_mode == core::RunningMode::LIVE_STREAM),
       std::move(options->base_options.op_resolver), options->running_mode,
-      std::move(packets_callback));
+      std::move(packets_callback),
+      std::move(
+          options->base_options.live_stream_options.frame_dropped_callback));
 }
 
 absl::StatusOr<ObjectDetectorResult> ObjectDetector::Detect(
@@ -180,6 +200,40 @@ absl::StatusOr<ObjectDetectorResult> ObjectDetector::Detect(
       output_packets[kDetectionsOutStreamName].Get<std::vector<Detection>>());
 }
 
+absl::StatusOr<std::vector<ObjectDetectorResult>> ObjectDetector::DetectBatch(
+    std::vector<mediapipe::Image> images,
+    std::optional<core::ImageProcessingOptions> image_processing_options) {
+  std::vector<tasks::core::PacketMap> inputs;
+  inputs.reserve(images.size());
+  for (auto& image : images) {
+    if (image.UsesGpu()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          absl::StrCat("GPU input images are currently not supported."),
+          MediaPipeTasksStatus::kRunnerUnexpectedInputError);
+    }
+    ASSIGN_OR_RETURN(NormalizedRect norm_rect,
+                     ConvertToNormalizedRect(image_processing_options, image,
+                                             /*roi_allowed=*/false));
+    inputs.push_back(
+        {{kImageInStreamName, MakePacket<Image>(std::move(image))},
+         {kNormRectName, MakePacket<NormalizedRect>(std::move(norm_rect))}});
+  }
+  ASSIGN_OR_RETURN(auto output_packets,
+                   ProcessImageDataBatch(std::move(inputs)));
+  std::vector<ObjectDetectorResult> results;
+  results.reserve(output_packets.size());
+  for (auto& packets : output_packets) {
+    if (packets[kDetectionsOutStreamName].IsEmpty()) {
+      results.push_back(ConvertToDetectionResult({}));
+      continue;
+    }
+    results.push_back(ConvertToDetectionResult(
+        packets[kDetectionsOutStreamName].Get<std::vector<Detection>>()));
+  }
+  return results;
+}
+
 absl::StatusOr<ObjectDetectorResult> ObjectDetector::DetectForVideo(
     mediapipe::Image image, int64_t timestamp_ms,
     std::optional<core::ImageProcessingOptions> image_processing_options) {
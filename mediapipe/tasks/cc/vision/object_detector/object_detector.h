@@ -81,6 +81,21 @@ struct ObjectDetectorOptions {
   // category names are ignored. Mutually exclusive with category_allowlist.
   std::vector<std::string> category_denylist = {};
 
+  // Options for tracking the detected objects between detector runs. Only used
+  // in the video and live stream modes, and requires depending on the
+  // ":object_detector_tracking_graph" target of this package.
+  struct DetectionTrackingOptions {
+    // The detector runs at least once every `detection_interval` frames, the
+    // detected objects being tracked on the frames in between. The default of 1
+    // runs the detector on every frame.
+    int detection_interval = 1;
+
+    // The detector also runs on the frame following one where no object was
+    // tracked, or a tracked object has a tracking confidence below this
+    // threshold, in [0, 1].
+    float min_tracking_confidence = 0.5f;
+  } detection_tracking_options;
+
   // The user-defined result callback for processing live stream data.
   // The result callback should only be specified when the running mode is set
   // to RunningMode::LIVE_STREAM.
@@ -187,6 +202,21 @@ class ObjectDetector : public tasks::vision::core::BaseVisionTaskApi {
       std::optional<core::ImageProcessingOptions> image_processing_options =
           std::nullopt);
 
+  // Performs object detection on the provided batch of independent images,
+  // returning one result per image in the same order. The optional
+  // 'image_processing_options' parameter applies to all the images, as
+  // described in Detect().
+  //
+  // The images are pipelined through the underlying graph, so this is faster
+  // than calling Detect() on each image for offline workloads.
+  //
+  // Only use this method when the ObjectDetector is created with the image
+  // running mode.
+  absl::StatusOr<std::vector<ObjectDetectorResult>> DetectBatch(
+      std::vector<mediapipe::Image> images,
+      std::optional<core::ImageProcessingOptions> image_processing_options =
+          std::nullopt);
+
   // Performs object detection on the provided video frame.
   // Only use this method when the ObjectDetector is created with the video
   // running mode.
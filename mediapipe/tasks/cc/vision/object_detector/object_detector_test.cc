@@ -15,7 +15,9 @@ limitations under the License.
 
 #include "mediapipe/tasks/cc/vision/object_detector/object_detector.h"
 
+#include <algorithm>
 #include <cmath>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <string>
@@ -737,6 +739,49 @@ TEST_F(VideoModeTest, Succeeds) {
   MP_ASSERT_OK(object_detector->Close());
 }
 
+// Requires the ":object_detector_tracking_graph" target.
+TEST_F(VideoModeTest, SucceedsWithDetectionTracking) {
+  int iterations = 20;
+  MP_ASSERT_OK_AND_ASSIGN(Image image, DecodeImageFromFile(JoinPath(
+                                           "./", kTestDataDirectory,
+                                           "cats_and_dogs_no_resizing.jpg")));
+  auto options = std::make_unique<ObjectDetectorOptions>();
+  options->max_results = 2;
+  options->running_mode = core::RunningMode::VIDEO;
+  options->base_options.model_asset_path =
+      JoinPath("./", kTestDataDirectory, kMobileSsdWithMetadata);
+  options->detection_tracking_options.detection_interval = 5;
+  options->detection_tracking_options.min_tracking_confidence = 0.0f;
+  MP_ASSERT_OK_AND_ASSIGN(std::unique_ptr<ObjectDetector> object_detector,
+                          ObjectDetector::Create(std::move(options)));
+  const ObjectDetectorResult expected_results = ConvertToDetectionResult(
+      GenerateMobileSsdNoImageResizingFullExpectedResults());
+  for (int i = 0; i < iterations; ++i) {
+    MP_ASSERT_OK_AND_ASSIGN(auto results,
+                            object_detector->DetectForVideo(image, i));
+    // The objects are static, so tracking them must keep them in place.
+    ASSERT_EQ(results.detections.size(), 2);
+    for (const auto& detection : results.detections) {
+      ASSERT_EQ(detection.categories.size(), 1);
+      EXPECT_EQ(detection.categories[0].category_name, "cat");
+      const bool matches_expected_box = std::any_of(
+          expected_results.detections.begin(),
+          expected_results.detections.end(), [&](const auto& expected) {
+            return std::abs(detection.bounding_box.left -
+                            expected.bounding_box.left) <= 2 &&
+                   std::abs(detection.bounding_box.top -
+                            expected.bounding_box.top) <= 2 &&
+                   std::abs(detection.bounding_box.right -
+                            expected.bounding_box.right) <= 2 &&
+                   std::abs(detection.bounding_box.bottom -
+                            expected.bounding_box.bottom) <= 2;
+          });
+      EXPECT_TRUE(matches_expected_box) << "frame " << i;
+    }
+  }
+  MP_ASSERT_OK(object_detector->Close());
+}
+
 class LiveStreamModeTest : public tflite::testing::Test {};
 
 TEST_F(LiveStreamModeTest, FailsWithCallingWrongMethod) {
@@ -0,0 +1,183 @@
+/* Copyright 2023 The MediaPipe Authors.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <vector>
+
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "mediapipe/framework/api2/builder.h"
+#include "mediapipe/framework/api2/port.h"
+#include "mediapipe/framework/calculator.pb.h"
+#include "mediapipe/framework/calculator_framework.h"
+#include "mediapipe/framework/formats/detection.pb.h"
+#include "mediapipe/framework/formats/image.h"
+#include "mediapipe/framework/formats/rect.pb.h"
+#include "mediapipe/tasks/cc/common.h"
+#include "mediapipe/tasks/cc/components/processors/detection_tracking_graph.h"
+#include "mediapipe/tasks/cc/components/processors/proto/detection_tracking_graph_options.pb.h"
+#include "mediapipe/tasks/cc/vision/object_detector/proto/object_detector_options.pb.h"
+#include "mediapipe/util/graph_builder_utils.h"
+
+namespace mediapipe {
+namespace tasks {
+namespace vision {
+
+namespace {
+
+using ::mediapipe::NormalizedRect;
+using ::mediapipe::api2::Input;
+using ::mediapipe::api2::Output;
+using ::mediapipe::api2::builder::Graph;
+using ::mediapipe::api2::builder::Source;
+using ::mediapipe::tasks::components::processors::proto::
+    DetectionTrackingGraphOptions;
+using ObjectDetectorOptionsProto =
+    object_detector::proto::ObjectDetectorOptions;
+
+constexpr char kDetectionsTag[] = "DETECTIONS";
+constexpr char kDetectorImageTag[] = "DETECTOR_IMAGE";
+constexpr char kDetectorNormRectTag[] = "DETECTOR_NORM_RECT";
+constexpr char kImageSizeTag[] = "IMAGE_SIZE";
+constexpr char kImageTag[] = "IMAGE";
+constexpr char kNormRectTag[] = "NORM_RECT";
+constexpr char kPixelDetectionsTag[] = "PIXEL_DETECTIONS";
+constexpr char kRelativeDetectionsTag[] = "RELATIVE_DETECTIONS";
+constexpr char kSizeTag[] = "SIZE";
+
+}  // namespace
+
+// An "ObjectDetectorTrackingGraph" performs object detection on a subset of
+// the frames of a video stream, and tracks the detected objects on the other
+// frames. It runs an ObjectDetectorGraph inside a DetectionTrackingGraph, as
+// configured by the `detection_tracking_options` of its options, and has the
+// same inputs, outputs and options as the ObjectDetectorGraph otherwise. It
+// must be used in stream mode.
+//
+// Inputs:
+//   IMAGE - Image
+//     Image to perform detection on.
+//   NORM_RECT - NormalizedRect @Optional
+//     Describes image rotation and region of image to perform detection
+//     on.
+//     @Optional: rect covering the whole image is used if not specified.
+//
+// Outputs:
+//   DETECTIONS - std::vector<Detection>
+//     Detected or tracked objects with bounding box in pixel units.
+//   IMAGE - mediapipe::Image
+//     The input image.
+//
+// Example:
+// node {
+//   calculator: "mediapipe.tasks.vision.ObjectDetectorTrackingGraph"
+//   input_stream: "IMAGE:image_in"
+//   output_stream: "DETECTIONS:detections_out"
+//   output_stream: "IMAGE:image_out"
+//   options {
+//     [mediapipe.tasks.vision.object_detector.proto.ObjectDetectorOptions.ext]
+//     {
+//       base_options {
+//         model_asset {
+//           file_name: "/path/to/model.tflite"
+//         }
+//         use_stream_mode: true
+//       }
+//       max_results: 4
+//       detection_tracking_options {
+//         detection_interval: 5
+//       }
+//     }
+//   }
+// }
+class ObjectDetectorTrackingGraph : public Subgraph {
+ public:
+  absl::StatusOr<CalculatorGraphConfig> GetConfig(
+      SubgraphContext* sc) override {
+    const auto& task_options = sc->Options<ObjectDetectorOptionsProto>();
+    if (!task_options.base_options().use_stream_mode()) {
+      return CreateStatusWithPayload(
+          absl::StatusCode::kInvalidArgument,
+          "Detection tracking is only supported in the video and live stream "
+          "modes.",
+          MediaPipeTasksStatus::kInvalidArgumentError);
+    }
+    Graph graph;
+    Source<Image> image_in = graph[Input<Image>(kImageTag)];
+
+    auto& detector =
+        graph.AddNode("mediapipe.tasks.vision.ObjectDetectorGraph");
+    auto& detector_options = detector.GetOptions<ObjectDetectorOptionsProto>();
+    detector_options.CopyFrom(task_options);
+    detector_options.clear_detection_tracking_options();
+
+    if (!components::processors::IsDetectionTrackingEnabled(
+            task_options.detection_tracking_options())) {
+      image_in >> detector.In(kImageTag);
+      if (HasInput(sc->OriginalNode(), kNormRectTag)) {
+        graph[Input<NormalizedRect>(kNormRectTag)] >>
+            detector.In(kNormRectTag);
+      }
+      detector.Out(kDetectionsTag) >>
+          graph[Output<std::vector<Detection>>(kDetectionsTag)];
+      detector.Out(kImageTag) >> graph[Output<Image>(kImageTag)];
+      return graph.GetConfig();
+    }
+
+    // Adds the detection tracking graph, which only forwards the frames the
+    // detector runs on.
+    auto& tracking = graph.AddNode(
+        "mediapipe.tasks.components.processors.DetectionTrackingGraph");
+    tracking.GetOptions<DetectionTrackingGraphOptions>().CopyFrom(
+        task_options.detection_tracking_options());
+    image_in >> tracking.In(kImageTag);
+    tracking.Out(kDetectorImageTag) >> detector.In(kImageTag);
+    if (HasInput(sc->OriginalNode(), kNormRectTag)) {
+      graph[Input<NormalizedRect>(kNormRectTag)] >> tracking.In(kNormRectTag);
+      tracking.Out(kDetectorNormRectTag) >> detector.In(kNormRectTag);
+    }
+
+    auto& image_properties = graph.AddNode("ImagePropertiesCalculator");
+    image_in >> image_properties.In(kImageTag);
+    auto image_size = image_properties.Out(kSizeTag);
+
+    // The objects are tracked with relative bounding boxes.
+    auto& relative_transformation =
+        graph.AddNode("DetectionTransformationCalculator");
+    detector.Out(kDetectionsTag) >>
+        relative_transformation.In(kDetectionsTag);
+    image_size >> relative_transformation.In(kImageSizeTag);
+    relative_transformation.Out(kRelativeDetectionsTag) >>
+        tracking.In(kDetectionsTag);
+
+    auto& pixel_transformation =
+        graph.AddNode("DetectionTransformationCalculator");
+    tracking.Out(kDetectionsTag) >> pixel_transformation.In(kDetectionsTag);
+    image_size >> pixel_transformation.In(kImageSizeTag);
+    pixel_transformation.Out(kPixelDetectionsTag) >>
+        graph[Output<std::vector<Detection>>(kDetectionsTag)];
+    image_in >> graph[Output<Image>(kImageTag)];
+    return graph.GetConfig();
+  }
+};
+
+// REGISTER_MEDIAPIPE_GRAPH argument has to fit on one line to work properly.
+// clang-format off
+REGISTER_MEDIAPIPE_GRAPH(
+  ::mediapipe::tasks::vision::ObjectDetectorTrackingGraph); // NOLINT
+// clang-format on
+
+}  // namespace vision
+}  // namespace tasks
+}  // namespace mediapipe
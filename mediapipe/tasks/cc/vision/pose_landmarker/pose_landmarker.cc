@@ -183,7 +183,9 @@ absl::StatusOr<std::unique_ptr<PoseLandmarker>> PoseLandmarker::Create(
               options->running_mode == core::RunningMode::LIVE_STREAM,
               options->output_segmentation_masks),
           std::move(options->base_options.op_resolver), options->running_mode,
-          std::move(packets_callback))));
+          std::move(packets_callback),
+          std::move(options->base_options.live_stream_options
+                        .frame_dropped_callback))));
 
   pose_landmarker->output_segmentation_masks_ =
       options->output_segmentation_masks;
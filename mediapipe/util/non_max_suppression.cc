@@ -0,0 +1,441 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/non_max_suppression.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "absl/log/absl_check.h"
+#include "absl/types/span.h"
+#include "mediapipe/framework/port/rectangle.h"
+
+namespace mediapipe {
+namespace {
+
+// Greedy suppression only bins the retained boxes for at least this many
+// candidates. Below that, comparing against all retained boxes is cheaper.
+constexpr int kMinBoxesForBinning = 64;
+// Maximum number of grid cells along each axis.
+constexpr int kMaxGridSize = 32;
+
+// Boxes in structure-of-arrays layout.
+struct BoxArrays {
+  BoxArrays() = default;
+  explicit BoxArrays(absl::Span<const Rectangle_f> boxes) {
+    Reserve(boxes.size());
+    for (const auto& box : boxes) {
+      Add(box.xmin(), box.ymin(), box.xmax(), box.ymax());
+    }
+  }
+
+  void Reserve(int size) {
+    xmin.reserve(size);
+    ymin.reserve(size);
+    xmax.reserve(size);
+    ymax.reserve(size);
+  }
+
+  void Add(float box_xmin, float box_ymin, float box_xmax, float box_ymax) {
+    xmin.push_back(box_xmin);
+    ymin.push_back(box_ymin);
+    xmax.push_back(box_xmax);
+    ymax.push_back(box_ymax);
+  }
+
+  // Appends box `i` of `boxes`.
+  void Add(const BoxArrays& boxes, int i) {
+    Add(boxes.xmin[i], boxes.ymin[i], boxes.xmax[i], boxes.ymax[i]);
+  }
+
+  void Clear() {
+    xmin.clear();
+    ymin.clear();
+    xmax.clear();
+    ymax.clear();
+  }
+
+  int size() const { return xmin.size(); }
+
+  bool IsEmpty(int i) const { return xmin[i] > xmax[i] || ymin[i] > ymax[i]; }
+
+  std::vector<float> xmin;
+  std::vector<float> ymin;
+  std::vector<float> xmax;
+  std::vector<float> ymax;
+};
+
+// Computes the same value as the Rectangle_f based OverlapSimilarity, for
+// boxes a (rect1) and b (rect2).
+inline float Overlap(NmsOverlapType overlap_type, float a_xmin, float a_ymin,
+                     float a_xmax, float a_ymax, float b_xmin, float b_ymin,
+                     float b_xmax, float b_ymax) {
+  // Same as !Rectangle_f::Intersects.
+  if (a_xmin > a_xmax || a_ymin > a_ymax || b_xmin > b_xmax ||
+      b_ymin > b_ymax || b_xmax < a_xmin || a_xmax < b_xmin ||
+      b_ymax < a_ymin || a_ymax < b_ymin) {
+    return 0.0f;
+  }
+  const float intersection_area =
+      (std::min(a_xmax, b_xmax) - std::max(a_xmin, b_xmin)) *
+      (std::min(a_ymax, b_ymax) - std::max(a_ymin, b_ymin));
+  float normalization = 0.0f;
+  switch (overlap_type) {
+    case NmsOverlapType::kJaccard:
+      normalization = (std::max(a_xmax, b_xmax) - std::min(a_xmin, b_xmin)) *
+                      (std::max(a_ymax, b_ymax) - std::min(a_ymin, b_ymin));
+      break;
+    case NmsOverlapType::kModifiedJaccard:
+      normalization = (b_xmax - b_xmin) * (b_ymax - b_ymin);
+      break;
+    case NmsOverlapType::kIntersectionOverUnion:
+      normalization = (a_xmax - a_xmin) * (a_ymax - a_ymin) +
+                      (b_xmax - b_xmin) * (b_ymax - b_ymin) -
+                      intersection_area;
+      break;
+  }
+  return normalization > 0.0f ? intersection_area / normalization : 0.0f;
+}
+
+// Computes Overlap(boxes[i], b) for every box of `boxes` into `overlaps`.
+// The overlap type is a template argument and the loop body only uses
+// selects, so that the compiler can vectorize the loop over the contiguous
+// coordinate arrays.
+template <NmsOverlapType kOverlapType>
+void ComputeOverlaps(const BoxArrays& boxes, float b_xmin, float b_ymin,
+                     float b_xmax, float b_ymax, float* overlaps) {
+  const int num_boxes = boxes.size();
+  if (b_xmin > b_xmax || b_ymin > b_ymax) {
+    std::fill(overlaps, overlaps + num_boxes, 0.0f);
+    return;
+  }
+  const float* a_xmins = boxes.xmin.data();
+  const float* a_ymins = boxes.ymin.data();
+  const float* a_xmaxs = boxes.xmax.data();
+  const float* a_ymaxs = boxes.ymax.data();
+  const float b_area = (b_xmax - b_xmin) * (b_ymax - b_ymin);
+  for (int i = 0; i < num_boxes; ++i) {
+    const float a_xmin = a_xmins[i];
+    const float a_ymin = a_ymins[i];
+    const float a_xmax = a_xmaxs[i];
+    const float a_ymax = a_ymaxs[i];
+    // The intersection is empty, and clamped to zero, if box a is empty or
+    // doesn't intersect box b, so there's no need to check for that
+    // separately.
+    const float width = std::max(
+        std::min(a_xmax, b_xmax) - std::max(a_xmin, b_xmin), 0.0f);
+    const float height = std::max(
+        std::min(a_ymax, b_ymax) - std::max(a_ymin, b_ymin), 0.0f);
+    const float intersection_area = width * height;
+    float normalization;
+    if constexpr (kOverlapType == NmsOverlapType::kJaccard) {
+      normalization = (std::max(a_xmax, b_xmax) - std::min(a_xmin, b_xmin)) *
+                      (std::max(a_ymax, b_ymax) - std::min(a_ymin, b_ymin));
+    } else if constexpr (kOverlapType == NmsOverlapType::kModifiedJaccard) {
+      normalization = b_area;
+    } else {
+      normalization =
+          (a_xmax - a_xmin) * (a_ymax - a_ymin) + b_area - intersection_area;
+    }
+    // Divides unconditionally, by 1 if the result is unused, so that the
+    // division can be executed for all the lanes.
+    const bool positive = normalization > 0.0f;
+    const float overlap =
+        intersection_area / (positive ? normalization : 1.0f);
+    overlaps[i] = positive ? overlap : 0.0f;
+  }
+}
+
+void ComputeOverlaps(NmsOverlapType overlap_type, const BoxArrays& boxes,
+                     float b_xmin, float b_ymin, float b_xmax, float b_ymax,
+                     float* overlaps) {
+  switch (overlap_type) {
+    case NmsOverlapType::kJaccard:
+      ComputeOverlaps<NmsOverlapType::kJaccard>(boxes, b_xmin, b_ymin, b_xmax,
+                                                b_ymax, overlaps);
+      break;
+    case NmsOverlapType::kModifiedJaccard:
+      ComputeOverlaps<NmsOverlapType::kModifiedJaccard>(
+          boxes, b_xmin, b_ymin, b_xmax, b_ymax, overlaps);
+      break;
+    case NmsOverlapType::kIntersectionOverUnion:
+      ComputeOverlaps<NmsOverlapType::kIntersectionOverUnion>(
+          boxes, b_xmin, b_ymin, b_xmax, b_ymax, overlaps);
+      break;
+  }
+}
+
+// Boxes and classes stored contiguously, against which a candidate box is
+// compared at once.
+struct BoxBin {
+  void Add(const BoxArrays& all_boxes, absl::Span<const int> all_classes,
+           int index) {
+    boxes.Add(all_boxes, index);
+    if (!all_classes.empty()) classes.push_back(all_classes[index]);
+  }
+
+  BoxArrays boxes;
+  std::vector<int> classes;
+};
+
+// Returns the indices of `scores` by decreasing score, keeping the index
+// order for equal scores.
+std::vector<int> SortByDecreasingScore(absl::Span<const float> scores) {
+  std::vector<int> order(scores.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(),
+                   [&scores](int a, int b) { return scores[a] > scores[b]; });
+  return order;
+}
+
+void CheckInput(const NmsInput& input, const NmsOptions& options) {
+  ABSL_CHECK_EQ(input.boxes.size(), input.scores.size());
+  if (options.class_aware) {
+    ABSL_CHECK_EQ(input.boxes.size(), input.classes.size());
+  }
+}
+
+// The boxes retained by greedy suppression. If enabled, they are binned into
+// a uniform grid spanning all the input boxes, so that a candidate is only
+// compared against retained boxes sharing a grid cell with it.
+class RetainedBoxes {
+ public:
+  RetainedBoxes(const NmsInput& input, const NmsOptions& options)
+      : input_(input), options_(options), boxes_(input.boxes) {
+    MaybeInitGrid();
+  }
+
+  // Returns true if box `index` overlaps with a retained box.
+  bool Suppresses(int index) const {
+    if (grid_size_ == 0) return Suppresses(retained_, index);
+    int x0, y0, x1, y1;
+    if (!GetCellRange(index, &x0, &y0, &x1, &y1)) return false;
+    for (int y = y0; y <= y1; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        if (Suppresses(cells_[y * grid_size_ + x], index)) return true;
+      }
+    }
+    return false;
+  }
+
+  void Add(int index) {
+    const absl::Span<const int> classes =
+        options_.class_aware ? input_.classes : absl::Span<const int>();
+    if (grid_size_ == 0) {
+      retained_.Add(boxes_, classes, index);
+      return;
+    }
+    int x0, y0, x1, y1;
+    if (!GetCellRange(index, &x0, &y0, &x1, &y1)) return;
+    for (int y = y0; y <= y1; ++y) {
+      for (int x = x0; x <= x1; ++x) {
+        cells_[y * grid_size_ + x].Add(boxes_, classes, index);
+      }
+    }
+  }
+
+ private:
+  // Returns true if box `index` overlaps with a box of `bin`.
+  bool Suppresses(const BoxBin& bin, int index) const {
+    const int num_boxes = bin.boxes.size();
+    if (num_boxes == 0) return false;
+    overlaps_.resize(num_boxes);
+    ComputeOverlaps(options_.overlap_type, bin.boxes, boxes_.xmin[index],
+                    boxes_.ymin[index], boxes_.xmax[index],
+                    boxes_.ymax[index], overlaps_.data());
+    const float threshold = options_.min_suppression_threshold;
+    bool suppressed = false;
+    if (options_.class_aware) {
+      const int box_class = input_.classes[index];
+      for (int i = 0; i < num_boxes; ++i) {
+        suppressed |=
+            (overlaps_[i] > threshold) & (bin.classes[i] == box_class);
+      }
+    } else {
+      for (int i = 0; i < num_boxes; ++i) {
+        suppressed |= overlaps_[i] > threshold;
+      }
+    }
+    return suppressed;
+  }
+
+  void MaybeInitGrid() {
+    const int num_boxes = input_.boxes.size();
+    // Binning relies on non-intersecting boxes never suppressing each other,
+    // i.e. on their zero overlap not exceeding the threshold.
+    if (num_boxes < kMinBoxesForBinning ||
+        options_.min_suppression_threshold < 0.0f) {
+      return;
+    }
+    float xmin = 0.0f, ymin = 0.0f, xmax = 0.0f, ymax = 0.0f;
+    bool has_box = false;
+    for (int i = 0; i < num_boxes; ++i) {
+      if (!std::isfinite(boxes_.xmin[i]) || !std::isfinite(boxes_.ymin[i]) ||
+          !std::isfinite(boxes_.xmax[i]) || !std::isfinite(boxes_.ymax[i])) {
+        return;
+      }
+      if (boxes_.IsEmpty(i)) continue;
+      xmin = has_box ? std::min(xmin, boxes_.xmin[i]) : boxes_.xmin[i];
+      ymin = has_box ? std::min(ymin, boxes_.ymin[i]) : boxes_.ymin[i];
+      xmax = has_box ? std::max(xmax, boxes_.xmax[i]) : boxes_.xmax[i];
+      ymax = has_box ? std::max(ymax, boxes_.ymax[i]) : boxes_.ymax[i];
+      has_box = true;
+    }
+    if (!has_box || xmax <= xmin || ymax <= ymin) return;
+    grid_size_ = std::clamp(
+        static_cast<int>(std::sqrt(static_cast<float>(num_boxes)) / 2), 1,
+        kMaxGridSize);
+    origin_x_ = xmin;
+    origin_y_ = ymin;
+    x_scale_ = grid_size_ / (xmax - xmin);
+    y_scale_ = grid_size_ / (ymax - ymin);
+    cells_.resize(grid_size_ * grid_size_);
+  }
+
+  int Cell(float value, float origin, float scale) const {
+    return std::min(static_cast<int>((value - origin) * scale), grid_size_ - 1);
+  }
+
+  // Gets the range of cells covered by box `index`. Returns false if the box
+  // is empty, as it can't intersect any other box.
+  bool GetCellRange(int index, int* x0, int* y0, int* x1, int* y1) const {
+    if (boxes_.IsEmpty(index)) return false;
+    *x0 = Cell(boxes_.xmin[index], origin_x_, x_scale_);
+    *y0 = Cell(boxes_.ymin[index], origin_y_, y_scale_);
+    *x1 = Cell(boxes_.xmax[index], origin_x_, x_scale_);
+    *y1 = Cell(boxes_.ymax[index], origin_y_, y_scale_);
+    return true;
+  }
+
+  const NmsInput& input_;
+  const NmsOptions& options_;
+  const BoxArrays boxes_;
+
+  // Retained boxes if binning is disabled.
+  BoxBin retained_;
+
+  // Number of cells along each axis, or 0 if binning is disabled.
+  int grid_size_ = 0;
+  float origin_x_ = 0.0f;
+  float origin_y_ = 0.0f;
+  float x_scale_ = 0.0f;
+  float y_scale_ = 0.0f;
+  // Retained boxes covering each cell, in row-major order.
+  std::vector<BoxBin> cells_;
+  // Scratch buffer for the overlaps with the boxes of a bin.
+  mutable std::vector<float> overlaps_;
+};
+
+}  // namespace
+
+float OverlapSimilarity(NmsOverlapType overlap_type, const Rectangle_f& rect1,
+                        const Rectangle_f& rect2) {
+  return Overlap(overlap_type, rect1.xmin(), rect1.ymin(), rect1.xmax(),
+                 rect1.ymax(), rect2.xmin(), rect2.ymin(), rect2.xmax(),
+                 rect2.ymax());
+}
+
+std::vector<int> NonMaxSuppression(const NmsInput& input,
+                                   const NmsOptions& options) {
+  CheckInput(input, options);
+  std::vector<int> retained;
+  const int num_boxes = input.boxes.size();
+  const int max_num_detections = options.max_num_detections < 0
+                                     ? num_boxes
+                                     : options.max_num_detections;
+  if (num_boxes == 0 || max_num_detections == 0) return retained;
+  retained.reserve(std::min(num_boxes, max_num_detections));
+
+  RetainedBoxes retained_boxes(input, options);
+  for (int index : SortByDecreasingScore(input.scores)) {
+    if (options.min_score_threshold > 0 &&
+        input.scores[index] < options.min_score_threshold) {
+      break;
+    }
+    if (!retained_boxes.Suppresses(index)) {
+      retained.push_back(index);
+      retained_boxes.Add(index);
+    }
+    if (retained.size() >= max_num_detections) break;
+  }
+  return retained;
+}
+
+std::vector<std::vector<int>> BatchedNonMaxSuppression(
+    absl::Span<const NmsInput> inputs, const NmsOptions& options) {
+  std::vector<std::vector<int>> results;
+  results.reserve(inputs.size());
+  for (const auto& input : inputs) {
+    results.push_back(NonMaxSuppression(input, options));
+  }
+  return results;
+}
+
+std::vector<NmsCluster> WeightedNonMaxSuppression(const NmsInput& input,
+                                                  const NmsOptions& options) {
+  CheckInput(input, options);
+  const BoxArrays boxes(input.boxes);
+  std::vector<NmsCluster> clusters;
+  // The remaining boxes, by decreasing score, and their coordinates in the
+  // same order so that they are compared with the top box at once.
+  std::vector<int> remaining = SortByDecreasingScore(input.scores);
+  BoxArrays remaining_boxes;
+  remaining_boxes.Reserve(remaining.size());
+  for (int index : remaining) remaining_boxes.Add(boxes, index);
+  std::vector<int> rest;
+  rest.reserve(remaining.size());
+  BoxArrays rest_boxes;
+  rest_boxes.Reserve(remaining.size());
+  std::vector<float> overlaps;
+  while (!remaining.empty()) {
+    if (options.max_num_detections >= 0 &&
+        clusters.size() >= options.max_num_detections) {
+      break;
+    }
+    const int top = remaining[0];
+    if (options.min_score_threshold > 0 &&
+        input.scores[top] < options.min_score_threshold) {
+      break;
+    }
+    NmsCluster cluster{top, {}};
+    overlaps.resize(remaining.size());
+    ComputeOverlaps(options.overlap_type, remaining_boxes, boxes.xmin[top],
+                    boxes.ymin[top], boxes.xmax[top], boxes.ymax[top],
+                    overlaps.data());
+    rest.clear();
+    rest_boxes.Clear();
+    for (int i = 0; i < remaining.size(); ++i) {
+      const int index = remaining[i];
+      const bool same_class =
+          !options.class_aware || input.classes[index] == input.classes[top];
+      if (same_class && overlaps[i] > options.min_suppression_threshold) {
+        cluster.members.push_back(index);
+      } else {
+        rest.push_back(index);
+        rest_boxes.Add(remaining_boxes, i);
+      }
+    }
+    const bool removed_any = !cluster.members.empty();
+    clusters.push_back(std::move(cluster));
+    if (!removed_any) break;
+    std::swap(remaining, rest);
+    std::swap(remaining_boxes, rest_boxes);
+  }
+  return clusters;
+}
+
+}  // namespace mediapipe
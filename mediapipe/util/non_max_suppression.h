@@ -0,0 +1,101 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MEDIAPIPE_UTIL_NON_MAX_SUPPRESSION_H_
+#define MEDIAPIPE_UTIL_NON_MAX_SUPPRESSION_H_
+
+#include <vector>
+
+#include "absl/types/span.h"
+#include "mediapipe/framework/port/rectangle.h"
+
+namespace mediapipe {
+
+// Non-maximum suppression over flat arrays of boxes and scores.
+//
+// Boxes are plain rectangles (usually in relative coordinates), so that the
+// overlap between two candidates is computed without touching any Detection
+// or LocationData proto. Boxes are kept in structure-of-arrays layout and a
+// candidate is compared against many boxes at once by a branch-free overlap
+// loop. Greedy suppression also bins the retained boxes into a uniform grid,
+// so that each candidate is only compared against the retained boxes it may
+// overlap with.
+
+enum class NmsOverlapType {
+  // Intersection area over the area of the bounding box of both rectangles.
+  kJaccard,
+  // Intersection area over the area of the rectangle checked for suppression.
+  kModifiedJaccard,
+  // Intersection area over the area of the union of both rectangles.
+  kIntersectionOverUnion,
+};
+
+struct NmsOptions {
+  NmsOverlapType overlap_type = NmsOverlapType::kJaccard;
+  // A candidate is suppressed by a higher scoring box if their overlap is
+  // strictly greater than this threshold.
+  float min_suppression_threshold = 1.0f;
+  // If positive, candidates scoring below this threshold are dropped.
+  float min_score_threshold = -1.0f;
+  // Maximum number of retained boxes, or -1 for no limit.
+  int max_num_detections = -1;
+  // If true, boxes only suppress boxes of the same class.
+  bool class_aware = false;
+};
+
+struct NmsInput {
+  absl::Span<const Rectangle_f> boxes;
+  absl::Span<const float> scores;
+  // Class of each box. Only used, and then required, if class_aware is set.
+  absl::Span<const int> classes;
+};
+
+// Returns the overlap of `rect1` and `rect2` as defined by `overlap_type`, or
+// 0 if they don't intersect. For kModifiedJaccard, the intersection is
+// normalized by the area of `rect2`.
+float OverlapSimilarity(NmsOverlapType overlap_type, const Rectangle_f& rect1,
+                        const Rectangle_f& rect2);
+
+// Greedy non-maximum suppression: boxes are visited by decreasing score and
+// retained unless they overlap with an already retained box. Returns the
+// indices of the retained boxes, by decreasing score. Boxes with equal scores
+// are visited in index order.
+std::vector<int> NonMaxSuppression(const NmsInput& input,
+                                   const NmsOptions& options);
+
+// Runs NonMaxSuppression independently on each input.
+std::vector<std::vector<int>> BatchedNonMaxSuppression(
+    absl::Span<const NmsInput> inputs, const NmsOptions& options);
+
+// A cluster of boxes found by WeightedNonMaxSuppression.
+struct NmsCluster {
+  // Index of the highest scoring box of the cluster.
+  int index;
+  // Indices of the boxes overlapping with `index`, by decreasing score. This
+  // includes `index` itself unless min_suppression_threshold is >= 1. May be
+  // empty, in which case the box is reported alone.
+  std::vector<int> members;
+};
+
+// Weighted non-maximum suppression: the highest scoring remaining box and all
+// the remaining boxes overlapping with it form a cluster, which is removed
+// before the next iteration. Callers typically blend the members of each
+// cluster, weighted by score. Clustering stops early once an iteration no
+// longer removes any box.
+std::vector<NmsCluster> WeightedNonMaxSuppression(const NmsInput& input,
+                                                  const NmsOptions& options);
+
+}  // namespace mediapipe
+
+#endif  // MEDIAPIPE_UTIL_NON_MAX_SUPPRESSION_H_
@@ -0,0 +1,83 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+// Benchmark for the non-maximum suppression library.
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "mediapipe/framework/port/rectangle.h"
+#include "mediapipe/util/non_max_suppression.h"
+
+namespace {
+
+using ::mediapipe::NmsInput;
+using ::mediapipe::NmsOptions;
+
+// Generates `num_boxes` small boxes clustered around a few objects, as seen in
+// crowded scenes before suppression.
+void MakeBoxes(int num_boxes, std::vector<Rectangle_f>* boxes,
+               std::vector<float>* scores) {
+  std::mt19937 rng(0 /*seed*/);
+  std::uniform_real_distribution<float> center(0.05f, 0.95f);
+  std::normal_distribution<float> jitter(0.0f, 0.005f);
+  std::uniform_real_distribution<float> score(0.0f, 1.0f);
+  const int num_objects = num_boxes / 8 + 1;
+  std::vector<std::pair<float, float>> objects;
+  for (int i = 0; i < num_objects; ++i) {
+    objects.emplace_back(center(rng), center(rng));
+  }
+  boxes->clear();
+  scores->clear();
+  for (int i = 0; i < num_boxes; ++i) {
+    const auto& object = objects[i % num_objects];
+    boxes->emplace_back(object.first + jitter(rng) - 0.02f,
+                        object.second + jitter(rng) - 0.02f, 0.04f, 0.04f);
+    scores->push_back(score(rng));
+  }
+}
+
+void BM_NonMaxSuppression(benchmark::State& state) {
+  std::vector<Rectangle_f> boxes;
+  std::vector<float> scores;
+  MakeBoxes(state.range(0), &boxes, &scores);
+  NmsOptions options;
+  options.overlap_type = mediapipe::NmsOverlapType::kIntersectionOverUnion;
+  options.min_suppression_threshold = 0.3f;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        mediapipe::NonMaxSuppression(NmsInput{boxes, scores}, options));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NonMaxSuppression)->RangeMultiplier(4)->Range(16, 16384);
+
+void BM_WeightedNonMaxSuppression(benchmark::State& state) {
+  std::vector<Rectangle_f> boxes;
+  std::vector<float> scores;
+  MakeBoxes(state.range(0), &boxes, &scores);
+  NmsOptions options;
+  options.min_suppression_threshold = 0.3f;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        mediapipe::WeightedNonMaxSuppression(NmsInput{boxes, scores}, options));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_WeightedNonMaxSuppression)->RangeMultiplier(4)->Range(16, 4096);
+
+}  // namespace
+
+BENCHMARK_MAIN();
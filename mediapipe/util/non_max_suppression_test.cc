@@ -0,0 +1,228 @@
+// Copyright 2023 The MediaPipe Authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "mediapipe/util/non_max_suppression.h"
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "mediapipe/framework/port/gmock.h"
+#include "mediapipe/framework/port/gtest.h"
+#include "mediapipe/framework/port/rectangle.h"
+
+namespace mediapipe {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::FloatEq;
+using ::testing::IsEmpty;
+
+// Straightforward greedy suppression, comparing against all retained boxes.
+std::vector<int> ReferenceNonMaxSuppression(const NmsInput& input,
+                                            const NmsOptions& options) {
+  std::vector<int> order(input.boxes.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return input.scores[a] > input.scores[b];
+  });
+  std::vector<int> retained;
+  for (int index : order) {
+    bool suppressed = false;
+    for (int r : retained) {
+      if (options.class_aware && input.classes[r] != input.classes[index]) {
+        continue;
+      }
+      if (OverlapSimilarity(options.overlap_type, input.boxes[r],
+                            input.boxes[index]) >
+          options.min_suppression_threshold) {
+        suppressed = true;
+        break;
+      }
+    }
+    if (!suppressed) retained.push_back(index);
+  }
+  return retained;
+}
+
+TEST(NonMaxSuppressionTest, OverlapSimilarity) {
+  const Rectangle_f rect1(0.0f, 0.0f, 0.4f, 0.4f);
+  const Rectangle_f rect2(0.2f, 0.0f, 0.4f, 0.2f);
+  // Intersection 0.2 x 0.2, bounding box 0.6 x 0.4.
+  EXPECT_FLOAT_EQ(OverlapSimilarity(NmsOverlapType::kJaccard, rect1, rect2),
+                  0.04f / 0.24f);
+  EXPECT_FLOAT_EQ(
+      OverlapSimilarity(NmsOverlapType::kModifiedJaccard, rect1, rect2),
+      0.04f / 0.08f);
+  EXPECT_FLOAT_EQ(
+      OverlapSimilarity(NmsOverlapType::kIntersectionOverUnion, rect1, rect2),
+      0.04f / (0.16f + 0.08f - 0.04f));
+  EXPECT_EQ(OverlapSimilarity(NmsOverlapType::kJaccard, rect1,
+                              Rectangle_f(0.5f, 0.5f, 0.1f, 0.1f)),
+            0.0f);
+}
+
+TEST(NonMaxSuppressionTest, SuppressesOverlappingBoxes) {
+  const std::vector<Rectangle_f> boxes = {
+      Rectangle_f(0.0f, 0.0f, 0.4f, 0.4f), Rectangle_f(0.05f, 0.0f, 0.4f, 0.4f),
+      Rectangle_f(0.6f, 0.6f, 0.3f, 0.3f)};
+  const std::vector<float> scores = {0.8f, 0.9f, 0.5f};
+  NmsOptions options;
+  options.overlap_type = NmsOverlapType::kIntersectionOverUnion;
+  options.min_suppression_threshold = 0.5f;
+
+  EXPECT_THAT(NonMaxSuppression({boxes, scores}, options), ElementsAre(1, 2));
+
+  options.max_num_detections = 1;
+  EXPECT_THAT(NonMaxSuppression({boxes, scores}, options), ElementsAre(1));
+
+  options.max_num_detections = -1;
+  options.min_score_threshold = 0.6f;
+  EXPECT_THAT(NonMaxSuppression({boxes, scores}, options), ElementsAre(1));
+}
+
+TEST(NonMaxSuppressionTest, ClassAware) {
+  const std::vector<Rectangle_f> boxes = {Rectangle_f(0.0f, 0.0f, 0.4f, 0.4f),
+                                          Rectangle_f(0.0f, 0.0f, 0.4f, 0.4f)};
+  const std::vector<float> scores = {0.9f, 0.8f};
+  const std::vector<int> classes = {0, 1};
+  NmsOptions options;
+  options.min_suppression_threshold = 0.5f;
+
+  EXPECT_THAT(NonMaxSuppression({boxes, scores, classes}, options),
+              ElementsAre(0));
+  options.class_aware = true;
+  EXPECT_THAT(NonMaxSuppression({boxes, scores, classes}, options),
+              ElementsAre(0, 1));
+}
+
+TEST(NonMaxSuppressionTest, BinningMatchesReference) {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> position(-0.1f, 1.0f);
+  std::uniform_real_distribution<float> size(0.0f, 0.2f);
+  std::uniform_real_distribution<float> score(0.0f, 1.0f);
+  std::uniform_int_distribution<int> class_id(0, 2);
+  std::vector<Rectangle_f> boxes;
+  std::vector<float> scores;
+  std::vector<int> classes;
+  for (int i = 0; i < 1000; ++i) {
+    boxes.emplace_back(position(rng), position(rng), size(rng), size(rng));
+    scores.push_back(score(rng));
+    classes.push_back(class_id(rng));
+  }
+  // Boxes touching along an edge intersect with zero area.
+  boxes.emplace_back(1.1f, 1.1f, 0.1f, 0.1f);
+  boxes.emplace_back(1.2f, 1.1f, 0.1f, 0.1f);
+  scores.push_back(1.0f);
+  scores.push_back(1.0f);
+  classes.push_back(0);
+  classes.push_back(0);
+
+  for (const auto overlap_type :
+       {NmsOverlapType::kJaccard, NmsOverlapType::kModifiedJaccard,
+        NmsOverlapType::kIntersectionOverUnion}) {
+    for (const float threshold : {0.0f, 0.3f, 0.7f}) {
+      for (const bool class_aware : {false, true}) {
+        NmsOptions options;
+        options.overlap_type = overlap_type;
+        options.min_suppression_threshold = threshold;
+        options.class_aware = class_aware;
+        const NmsInput input{boxes, scores, classes};
+        EXPECT_EQ(NonMaxSuppression(input, options),
+                  ReferenceNonMaxSuppression(input, options));
+      }
+    }
+  }
+}
+
+TEST(NonMaxSuppressionTest, SmallInputMatchesReference) {
+  std::mt19937 rng(0);
+  std::uniform_real_distribution<float> position(0.0f, 1.0f);
+  std::uniform_real_distribution<float> size(-0.05f, 0.5f);
+  std::uniform_real_distribution<float> score(0.0f, 1.0f);
+  std::uniform_int_distribution<int> class_id(0, 1);
+  std::vector<Rectangle_f> boxes;
+  std::vector<float> scores;
+  std::vector<int> classes;
+  // Few enough boxes not to be binned, some of them empty.
+  for (int i = 0; i < 40; ++i) {
+    boxes.emplace_back(position(rng), position(rng), size(rng), size(rng));
+    scores.push_back(score(rng));
+    classes.push_back(class_id(rng));
+  }
+
+  for (const auto overlap_type :
+       {NmsOverlapType::kJaccard, NmsOverlapType::kModifiedJaccard,
+        NmsOverlapType::kIntersectionOverUnion}) {
+    for (const float threshold : {-1.0f, 0.0f, 0.3f, 0.7f}) {
+      for (const bool class_aware : {false, true}) {
+        NmsOptions options;
+        options.overlap_type = overlap_type;
+        options.min_suppression_threshold = threshold;
+        options.class_aware = class_aware;
+        const NmsInput input{boxes, scores, classes};
+        EXPECT_EQ(NonMaxSuppression(input, options),
+                  ReferenceNonMaxSuppression(input, options));
+      }
+    }
+  }
+}
+
+TEST(NonMaxSuppressionTest, Batched) {
+  const std::vector<Rectangle_f> boxes = {Rectangle_f(0.0f, 0.0f, 0.4f, 0.4f),
+                                          Rectangle_f(0.0f, 0.0f, 0.4f, 0.4f)};
+  const std::vector<float> scores1 = {0.9f, 0.8f};
+  const std::vector<float> scores2 = {0.1f, 0.8f};
+  NmsOptions options;
+  options.min_suppression_threshold = 0.5f;
+  const std::vector<NmsInput> inputs = {{boxes, scores1}, {boxes, scores2}};
+
+  EXPECT_THAT(BatchedNonMaxSuppression(inputs, options),
+              ElementsAre(ElementsAre(0), ElementsAre(1)));
+}
+
+TEST(NonMaxSuppressionTest, Weighted) {
+  const std::vector<Rectangle_f> boxes = {
+      Rectangle_f(0.0f, 0.0f, 0.4f, 0.4f), Rectangle_f(0.02f, 0.0f, 0.4f, 0.4f),
+      Rectangle_f(0.6f, 0.6f, 0.3f, 0.3f)};
+  const std::vector<float> scores = {0.8f, 0.9f, 0.5f};
+  NmsOptions options;
+  options.min_suppression_threshold = 0.5f;
+
+  const auto clusters = WeightedNonMaxSuppression({boxes, scores}, options);
+  ASSERT_EQ(clusters.size(), 2);
+  EXPECT_EQ(clusters[0].index, 1);
+  EXPECT_THAT(clusters[0].members, ElementsAre(1, 0));
+  EXPECT_EQ(clusters[1].index, 2);
+  EXPECT_THAT(clusters[1].members, ElementsAre(2));
+}
+
+TEST(NonMaxSuppressionTest, WeightedStopsWhenNothingIsRemoved) {
+  const std::vector<Rectangle_f> boxes = {Rectangle_f(0.0f, 0.0f, 0.4f, 0.4f),
+                                          Rectangle_f(0.6f, 0.6f, 0.3f, 0.3f)};
+  const std::vector<float> scores = {0.8f, 0.9f};
+  // A box overlaps with itself by exactly 1, so it isn't part of its own
+  // cluster with this threshold.
+  NmsOptions options;
+  options.min_suppression_threshold = 1.0f;
+
+  const auto clusters = WeightedNonMaxSuppression({boxes, scores}, options);
+  ASSERT_EQ(clusters.size(), 1);
+  EXPECT_EQ(clusters[0].index, 1);
+  EXPECT_THAT(clusters[0].members, IsEmpty());
+}
+
+}  // namespace
+}  // namespace mediapipe